@@ -7,6 +7,8 @@
 #ifndef _ASM_ARCH_CLOCK_H
 #define _ASM_ARCH_CLOCK_H
 
+#include <errno.h>
+
 /* define pll mode */
 #define RKCLK_PLL_MODE_SLOW		0
 #define RKCLK_PLL_MODE_NORMAL		1
@@ -102,9 +104,115 @@ struct rockchip_cpu_rate_table {
 	unsigned int pclk_div;
 };
 
+/**
+ * struct rockchip_pll_set - one PLL of a rockchip_pll_set_rates() call
+ *
+ * @pll:	PLL to set
+ * @base:	Base address of the CRU holding the PLL
+ * @pll_id:	PLL index, for messages
+ * @rate:	Rate to set, in Hz
+ * @ret:	Returns 0 on success or negative value of errno
+ */
+struct rockchip_pll_set {
+	struct rockchip_pll_clock *pll;
+	void __iomem *base;
+	ulong pll_id;
+	ulong rate;
+	int ret;
+};
+
 int rockchip_pll_set_rate(struct rockchip_pll_clock *pll,
 			  void __iomem *base, ulong clk_id,
 			  ulong drate);
+
+/**
+ * rockchip_pll_set_rates() - set the rate of several PLLs
+ *
+ * All the PLLs are reprogrammed first and then waited for together, so
+ * that they lock in parallel rather than one after the other. Each PLL
+ * runs from the oscillator until it has locked.
+ *
+ * @sets:	PLLs to set, the result for each is returned in its @ret
+ * @count:	Number of entries in @sets
+ * @return 0 if all PLLs were set, else the first error
+ */
+int rockchip_pll_set_rates(struct rockchip_pll_set *sets, int count);
+
+#define ROCKCHIP_CLK_CACHE_SIZE		32
+
+/**
+ * struct rockchip_clk_cache - clock rates read from a CRU
+ *
+ * Direct-mapped by clock ID. An entry is valid while its generation
+ * matches the one bumped by rockchip_clk_cache_invalidate().
+ */
+struct rockchip_clk_cache {
+	struct {
+		u32 id;
+		u32 gen;
+		ulong rate;
+	} ent[ROCKCHIP_CLK_CACHE_SIZE];
+};
+
+#if CONFIG_IS_ENABLED(ROCKCHIP_CLK_RATE_CACHE)
+/**
+ * rockchip_clk_cache_alloc() - allocate a rate cache for a CRU
+ *
+ * @return the cache, or NULL if there is no memory for it
+ */
+struct rockchip_clk_cache *rockchip_clk_cache_alloc(void);
+
+/**
+ * rockchip_clk_cache_get() - look up the cached rate of a clock
+ *
+ * @cache:	Rate cache of the CRU, may be NULL
+ * @id:		Clock ID
+ * @rate:	Returns the rate on success
+ * @return 0 on success, -ENOENT if the rate must be read
+ */
+int rockchip_clk_cache_get(struct rockchip_clk_cache *cache, ulong id,
+			   ulong *rate);
+
+/**
+ * rockchip_clk_cache_put() - remember the rate of a clock
+ *
+ * Error values and zero rates are not remembered.
+ *
+ * @cache:	Rate cache of the CRU, may be NULL
+ * @id:		Clock ID
+ * @rate:	Rate read from the CRU
+ */
+void rockchip_clk_cache_put(struct rockchip_clk_cache *cache, ulong id,
+			    ulong rate);
+
+/**
+ * rockchip_clk_cache_invalidate() - forget all cached rates
+ *
+ * Must be called on any PLL, mux or divider change. A change in one CRU
+ * may affect clocks of another, so this covers the caches of all CRUs.
+ */
+void rockchip_clk_cache_invalidate(void);
+#else
+static inline struct rockchip_clk_cache *rockchip_clk_cache_alloc(void)
+{
+	return NULL;
+}
+
+static inline int rockchip_clk_cache_get(struct rockchip_clk_cache *cache,
+					 ulong id, ulong *rate)
+{
+	return -ENOENT;
+}
+
+static inline void rockchip_clk_cache_put(struct rockchip_clk_cache *cache,
+					  ulong id, ulong rate)
+{
+}
+
+static inline void rockchip_clk_cache_invalidate(void)
+{
+}
+#endif
 ulong rockchip_pll_get_rate(struct rockchip_pll_clock *pll,
 			    void __iomem *base, ulong clk_id);
 const struct rockchip_cpu_rate_table *
@@ -12,6 +12,7 @@
 /* Private data for the clock driver - used by rockchip_get_cru() */
 struct rk3399_clk_priv {
 	struct rk3399_cru *cru;
+	struct rockchip_clk_cache *rate_cache;
 	ulong armlclk_hz;
 	ulong armlclk_enter_hz;
 	ulong armlclk_init_hz;
@@ -24,6 +25,7 @@ struct rk3399_clk_priv {
 
 struct rk3399_pmuclk_priv {
 	struct rk3399_pmucru *pmucru;
+	struct rockchip_clk_cache *rate_cache;
 };
 
 struct rk3399_pmucru {
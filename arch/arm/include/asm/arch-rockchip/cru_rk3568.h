@@ -38,6 +38,7 @@ struct rk3568_clk_info {
 /* Private data for the clock driver - used by rockchip_get_cru() */
 struct rk3568_pmuclk_priv {
 	struct rk3568_pmucru *pmucru;
+	struct rockchip_clk_cache *rate_cache;
 	ulong ppll_hz;
 	ulong hpll_hz;
 };
@@ -45,6 +46,7 @@ struct rk3568_pmuclk_priv {
 struct rk3568_clk_priv {
 	struct rk3568_cru *cru;
 	struct rk3568_grf *grf;
+	struct rockchip_clk_cache *rate_cache;
 	ulong ppll_hz;
 	ulong hpll_hz;
 	ulong gpll_hz;
@@ -38,6 +38,19 @@ int resource_create_ram_list(struct blk_desc *dev_desc, void *rsce_hdr);
  */
 int rockchip_read_resource_file(void *buf, const char *name, int offset, int len);
 
+/*
+ * rockchip_read_resource_file_stream - read file and process it while it loads
+ * @name: file name
+ * @chunk: the size(by bytes) handed to @process at a time
+ * @process: called in order with each piece of the file, returns 0 to go on
+ * @priv: private data passed to @process
+ * return negative num on failed, otherwise the file size
+ */
+int rockchip_read_resource_file_stream(const char *name, ulong chunk,
+				       int (*process)(void *priv, void *buf,
+						      ulong len),
+				       void *priv);
+
 /*
  * rockchip_read_resource_dtb() - read dtb file
  *
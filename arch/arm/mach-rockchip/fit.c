@@ -5,6 +5,8 @@
  */
 #include <common.h>
 #include <boot_rkimg.h>
+#include <crypto.h>
+#include <hash.h>
 #include <image.h>
 #include <malloc.h>
 #include <sysmem.h>
@@ -260,6 +262,134 @@ int fit_image_fail_process(const void *fit)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+#define FIT_HASH_CHUNK_SIZE		SZ_512K
+
+struct fit_hash_state {
+	struct udevice *crypto;	/* hash by hardware if not NULL */
+	sha_context crypto_ctx;
+	struct hash_algo *algo;
+	void *ctx;
+};
+
+#if CONFIG_IS_ENABLED(FIT_HW_CRYPTO)
+/* Starts a hardware hash of @size bytes, returns -ENODEV if there is none */
+static int fit_hash_crypto_init(struct fit_hash_state *state,
+				const char *algo, int size, int value_len)
+{
+	sha_context *ctx = &state->crypto_ctx;
+
+	if (!strcmp(algo, "sha1"))
+		ctx->algo = CRYPTO_SHA1;
+	else if (!strcmp(algo, "sha256"))
+		ctx->algo = CRYPTO_SHA256;
+	else if (!strcmp(algo, "md5"))
+		ctx->algo = CRYPTO_MD5;
+	else
+		return -ENODEV;
+
+	if (BITS2BYTE(crypto_algo_nbits(ctx->algo)) != value_len)
+		return -ENODEV;
+
+	state->crypto = crypto_get_device(ctx->algo);
+	if (!state->crypto)
+		return -ENODEV;
+
+	ctx->length = size;
+	if (crypto_sha_init(state->crypto, ctx)) {
+		state->crypto = NULL;
+		return -ENODEV;
+	}
+
+	return 0;
+}
+#else
+static inline int fit_hash_crypto_init(struct fit_hash_state *state,
+				       const char *algo, int size,
+				       int value_len)
+{
+	return -ENODEV;
+}
+#endif
+
+static int fit_hash_chunk(void *priv, void *buf, ulong len)
+{
+	struct fit_hash_state *state = priv;
+
+	if (CONFIG_IS_ENABLED(FIT_HW_CRYPTO) && state->crypto)
+		return crypto_sha_update(state->crypto, (u32 *)buf, len);
+
+	/* hash_update() frees the context when it fails */
+	if (state->algo->hash_update(state->algo, state->ctx, buf, len, 0)) {
+		state->ctx = NULL;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int fit_hash_finish(struct fit_hash_state *state, u8 *value, int size)
+{
+	if (CONFIG_IS_ENABLED(FIT_HW_CRYPTO) && state->crypto)
+		return crypto_sha_final(state->crypto, &state->crypto_ctx,
+					value);
+	if (!state->ctx)
+		return -EINVAL;
+
+	return state->algo->hash_finish(state->algo, state->ctx, value, size);
+}
+
+/*
+ * Read and hash the image chunk by chunk, so the hash of one chunk overlaps
+ * the read of the next. The crypto device hashes it if there is one for the
+ * algorithm, else it is hashed in software. Returns -ENOSYS if the algorithm
+ * cannot be hashed progressively and the caller should read and check the
+ * image as a whole.
+ */
+static int fit_image_load_hashed(const void *fit, int hash_noffset,
+				 struct blk_desc *dev_desc, lbaint_t start,
+				 int size, void *data)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	struct fit_hash_state state = { 0 };
+	uint8_t *fit_value;
+	int fit_value_len;
+	char *algo;
+	int ret;
+
+	if (fit_image_hash_get_algo(fit, hash_noffset, &algo) ||
+	    fit_image_hash_get_value(fit, hash_noffset, &fit_value,
+				     &fit_value_len))
+		return -ENOSYS;
+
+	if (fit_hash_crypto_init(&state, algo, size, fit_value_len)) {
+		if (hash_progressive_lookup_algo(algo, &state.algo) ||
+		    state.algo->digest_size != fit_value_len)
+			return -ENOSYS;
+
+		if (state.algo->hash_init(state.algo, &state.ctx))
+			return -ENOSYS;
+	}
+
+	printf("%s", algo);
+	ret = blk_dread_pipeline(dev_desc, start, size, data,
+				 FIT_HASH_CHUNK_SIZE, fit_hash_chunk, &state);
+
+	/* Finish even on error, to free the context or idle the engine */
+	if (fit_hash_finish(&state, value, sizeof(value)) && !ret)
+		ret = -EINVAL;
+	if (ret)
+		return ret;
+
+	if (memcmp(value, fit_value, fit_value_len)) {
+		printf(" Bad hash\n");
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+#endif
+
 static int fit_image_load_one(const void *fit, struct blk_desc *dev_desc,
 			      disk_partition_t *part, char *prop_name,
 			      void *data, int check_hash)
@@ -267,20 +397,14 @@ static int fit_image_load_one(const void *fit, struct blk_desc *dev_desc,
 	u32 blk_num, blk_off;
 	int offset, size;
 	int noffset, ret;
+	int hash_noffset = 0;
 	char *msg = "";
 
 	ret = fdt_image_get_offset_size(fit, prop_name, &offset, &size);
 	if (ret)
 		return ret;
 
-	blk_off = (FIT_ALIGN(fdt_totalsize(fit)) + offset) / dev_desc->blksz;
-	blk_num = DIV_ROUND_UP(size, dev_desc->blksz);
-	if (blk_dread(dev_desc, part->start + blk_off, blk_num, data) != blk_num)
-		return -EIO;
-
 	if (check_hash) {
-		int hash_noffset;
-
 		noffset = fit_default_conf_get_node(fit, prop_name);
 		if (noffset < 0)
 			return noffset;
@@ -291,12 +415,30 @@ static int fit_image_load_one(const void *fit, struct blk_desc *dev_desc,
 			return hash_noffset;
 
 		printf("%s: ", fdt_get_name(fit, noffset, NULL));
-		ret = fit_image_check_hash(fit, hash_noffset, data, size, &msg);
-		if (ret)
-			return ret;
+	}
 
-		puts("+\n");
+	blk_off = (FIT_ALIGN(fdt_totalsize(fit)) + offset) / dev_desc->blksz;
+	blk_num = DIV_ROUND_UP(size, dev_desc->blksz);
+
+	ret = -ENOSYS;
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	if (check_hash)
+		ret = fit_image_load_hashed(fit, hash_noffset, dev_desc,
+					    part->start + blk_off, size, data);
+#endif
+	if (ret == -ENOSYS) {
+		if (blk_dread(dev_desc, part->start + blk_off, blk_num,
+			      data) != blk_num)
+			return -EIO;
+
+		ret = check_hash ? fit_image_check_hash(fit, hash_noffset,
+							data, size, &msg) : 0;
 	}
+	if (ret)
+		return ret;
+
+	if (check_hash)
+		puts("+\n");
 
 	return 0;
 }
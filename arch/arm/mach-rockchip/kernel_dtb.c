@@ -5,6 +5,7 @@
  */
 #include <common.h>
 #include <boot_rkimg.h>
+#include <bootstage.h>
 #include <dm.h>
 #include <malloc.h>
 #include <of_live.h>
@@ -321,7 +322,16 @@ dtb_okay:
 	phandles_fixup_gpio((void *)gd->fdt_blob, (void *)ufdt_blob);
 
 	gd->flags |= GD_FLG_KDTB_READY;
-	of_live_build((void *)gd->fdt_blob, (struct device_node **)&gd->of_root);
+	/*
+	 * The U-Boot live tree is not freed with of_live_free(): devices
+	 * and aliases kept from the U-Boot dtb still refer to its nodes.
+	 */
+	bootstage_start(BOOTSTAGE_ID_ACCUM_OF_LIVE, "of_live");
+	ret = of_live_build((void *)gd->fdt_blob,
+			    (struct device_node **)&gd->of_root);
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_OF_LIVE);
+	if (ret)
+		printf("Failed to build kernel live dt, ret=%d\n", ret);
 	dm_scan_fdt((void *)gd->fdt_blob, false);
 
 	/*
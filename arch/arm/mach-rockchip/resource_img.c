@@ -28,6 +28,8 @@ DECLARE_GLOBAL_DATA_PTR;
 #define ENTRY_TAG_SIZE			4
 #define MAX_FILE_NAME_LEN		220
 #define MAX_HASH_LEN			32
+#define INDEX_MAGIC			"RIDX"
+#define INDEX_MAGIC_SIZE		4
 #define DTB_FILE			"rk-kernel.dtb"
 
 /*
@@ -65,6 +67,10 @@ DECLARE_GLOBAL_DATA_PTR;
  * |    filen  (z blocks)                       |
  * |                                            |
  * ----------------------------------------------
+ * |                                            |
+ * |    name index (optional, m blocks)         |
+ * |                                            |
+ * ----------------------------------------------
  */
 
 /**
@@ -77,6 +83,9 @@ DECLARE_GLOBAL_DATA_PTR;
  * @c_offset: contents offset(by block) in the image
  * @e_blks: the size(by block) of the entry in the contents
  * @e_num: numbers of the entrys.
+ * @i_magic: "RIDX" if the name index is present, old images leave it zero
+ * @i_offset: name index offset(by block) in the image
+ * @i_nums: numbers of the name index entrys, must be equal to @e_nums
  */
 
 struct resource_img_hdr {
@@ -87,6 +96,18 @@ struct resource_img_hdr {
 	uint8_t		c_offset;
 	uint8_t		e_blks;
 	uint32_t	e_nums;
+	char		i_magic[4];
+	uint32_t	i_offset;
+	uint32_t	i_nums;
+};
+
+/*
+ * The name index is sorted by hash and then by name, it lets us build the
+ * lookup table below without hashing and sorting all the entrys again.
+ */
+struct resource_index_entry {
+	uint32_t	hash;		/* resource_name_hash() of the name */
+	uint32_t	e_index;	/* Entry number in the contents */
 };
 
 struct resource_entry {
@@ -108,10 +129,161 @@ struct resource_file {
 	/* Sector base of resource when ram=false, byte base when ram=true */
 	uint32_t	rsce_base;
 	bool		ram;
+	uint32_t	name_hash;
 };
 
 static LIST_HEAD(entrys_head);
 
+/* All files of entrys_head, sorted by name_hash and then by name */
+static struct resource_file **file_index;
+static int file_index_num;
+static int file_index_max;
+
+/* FNV-1a, sync with tools/rockchip/resource_tool.c */
+static uint32_t resource_name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static int file_index_cmp(uint32_t hash, const char *name,
+			  struct resource_file *file)
+{
+	if (hash != file->name_hash)
+		return hash < file->name_hash ? -1 : 1;
+
+	return strcmp(name, file->name);
+}
+
+/* Return the position of @name, or -(insert position + 1) if not found */
+static int file_index_search(uint32_t hash, const char *name)
+{
+	int lo = 0, hi = file_index_num - 1;
+	int mid, ret;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		ret = file_index_cmp(hash, name, file_index[mid]);
+		if (!ret)
+			return mid;
+		else if (ret < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+
+	return -(lo + 1);
+}
+
+static int file_index_grow(int num)
+{
+	struct resource_file **index;
+
+	if (num <= file_index_max)
+		return 0;
+
+	num = max(num, file_index_max * 2);
+	index = realloc(file_index, num * sizeof(*index));
+	if (!index)
+		return -ENOMEM;
+
+	file_index = index;
+	file_index_max = num;
+
+	return 0;
+}
+
+static int file_index_insert(struct resource_file *file)
+{
+	int pos;
+
+	if (file_index_grow(file_index_num + 1))
+		return -ENOMEM;
+
+	/* Keep the first one of the same name, as the list walk did */
+	pos = file_index_search(file->name_hash, file->name);
+	if (pos >= 0)
+		return 0;
+
+	pos = -(pos + 1);
+	memmove(&file_index[pos + 1], &file_index[pos],
+		(file_index_num - pos) * sizeof(*file_index));
+	file_index[pos] = file;
+	file_index_num++;
+
+	return 0;
+}
+
+static void file_index_remove(struct resource_file *file)
+{
+	int pos;
+
+	pos = file_index_search(file->name_hash, file->name);
+	if (pos < 0 || file_index[pos] != file)
+		return;
+
+	file_index_num--;
+	memmove(&file_index[pos], &file_index[pos + 1],
+		(file_index_num - pos) * sizeof(*file_index));
+}
+
+/*
+ * Take the lookup table from the name index of image as it is, if it
+ * matches the files we just added. Otherwise fall back to insert the
+ * files one by one.
+ */
+static int file_index_load(struct resource_index_entry *index,
+			   struct resource_file **files, int num)
+{
+	struct resource_file *file, *prev = NULL;
+	u32 e_index;
+	int i;
+
+	if (file_index_num || file_index_grow(num))
+		goto insert;
+
+	for (i = 0; i < num; i++) {
+		e_index = le32_to_cpu(index[i].e_index);
+		if (e_index >= num || !files[e_index])
+			goto fallback;
+
+		file = files[e_index];
+		if (le32_to_cpu(index[i].hash) != file->name_hash)
+			goto fallback;
+		if (prev && file_index_cmp(prev->name_hash, prev->name,
+					   file) >= 0)
+			goto fallback;
+
+		file_index[i] = file;
+		prev = file;
+	}
+	file_index_num = num;
+
+	return 0;
+
+fallback:
+	debug("invalid resource name index\n");
+insert:
+	for (i = 0; i < num; i++) {
+		if (files[i] && file_index_insert(files[i]))
+			return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static bool resource_has_index(struct resource_img_hdr *hdr)
+{
+	return !memcmp(hdr->i_magic, INDEX_MAGIC, INDEX_MAGIC_SIZE) &&
+	       hdr->i_nums == hdr->e_nums;
+}
+
 int resource_image_check_header(void *rsce_hdr)
 {
 	struct resource_img_hdr *hdr = rsce_hdr;
@@ -132,24 +304,27 @@ int resource_image_check_header(void *rsce_hdr)
 	debug("c_offset:%d\n", hdr->c_offset);
 	debug("e_blks:%d\n", hdr->e_blks);
 	debug("e_num:%d\n", hdr->e_nums);
+	if (resource_has_index(hdr))
+		debug("i_offset:%d\n", hdr->i_offset);
 
 	return ret;
 }
 
-static int add_file_to_list(struct resource_entry *entry,
-			    int rsce_base, bool ram)
+static struct resource_file *add_file_to_list(struct resource_entry *entry,
+					      int rsce_base, bool ram,
+					      bool index)
 {
 	struct resource_file *file;
 
 	if (memcmp(entry->tag, ENTRY_TAG, ENTRY_TAG_SIZE)) {
 		printf("invalid entry tag\n");
-		return -ENOENT;
+		return NULL;
 	}
 
 	file = malloc(sizeof(*file));
 	if (!file) {
 		printf("out of memory\n");
-		return -ENOMEM;
+		return NULL;
 	}
 
 	strcpy(file->name, entry->name);
@@ -158,13 +333,56 @@ static int add_file_to_list(struct resource_entry *entry,
 	file->f_size = entry->f_size;
 	file->hash_size = entry->hash_size;
 	file->ram = ram;
+	file->name_hash = resource_name_hash(file->name);
 	memcpy(file->hash, entry->hash, entry->hash_size);
 	list_add_tail(&file->link, &entrys_head);
+	if (index && file_index_insert(file)) {
+		list_del(&file->link);
+		free(file);
+		return NULL;
+	}
 
 	debug("entry: %p, %18s, base: 0x%08x, offset: 0x%08x, size: 0x%08x\n",
 	      entry, file->name, file->rsce_base, file->f_offset, file->f_size);
 
-	return 0;
+	return file;
+}
+
+/*
+ * Add all entrys to the file list, and use the name index of image for
+ * lookup table if there is one.
+ */
+static int add_entrys_to_list(struct resource_img_hdr *hdr, void *data,
+			      struct resource_index_entry *index,
+			      u32 blksz, int rsce_base, bool ram)
+{
+	struct resource_file **files = NULL;
+	struct resource_entry *entry;
+	int e_num, size;
+	int ret = 0;
+
+	if (index) {
+		files = calloc(hdr->e_nums, sizeof(*files));
+		if (!files)
+			index = NULL;
+	}
+
+	for (e_num = 0; e_num < hdr->e_nums; e_num++) {
+		size = e_num * hdr->e_blks * blksz;
+		entry = (struct resource_entry *)(data + size);
+		if (files)
+			files[e_num] = add_file_to_list(entry, rsce_base,
+							ram, false);
+		else
+			add_file_to_list(entry, rsce_base, ram, true);
+	}
+
+	if (files) {
+		ret = file_index_load(index, files, hdr->e_nums);
+		free(files);
+	}
+
+	return ret;
 }
 
 static int replace_resource_entry(const char *f_name, uint32_t base,
@@ -191,16 +409,17 @@ static int replace_resource_entry(const char *f_name, uint32_t base,
 	list_for_each(node, &entrys_head) {
 		file = list_entry(node, struct resource_file, link);
 		if (!strcmp(file->name, entry->name)) {
+			file_index_remove(file);
 			list_del(&file->link);
 			free(file);
 			break;
 		}
 	}
 
-	add_file_to_list(entry, base, false);
+	file = add_file_to_list(entry, base, false, true);
 	free(entry);
 
-	return 0;
+	return file ? 0 : -ENOMEM;
 }
 
 static int read_bmp(struct blk_desc *dev_desc, const char *name,
@@ -277,8 +496,7 @@ static int read_logo_bmps(struct blk_desc *dev_desc)
 int resource_create_ram_list(struct blk_desc *dev_desc, void *rsce_hdr)
 {
 	struct resource_img_hdr *hdr = rsce_hdr;
-	struct resource_entry *entry;
-	int e_num, size;
+	struct resource_index_entry *index = NULL;
 	void *data;
 	int ret = 0;
 
@@ -288,11 +506,10 @@ int resource_create_ram_list(struct blk_desc *dev_desc, void *rsce_hdr)
 	}
 
 	data = (void *)((ulong)hdr + hdr->c_offset * dev_desc->blksz);
-	for (e_num = 0; e_num < hdr->e_nums; e_num++) {
-		size = e_num * hdr->e_blks * dev_desc->blksz;
-		entry = (struct resource_entry *)(data + size);
-		add_file_to_list(entry, (ulong)hdr, true);
-	}
+	if (resource_has_index(hdr))
+		index = (void *)((ulong)hdr + hdr->i_offset * dev_desc->blksz);
+	ret = add_entrys_to_list(hdr, data, index, dev_desc->blksz,
+				 (ulong)hdr, true);
 out:
 	read_logo_bmps(dev_desc);
 
@@ -301,12 +518,11 @@ out:
 
 static int resource_create_list(struct blk_desc *dev_desc, int rsce_base)
 {
+	struct resource_index_entry *index = NULL;
 	struct resource_img_hdr *hdr;
-	struct resource_entry *entry;
-	int blknum, e_num;
+	int blknum;
 	void *data = NULL;
 	int ret = 0;
-	int size;
 
 	hdr = memalign(ARCH_DMA_MINALIGN, dev_desc->blksz);
 	if (!hdr)
@@ -344,17 +560,28 @@ static int resource_create_list(struct blk_desc *dev_desc, int rsce_base)
 		goto err;
 	}
 
+	/* The name index is only an accelerator, go on without it if bad */
+	if (resource_has_index(hdr)) {
+		blknum = DIV_ROUND_UP(hdr->i_nums * sizeof(*index),
+				      dev_desc->blksz);
+		index = memalign(ARCH_DMA_MINALIGN, blknum * dev_desc->blksz);
+		if (index && blk_dread(dev_desc, rsce_base + hdr->i_offset,
+				       blknum, index) != blknum) {
+			free(index);
+			index = NULL;
+		}
+	}
+
 	/*
 	 * Add all file into resource file list, and load what we want from
 	 * storage when we really need it.
 	 */
-	for (e_num = 0; e_num < hdr->e_nums; e_num++) {
-		size = e_num * hdr->e_blks * dev_desc->blksz;
-		entry = (struct resource_entry *)(data + size);
-		add_file_to_list(entry, rsce_base, false);
-	}
+	ret = add_entrys_to_list(hdr, data, index, dev_desc->blksz,
+				 rsce_base, false);
 
 err:
+	if (index)
+		free(index);
 	if (data)
 		free(data);
 	if (hdr)
@@ -520,21 +747,16 @@ static int init_resource_list(void)
 
 static struct resource_file *get_file_info(const char *name)
 {
-	struct resource_file *file;
-	struct list_head *node;
+	int pos;
 
 	if (list_empty(&entrys_head)) {
 		if (init_resource_list())
 			return NULL;
 	}
 
-	list_for_each(node, &entrys_head) {
-		file = list_entry(node, struct resource_file, link);
-		if (!strcmp(file->name, name))
-			return file;
-	}
+	pos = file_index_search(resource_name_hash(name), name);
 
-	return NULL;
+	return pos < 0 ? NULL : file_index[pos];
 }
 
 /*
@@ -584,6 +806,67 @@ int rockchip_read_resource_file(void *buf, const char *name,
 	return ret;
 }
 
+/*
+ * read file from resource partition and process it while it loads
+ * @name: file name
+ * @chunk: the size(by bytes) handed to @process at a time
+ * @process: called in order with each piece of the file, the pieces are
+ *	     contiguous in memory
+ * @priv: private data passed to @process
+ */
+int rockchip_read_resource_file_stream(const char *name, ulong chunk,
+				       int (*process)(void *priv, void *buf,
+						      ulong len),
+				       void *priv)
+{
+	struct resource_file *file;
+	struct blk_desc *dev_desc;
+	ulong src, off, len;
+	void *buf;
+	int ret = 0;
+
+	file = get_file_info(name);
+	if (!file) {
+		printf("No file: %s\n", name);
+		return -ENOENT;
+	}
+
+	dev_desc = rockchip_get_bootdev();
+	if (!dev_desc) {
+		printf("No dev_desc!\n");
+		return -ENODEV;
+	}
+
+	if (file->ram) {
+		src = file->rsce_base + file->f_offset * dev_desc->blksz;
+		for (off = 0; off < file->f_size && !ret; off += len) {
+			len = min_t(ulong, chunk, file->f_size - off);
+			ret = process(priv, (void *)(src + off), len);
+		}
+		return ret ? ret : file->f_size;
+	}
+
+	buf = memalign(ARCH_DMA_MINALIGN,
+		       ALIGN(file->f_size, dev_desc->blksz));
+	if (!buf)
+		return -ENOMEM;
+
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	ret = blk_dread_pipeline(dev_desc, file->rsce_base + file->f_offset,
+				 file->f_size, buf, chunk, process, priv);
+#else
+	len = DIV_ROUND_UP(file->f_size, dev_desc->blksz);
+	if (blk_dread(dev_desc, file->rsce_base + file->f_offset, len,
+		      buf) != len)
+		ret = -EIO;
+	else
+		ret = process(priv, buf, file->f_size);
+#endif
+	free(buf);
+
+	return ret ? ret : file->f_size;
+}
+
 #ifdef CONFIG_ROCKCHIP_HWID_DTB
 #define is_digit(c)		((c) >= '0' && (c) <= '9')
 #define is_abcd(c)		((c) >= 'a' && (c) <= 'd')
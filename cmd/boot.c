@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <console.h>
 #include <net.h>
 #include <asm/io.h>
 #include <asm/arch/boot_mode.h>
@@ -35,6 +36,8 @@ static int do_go(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	addr = simple_strtoul(argv[1], NULL, 16);
 
 	printf ("## Starting application at 0x%08lX ...\n", addr);
+	/* The application may never return to send buffered output */
+	console_async_stop();
 
 	/*
 	 * pass address parameter as argv[0] (aka command name),
@@ -13,14 +13,32 @@ int __weak soc_clk_dump(void)
 	return 1;
 }
 
+void __weak soc_clk_dump_timing(void)
+{
+}
+
 static int do_clk_dump(cmd_tbl_t *cmdtp, int flag, int argc,
 		       char *const argv[])
 {
-	return soc_clk_dump();
+	ulong start;
+	int ret;
+
+	if (argc < 2)
+		return soc_clk_dump();
+
+	if (strcmp(argv[1], "-t"))
+		return CMD_RET_USAGE;
+
+	start = timer_get_us();
+	ret = soc_clk_dump();
+	printf("Dump took %lu us\n", timer_get_us() - start);
+	soc_clk_dump_timing();
+
+	return ret;
 }
 
 static cmd_tbl_t cmd_clk_sub[] = {
-	U_BOOT_CMD_MKENT(dump, 1, 1, do_clk_dump, "", ""),
+	U_BOOT_CMD_MKENT(dump, 2, 1, do_clk_dump, "", ""),
 };
 
 static int do_clk(cmd_tbl_t *cmdtp, int flag, int argc,
@@ -45,7 +63,8 @@ static int do_clk(cmd_tbl_t *cmdtp, int flag, int argc,
 
 #ifdef CONFIG_SYS_LONGHELP
 static char clk_help_text[] =
-	"dump - Print clock frequencies";
+	"dump [-t] - Print clock frequencies\n"
+	"    -t: also show the time taken and the clock setup timing";
 #endif
 
-U_BOOT_CMD(clk, 2, 1, do_clk, "CLK sub-system", clk_help_text);
+U_BOOT_CMD(clk, 3, 1, do_clk, "CLK sub-system", clk_help_text);
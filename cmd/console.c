@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <console.h>
 #include <stdio_dev.h>
 
 extern void _do_coninfo (void);
@@ -51,3 +52,26 @@ U_BOOT_CMD(
 	"print console devices and information",
 	""
 );
+
+#if CONFIG_IS_ENABLED(CONSOLE_ASYNC)
+static int do_console(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char * const argv[])
+{
+	if (argc < 2 || strcmp(argv[1], "stats"))
+		return CMD_RET_USAGE;
+
+	if (argc == 3 && !strcmp(argv[2], "reset")) {
+		console_async_reset_stats();
+		return 0;
+	}
+	console_async_print_stats();
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	console,	3,	1,	do_console,
+	"console output buffer",
+	"stats [reset] - show or clear serial output buffer statistics"
+);
+#endif
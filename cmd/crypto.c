@@ -8,6 +8,7 @@
 #include <crypto.h>
 #include <dm.h>
 #include <u-boot/md5.h>
+#include <u-boot/rsa-mod-exp.h>
 #include <u-boot/sha1.h>
 #include <u-boot/sha256.h>
 #include <u-boot/sha512.h>
@@ -18,6 +19,8 @@
 
 #define CALC_RATE_MPBS(bytes, ms)	(((bytes) / 1024) / (ms))
 
+#define RSA_BENCH_LOOPS			10
+
 struct hash_test_data {
 	const char	*algo_name;
 	const char	*mode_name;
@@ -152,6 +155,15 @@ struct rsa_test_data {
 	.sign_out_len = sizeof(out) \
 }
 
+#define RSA_BENCH(nbits) { \
+	.n_bits = (nbits), \
+	.n      = rsa##nbits##_bench_n, \
+	.rr     = rsa##nbits##_bench_rr, \
+	.n0inv  = RSA##nbits##_BENCH_N0INV, \
+	.sign   = rsa##nbits##_bench_sign, \
+	.msg    = rsa##nbits##_bench_msg, \
+}
+
 #define EMPTY_TEST() {}
 
 const struct hash_test_data hash_data_set[] = {
@@ -236,6 +248,20 @@ const struct rsa_test_data rsa_data_set[] = {
 #endif
 };
 
+struct rsa_bench_data {
+	u32		n_bits;
+	const u8	*n;
+	const u8	*rr;
+	u32		n0inv;
+	const u8	*sign;
+	const u8	*msg;
+};
+
+static const struct rsa_bench_data rsa_bench_set[] = {
+	RSA_BENCH(2048),
+	RSA_BENCH(4096),
+};
+
 static void dump_hex(const char *name, const u8 *array, u32 len)
 {
 	int i;
@@ -654,6 +680,100 @@ error:
 	return ret;
 }
 
+static int rsa_bench_sw(const struct rsa_bench_data *data,
+			const u8 *e, u8 *out)
+{
+#ifdef CONFIG_RSA_SOFTWARE_EXP
+	struct key_prop prop;
+
+	memset(&prop, 0x00, sizeof(prop));
+	prop.num_bits = data->n_bits;
+	prop.n0inv = data->n0inv;
+	prop.modulus = data->n;
+	prop.rr = data->rr;
+
+	/* NULL public_exponent means 65537 */
+	return rsa_mod_exp_sw(data->sign, BITS2BYTE(data->n_bits), &prop, out);
+#else
+	return -ENOSYS;
+#endif
+}
+
+static int rsa_bench_hw(const struct rsa_bench_data *data,
+			const u8 *e, u8 *out)
+{
+	return crypto_rsa_verify_be(data->n_bits, data->n, e, NULL,
+				    data->sign, out);
+}
+
+static void rsa_bench_one(const struct rsa_bench_data *data, const char *name,
+			  int (*verify)(const struct rsa_bench_data *data,
+					const u8 *e, u8 *out),
+			  const u8 *e, u8 *out, int loops)
+{
+	ulong start, time_cost;
+	int ret, i;
+
+	memset(out, 0x00, BITS2BYTE(data->n_bits));
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		ret = verify(data, e, out);
+		if (ret) {
+			printf("[RSA] %-8u%-8s unsupported (%d)\n",
+			       data->n_bits, name, ret);
+			return;
+		}
+	}
+	time_cost = (timer_get_us() - start) / loops;
+
+	if (memcmp(data->msg, out, BITS2BYTE(data->n_bits)) == 0) {
+		printf("[RSA] %-8u%-8s PASS    (%luus)\n",
+		       data->n_bits, name, time_cost);
+	} else {
+		printf("[RSA] %-8u%-8s FAIL\n", data->n_bits, name);
+		dump_hex("expect", data->msg, BITS2BYTE(data->n_bits));
+		dump_hex("actual", out, BITS2BYTE(data->n_bits));
+	}
+}
+
+/* Verify latency of software and crypto device with the same keys */
+static int test_rsa_bench(int loops)
+{
+	u32 data_size = 4096 / 8;
+	u8 *out, *e;
+	int i;
+
+	out = (u8 *)memalign(CONFIG_SYS_CACHELINE_SIZE, data_size);
+	e = (u8 *)calloc(1, data_size);
+	if (!out || !e) {
+		printf("%s, %d: alloc %u error!\n",
+		       __func__, __LINE__, data_size);
+		free(out);
+		free(e);
+		return -ENOMEM;
+	}
+
+	printf("\n================== rsa verify bench ====================\n");
+	for (i = 0; i < ARRAY_SIZE(rsa_bench_set); i++) {
+		const struct rsa_bench_data *data = &rsa_bench_set[i];
+		u32 len = BITS2BYTE(data->n_bits);
+
+		/* E = 65537, big-endian */
+		memset(e, 0x00, data_size);
+		e[len - 3] = 0x01;
+		e[len - 1] = 0x01;
+
+		rsa_bench_one(data, "sw", rsa_bench_sw, e, out, loops);
+		rsa_bench_one(data, "hw", rsa_bench_hw, e, out, loops);
+	}
+
+	free(out);
+	free(e);
+
+	return 0;
+}
+
 static int test_all_result(void)
 {
 	int ret = 0;
@@ -676,11 +796,27 @@ exit:
 
 static int do_crypto(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
-	return test_all_result();
+	int loops = RSA_BENCH_LOOPS;
+
+	if (argc == 1)
+		return test_all_result();
+
+	if (strcmp(argv[1], "rsa-bench"))
+		return CMD_RET_USAGE;
+
+	if (argc > 2)
+		loops = simple_strtoul(argv[2], NULL, 10);
+	if (loops <= 0)
+		return CMD_RET_USAGE;
+
+	return test_rsa_bench(loops) ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
 }
 
 U_BOOT_CMD(
-	crypto, 1, 1, do_crypto,
+	crypto, 3, 1, do_crypto,
 	"crypto test",
-	""
+	"\n"
+	"    - run all the crypto tests\n"
+	"crypto rsa-bench [loops]\n"
+	"    - compare software and hardware rsa verify latency"
 );
@@ -7,6 +7,7 @@
 #include <common.h>
 #include <command.h>
 #include <console.h>
+#include <div64.h>
 #include <mmc.h>
 #include <optee_include/OpteeClientInterface.h>
 #include <optee_include/OpteeClientApiLib.h>
@@ -450,6 +451,57 @@ static int do_mmc_read(cmd_tbl_t *cmdtp, int flag,
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
+
+#define MMC_BENCH_LOOPS		1
+
+static int do_mmc_bench(cmd_tbl_t *cmdtp, int flag,
+			int argc, char * const argv[])
+{
+	struct mmc *mmc;
+	u32 blk, cnt, loops = MMC_BENCH_LOOPS, i, n;
+	unsigned long start, us;
+	u64 bytes;
+	void *addr;
+
+	if (argc < 4)
+		return CMD_RET_USAGE;
+
+	addr = (void *)simple_strtoul(argv[1], NULL, 16);
+	blk = simple_strtoul(argv[2], NULL, 16);
+	cnt = simple_strtoul(argv[3], NULL, 16);
+	if (argc > 4)
+		loops = simple_strtoul(argv[4], NULL, 10);
+	if (!cnt || !loops)
+		return CMD_RET_USAGE;
+
+	mmc = init_mmc_device(curr_device, false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+
+	printf("\nMMC bench: dev # %d, block # %d, count %d, loops %d ... ",
+	       curr_device, blk, cnt, loops);
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		n = blk_dread(mmc_get_blk_desc(mmc), blk, cnt, addr);
+		if (n != cnt) {
+			printf("%d blocks read: ERROR\n", n);
+			return CMD_RET_FAILURE;
+		}
+	}
+	us = max(timer_get_us() - start, 1UL);
+
+	/* Bytes per microsecond is MB/s */
+	bytes = (u64)cnt * mmc->read_bl_len * loops;
+	printf("OK\n");
+	print_size(bytes, " read in ");
+	printf("%lu us, %llu.%02llu MB/s\n", us,
+	       (unsigned long long)lldiv(bytes, us),
+	       (unsigned long long)lldiv(bytes * 100, us) % 100);
+
+	return CMD_RET_SUCCESS;
+}
+
 static int do_mmc_write(cmd_tbl_t *cmdtp, int flag,
 			int argc, char * const argv[])
 {
@@ -939,6 +991,7 @@ static cmd_tbl_t cmd_mmc[] = {
 	U_BOOT_CMD_MKENT(info, 1, 0, do_mmcinfo, "", ""),
 	U_BOOT_CMD_MKENT(read, 4, 1, do_mmc_read, "", ""),
 	U_BOOT_CMD_MKENT(write, 4, 0, do_mmc_write, "", ""),
+	U_BOOT_CMD_MKENT(bench, 5, 0, do_mmc_bench, "", ""),
 	U_BOOT_CMD_MKENT(erase, 3, 0, do_mmc_erase, "", ""),
 	U_BOOT_CMD_MKENT(rescan, 1, 1, do_mmc_rescan, "", ""),
 	U_BOOT_CMD_MKENT(part, 1, 1, do_mmc_part, "", ""),
@@ -996,6 +1049,7 @@ U_BOOT_CMD(
 	"info - display info of the current MMC device\n"
 	"mmc read addr blk# cnt\n"
 	"mmc write addr blk# cnt\n"
+	"mmc bench addr blk# cnt [loops] - read throughput in MB/s\n"
 	"mmc erase blk# cnt\n"
 	"mmc rescan\n"
 	"mmc part - lists available partition on current mmc device\n"
@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <dm.h>
 #include <net.h>
 #include <boot_rkimg.h>
 
@@ -555,3 +556,67 @@ U_BOOT_CMD(
 );
 
 #endif  /* CONFIG_CMD_LINK_LOCAL */
+
+#if defined(CONFIG_CMD_ETH_STATS)
+static int do_eth(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct eth_stats stats;
+	struct udevice *dev;
+	bool reset = false;
+	int ret;
+
+	if (argc < 2 || strcmp(argv[1], "stats"))
+		return CMD_RET_USAGE;
+	argc -= 2;
+	argv += 2;
+
+	if (argc && !strcmp(argv[0], "reset")) {
+		reset = true;
+		argc--;
+		argv++;
+	}
+
+	if (argc > 1)
+		return CMD_RET_USAGE;
+
+	if (argc)
+		dev = eth_get_dev_by_name(argv[0]);
+	else
+		dev = eth_get_dev();
+	if (!dev) {
+		printf("No ethernet device found\n");
+		return CMD_RET_FAILURE;
+	}
+
+	if (reset)
+		ret = eth_reset_stats(dev);
+	else
+		ret = eth_get_stats(dev, &stats);
+	if (ret) {
+		printf("%s: cannot read counters (err=%d)\n", dev->name, ret);
+		return CMD_RET_FAILURE;
+	}
+
+	if (reset)
+		return CMD_RET_SUCCESS;
+
+	printf("%s:\n", dev->name);
+	printf("  RX packets %llu  bytes %llu  max batch %u\n",
+	       stats.rx_packets, stats.rx_bytes, stats.rx_batch_max);
+	printf("  RX errors %u  dropped %u  overruns %u\n",
+	       stats.rx_errors, stats.rx_dropped, stats.rx_overruns);
+	printf("  TX packets %llu  bytes %llu\n",
+	       stats.tx_packets, stats.tx_bytes);
+	printf("  TX errors %u  dropped %u\n",
+	       stats.tx_errors, stats.tx_dropped);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	eth,	4,	1,	do_eth,
+	"Ethernet device counters",
+	"stats [dev] - show receive/transmit counters of 'dev' or the current device\n"
+	"eth stats reset [dev] - clear the counters"
+);
+#endif  /* CONFIG_CMD_ETH_STATS */
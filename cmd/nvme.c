@@ -38,6 +38,24 @@ static int do_nvme(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		}
 	}
 
+	if ((argc == 2 || argc == 3) && !strcmp(argv[1], "stats")) {
+		struct udevice *udev;
+
+		if (argc == 3 && strcmp(argv[2], "reset"))
+			return CMD_RET_USAGE;
+
+		ret = blk_get_device(IF_TYPE_NVME, nvme_curr_dev, &udev);
+		if (ret < 0)
+			return CMD_RET_FAILURE;
+
+		if (argc == 3)
+			nvme_reset_stats(udev);
+		else
+			nvme_print_stats(udev);
+
+		return 0;
+	}
+
 	return blk_common_cmd(argc, argv, IF_TYPE_NVME, &nvme_curr_dev);
 }
 
@@ -46,6 +64,8 @@ U_BOOT_CMD(
 	"NVM Express sub-system",
 	"scan - scan NVMe devices\n"
 	"nvme detail - show details of current NVMe device\n"
+	"nvme stats [reset] - show or clear I/O statistics of current NVMe\n"
+	"     controller\n"
 	"nvme info - show all available NVMe devices\n"
 	"nvme device [dev] - show or set current NVMe device\n"
 	"nvme part [dev] - print partition table of one or all NVMe devices\n"
@@ -177,12 +177,42 @@ static int do_write(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	return CMD_RET_SUCCESS;
 }
 
+static int do_stats(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct pmic_stats stats;
+	ulong saved;
+	int ret;
+
+	if (!currdev) {
+		printf("First, set the PMIC device!\n");
+		return CMD_RET_USAGE;
+	}
+
+	ret = pmic_get_stats(currdev, &stats);
+	if (ret) {
+		printf("No statistics for PMIC: %s!\n", currdev->name);
+		return failure(ret);
+	}
+
+	saved = stats.read_hits + stats.write_skips + stats.write_merges;
+	printf("Bus reads:       %lu\n", stats.reads);
+	printf("Bus writes:      %lu\n", stats.writes);
+	printf("Cached reads:    %lu\n", stats.read_hits);
+	printf("Skipped writes:  %lu\n", stats.write_skips);
+	printf("Merged writes:   %lu\n", stats.write_merges);
+	printf("Transfers saved: %lu of %lu\n", saved,
+	       saved + stats.reads + stats.writes);
+
+	return CMD_RET_SUCCESS;
+}
+
 static cmd_tbl_t subcmd[] = {
 	U_BOOT_CMD_MKENT(dev, 2, 1, do_dev, "", ""),
 	U_BOOT_CMD_MKENT(list, 1, 1, do_list, "", ""),
 	U_BOOT_CMD_MKENT(dump, 1, 1, do_dump, "", ""),
 	U_BOOT_CMD_MKENT(read, 2, 1, do_read, "", ""),
 	U_BOOT_CMD_MKENT(write, 3, 1, do_write, "", ""),
+	U_BOOT_CMD_MKENT(stats, 1, 1, do_stats, "", ""),
 };
 
 static int do_pmic(cmd_tbl_t *cmdtp, int flag, int argc,
@@ -207,4 +237,5 @@ U_BOOT_CMD(pmic, CONFIG_SYS_MAXARGS, 1, do_pmic,
 	"pmic dump          - dump registers\n"
 	"pmic read address  - read byte of register at address\n"
 	"pmic write address - write byte to register at address\n"
+	"pmic stats         - show bus transfers and those saved by caching\n"
 );
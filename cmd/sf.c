@@ -15,6 +15,7 @@
 #include <spi_flash.h>
 #include <jffs2/jffs2.h>
 #include <linux/mtd/mtd.h>
+#include <linux/sizes.h>
 
 #include <asm/io.h>
 #include <dm/device-internal.h>
@@ -554,6 +555,95 @@ static int do_spi_flash_test(int argc, char * const argv[])
 
 	return 0;
 }
+
+/* Read patterns timed by 'sf bench', each favours a different read path */
+static const struct {
+	const char *name;
+	ulong chunk;		/* size of each read, 0 for one read */
+	ulong skew;		/* offset of the buffer from an aligned one */
+} bench_mode[] = {
+	{ "aligned", 0, 0 },
+	{ "unaligned", 0, 1 },
+	{ "4 KiB reads", SZ_4K, 0 },
+	{ "64 B reads", 64, 0 },
+};
+
+/**
+ * Time reads of the same area of SPI flash in different ways and check
+ * that they all return the same data
+ *
+ * @param flash		SPI flash to use
+ * @param offset	Offset within flash to read
+ * @param len		Size of data to read
+ * @param ref		Buffer for the first read
+ * @param vbuf		Buffer for the other reads, len + ARCH_DMA_MINALIGN
+ * @return 0 if ok, -1 on error
+ */
+static int spi_flash_bench(struct spi_flash *flash, ulong offset, ulong len,
+			   uint8_t *ref, uint8_t *vbuf)
+{
+	ulong start, chunk, pos;
+	uint8_t *buf;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bench_mode); i++) {
+		buf = i ? vbuf + bench_mode[i].skew : ref;
+		chunk = bench_mode[i].chunk ? bench_mode[i].chunk : len;
+
+		start = get_timer(0);
+		for (pos = 0; pos < len; pos += chunk) {
+			if (spi_flash_read(flash, offset + pos,
+					   min(chunk, len - pos), buf + pos)) {
+				printf("%s: Read failed at %lx\n",
+				       bench_mode[i].name, offset + pos);
+				return -1;
+			}
+		}
+		printf("%-12s %6lu ms, %lu bytes/s\n", bench_mode[i].name,
+		       get_timer(start), bytes_per_second(len, start));
+
+		if (i && memcmp(ref, buf, len)) {
+			printf("%s: Data differs from the first read\n",
+			       bench_mode[i].name);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int do_spi_flash_bench(int argc, char * const argv[])
+{
+	unsigned long offset;
+	unsigned long len;
+	uint8_t *ref, *vbuf;
+	char *endp;
+	int ret;
+
+	if (argc < 3)
+		return -1;
+	offset = simple_strtoul(argv[1], &endp, 16);
+	if (*argv[1] == 0 || *endp != 0)
+		return -1;
+	len = simple_strtoul(argv[2], &endp, 16);
+	if (*argv[2] == 0 || *endp != 0 || !len)
+		return -1;
+
+	ref = memalign(ARCH_DMA_MINALIGN, len);
+	vbuf = memalign(ARCH_DMA_MINALIGN, len + ARCH_DMA_MINALIGN);
+	if (!ref || !vbuf) {
+		free(ref);
+		free(vbuf);
+		printf("Cannot allocate memory (%lu bytes)\n", len);
+		return 1;
+	}
+
+	ret = spi_flash_bench(flash, offset, len, ref, vbuf);
+	free(vbuf);
+	free(ref);
+
+	return ret ? 1 : 0;
+}
 #endif /* CONFIG_CMD_SF_TEST */
 
 static int do_spi_flash(cmd_tbl_t *cmdtp, int flag, int argc,
@@ -591,6 +681,8 @@ static int do_spi_flash(cmd_tbl_t *cmdtp, int flag, int argc,
 #ifdef CONFIG_CMD_SF_TEST
 	else if (!strcmp(cmd, "test"))
 		ret = do_spi_flash_test(argc, argv);
+	else if (!strcmp(cmd, "bench"))
+		ret = do_spi_flash_bench(argc, argv);
 #endif
 	else
 		ret = -1;
@@ -605,7 +697,9 @@ usage:
 
 #ifdef CONFIG_CMD_SF_TEST
 #define SF_TEST_HELP "\nsf test offset len		" \
-		"- run a very basic destructive test"
+		"- run a very basic destructive test" \
+	"\nsf bench offset len		" \
+		"- time reads of `len' bytes at `offset'"
 #else
 #define SF_TEST_HELP
 #endif
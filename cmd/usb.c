@@ -16,6 +16,7 @@
 #include <console.h>
 #include <dm.h>
 #include <dm/uclass-internal.h>
+#include <div64.h>
 #include <memalign.h>
 #include <asm/byteorder.h>
 #include <asm/unaligned.h>
@@ -629,6 +630,59 @@ static void usb_show_info(struct usb_device *udev)
 }
 #endif
 
+#ifdef CONFIG_USB_STORAGE
+#define USB_BENCH_LOOPS		1
+
+static int do_usb_bench(int argc, char * const argv[])
+{
+	struct blk_desc *desc;
+	ulong blk, cnt, loops = USB_BENCH_LOOPS, i, n;
+	unsigned long start, us;
+	u64 bytes;
+	void *addr;
+
+	if (argc < 5)
+		return CMD_RET_USAGE;
+
+	addr = (void *)simple_strtoul(argv[2], NULL, 16);
+	blk = simple_strtoul(argv[3], NULL, 16);
+	cnt = simple_strtoul(argv[4], NULL, 16);
+	if (argc > 5)
+		loops = simple_strtoul(argv[5], NULL, 10);
+	if (!cnt || !loops)
+		return CMD_RET_USAGE;
+
+	desc = blk_get_devnum_by_type(IF_TYPE_USB, usb_stor_curr_dev);
+	if (!desc) {
+		printf("no current device selected\n");
+		return CMD_RET_FAILURE;
+	}
+
+	printf("\nUSB bench: device %d block # %ld, count %ld, loops %ld ... ",
+	       usb_stor_curr_dev, blk, cnt, loops);
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		n = blk_dread(desc, blk, cnt, addr);
+		if (n != cnt) {
+			printf("%ld blocks read: ERROR\n", n);
+			return CMD_RET_FAILURE;
+		}
+	}
+	us = max(timer_get_us() - start, 1UL);
+
+	/* Bytes per microsecond is MB/s */
+	bytes = (u64)cnt * desc->blksz * loops;
+	printf("OK\n");
+	print_size(bytes, " read in ");
+	printf("%lu us, %llu.%02llu MB/s\n", us,
+	       (unsigned long long)lldiv(bytes, us),
+	       (unsigned long long)lldiv(bytes * 100, us) % 100);
+
+	return CMD_RET_SUCCESS;
+}
+#endif
+
 /******************************************************************************
  * usb command intepreter
  */
@@ -725,6 +779,9 @@ static int do_usb(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	if (strncmp(argv[1], "stor", 4) == 0)
 		return usb_stor_info();
 
+	if (strncmp(argv[1], "bench", 5) == 0)
+		return do_usb_bench(argc, argv);
+
 	return blk_common_cmd(argc, argv, IF_TYPE_USB, &usb_stor_curr_dev);
 #else
 	return CMD_RET_USAGE;
@@ -732,7 +789,7 @@ static int do_usb(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 }
 
 U_BOOT_CMD(
-	usb,	5,	1,	do_usb,
+	usb,	6,	1,	do_usb,
 	"USB sub-system",
 	"start - start (scan) USB controller\n"
 	"usb reset - reset (rescan) USB controller\n"
@@ -750,7 +807,8 @@ U_BOOT_CMD(
 	"usb read addr blk# cnt - read `cnt' blocks starting at block `blk#'\n"
 	"    to memory address `addr'\n"
 	"usb write addr blk# cnt - write `cnt' blocks starting at block `blk#'\n"
-	"    from memory address `addr'"
+	"    from memory address `addr'\n"
+	"usb bench addr blk# cnt [loops] - read throughput in MB/s"
 #endif /* CONFIG_USB_STORAGE */
 );
 
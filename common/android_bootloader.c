@@ -777,6 +777,9 @@ out1:
 
 int android_fdt_overlay_apply(void *fdt_addr)
 {
+#ifdef CONFIG_OF_LIBFDT_OVERLAY_INDEX
+	struct fdt_overlay_index *idx;
+#endif
 	struct andr_img_hdr *hdr;
 	struct blk_desc *dev_desc;
 	const char *part_boot = PART_BOOT;
@@ -860,6 +863,13 @@ int android_fdt_overlay_apply(void *fdt_addr)
 
 		memcpy(fdt_backup, fdt_addr, totalsize);
 		fdt_increase_size(fdt_addr, fdt_totalsize((void *)fdt_dtbo));
+#ifdef CONFIG_OF_LIBFDT_OVERLAY_INDEX
+		if (!fdt_overlay_index_create(fdt_addr, &idx)) {
+			ret = fdt_overlay_apply_index(fdt_addr,
+						      (void *)fdt_dtbo, idx);
+			fdt_overlay_index_free(idx);
+		} else
+#endif
 		ret = fdt_overlay_apply(fdt_addr, (void *)fdt_dtbo);
 		if (!ret) {
 			snprintf(buf, 32, "%s%d", "androidboot.dtbo_idx=", index);
@@ -84,6 +84,7 @@
 #include <cli.h>
 #include <cli_hush.h>
 #include <command.h>        /* find_cmd */
+#include <environment.h>    /* env_htab */
 #ifndef CONFIG_SYS_PROMPT_HUSH_PS2
 #define CONFIG_SYS_PROMPT_HUSH_PS2	"> "
 #endif
@@ -308,6 +309,9 @@ struct variables *top_vars = &shell_ver;
 static int flag_repeat = 0;
 static int do_repeat = 0;
 static struct variables *top_vars = NULL ;
+#ifdef CONFIG_HUSH_SCRIPT_CACHE
+static unsigned int local_var_gen;	/* bumped on any hush variable change */
+#endif
 #endif /*__U_BOOT__ */
 
 #define B_CHUNK (100)
@@ -479,7 +483,9 @@ static int parse_string(o_string *dest, struct p_context *ctx, const char *src);
 #endif
 static int parse_stream(o_string *dest, struct p_context *ctx, struct in_str *input0, int end_trigger);
 /*   setup: */
-static int parse_stream_outer(struct in_str *inp, int flag);
+struct hush_script;
+static int parse_stream_outer(struct in_str *inp, int flag,
+			      struct hush_script *rec);
 #ifndef __U_BOOT__
 static int parse_string_outer(const char *s, int flag);
 static int parse_file_outer(FILE *f);
@@ -1589,6 +1595,9 @@ static int run_pipe_real(struct pipe *pi)
 #endif
 		return rcode;
 	} else if (pi->num_progs == 1 && pi->progs[0].argv != NULL) {
+		/* Counted here, the parsed command may be run again */
+		int sp = child->sp;
+
 		for (i=0; is_assignment(child->argv[i]); i++) { /* nothing */ }
 		if (i!=0 && child->argv[i]==NULL) {
 			/* assignments, but no command: set the local environment */
@@ -1627,11 +1636,11 @@ static int run_pipe_real(struct pipe *pi)
 			set_local_var(p, 0);
 #endif
 			if (p != child->argv[i]) {
-				child->sp--;
+				sp--;
 				free(p);
 			}
 		}
-		if (child->sp) {
+		if (sp) {
 			char * str = NULL;
 
 			str = make_string(child->argv + i,
@@ -1803,7 +1812,8 @@ static int run_list_real(struct pipe *pi)
 				/* check Ctrl-C */
 				ctrlc();
 				if ((had_ctrlc())) {
-					return 1;
+					rcode = 1;
+					break;
 				}
 #endif
 				flag_restore = 0;
@@ -1903,7 +1913,8 @@ static int run_list_real(struct pipe *pi)
 #else
 		if (rcode < -1) {
 			last_return_code = -rcode - 2;
-			return -2;	/* exit */
+			rcode = -2;	/* exit */
+			break;
 		}
 		last_return_code=(rcode == 0) ? 0 : 1;
 #endif
@@ -1923,6 +1934,16 @@ static int run_list_real(struct pipe *pi)
 		checkjobs(NULL);
 #endif
 	}
+#ifdef __U_BOOT__
+	/* Left a "for" loop early: give its variable name back */
+	if (list) {
+		while (*list)
+			free(*list++);
+		free(save_list);
+		free(rpipe->progs->argv[0]);
+		rpipe->progs->argv[0] = save_name;
+	}
+#endif
 	return rcode;
 }
 
@@ -2233,6 +2254,9 @@ int set_local_var(const char *s, int flg_export)
 		}
 	}
 
+#ifdef CONFIG_HUSH_SCRIPT_CACHE
+	local_var_gen++;
+#endif
 #ifndef __U_BOOT__
 	if(result==0 && cur->flg_export==1) {
 		*(value-1) = '=';
@@ -2272,6 +2296,9 @@ void unset_local_var(const char *name)
 				while (next->next != cur)
 					next = next->next;
 				next->next = cur->next;
+#ifdef CONFIG_HUSH_SCRIPT_CACHE
+				local_var_gen++;
+#endif
 			}
 			free(cur);
 		}
@@ -2764,6 +2791,249 @@ static int parse_group(o_string *dest, struct p_context *ctx,
 }
 #endif
 
+#ifdef CONFIG_HUSH_SCRIPT_CACHE
+/*
+ * Parsed scripts, keyed by their text and parse flags. A script holds the
+ * lists parsed by the successive passes of parse_stream_outer() over its
+ * text, which are run again in the same order when the same text comes
+ * back. It is only kept if all of its text was parsed, i.e. without a
+ * syntax error or an "exit" on the way. Running a "for" loop changes its
+ * list for the time of the loop, so a script is not shared with a nested
+ * run of the same text, which parses its own copy instead.
+ */
+#define HUSH_CACHE_SCRIPTS	16
+#define HUSH_CACHE_VARS		32
+#define HUSH_CACHE_VAR_LEN	32
+
+struct hush_script {
+	char *text;
+	u32 hash;
+	int flag;
+	struct pipe **lists;
+	int count;
+	int busy;
+	bool failed;
+	ulong used;		/* stamp of the last run, for eviction */
+};
+
+static struct hush_script *script_cache[HUSH_CACHE_SCRIPTS];
+static ulong script_stamp;
+
+/*
+ * Variable lookups, valid while neither the environment nor the hush
+ * variables have changed since
+ */
+static struct {
+	char name[HUSH_CACHE_VAR_LEN];
+	char *value;
+	unsigned int env_gen;
+	unsigned int local_gen;
+} var_cache[HUSH_CACHE_VARS];
+
+static u32 hush_hash(const char *s)
+{
+	u32 hash = 0x811c9dc5;
+
+	while (*s)
+		hash = (hash ^ (u8)*s++) * 0x01000193;
+
+	return hash;
+}
+
+static char *lookup_var(const char *name)
+{
+	int idx = hush_hash(name) % HUSH_CACHE_VARS;
+	char *p;
+
+	/* Before relocation env_get() returns a buffer, $? changes anyway */
+	if (!(gd->flags & GD_FLG_ENV_READY) || !isalpha(*name) ||
+	    strlen(name) >= HUSH_CACHE_VAR_LEN) {
+		p = env_get(name);
+		return p ? p : get_local_var(name);
+	}
+
+	if (var_cache[idx].env_gen == env_htab.gen &&
+	    var_cache[idx].local_gen == local_var_gen &&
+	    !strcmp(var_cache[idx].name, name))
+		return var_cache[idx].value;
+
+	p = env_get(name);
+	if (!p)
+		p = get_local_var(name);
+	strcpy(var_cache[idx].name, name);
+	var_cache[idx].value = p;
+	var_cache[idx].env_gen = env_htab.gen;
+	var_cache[idx].local_gen = local_var_gen;
+
+	return p;
+}
+
+static void script_free(struct hush_script *sc)
+{
+	int i;
+
+	for (i = 0; i < sc->count; i++)
+		free_pipe_list(sc->lists[i], 0);
+	free(sc->lists);
+	free(sc->text);
+	free(sc);
+}
+
+/*
+ * Returns the parsed script for @s, or NULL with @recp set to a script to
+ * record while @s is parsed and run, if it can be cached
+ */
+static struct hush_script *script_lookup(const char *s, int flag,
+					 struct hush_script **recp)
+{
+	struct hush_script *sc;
+	u32 hash;
+	int i;
+
+	*recp = NULL;
+	/* Reparsed commands hold expanded values, IFS changes the parse */
+	if ((flag & FLAG_REPARSING) || env_get("IFS"))
+		return NULL;
+
+	hash = hush_hash(s);
+	for (i = 0; i < HUSH_CACHE_SCRIPTS; i++) {
+		sc = script_cache[i];
+		if (sc && sc->hash == hash && sc->flag == flag &&
+		    !strcmp(sc->text, s))
+			return sc->busy ? NULL : sc;
+	}
+
+	sc = calloc(1, sizeof(*sc));
+	if (!sc)
+		return NULL;
+	sc->text = strdup(s);
+	if (!sc->text) {
+		free(sc);
+		return NULL;
+	}
+	sc->hash = hash;
+	sc->flag = flag;
+	*recp = sc;
+
+	return NULL;
+}
+
+/* Keeps @list, parsed and run, in the script being recorded */
+static void script_add(struct hush_script *rec, struct pipe *list)
+{
+	struct pipe **lists;
+
+	lists = realloc(rec->lists, (rec->count + 1) * sizeof(*lists));
+	if (!lists) {
+		free_pipe_list(list, 0);
+		rec->failed = true;
+		return;
+	}
+	lists[rec->count++] = list;
+	rec->lists = lists;
+}
+
+static void script_fail(struct hush_script *rec)
+{
+	if (rec)
+		rec->failed = true;
+}
+
+/* Puts a recorded script in the cache, in place of the least recently run */
+static void script_finish(struct hush_script *rec)
+{
+	struct hush_script **slot = NULL;
+	int i;
+
+	if (!rec)
+		return;
+	if (rec->failed) {
+		script_free(rec);
+		return;
+	}
+
+	for (i = 0; i < HUSH_CACHE_SCRIPTS; i++) {
+		struct hush_script *sc = script_cache[i];
+
+		if (!sc) {
+			slot = &script_cache[i];
+			break;
+		}
+		/* A nested run of the same text got there first */
+		if (sc->hash == rec->hash && sc->flag == rec->flag &&
+		    !strcmp(sc->text, rec->text)) {
+			script_free(rec);
+			return;
+		}
+		if (!sc->busy && (!slot || sc->used < (*slot)->used))
+			slot = &script_cache[i];
+	}
+	/* All of them are running */
+	if (!slot) {
+		script_free(rec);
+		return;
+	}
+
+	if (*slot)
+		script_free(*slot);
+	rec->used = ++script_stamp;
+	*slot = rec;
+}
+
+/* Same as parse_stream_outer() on the text of @sc, without the parsing */
+static int script_run(struct hush_script *sc)
+{
+	int code = 1;
+	int i;
+
+	sc->busy++;
+	sc->used = ++script_stamp;
+	for (i = 0; i < sc->count; i++) {
+		code = run_list_real(sc->lists[i]);
+		if (code == -2) {	/* exit */
+			code = 0;
+			break;
+		}
+		if (code == -1)
+			flag_repeat = 0;
+	}
+	sc->busy--;
+
+	return (code != 0) ? 1 : 0;
+}
+#else
+static char *lookup_var(const char *name)
+{
+	char *p = env_get(name);
+
+	return p ? p : get_local_var(name);
+}
+
+static inline struct hush_script *script_lookup(const char *s, int flag,
+						struct hush_script **recp)
+{
+	*recp = NULL;
+	return NULL;
+}
+
+static inline void script_add(struct hush_script *rec, struct pipe *list)
+{
+}
+
+static inline void script_fail(struct hush_script *rec)
+{
+}
+
+static inline void script_finish(struct hush_script *rec)
+{
+}
+
+static inline int script_run(struct hush_script *sc)
+{
+	return 0;
+}
+#endif
+
 /* basically useful version until someone wants to get fancier,
  * see the bash man page under "Parameter Expansion" */
 static char *lookup_param(char *src)
@@ -2793,9 +3063,7 @@ static char *lookup_param(char *src)
 		}
 	}
 
-	p = env_get(src);
-	if (!p)
-		p = get_local_var(src);
+	p = lookup_var(src);
 
 	if (!p || strlen(p) == 0) {
 		p = default_val;
@@ -3182,7 +3450,12 @@ static void update_ifs_map(void)
 
 /* most recursion does not come through here, the exeception is
  * from builtin_source() */
-static int parse_stream_outer(struct in_str *inp, int flag)
+/*
+ * Parses and runs @inp one list at a time. If @rec is given, the lists are
+ * kept in it once run, see script_lookup().
+ */
+static int parse_stream_outer(struct in_str *inp, int flag,
+			      struct hush_script *rec)
 {
 
 	struct p_context ctx;
@@ -3197,9 +3470,16 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 		update_ifs_map();
 		if (!(flag & FLAG_PARSE_SEMICOLON) || (flag & FLAG_REPARSING)) mapset((uchar *)";$&|", 0);
 		inp->promptmode=1;
+#ifdef __U_BOOT__
+		/* Script text only, console input would count the typing */
+		if (inp->peek == static_peek)
+			bootstage_start(BOOTSTAGE_ID_ACCUM_HUSH, "hush_parse");
+#endif
 		rcode = parse_stream(&temp, &ctx, inp,
 				     flag & FLAG_CONT_ON_NEWLINE ? -1 : '\n');
 #ifdef __U_BOOT__
+		if (inp->peek == static_peek)
+			bootstage_accum(BOOTSTAGE_ID_ACCUM_HUSH);
 		if (rcode == 1) flag_repeat = 0;
 #endif
 		if (rcode != 1 && ctx.old_flag != 0) {
@@ -3214,8 +3494,14 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 #ifndef __U_BOOT__
 			run_list(ctx.list_head);
 #else
-			code = run_list(ctx.list_head);
+			if (rec) {
+				code = run_list_real(ctx.list_head);
+				script_add(rec, ctx.list_head);
+			} else {
+				code = run_list(ctx.list_head);
+			}
 			if (code == -2) {	/* exit */
+				script_fail(rec);
 				b_free(&temp);
 				code = 0;
 				/* XXX hackish way to not allow exit from main loop */
@@ -3241,6 +3527,9 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 			temp.quote = 0;
 			inp->p = NULL;
 			free_pipe_list(ctx.list_head,0);
+#ifdef __U_BOOT__
+			script_fail(rec);
+#endif
 		}
 		b_free(&temp);
 	/* loop on syntax errors, return on EOF */
@@ -3261,26 +3550,32 @@ int parse_string_outer(const char *s, int flag)
 {
 	struct in_str input;
 #ifdef __U_BOOT__
+	struct hush_script *sc, *rec;
 	char *p = NULL;
 	int rcode;
 	if (!s)
 		return 1;
 	if (!*s)
 		return 0;
+	sc = script_lookup(s, flag, &rec);
+	if (sc)
+		return script_run(sc);
 	if (!(p = strchr(s, '\n')) || *++p) {
 		p = xmalloc(strlen(s) + 2);
 		strcpy(p, s);
 		strcat(p, "\n");
 		setup_string_in_str(&input, p);
-		rcode = parse_stream_outer(&input, flag);
+		rcode = parse_stream_outer(&input, flag, rec);
 		free(p);
-		return rcode;
 	} else {
-#endif
-	setup_string_in_str(&input, s);
-	return parse_stream_outer(&input, flag);
-#ifdef __U_BOOT__
+		setup_string_in_str(&input, s);
+		rcode = parse_stream_outer(&input, flag, rec);
 	}
+	script_finish(rec);
+	return rcode;
+#else
+	setup_string_in_str(&input, s);
+	return parse_stream_outer(&input, flag, NULL);
 #endif
 }
 
@@ -3297,7 +3592,7 @@ int parse_file_outer(void)
 #else
 	setup_file_in_str(&input);
 #endif
-	rcode = parse_stream_outer(&input, FLAG_PARSE_SEMICOLON);
+	rcode = parse_stream_outer(&input, FLAG_PARSE_SEMICOLON, NULL);
 	return rcode;
 }
 
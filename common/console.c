@@ -13,6 +13,7 @@
 #include <iomux.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <membuff.h>
 #include <os.h>
 #include <serial.h>
 #include <stdio_dev.h>
@@ -171,6 +172,202 @@ static bool console_dev_is_serial(struct stdio_dev *sdev)
 	return is_serial;
 }
 
+#if CONFIG_IS_ENABLED(CONSOLE_ASYNC)
+/** Buffered serial output *********************************************/
+
+/**
+ * struct console_async - Serial console output waiting to be sent
+ *
+ * Output for the serial console is added to @buf and sent from there as
+ * the UART accepts it, so that printing does not wait for the UART.
+ *
+ * @buf:	Output not yet sent
+ * @sdev:	Console device the output is for, NULL until first used
+ * @dev:	Serial device behind @sdev
+ * @off:	true if output is not buffered (allocation failed or panic)
+ * @draining:	true while sending, to stop WATCHDOG_RESET() in the serial
+ *		driver from starting another drain
+ * @cr_sent:	true if the '\r' for a '\n' at the head of @buf was sent
+ * @bytes:	Number of bytes added to @buf
+ * @peak:	Largest number of bytes waiting in @buf
+ * @stalls:	Number of times @buf was full and output had to wait
+ * @drain_us:	Time spent sending from @buf, in microseconds
+ */
+static struct console_async {
+	struct membuff buf;
+	struct stdio_dev *sdev;
+	struct udevice *dev;
+	bool off;
+	bool draining;
+	bool cr_sent;
+	ulong bytes;
+	int peak;
+	ulong stalls;
+	ulong drain_us;
+} con_async;
+
+/* Send a character, or return -EAGAIN if @wait is false and the UART is busy */
+static int console_async_out(struct console_async *ca, char ch, bool wait)
+{
+	int ret;
+
+	if (ch == '\n' && !ca->cr_sent) {
+		do {
+			ret = serial_dev_try_putc(ca->dev, '\r');
+		} while (ret == -EAGAIN && wait);
+		if (ret == -EAGAIN)
+			return ret;
+		ca->cr_sent = true;
+	}
+
+	do {
+		ret = serial_dev_try_putc(ca->dev, ch);
+	} while (ret == -EAGAIN && wait);
+	if (ret == -EAGAIN)
+		return ret;
+	ca->cr_sent = false;
+
+	return 0;
+}
+
+/*
+ * Send buffered output until the UART is busy, waiting for it to accept the
+ * first @need bytes. Returns the number of bytes sent.
+ */
+static int console_async_send(struct console_async *ca, int need)
+{
+	ulong start;
+	char *data;
+	int sent = 0;
+	int len, i;
+
+	if (ca->draining || membuff_isempty(&ca->buf))
+		return 0;
+
+	ca->draining = true;
+	start = timer_get_us();
+	while ((len = membuff_getraw(&ca->buf, -1, false, &data)) > 0) {
+		for (i = 0; i < len; i++) {
+			if (console_async_out(ca, data[i], sent + i < need))
+				break;
+		}
+		membuff_getraw(&ca->buf, i, true, &data);
+		sent += i;
+		if (i < len)
+			break;
+	}
+	ca->drain_us += timer_get_us() - start;
+	ca->draining = false;
+
+	return sent;
+}
+
+void console_drain(void)
+{
+	if (gd->flags & GD_FLG_DEVINIT)
+		console_async_send(&con_async, 0);
+}
+
+void console_flush(void)
+{
+	if (gd->flags & GD_FLG_DEVINIT)
+		console_async_send(&con_async, INT_MAX);
+}
+
+void console_async_stop(void)
+{
+	console_flush();
+	con_async.off = true;
+}
+
+/* Check whether output to @sdev should go through the buffer */
+static bool console_async_wanted(struct console_async *ca, int file,
+				 struct stdio_dev *sdev)
+{
+	if (ca->off || file == stdin)
+		return false;
+	if (ca->sdev)
+		return sdev == ca->sdev;
+	if (!console_dev_is_serial(sdev))
+		return false;
+
+	if (membuff_new(&ca->buf, CONFIG_CONSOLE_ASYNC_SIZE)) {
+		ca->off = true;
+		return false;
+	}
+	ca->sdev = sdev;
+	ca->dev = sdev->flags & DEV_FLAGS_DM ? sdev->priv : gd->cur_serial_dev;
+
+	return true;
+}
+
+static void console_async_puts(struct console_async *ca, const char *s,
+			       int len)
+{
+	int done;
+
+	while (len) {
+		done = membuff_put(&ca->buf, s, len);
+		s += done;
+		len -= done;
+		ca->bytes += done;
+		if (!len)
+			break;
+
+		/* Full: wait until the UART takes some, or write directly */
+		ca->stalls++;
+		if (!console_async_send(ca, 1)) {
+			serial_dev_putc(ca->dev, *s++);
+			len--;
+		}
+	}
+	ca->peak = max(ca->peak, membuff_avail(&ca->buf));
+	console_async_send(ca, 0);
+}
+
+/* Buffer output for the serial console, returning false for other devices */
+static bool console_async_put(int file, struct stdio_dev *sdev, const char *s,
+			      int len)
+{
+	struct console_async *ca = &con_async;
+
+	if (!console_async_wanted(ca, file, sdev))
+		return false;
+	console_async_puts(ca, s, len);
+
+	return true;
+}
+
+void console_async_print_stats(void)
+{
+	struct console_async *ca = &con_async;
+
+	printf("Buffer:   %s, %d of %d bytes waiting, peak %d\n",
+	       ca->off ? "off" : ca->sdev ? ca->sdev->name : "unused",
+	       ca->sdev ? membuff_avail(&ca->buf) : 0,
+	       CONFIG_CONSOLE_ASYNC_SIZE, ca->peak);
+	printf("Buffered: %lu bytes, %lu stalls\n", ca->bytes, ca->stalls);
+	printf("Drain:    %lu.%03lu ms\n", ca->drain_us / 1000,
+	       ca->drain_us % 1000);
+}
+
+void console_async_reset_stats(void)
+{
+	struct console_async *ca = &con_async;
+
+	ca->bytes = 0;
+	ca->stalls = 0;
+	ca->drain_us = 0;
+	ca->peak = ca->sdev ? membuff_avail(&ca->buf) : 0;
+}
+#else
+static inline bool console_async_put(int file, struct stdio_dev *sdev,
+				     const char *s, int len)
+{
+	return false;
+}
+#endif
+
 #if CONFIG_IS_ENABLED(CONSOLE_MUX)
 /** Console I/O multiplexing *******************************************/
 
@@ -223,7 +420,7 @@ static void console_putc(int file, const char c)
 
 	for (i = 0; i < cd_count[file]; i++) {
 		dev = console_devices[file][i];
-		if (dev->putc != NULL)
+		if (dev->putc != NULL && !console_async_put(file, dev, &c, 1))
 			dev->putc(dev, c);
 	}
 }
@@ -247,7 +444,8 @@ static void console_puts(int file, const char *s)
 
 	for (i = 0; i < cd_count[file]; i++) {
 		dev = console_devices[file][i];
-		if (dev->puts != NULL)
+		if (dev->puts != NULL &&
+		    !console_async_put(file, dev, s, strlen(s)))
 			dev->puts(dev, s);
 	}
 }
@@ -281,7 +479,8 @@ static inline int console_tstc(int file)
 
 static inline void console_putc(int file, const char c)
 {
-	stdio_devices[file]->putc(stdio_devices[file], c);
+	if (!console_async_put(file, stdio_devices[file], &c, 1))
+		stdio_devices[file]->putc(stdio_devices[file], c);
 }
 
 static inline void console_puts_noserial(int file, const char *s)
@@ -292,7 +491,8 @@ static inline void console_puts_noserial(int file, const char *s)
 
 static inline void console_puts(int file, const char *s)
 {
-	stdio_devices[file]->puts(stdio_devices[file], s);
+	if (!console_async_put(file, stdio_devices[file], s, strlen(s)))
+		stdio_devices[file]->puts(stdio_devices[file], s);
 }
 
 static inline void console_clear(int file)
@@ -424,6 +624,8 @@ int getc(void)
 	}
 #endif
 	if (gd->flags & GD_FLG_DEVINIT) {
+		/* Show everything printed so far before waiting for input */
+		console_flush();
 		/* Get from the standard input */
 		return fgetc(stdin);
 	}
@@ -446,6 +648,7 @@ int tstc(void)
 	}
 #endif
 	if (gd->flags & GD_FLG_DEVINIT) {
+		console_drain();
 		/* Test the standard input */
 		return ftstc(stdin);
 	}
@@ -459,9 +662,10 @@ void flushc(void)
 	if (!gd || gd->flags & GD_FLG_DISABLE_CONSOLE)
 		return;
 
-	if (gd->flags & GD_FLG_DEVINIT)
+	if (gd->flags & GD_FLG_DEVINIT) {
+		console_flush();
 		fclear(stdout);
-	else
+	} else
 		serial_clear();
 }
 
@@ -15,6 +15,7 @@
 #include <crypto.h>
 #include <sysmem.h>
 #include <u-boot/sha1.h>
+#include <linux/sizes.h>
 #ifdef CONFIG_RKIMG_BOOTLOADER
 #include <asm/arch/resource_img.h>
 #endif
@@ -310,6 +311,28 @@ typedef enum {
 	IMG_MAX,
 } img_t;
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_DM_CRYPTO)
+#define IMAGE_HASH_CHUNK_SIZE	SZ_1M
+
+struct image_hash_state {
+	struct udevice *crypto;
+	ulong skip;	/* leading bytes not covered by the hash */
+};
+
+static int image_hash_chunk(void *priv, void *buf, ulong len)
+{
+	struct image_hash_state *state = priv;
+	ulong skip = min(state->skip, len);
+
+	state->skip -= skip;
+	if (len == skip)
+		return 0;
+
+	return crypto_sha_update(state->crypto, (u32 *)(buf + skip),
+				 len - skip);
+}
+#endif
+
 static int image_load(img_t img, struct andr_img_hdr *hdr,
 		      ulong blkstart, void *ram_base,
 		      struct udevice *crypto)
@@ -326,6 +349,7 @@ static int image_load(img_t img, struct andr_img_hdr *hdr,
 	ulong datasz;
 	void *ramdst;
 	int ret = 0;
+	__maybe_unused bool hashed = false;
 
 	switch (img) {
 	case IMG_KERNEL:
@@ -448,6 +472,24 @@ static int image_load(img_t img, struct andr_img_hdr *hdr,
 	/* load */
 	if (ram_base) {
 		memcpy(ramdst, (char *)((ulong)ram_base + offset), datasz);
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_DM_CRYPTO)
+	} else if (crypto && !orgdst) {
+		/* hash each chunk while the next one is read */
+		struct image_hash_state state = {
+			.crypto = crypto,
+			.skip = img == IMG_KERNEL ? pgsz : 0,
+		};
+
+		blkoff = DIV_ROUND_UP(offset, blksz);
+		ret = blk_dread_pipeline(desc, blkstart + blkoff, datasz,
+					 ramdst, IMAGE_HASH_CHUNK_SIZE,
+					 image_hash_chunk, &state);
+		if (ret) {
+			printf("Failed to read img(%d), ret=%d\n", img, ret);
+			return -EIO;
+		}
+		hashed = true;
+#endif
 	} else {
 		blkoff = DIV_ROUND_UP(offset, blksz);
 		ret = blk_dread(desc, blkstart + blkoff, blkcnt, ramdst);
@@ -469,7 +511,8 @@ crypto_calc:
 			datasz -= pgsz;
 		}
 
-		crypto_sha_update(crypto, (u32 *)ramdst, datasz);
+		if (!hashed)
+			crypto_sha_update(crypto, (u32 *)ramdst, datasz);
 		crypto_sha_update(crypto, (u32 *)&datasz, sizesz);
 	}
 #endif
@@ -58,7 +58,7 @@
 static const unsigned char us_direction[256/8] = {
 	0x28, 0x81, 0x14, 0x14, 0x20, 0x01, 0x90, 0x77,
 	0x0C, 0x20, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01,
+	0x00, 0x01, 0x00, 0x40, 0x00, 0x01, 0x00, 0x01,
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 #define US_DIRECTION(x) ((us_direction[x>>3] >> (x & 7)) & 1)
@@ -81,6 +81,8 @@ struct us_data {
 
 	unsigned int	flags;			/* from filter initially */
 #	define USB_READY	(1 << 0)
+#	define USB_CMD16	(1 << 1)	/* READ/WRITE(16) accepted */
+#	define USB_NO_CHAIN	(1 << 2)	/* HCD cannot chain bulk msgs */
 	unsigned char	ifnum;			/* interface number */
 	unsigned char	ep_in;			/* in endpoint */
 	unsigned char	ep_out;			/* out ....... */
@@ -98,7 +100,7 @@ struct us_data {
 	struct scsi_cmd	*srb;			/* current srb */
 	trans_reset	transport_reset;	/* reset routine */
 	trans_cmnd	transport;		/* transport routine */
-	unsigned short	max_xfer_blk;		/* maximum transfer blocks */
+	unsigned int	max_xfer_blk;		/* maximum transfer blocks */
 };
 
 #ifndef CONFIG_BLK
@@ -109,6 +111,13 @@ static struct us_data usb_stor[USB_MAX_STOR_DEV];
 #define USB_STOR_TRANSPORT_FAILED -1
 #define USB_STOR_TRANSPORT_ERROR  -2
 
+/*
+ * Most blocks moved by one READ(16)/WRITE(16), so that the transfer length
+ * of a CBW stays below 4GiB even with 4KiB sectors. READ(10)/WRITE(10)
+ * are limited to USHRT_MAX blocks.
+ */
+#define USB_MAX_XFER_BLK_16	0x40000
+
 int usb_stor_get_info(struct usb_device *dev, struct us_data *us,
 		      struct blk_desc *dev_desc);
 int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
@@ -527,6 +536,21 @@ static int usb_stor_CB_reset(struct us_data *us)
 	return 0;
 }
 
+static void usb_stor_BBB_setup_cbw(struct scsi_cmd *srb,
+				   struct umass_bbb_cbw *cbw, int dir_in)
+{
+	cbw->dCBWSignature = cpu_to_le32(CBWSIGNATURE);
+	cbw->dCBWTag = cpu_to_le32(CBWTag++);
+	cbw->dCBWDataTransferLength = cpu_to_le32(srb->datalen);
+	cbw->bCBWFlags = (dir_in ? CBWFLAGS_IN : CBWFLAGS_OUT);
+	cbw->bCBWLUN = srb->lun;
+	cbw->bCDBLength = srb->cmdlen;
+	/* copy the command data into the CBW command data buffer */
+	/* DST SRC LEN!!! */
+
+	memcpy(cbw->CBWCDB, srb->cmd, srb->cmdlen);
+}
+
 /*
  * Set up the command for a BBB device. Note that the actual SCSI
  * command is copied into cbw.CBWCDB.
@@ -560,16 +584,7 @@ static int usb_stor_BBB_comdat(struct scsi_cmd *srb, struct us_data *us)
 	/* always OUT to the ep */
 	pipe = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
 
-	cbw->dCBWSignature = cpu_to_le32(CBWSIGNATURE);
-	cbw->dCBWTag = cpu_to_le32(CBWTag++);
-	cbw->dCBWDataTransferLength = cpu_to_le32(srb->datalen);
-	cbw->bCBWFlags = (dir_in ? CBWFLAGS_IN : CBWFLAGS_OUT);
-	cbw->bCBWLUN = srb->lun;
-	cbw->bCDBLength = srb->cmdlen;
-	/* copy the command data into the CBW command data buffer */
-	/* DST SRC LEN!!! */
-
-	memcpy(cbw->CBWCDB, srb->cmd, srb->cmdlen);
+	usb_stor_BBB_setup_cbw(srb, cbw, dir_in);
 	result = usb_bulk_msg(us->pusb_dev, pipe, cbw, UMASS_BBB_CBW_SIZE,
 			      &actlen, USB_CNTL_TIMEOUT * 5);
 	if (result < 0)
@@ -704,18 +719,176 @@ static int usb_stor_BBB_clear_endpt_stall(struct us_data *us, __u8 endpt)
 			       endpt, NULL, 0, USB_CNTL_TIMEOUT * 5);
 }
 
+/* Check the CSW of a BBB command, returns a USB_STOR_TRANSPORT_... code */
+static int usb_stor_BBB_check_csw(struct scsi_cmd *srb, struct us_data *us,
+				  struct umass_bbb_csw *csw, int data_actlen)
+{
+	if (CSWSIGNATURE != le32_to_cpu(csw->dCSWSignature)) {
+		debug("!CSWSIGNATURE\n");
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	} else if ((CBWTag - 1) != le32_to_cpu(csw->dCSWTag)) {
+		debug("!Tag\n");
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	} else if (csw->bCSWStatus > CSWSTATUS_PHASE) {
+		debug(">PHASE\n");
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	} else if (csw->bCSWStatus == CSWSTATUS_PHASE) {
+		debug("=PHASE\n");
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	} else if (data_actlen > srb->datalen) {
+		debug("transferred %dB instead of %ldB\n",
+		      data_actlen, srb->datalen);
+		return USB_STOR_TRANSPORT_FAILED;
+	} else if (csw->bCSWStatus == CSWSTATUS_FAILED) {
+		debug("FAILED\n");
+		return USB_STOR_TRANSPORT_FAILED;
+	}
+
+	return USB_STOR_TRANSPORT_GOOD;
+}
+
+/* Read and check the CSW of a BBB command, retrying once after a STALL */
+static int usb_stor_BBB_status(struct scsi_cmd *srb, struct us_data *us,
+			       int data_actlen)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_csw, csw, 1);
+	unsigned int pipein = usb_rcvbulkpipe(us->pusb_dev, us->ep_in);
+	int result, actlen, retry = 0;
+#ifdef BBB_XPORT_TRACE
+	unsigned char *ptr;
+	int index;
+#endif
+
+again:
+	debug("STATUS phase\n");
+	result = usb_bulk_msg(us->pusb_dev, pipein, csw, UMASS_BBB_CSW_SIZE,
+				&actlen, USB_CNTL_TIMEOUT*5);
+
+	/* special handling of STALL in STATUS phase */
+	if ((result < 0) && (retry < 1) &&
+	    (us->pusb_dev->status & USB_ST_STALLED)) {
+		debug("STATUS:stall\n");
+		/* clear the STALL on the endpoint */
+		result = usb_stor_BBB_clear_endpt_stall(us, us->ep_in);
+		if (result >= 0 && (retry++ < 1))
+			/* do a retry */
+			goto again;
+	}
+	if (result < 0) {
+		debug("usb_bulk_msg error status %ld\n",
+		      us->pusb_dev->status);
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	}
+#ifdef BBB_XPORT_TRACE
+	ptr = (unsigned char *)csw;
+	for (index = 0; index < UMASS_BBB_CSW_SIZE; index++)
+		printf("ptr[%d] %#x ", index, ptr[index]);
+	printf("\n");
+#endif
+
+	return usb_stor_BBB_check_csw(srb, us, csw, data_actlen);
+}
+
+#if CONFIG_IS_ENABLED(DM_USB)
+/*
+ * Queue the CBW, the data and the CSW of a BBB command together, so the
+ * device goes from one phase to the next without a round trip through
+ * software. Only READ and WRITE on a ready device are queued this way,
+ * other commands need the delays and error handling of the phase by phase
+ * path. A STALL in the data phase is cleared and the CSW read on its own,
+ * as that path does, any other failed phase is recovered with a reset of
+ * the device. Returns -ENOSYS if the command is not to be queued or the
+ * host controller cannot queue the messages; the caller then runs the
+ * phases one at a time.
+ */
+static int usb_stor_BBB_chain(struct scsi_cmd *srb, struct us_data *us)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_cbw, cbw, 1);
+	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_csw, csw, 1);
+	struct usb_bulk_xfer xfer[3];
+	unsigned int pipein, pipeout;
+	int dir_in, data_actlen = 0;
+	int n = 0, ret;
+
+	if ((us->flags & USB_NO_CHAIN) || !(us->flags & USB_READY) ||
+	    srb->cmdlen > CBWCDBLENGTH)
+		return -ENOSYS;
+
+	switch (srb->cmd[0]) {
+	case SCSI_READ10:
+	case SCSI_READ16:
+	case SCSI_WRITE10:
+	case SCSI_WRITE16:
+		break;
+	default:
+		return -ENOSYS;
+	}
+
+	dir_in = US_DIRECTION(srb->cmd[0]);
+	pipein = usb_rcvbulkpipe(us->pusb_dev, us->ep_in);
+	pipeout = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
+
+	usb_stor_BBB_setup_cbw(srb, cbw, dir_in);
+	xfer[n].pipe = pipeout;
+	xfer[n].buffer = cbw;
+	xfer[n++].length = UMASS_BBB_CBW_SIZE;
+	if (srb->datalen) {
+		xfer[n].pipe = dir_in ? pipein : pipeout;
+		xfer[n].buffer = srb->pdata;
+		xfer[n++].length = srb->datalen;
+	}
+	xfer[n].pipe = pipein;
+	xfer[n].buffer = csw;
+	xfer[n++].length = UMASS_BBB_CSW_SIZE;
+
+	ret = usb_bulk_chain(us->pusb_dev, xfer, n);
+	if (ret == -ENOSYS)
+		us->flags |= USB_NO_CHAIN;
+	if (ret == -ENOSYS || ret == -E2BIG)
+		return -ENOSYS;
+	if (srb->datalen)
+		data_actlen = xfer[1].act_len;
+	/* special handling of STALL in DATA phase */
+	if (ret && srb->datalen && !xfer[0].status &&
+	    (xfer[1].status & USB_ST_STALLED)) {
+		debug("DATA:stall\n");
+		/* clear the STALL on the endpoint */
+		if (usb_stor_BBB_clear_endpt_stall(us,
+				dir_in ? us->ep_in : us->ep_out) >= 0)
+			/* continue on to STATUS phase */
+			return usb_stor_BBB_status(srb, us, data_actlen);
+	}
+	if (ret) {
+		debug("usb_bulk_chain error %d\n", ret);
+		usb_stor_BBB_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	}
+
+	return usb_stor_BBB_check_csw(srb, us, csw, data_actlen);
+}
+#endif
+
 static int usb_stor_BBB_transport(struct scsi_cmd *srb, struct us_data *us)
 {
-	int result, retry;
+	int result;
 	int dir_in;
-	int actlen, data_actlen;
+	int data_actlen;
 	unsigned int pipe, pipein, pipeout;
-	ALLOC_CACHE_ALIGN_BUFFER(struct umass_bbb_csw, csw, 1);
 #ifdef BBB_XPORT_TRACE
-	unsigned char *ptr;
 	int index;
 #endif
 
+#if CONFIG_IS_ENABLED(DM_USB)
+	result = usb_stor_BBB_chain(srb, us);
+	if (result != -ENOSYS)
+		return result;
+#endif
+
 	dir_in = US_DIRECTION(srb->cmd[0]);
 
 	/* COMMAND phase */
@@ -767,64 +940,7 @@ static int usb_stor_BBB_transport(struct scsi_cmd *srb, struct us_data *us)
 #endif
 	/* STATUS phase + error handling */
 st:
-	retry = 0;
-again:
-	debug("STATUS phase\n");
-	result = usb_bulk_msg(us->pusb_dev, pipein, csw, UMASS_BBB_CSW_SIZE,
-				&actlen, USB_CNTL_TIMEOUT*5);
-
-	/* special handling of STALL in STATUS phase */
-	if ((result < 0) && (retry < 1) &&
-	    (us->pusb_dev->status & USB_ST_STALLED)) {
-		debug("STATUS:stall\n");
-		/* clear the STALL on the endpoint */
-		result = usb_stor_BBB_clear_endpt_stall(us, us->ep_in);
-		if (result >= 0 && (retry++ < 1))
-			/* do a retry */
-			goto again;
-	}
-	if (result < 0) {
-		debug("usb_bulk_msg error status %ld\n",
-		      us->pusb_dev->status);
-		usb_stor_BBB_reset(us);
-		return USB_STOR_TRANSPORT_FAILED;
-	}
-#ifdef BBB_XPORT_TRACE
-	ptr = (unsigned char *)csw;
-	for (index = 0; index < UMASS_BBB_CSW_SIZE; index++)
-		printf("ptr[%d] %#x ", index, ptr[index]);
-	printf("\n");
-#endif
-	/* misuse pipe to get the residue */
-	pipe = le32_to_cpu(csw->dCSWDataResidue);
-	if (pipe == 0 && srb->datalen != 0 && srb->datalen - data_actlen != 0)
-		pipe = srb->datalen - data_actlen;
-	if (CSWSIGNATURE != le32_to_cpu(csw->dCSWSignature)) {
-		debug("!CSWSIGNATURE\n");
-		usb_stor_BBB_reset(us);
-		return USB_STOR_TRANSPORT_FAILED;
-	} else if ((CBWTag - 1) != le32_to_cpu(csw->dCSWTag)) {
-		debug("!Tag\n");
-		usb_stor_BBB_reset(us);
-		return USB_STOR_TRANSPORT_FAILED;
-	} else if (csw->bCSWStatus > CSWSTATUS_PHASE) {
-		debug(">PHASE\n");
-		usb_stor_BBB_reset(us);
-		return USB_STOR_TRANSPORT_FAILED;
-	} else if (csw->bCSWStatus == CSWSTATUS_PHASE) {
-		debug("=PHASE\n");
-		usb_stor_BBB_reset(us);
-		return USB_STOR_TRANSPORT_FAILED;
-	} else if (data_actlen > srb->datalen) {
-		debug("transferred %dB instead of %ldB\n",
-		      data_actlen, srb->datalen);
-		return USB_STOR_TRANSPORT_FAILED;
-	} else if (csw->bCSWStatus == CSWSTATUS_FAILED) {
-		debug("FAILED\n");
-		return USB_STOR_TRANSPORT_FAILED;
-	}
-
-	return result;
+	return usb_stor_BBB_status(srb, us, data_actlen);
 }
 
 static int usb_stor_CB_transport(struct scsi_cmd *srb, struct us_data *us)
@@ -942,7 +1058,7 @@ do_retry:
 static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 				      struct us_data *us)
 {
-	unsigned short blk;
+	unsigned int blk;
 	size_t __maybe_unused size;
 	int __maybe_unused ret;
 
@@ -950,10 +1066,10 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 #ifdef CONFIG_USB_EHCI_HCD
 	/*
 	 * The U-Boot EHCI driver can handle any transfer length as long as
-	 * there is enough free heap space left, but the SCSI READ(10) and
-	 * WRITE(10) commands are limited to 65535 blocks.
+	 * there is enough free heap space left. The SCSI READ(10) and
+	 * WRITE(10) commands further limit this, see usb_stor_max_blks().
 	 */
-	blk = USHRT_MAX;
+	blk = USB_MAX_XFER_BLK_16;
 #else
 	blk = 20;
 #endif
@@ -963,8 +1079,8 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 		/* unimplemented, let's use default 20 */
 		blk = 20;
 	} else {
-		if (size > USHRT_MAX * 512)
-			size = USHRT_MAX * 512;
+		if (size > (size_t)USB_MAX_XFER_BLK_16 * 512)
+			size = (size_t)USB_MAX_XFER_BLK_16 * 512;
 		blk = size / 512;
 	}
 #endif
@@ -972,6 +1088,23 @@ static void usb_stor_set_max_xfer_blk(struct usb_device *udev,
 	us->max_xfer_blk = blk;
 }
 
+/* Most blocks one READ/WRITE command may move */
+static unsigned int usb_stor_max_blks(struct us_data *us)
+{
+	if (us->flags & USB_CMD16)
+		return us->max_xfer_blk;
+
+	return min_t(unsigned int, us->max_xfer_blk, USHRT_MAX);
+}
+
+/* READ(10)/WRITE(10) cannot address the request */
+static bool usb_stor_use_16(struct us_data *us, lbaint_t start,
+			    unsigned int blocks)
+{
+	return (us->flags & USB_CMD16) &&
+	       (blocks > USHRT_MAX || (u64)start + blocks > 0x100000000ULL);
+}
+
 static int usb_inquiry(struct scsi_cmd *srb, struct us_data *ss)
 {
 	int retry, i;
@@ -1065,6 +1198,25 @@ static int usb_read_capacity(struct scsi_cmd *srb, struct us_data *ss)
 	return -1;
 }
 
+static int usb_read_capacity_16(struct scsi_cmd *srb, struct us_data *ss)
+{
+	int retry;
+
+	retry = 3;
+	do {
+		memset(&srb->cmd[0], 0, 16);
+		srb->cmd[0] = SCSI_RD_CAPAC16;
+		srb->cmd[1] = 0x10;	/* service action: READ CAPACITY(16) */
+		srb->cmd[13] = 32;	/* allocation length */
+		srb->datalen = 32;
+		srb->cmdlen = 16;
+		if (ss->transport(srb, ss) == USB_STOR_TRANSPORT_GOOD)
+			return 0;
+	} while (retry--);
+
+	return -1;
+}
+
 static int usb_read_10(struct scsi_cmd *srb, struct us_data *ss,
 		       unsigned long start, unsigned short blocks)
 {
@@ -1099,6 +1251,38 @@ static int usb_write_10(struct scsi_cmd *srb, struct us_data *ss,
 	return ss->transport(srb, ss);
 }
 
+static void usb_setup_16(struct scsi_cmd *srb, unsigned char cmd,
+			 lbaint_t start, unsigned int blocks)
+{
+	u64 lba = start;
+	int i;
+
+	memset(&srb->cmd[0], 0, 16);
+	srb->cmd[0] = cmd;
+	for (i = 0; i < 8; i++)
+		srb->cmd[2 + i] = (unsigned char)(lba >> (56 - 8 * i)) & 0xff;
+	for (i = 0; i < 4; i++)
+		srb->cmd[10 + i] = (unsigned char)(blocks >> (24 - 8 * i)) &
+				   0xff;
+	srb->cmdlen = 16;
+}
+
+static int usb_read_16(struct scsi_cmd *srb, struct us_data *ss,
+		       lbaint_t start, unsigned int blocks)
+{
+	usb_setup_16(srb, SCSI_READ16, start, blocks);
+	debug("read16: start " LBAF " blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
+static int usb_write_16(struct scsi_cmd *srb, struct us_data *ss,
+			lbaint_t start, unsigned int blocks)
+{
+	usb_setup_16(srb, SCSI_WRITE16, start, blocks);
+	debug("write16: start " LBAF " blocks %x\n", start, blocks);
+	return ss->transport(srb, ss);
+}
+
 
 #ifdef CONFIG_USB_BIN_FIXUP
 /*
@@ -1133,10 +1317,10 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned int smallblks, max_blks;
 	struct usb_device *udev;
 	struct us_data *ss;
-	int retry;
+	int retry, ret;
 	struct scsi_cmd *srb = &usb_ccb;
 #ifdef CONFIG_BLK
 	struct blk_desc *block_dev;
@@ -1161,6 +1345,7 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 
 	usb_disable_asynch(1); /* asynch transfer not allowed */
 	srb->lun = block_dev->lun;
+	max_blks = usb_stor_max_blks(ss);
 	buf_addr = (uintptr_t)buffer;
 	start = blknr;
 	blks = blkcnt;
@@ -1172,16 +1357,20 @@ static unsigned long usb_stor_read(struct blk_desc *block_dev, lbaint_t blknr,
 		/* XXX need some comment here */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > ss->max_xfer_blk)
-			smallblks = ss->max_xfer_blk;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
-			smallblks = (unsigned short) blks;
+			smallblks = blks;
 retry_it:
-		if (smallblks == ss->max_xfer_blk)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_read_10(srb, ss, start, smallblks)) {
+		if (usb_stor_use_16(ss, start, smallblks))
+			ret = usb_read_16(srb, ss, start, smallblks);
+		else
+			ret = usb_read_10(srb, ss, start, smallblks);
+		if (ret) {
 			debug("Read ERROR\n");
 			usb_request_sense(srb, ss);
 			if (retry--)
@@ -1200,7 +1389,7 @@ retry_it:
 	      start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= ss->max_xfer_blk)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 }
@@ -1215,10 +1404,10 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned int smallblks, max_blks;
 	struct usb_device *udev;
 	struct us_data *ss;
-	int retry;
+	int retry, ret;
 	struct scsi_cmd *srb = &usb_ccb;
 #ifdef CONFIG_BLK
 	struct blk_desc *block_dev;
@@ -1245,6 +1434,7 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 	usb_disable_asynch(1); /* asynch transfer not allowed */
 
 	srb->lun = block_dev->lun;
+	max_blks = usb_stor_max_blks(ss);
 	buf_addr = (uintptr_t)buffer;
 	start = blknr;
 	blks = blkcnt;
@@ -1258,16 +1448,20 @@ static unsigned long usb_stor_write(struct blk_desc *block_dev, lbaint_t blknr,
 		 */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > ss->max_xfer_blk)
-			smallblks = ss->max_xfer_blk;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
-			smallblks = (unsigned short) blks;
+			smallblks = blks;
 retry_it:
-		if (smallblks == ss->max_xfer_blk)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = block_dev->blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (usb_write_10(srb, ss, start, smallblks)) {
+		if (usb_stor_use_16(ss, start, smallblks))
+			ret = usb_write_16(srb, ss, start, smallblks);
+		else
+			ret = usb_write_10(srb, ss, start, smallblks);
+		if (ret) {
 			debug("Write ERROR\n");
 			usb_request_sense(srb, ss);
 			if (retry--)
@@ -1285,7 +1479,7 @@ retry_it:
 	      PRIxPTR "\n", start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= ss->max_xfer_blk)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 
@@ -1418,9 +1612,10 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 		      struct blk_desc *dev_desc)
 {
 	unsigned char perq, modi;
-	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 2);
+	ALLOC_CACHE_ALIGN_BUFFER(u32, cap, 8);
 	ALLOC_CACHE_ALIGN_BUFFER(u8, usb_stor_buf, 36);
-	u32 capacity, blksz;
+	u64 capacity;
+	u32 blksz;
 	struct scsi_cmd *pccb = &usb_ccb;
 
 	pccb->pdata = usb_stor_buf;
@@ -1477,6 +1672,17 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 		cap[0] = 2880;
 		cap[1] = 0x200;
 	}
+	if (be32_to_cpu(cap[0]) == 0xffffffff) {
+		/* Too large for READ CAPACITY(10), and so for READ(10) */
+		memset(pccb->pdata, 0, 32);
+		if (usb_read_capacity_16(pccb, ss) == 0) {
+			ss->flags |= USB_CMD16;
+		} else {
+			printf("READ_CAP16 ERROR\n");
+			cap[0] = cpu_to_be32(0xfffffffe);
+			cap[1] = cpu_to_be32(0x200);
+		}
+	}
 	ss->flags &= ~USB_READY;
 	debug("Read Capacity returns: 0x%08x, 0x%08x\n", cap[0], cap[1]);
 #if 0
@@ -1487,11 +1693,18 @@ int usb_stor_get_info(struct usb_device *dev, struct us_data *ss,
 	cap[1] = cpu_to_be32(cap[1]);
 #endif
 
-	capacity = be32_to_cpu(cap[0]) + 1;
-	blksz = be32_to_cpu(cap[1]);
+	if (ss->flags & USB_CMD16) {
+		capacity = ((u64)be32_to_cpu(cap[0]) << 32 |
+			    be32_to_cpu(cap[1])) + 1;
+		blksz = be32_to_cpu(cap[2]);
+	} else {
+		capacity = be32_to_cpu(cap[0]) + 1;
+		blksz = be32_to_cpu(cap[1]);
+	}
 
-	debug("Capacity = 0x%08x, blocksz = 0x%08x\n", capacity, blksz);
-	dev_desc->lba = capacity;
+	debug("Capacity = 0x%llx, blocksz = 0x%08x\n",
+	      (unsigned long long)capacity, blksz);
+	dev_desc->lba = min_t(u64, capacity, (lbaint_t)-1);
 	dev_desc->blksz = blksz;
 	dev_desc->log2blksz = LOG2(dev_desc->blksz);
 	dev_desc->type = perq;
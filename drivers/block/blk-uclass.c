@@ -50,6 +50,16 @@ static enum uclass_id if_type_uclass_id[IF_TYPE_COUNT] = {
 	[IF_TYPE_SYSTEMACE]	= UCLASS_INVALID,
 };
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+static void blk_async_flush(struct blk_desc *desc)
+{
+	if (desc->async_req)
+		blk_dread_wait(desc->async_req);
+}
+#else
+static inline void blk_async_flush(struct blk_desc *desc) {}
+#endif
+
 enum if_type if_typename_to_iftype(const char *if_typename)
 {
 	int i;
@@ -351,6 +361,8 @@ int blk_select_hwpart(struct udevice *dev, int hwpart)
 	if (!ops->select_hwpart)
 		return 0;
 
+	blk_async_flush(dev_get_uclass_platdata(dev));
+
 	return ops->select_hwpart(dev, hwpart);
 }
 
@@ -444,6 +456,7 @@ unsigned long blk_dread(struct blk_desc *block_dev, lbaint_t start,
 	if (!ops->read)
 		return -ENOSYS;
 
+	blk_async_flush(block_dev);
 	if (blkcache_read(block_dev->if_type, block_dev->devnum,
 			  start, blkcnt, block_dev->blksz, buffer))
 		return blkcnt;
@@ -464,6 +477,7 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 	if (!ops->write)
 		return -ENOSYS;
 
+	blk_async_flush(block_dev);
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
 	return ops->write(dev, start, blkcnt, buffer);
 }
@@ -477,10 +491,128 @@ unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 	if (!ops->erase)
 		return -ENOSYS;
 
+	blk_async_flush(block_dev);
 	blkcache_invalidate(block_dev->if_type, block_dev->devnum);
 	return ops->erase(dev, start, blkcnt);
 }
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int blk_dread_submit(struct blk_desc *block_dev, struct blk_req *req,
+		     lbaint_t start, lbaint_t blkcnt, void *buffer)
+{
+	struct udevice *dev = block_dev->bdev;
+	const struct blk_ops *ops = blk_get_ops(dev);
+	int ret;
+
+	if (!ops->read)
+		return -ENOSYS;
+
+	blk_async_flush(block_dev);
+
+	req->dev = dev;
+	req->start = start;
+	req->blkcnt = blkcnt;
+	req->buffer = buffer;
+	req->done = 0;
+
+	if (!ops->read_submit || !ops->read_poll) {
+		/* No background transfer, complete the request right here */
+		req->done = ops->read(dev, start, blkcnt, buffer);
+		req->status = req->done == blkcnt ? 0 : -EIO;
+		return req->status;
+	}
+
+	req->status = -EINPROGRESS;
+	ret = ops->read_submit(dev, req);
+	if (ret) {
+		req->status = ret;
+		return ret;
+	}
+	block_dev->async_req = req;
+
+	return 0;
+}
+
+int blk_dread_poll(struct blk_req *req)
+{
+	struct blk_desc *block_dev;
+	const struct blk_ops *ops;
+	int ret;
+
+	if (req->status != -EINPROGRESS)
+		return req->status;
+
+	block_dev = dev_get_uclass_platdata(req->dev);
+	ops = blk_get_ops(req->dev);
+	ret = ops->read_poll(req->dev, req);
+	if (ret == -EINPROGRESS)
+		return ret;
+
+	req->status = ret;
+	if (block_dev->async_req == req)
+		block_dev->async_req = NULL;
+
+	return ret;
+}
+
+int blk_dread_wait(struct blk_req *req)
+{
+	int ret;
+
+	do {
+		ret = blk_dread_poll(req);
+	} while (ret == -EINPROGRESS);
+
+	return ret;
+}
+
+int blk_dread_pipeline(struct blk_desc *block_dev, lbaint_t start,
+		       ulong size, void *buffer, ulong chunk,
+		       int (*process)(void *priv, void *buf, ulong len),
+		       void *priv)
+{
+	ulong blksz = block_dev->blksz;
+	lbaint_t blkcnt = DIV_ROUND_UP(size, blksz);
+	lbaint_t chunk_blks = DIV_ROUND_UP(chunk, blksz);
+	lbaint_t done = 0, cur;
+	ulong offset = 0, len;
+	struct blk_req req;
+	int ret;
+
+	if (!chunk_blks)
+		chunk_blks = 1;
+
+	while (done < blkcnt) {
+		cur = min(blkcnt - done, chunk_blks);
+		ret = blk_dread_submit(block_dev, &req, start + done, cur,
+				       buffer + done * blksz);
+		if (ret)
+			return ret;
+
+		/* Work on the previous chunk while this one is read */
+		if (offset < done * blksz) {
+			len = done * blksz - offset;
+			ret = process(priv, buffer + offset, len);
+			if (ret) {
+				blk_dread_wait(&req);
+				return ret;
+			}
+			offset += len;
+		}
+
+		ret = blk_dread_wait(&req);
+		if (ret)
+			return ret;
+		done += cur;
+	}
+
+	if (offset < size)
+		return process(priv, buffer + offset, size - offset);
+
+	return 0;
+}
+#endif
+
 int blk_prepare_device(struct udevice *dev)
 {
 	struct blk_desc *desc = dev_get_uclass_platdata(dev);
@@ -12,9 +12,26 @@
 #include <asm/arch/clock.h>
 #include <asm/arch/hardware.h>
 #include <div64.h>
+#include <malloc.h>
+#include <linux/err.h>
 
 static struct rockchip_pll_rate_table rockchip_auto_table;
 
+#define PLL_LOCK_TIMEOUT_US			1000
+
+/*
+ * Shared by the clock drivers of all CRUs. The generation starts at 1 so
+ * that zeroed cache entries are never valid, which also keeps this in
+ * .data for use before relocation.
+ */
+static struct {
+	u32 gen;
+	ulong rate_hits;
+	ulong rate_misses;
+	ulong pll_relocks;
+	ulong pll_lock_us;
+} rockchip_clk_stats = { .gen = 1 };
+
 #define PLL_MODE_MASK				0x3
 #define PLL_RK3328_MODE_MASK			0x1
 
@@ -179,9 +196,9 @@ rockchip_get_pll_settings(struct rockchip_pll_clock *pll, ulong rate)
 		return rate_table;
 }
 
-static int rk3036_pll_set_rate(struct rockchip_pll_clock *pll,
-			       void __iomem *base, ulong pll_id,
-			       ulong drate)
+/* Reprogram the PLL, which runs from the oscillator until it has locked */
+static int rk3036_pll_start(struct rockchip_pll_clock *pll,
+			    void __iomem *base, ulong pll_id, ulong drate)
 {
 	const struct rockchip_pll_rate_table *rate;
 
@@ -232,12 +249,19 @@ static int rk3036_pll_set_rate(struct rockchip_pll_clock *pll,
 	rk_clrreg(base + pll->con_offset + 0x4,
 		  1 << RK3036_PLLCON1_PWRDOWN_SHIT);
 
-	/* waiting for pll lock */
-	while (!(readl(base + pll->con_offset + 0x4) & (1 << pll->lock_shift))) {
-		udelay(1);
-		debug("%s: wait pll lock, pll_id=%ld\n", __func__, pll_id);
-	}
+	return 0;
+}
+
+static bool rk3036_pll_locked(struct rockchip_pll_clock *pll,
+			      void __iomem *base)
+{
+	return readl(base + pll->con_offset + 0x4) & (1 << pll->lock_shift);
+}
 
+/* Switch a locked PLL from the oscillator to its own output */
+static void rk3036_pll_finish(struct rockchip_pll_clock *pll,
+			      void __iomem *base)
+{
 	rk_clrsetreg(base + pll->mode_offset, pll->mode_mask << pll->mode_shift,
 		     RKCLK_PLL_MODE_NORMAL << pll->mode_shift);
 	debug("PLL at %p: con0=%x con1= %x con2= %x mode= %x\n",
@@ -245,8 +269,6 @@ static int rk3036_pll_set_rate(struct rockchip_pll_clock *pll,
 	      readl(base + pll->con_offset + 0x4),
 	      readl(base + pll->con_offset + 0x8),
 	      readl(base + pll->mode_offset));
-
-	return 0;
 }
 
 static ulong rk3036_pll_get_rate(struct rockchip_pll_clock *pll,
@@ -319,31 +341,91 @@ ulong rockchip_pll_get_rate(struct rockchip_pll_clock *pll,
 	return rate;
 }
 
-int rockchip_pll_set_rate(struct rockchip_pll_clock *pll,
-			  void __iomem *base, ulong pll_id,
-			  ulong drate)
+/*
+ * Start reprogramming one PLL of a batch. Returns -EINPROGRESS if it is
+ * now waiting for lock, 0 if it already runs at the rate.
+ */
+static int rockchip_pll_start(struct rockchip_pll_set *set)
 {
-	int ret = 0;
+	struct rockchip_pll_clock *pll = set->pll;
+	int ret;
 
-	if (rockchip_pll_get_rate(pll, base, pll_id) == drate)
+	if (rockchip_pll_get_rate(pll, set->base, set->pll_id) == set->rate)
 		return 0;
 
 	switch (pll->type) {
 	case pll_rk3036:
-		pll->mode_mask = PLL_MODE_MASK;
-		ret = rk3036_pll_set_rate(pll, base, pll_id, drate);
-		break;
 	case pll_rk3328:
-		pll->mode_mask = PLL_RK3328_MODE_MASK;
-		ret = rk3036_pll_set_rate(pll, base, pll_id, drate);
+		ret = rk3036_pll_start(pll, set->base, set->pll_id, set->rate);
 		break;
 	default:
 		printf("%s: Unknown pll type for pll clk %ld\n",
-		       __func__, pll_id);
+		       __func__, set->pll_id);
+		return -EINVAL;
+	}
+	if (ret)
+		return ret;
+
+	rockchip_clk_stats.pll_relocks++;
+
+	return -EINPROGRESS;
+}
+
+int rockchip_pll_set_rates(struct rockchip_pll_set *sets, int count)
+{
+	struct rockchip_pll_set *set;
+	ulong start;
+	int i, pending, ret = 0;
+
+	for (i = 0; i < count; i++)
+		sets[i].ret = rockchip_pll_start(&sets[i]);
+	rockchip_clk_cache_invalidate();
+
+	start = timer_get_us();
+	do {
+		pending = 0;
+		for (i = 0; i < count; i++) {
+			set = &sets[i];
+			if (set->ret != -EINPROGRESS)
+				continue;
+			if (rk3036_pll_locked(set->pll, set->base)) {
+				rk3036_pll_finish(set->pll, set->base);
+				set->ret = 0;
+			} else if (timer_get_us() - start > PLL_LOCK_TIMEOUT_US) {
+				printf("%s: pll %ld did not lock\n", __func__,
+				       set->pll_id);
+				set->ret = -ETIMEDOUT;
+			} else {
+				pending++;
+			}
+		}
+		if (pending)
+			udelay(1);
+	} while (pending);
+	rockchip_clk_stats.pll_lock_us += timer_get_us() - start;
+
+	for (i = 0; i < count; i++) {
+		if (sets[i].ret && !ret)
+			ret = sets[i].ret;
 	}
+
 	return ret;
 }
 
+int rockchip_pll_set_rate(struct rockchip_pll_clock *pll,
+			  void __iomem *base, ulong pll_id,
+			  ulong drate)
+{
+	struct rockchip_pll_set set = {
+		.pll = pll,
+		.base = base,
+		.pll_id = pll_id,
+		.rate = drate,
+	};
+
+	return rockchip_pll_set_rates(&set, 1);
+}
+
 const struct rockchip_cpu_rate_table *
 rockchip_get_cpu_settings(struct rockchip_cpu_rate_table *cpu_table,
 			  ulong rate)
@@ -361,3 +443,64 @@ rockchip_get_cpu_settings(struct rockchip_cpu_rate_table *cpu_table,
 		return ps;
 }
 
+#if CONFIG_IS_ENABLED(ROCKCHIP_CLK_RATE_CACHE)
+struct rockchip_clk_cache *rockchip_clk_cache_alloc(void)
+{
+	return calloc(1, sizeof(struct rockchip_clk_cache));
+}
+
+int rockchip_clk_cache_get(struct rockchip_clk_cache *cache, ulong id,
+			   ulong *rate)
+{
+	int i = id % ROCKCHIP_CLK_CACHE_SIZE;
+
+	if (!cache)
+		return -ENOENT;
+
+	if (cache->ent[i].gen != rockchip_clk_stats.gen ||
+	    cache->ent[i].id != id) {
+		rockchip_clk_stats.rate_misses++;
+		return -ENOENT;
+	}
+	rockchip_clk_stats.rate_hits++;
+	*rate = cache->ent[i].rate;
+
+	return 0;
+}
+
+void rockchip_clk_cache_put(struct rockchip_clk_cache *cache, ulong id,
+			    ulong rate)
+{
+	int i = id % ROCKCHIP_CLK_CACHE_SIZE;
+
+	if (!cache || !rate || IS_ERR_VALUE(rate))
+		return;
+
+	cache->ent[i].id = id;
+	cache->ent[i].gen = rockchip_clk_stats.gen;
+	cache->ent[i].rate = rate;
+}
+
+void rockchip_clk_cache_invalidate(void)
+{
+	if (!++rockchip_clk_stats.gen)
+		rockchip_clk_stats.gen = 1;
+}
+#endif
+
+#ifndef CONFIG_SPL_BUILD
+/**
+ * soc_clk_dump_timing() - Print clock setup timing
+ *
+ * Implementation for the 'clk dump -t' command.
+ */
+void soc_clk_dump_timing(void)
+{
+	printf("PLL relocks: %lu, waiting %lu us for lock\n",
+	       rockchip_clk_stats.pll_relocks, rockchip_clk_stats.pll_lock_us);
+	if (CONFIG_IS_ENABLED(ROCKCHIP_CLK_RATE_CACHE))
+		printf("Rate cache: %lu hits, %lu misses\n",
+		       rockchip_clk_stats.rate_hits,
+		       rockchip_clk_stats.rate_misses);
+}
+#endif
@@ -363,7 +363,8 @@ static uint32_t rkclk_pll_get_rate(u32 *pll_con)
 	}
 }
 
-static void rkclk_set_pll(u32 *pll_con, const struct pll_div *div)
+/* Program a PLL and leave it in slow mode, see rkclk_finish_pll() */
+static void rkclk_start_pll(u32 *pll_con, const struct pll_div *div)
 {
 	/* All 8 PLLs have same VCO and output frequency range restrictions. */
 	u32 vco_khz = OSC_HZ / 1000 * div->fbdiv / div->refdiv;
@@ -396,7 +397,10 @@ static void rkclk_set_pll(u32 *pll_con, const struct pll_div *div)
 		     (div->postdiv2 << PLL_POSTDIV2_SHIFT) |
 		     (div->postdiv1 << PLL_POSTDIV1_SHIFT) |
 		     (div->refdiv << PLL_REFDIV_SHIFT));
+}
 
+static void rkclk_finish_pll(u32 *pll_con)
+{
 	/* waiting for pll lock */
 	while (!(readl(&pll_con[2]) & (1 << PLL_LOCK_STATUS_SHIFT)))
 		udelay(1);
@@ -404,6 +408,13 @@ static void rkclk_set_pll(u32 *pll_con, const struct pll_div *div)
 	/* pll enter normal mode */
 	rk_clrsetreg(&pll_con[3], PLL_MODE_MASK,
 		     PLL_MODE_NORM << PLL_MODE_SHIFT);
+	rockchip_clk_cache_invalidate();
+}
+
+static void rkclk_set_pll(u32 *pll_con, const struct pll_div *div)
+{
+	rkclk_start_pll(pll_con, div);
+	rkclk_finish_pll(pll_con);
 }
 
 static ulong rk3399_pll_get_rate(struct rk3399_clk_priv *priv,
@@ -1134,7 +1145,7 @@ static ulong rk3399_alive_get_clk(struct rk3399_clk_priv *priv)
 }
 #endif
 
-static ulong rk3399_clk_get_rate(struct clk *clk)
+static ulong rk3399_clk_read_rate(struct clk *clk)
 {
 	struct rk3399_clk_priv *priv = dev_get_priv(clk->dev);
 	ulong rate = 0;
@@ -1211,11 +1222,27 @@ static ulong rk3399_clk_get_rate(struct clk *clk)
 	return rate;
 }
 
+static ulong rk3399_clk_get_rate(struct clk *clk)
+{
+	struct rk3399_clk_priv *priv = dev_get_priv(clk->dev);
+	ulong rate;
+
+	if (!rockchip_clk_cache_get(priv->rate_cache, clk->id, &rate))
+		return rate;
+
+	rate = rk3399_clk_read_rate(clk);
+	rockchip_clk_cache_put(priv->rate_cache, clk->id, rate);
+
+	return rate;
+}
+
 static ulong rk3399_clk_set_rate(struct clk *clk, ulong rate)
 {
 	struct rk3399_clk_priv *priv = dev_get_priv(clk->dev);
 	ulong ret = 0;
 
+	rockchip_clk_cache_invalidate();
+
 	switch (clk->id) {
 	case 0 ... 63:
 		return 0;
@@ -1350,6 +1377,7 @@ static int __maybe_unused rk3399_dclk_vop_set_parent(struct clk *clk,
 
 static int __maybe_unused rk3399_clk_set_parent(struct clk *clk, struct clk *parent)
 {
+	rockchip_clk_cache_invalidate();
 	switch (clk->id) {
 	case SCLK_RMII_SRC:
 		return rk3399_gmac_set_parent(clk, parent);
@@ -1396,6 +1424,7 @@ static void rkclk_init(struct rk3399_cru *cru)
 	u32 aclk_div;
 	u32 hclk_div;
 	u32 pclk_div;
+	bool npll;
 
 	rk3399_configure_cpu(cru, APLL_816_MHZ, CPU_CLUSTER_LITTLE);
 	rk3399_configure_cpu(cru, APLL_816_MHZ, CPU_CLUSTER_BIG);
@@ -1408,12 +1437,18 @@ static void rkclk_init(struct rk3399_cru *cru)
 	 * some cru registers changed by bootrom, we'd better reset them to
 	 * reset/default values described in TRM to avoid confusion in kernel.
 	 * Please consider these three lines as a fix of bootrom bug.
+	 *
+	 * NPLL feeds nothing set up here, so it locks while GPLL is set up.
 	 */
-	if (rkclk_pll_get_rate(&cru->npll_con[0]) != NPLL_HZ)
-		rkclk_set_pll(&cru->npll_con[0], &npll_init_cfg);
+	npll = rkclk_pll_get_rate(&cru->npll_con[0]) != NPLL_HZ;
+	if (npll)
+		rkclk_start_pll(&cru->npll_con[0], &npll_init_cfg);
 
-	if (rkclk_pll_get_rate(&cru->gpll_con[0]) == GPLL_HZ)
+	if (rkclk_pll_get_rate(&cru->gpll_con[0]) == GPLL_HZ) {
+		if (npll)
+			rkclk_finish_pll(&cru->npll_con[0]);
 		return;
+	}
 
 	rk_clrsetreg(&cru->clksel_con[12], 0xffff, 0x4101);
 	rk_clrsetreg(&cru->clksel_con[19], 0xffff, 0x033f);
@@ -1500,7 +1535,10 @@ static void rkclk_init(struct rk3399_cru *cru)
 	rk_clrsetreg(&cru->clksel_con[63], I2C_CLK_REG_MASK(7),
 		     I2C_CLK_REG_VALUE(7, 4));
 
-	rkclk_set_pll(&cru->gpll_con[0], &gpll_init_cfg);
+	rkclk_start_pll(&cru->gpll_con[0], &gpll_init_cfg);
+	if (npll)
+		rkclk_finish_pll(&cru->npll_con[0]);
+	rkclk_finish_pll(&cru->gpll_con[0]);
 }
 
 static int rk3399_clk_probe(struct udevice *dev)
@@ -1513,6 +1551,7 @@ static int rk3399_clk_probe(struct udevice *dev)
 	priv->cru = map_sysmem(plat->dtd.reg[0], plat->dtd.reg[1]);
 #endif
 
+	priv->rate_cache = rockchip_clk_cache_alloc();
 	priv->sync_kernel = false;
 	if (!priv->armlclk_enter_hz)
 		priv->armlclk_enter_hz =
@@ -1661,7 +1700,7 @@ static ulong rk3399_pwm_get_clk(struct rk3399_pmucru *pmucru)
 	return DIV_TO_RATE(PPLL_HZ, div);
 }
 
-static ulong rk3399_pmuclk_get_rate(struct clk *clk)
+static ulong rk3399_pmuclk_read_rate(struct clk *clk)
 {
 	struct rk3399_pmuclk_priv *priv = dev_get_priv(clk->dev);
 	ulong rate = 0;
@@ -1686,11 +1725,27 @@ static ulong rk3399_pmuclk_get_rate(struct clk *clk)
 	return rate;
 }
 
+static ulong rk3399_pmuclk_get_rate(struct clk *clk)
+{
+	struct rk3399_pmuclk_priv *priv = dev_get_priv(clk->dev);
+	ulong rate;
+
+	if (!rockchip_clk_cache_get(priv->rate_cache, clk->id, &rate))
+		return rate;
+
+	rate = rk3399_pmuclk_read_rate(clk);
+	rockchip_clk_cache_put(priv->rate_cache, clk->id, rate);
+
+	return rate;
+}
+
 static ulong rk3399_pmuclk_set_rate(struct clk *clk, ulong rate)
 {
 	struct rk3399_pmuclk_priv *priv = dev_get_priv(clk->dev);
 	ulong ret = 0;
 
+	rockchip_clk_cache_invalidate();
+
 	switch (clk->id) {
 	case SCLK_I2C0_PMU:
 	case SCLK_I2C4_PMU:
@@ -1727,9 +1782,7 @@ static void pmuclk_init(struct rk3399_pmucru *pmucru)
 
 static int rk3399_pmuclk_probe(struct udevice *dev)
 {
-#if CONFIG_IS_ENABLED(OF_PLATDATA) || !defined(CONFIG_SPL_BUILD)
 	struct rk3399_pmuclk_priv *priv = dev_get_priv(dev);
-#endif
 
 #if CONFIG_IS_ENABLED(OF_PLATDATA)
 	struct rk3399_pmuclk_plat *plat = dev_get_platdata(dev);
@@ -1737,6 +1790,7 @@ static int rk3399_pmuclk_probe(struct udevice *dev)
 	priv->pmucru = map_sysmem(plat->dtd.reg[0], plat->dtd.reg[1]);
 #endif
 
+	priv->rate_cache = rockchip_clk_cache_alloc();
 #ifndef CONFIG_SPL_BUILD
 	pmuclk_init(priv->pmucru);
 #endif
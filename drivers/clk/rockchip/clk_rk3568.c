@@ -365,7 +365,7 @@ static ulong rk3568_pmu_set_pmuclk(struct rk3568_pmuclk_priv *priv,
 	return rk3568_pmu_get_pmuclk(priv);
 }
 
-static ulong rk3568_pmuclk_get_rate(struct clk *clk)
+static ulong rk3568_pmuclk_read_rate(struct clk *clk)
 {
 	struct rk3568_pmuclk_priv *priv = dev_get_priv(clk->dev);
 	ulong rate = 0;
@@ -405,6 +405,20 @@ static ulong rk3568_pmuclk_get_rate(struct clk *clk)
 	return rate;
 }
 
+static ulong rk3568_pmuclk_get_rate(struct clk *clk)
+{
+	struct rk3568_pmuclk_priv *priv = dev_get_priv(clk->dev);
+	ulong rate;
+
+	if (!rockchip_clk_cache_get(priv->rate_cache, clk->id, &rate))
+		return rate;
+
+	rate = rk3568_pmuclk_read_rate(clk);
+	rockchip_clk_cache_put(priv->rate_cache, clk->id, rate);
+
+	return rate;
+}
+
 static ulong rk3568_pmuclk_set_rate(struct clk *clk, ulong rate)
 {
 	struct rk3568_pmuclk_priv *priv = dev_get_priv(clk->dev);
@@ -415,6 +429,8 @@ static ulong rk3568_pmuclk_set_rate(struct clk *clk, ulong rate)
 		return -ENOENT;
 	}
 
+	rockchip_clk_cache_invalidate();
+
 	debug("%s %ld %ld\n", __func__, clk->id, rate);
 	switch (clk->id) {
 	case PLL_PPLL:
@@ -466,6 +482,7 @@ static int rk3568_rtc32k_set_parent(struct clk *clk, struct clk *parent)
 
 static int rk3568_pmuclk_set_parent(struct clk *clk, struct clk *parent)
 {
+	rockchip_clk_cache_invalidate();
 	switch (clk->id) {
 	case CLK_RTC_32K:
 		return rk3568_rtc32k_set_parent(clk, parent);
@@ -485,6 +502,7 @@ static int rk3568_pmuclk_probe(struct udevice *dev)
 	struct rk3568_pmuclk_priv *priv = dev_get_priv(dev);
 	int ret = 0;
 
+	priv->rate_cache = rockchip_clk_cache_alloc();
 	if (priv->ppll_hz != PPLL_HZ) {
 		ret = rockchip_pll_set_rate(&rk3568_pll_clks[PPLL],
 					    priv->pmucru,
@@ -2291,7 +2309,7 @@ static ulong rk3568_uart_set_rate(struct rk3568_clk_priv *priv,
 }
 #endif
 
-static ulong rk3568_clk_get_rate(struct clk *clk)
+static ulong rk3568_clk_read_rate(struct clk *clk)
 {
 	struct rk3568_clk_priv *priv = dev_get_priv(clk->dev);
 	ulong rate = 0;
@@ -2460,6 +2478,20 @@ static ulong rk3568_clk_get_rate(struct clk *clk)
 	return rate;
 };
 
+static ulong rk3568_clk_get_rate(struct clk *clk)
+{
+	struct rk3568_clk_priv *priv = dev_get_priv(clk->dev);
+	ulong rate;
+
+	if (!rockchip_clk_cache_get(priv->rate_cache, clk->id, &rate))
+		return rate;
+
+	rate = rk3568_clk_read_rate(clk);
+	rockchip_clk_cache_put(priv->rate_cache, clk->id, rate);
+
+	return rate;
+}
+
 static ulong rk3568_clk_set_rate(struct clk *clk, ulong rate)
 {
 	struct rk3568_clk_priv *priv = dev_get_priv(clk->dev);
@@ -2470,6 +2502,8 @@ static ulong rk3568_clk_set_rate(struct clk *clk, ulong rate)
 		return -ENOENT;
 	}
 
+	rockchip_clk_cache_invalidate();
+
 	switch (clk->id) {
 	case PLL_APLL:
 	case ARMCLK:
@@ -2914,6 +2948,7 @@ static int __maybe_unused rk3568_rkvdec_set_parent(struct clk *clk,
 
 static int rk3568_clk_set_parent(struct clk *clk, struct clk *parent)
 {
+	rockchip_clk_cache_invalidate();
 	switch (clk->id) {
 	case SCLK_GMAC0:
 		return rk3568_gmac0_src_set_parent(clk, parent);
@@ -2950,7 +2985,8 @@ static struct clk_ops rk3568_clk_ops = {
 
 static void rk3568_clk_init(struct rk3568_clk_priv *priv)
 {
-	int ret;
+	struct rockchip_pll_set plls[2];
+	int ret, n = 0;
 
 	priv->sync_kernel = false;
 	if (!priv->armclk_enter_hz) {
@@ -2965,16 +3001,21 @@ static void rk3568_clk_init(struct rk3568_clk_priv *priv)
 		if (!ret)
 			priv->armclk_init_hz = APLL_HZ;
 	}
-	if (priv->cpll_hz != CPLL_HZ) {
-		ret = rockchip_pll_set_rate(&rk3568_pll_clks[CPLL], priv->cru,
-					    CPLL, CPLL_HZ);
-		if (!ret)
+
+	/* CPLL and GPLL lock together */
+	if (priv->cpll_hz != CPLL_HZ)
+		plls[n++] = (struct rockchip_pll_set) {
+			&rk3568_pll_clks[CPLL], priv->cru, CPLL, CPLL_HZ };
+	if (priv->gpll_hz != GPLL_HZ)
+		plls[n++] = (struct rockchip_pll_set) {
+			&rk3568_pll_clks[GPLL], priv->cru, GPLL, GPLL_HZ };
+	rockchip_pll_set_rates(plls, n);
+	while (n--) {
+		if (plls[n].ret)
+			continue;
+		if (plls[n].pll_id == CPLL)
 			priv->cpll_hz = CPLL_HZ;
-	}
-	if (priv->gpll_hz != GPLL_HZ) {
-		ret = rockchip_pll_set_rate(&rk3568_pll_clks[GPLL], priv->cru,
-					    GPLL, GPLL_HZ);
-		if (!ret)
+		else
 			priv->gpll_hz = GPLL_HZ;
 	}
 
@@ -2997,6 +3038,7 @@ static int rk3568_clk_probe(struct udevice *dev)
 	if (IS_ERR(priv->grf))
 		return PTR_ERR(priv->grf);
 
+	priv->rate_cache = rockchip_clk_cache_alloc();
 	rk3568_clk_init(priv);
 
 	/* Process 'assigned-{clocks/clock-parents/clock-rates}' properties */
@@ -22,6 +22,7 @@
 
 #include <common.h>
 #include <linux/libfdt.h>
+#include <of_live.h>
 #include <dm/of_access.h>
 #include <linux/ctype.h>
 #include <linux/err.h>
@@ -384,9 +385,12 @@ struct device_node *of_find_node_by_phandle(phandle handle)
 	if (!handle)
 		return NULL;
 
-	for_each_of_allnodes(np)
-		if (np->phandle == handle)
-			break;
+	np = of_live_find_node_by_phandle(gd->of_root, handle);
+	if (IS_ERR(np)) {
+		for_each_of_allnodes(np)
+			if (np->phandle == handle)
+				break;
+	}
 	(void)of_node_get(np);
 
 	return np;
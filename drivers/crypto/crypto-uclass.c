@@ -261,6 +261,74 @@ int crypto_rsa_verify(struct udevice *dev, rsa_key *ctx, u8 *sign, u8 *output)
 	return ops->rsa_verify(dev, ctx, sign, output);
 }
 
+u32 crypto_rsa_algo(u32 n_bits)
+{
+	switch (n_bits) {
+	case 512:
+		return CRYPTO_RSA512;
+	case 1024:
+		return CRYPTO_RSA1024;
+	case 2048:
+		return CRYPTO_RSA2048;
+	case 3072:
+		return CRYPTO_RSA3072;
+	case 4096:
+		return CRYPTO_RSA4096;
+	}
+
+	return 0;
+}
+
+/* Crypto drivers take little-endian factors */
+static void crypto_rsa_reverse(u8 *dst, const u8 *src, u32 len)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		dst[len - 1 - i] = src[i];
+}
+
+int crypto_rsa_verify_be(u32 n_bits, const u8 *n, const u8 *e, const u8 *c,
+			 const u8 *sign, u8 *output)
+{
+	u32 algo = crypto_rsa_algo(n_bits);
+	u32 len = BITS2BYTE(n_bits);
+	struct udevice *dev;
+	rsa_key rsa_key;
+	u8 *buf;
+	int ret;
+
+	if (!algo || !n || !e || !sign || !output)
+		return -EINVAL;
+
+	dev = crypto_get_device(algo);
+	if (!dev)
+		return -ENODEV;
+
+	/* n, e, c, sign and result */
+	buf = memalign(ARCH_DMA_MINALIGN, len * 5);
+	if (!buf)
+		return -ENOMEM;
+
+	rsa_key.algo = algo;
+	rsa_key.n = (u32 *)buf;
+	rsa_key.e = (u32 *)(buf + len);
+	rsa_key.c = c ? (u32 *)(buf + len * 2) : NULL;
+	crypto_rsa_reverse(buf, n, len);
+	crypto_rsa_reverse(buf + len, e, len);
+	if (c)
+		crypto_rsa_reverse(buf + len * 2, c, len);
+	crypto_rsa_reverse(buf + len * 3, sign, len);
+
+	ret = crypto_rsa_verify(dev, &rsa_key, buf + len * 3, buf + len * 4);
+	if (!ret)
+		crypto_rsa_reverse(output, buf + len * 4, len);
+
+	free(buf);
+
+	return ret;
+}
+
 int crypto_cipher(struct udevice *dev, cipher_context *ctx,
 		  const u8 *in, u8 *out, u32 len, bool enc)
 {
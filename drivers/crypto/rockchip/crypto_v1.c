@@ -216,7 +216,8 @@ static int rockchip_crypto_rsa_verify(struct udevice *dev, rsa_key *ctx,
 	u32 nbits, *buf = (u32 *)output;
 	int i, value;
 
-	if (!ctx)
+	/* There is no way to calculate the factor c on v1 */
+	if (!ctx || !ctx->c)
 		return -EINVAL;
 
 	if (ctx->algo == CRYPTO_RSA512)
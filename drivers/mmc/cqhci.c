@@ -0,0 +1,268 @@
+/*
+ * eMMC Command Queue Host Controller Interface (CQHCI)
+ *
+ * Polled implementation: a batch of tasks is queued through the doorbell
+ * and the task completion notification register is polled until all of
+ * them are done. Direct commands (DCMD) are not used, the engine is
+ * turned off before any other command is sent and the card only leaves
+ * command queue mode for a command it does not accept there.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <cqhci.h>
+#include <errno.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <mmc.h>
+
+#define CQHCI_HALT_TIMEOUT	100	/* ms */
+#define CQHCI_TASK_TIMEOUT	10000	/* ms, for a whole batch */
+
+static u8 *cqhci_link_desc(struct cqhci_host *cq_host, int tag)
+{
+	return cq_host->desc_base + tag * cq_host->slot_sz +
+	       cq_host->task_desc_len;
+}
+
+static u8 *cqhci_trans_desc(struct cqhci_host *cq_host, int tag)
+{
+	return cq_host->trans_base + tag * cq_host->trans_area_sz;
+}
+
+/* Transfer and link descriptors share the ADMA2 layout */
+static void cqhci_set_desc(struct cqhci_host *cq_host, u8 *desc, u32 attr,
+			   ulong addr)
+{
+	u32 *word = (u32 *)desc;
+
+	word[0] = cpu_to_le32(attr);
+	word[1] = cpu_to_le32(lower_32_bits(addr));
+	if (cq_host->dma64) {
+		word[2] = cpu_to_le32(upper_32_bits(addr));
+		word[3] = 0;
+	}
+}
+
+static int cqhci_halt(struct cqhci_host *cq_host)
+{
+	ulong start = get_timer(0);
+
+	cqhci_writel(cq_host, CQHCI_HALT, CQHCI_CTL);
+	while (!(cqhci_readl(cq_host, CQHCI_CTL) & CQHCI_HALT)) {
+		if (get_timer(start) > CQHCI_HALT_TIMEOUT) {
+			debug("%s: Timeout waiting for halt\n", __func__);
+			return -ETIMEDOUT;
+		}
+	}
+
+	return 0;
+}
+
+/* Drop every queued task after an error; the engine must be halted */
+static void cqhci_clear_tasks(struct cqhci_host *cq_host)
+{
+	ulong start = get_timer(0);
+
+	cqhci_writel(cq_host, CQHCI_CLEAR_ALL_TASKS, CQHCI_CTL);
+	while (cqhci_readl(cq_host, CQHCI_TDBR)) {
+		if (get_timer(start) > CQHCI_HALT_TIMEOUT) {
+			debug("%s: Timeout clearing tasks\n", __func__);
+			break;
+		}
+	}
+}
+
+static int cqhci_prep_task(struct cqhci_host *cq_host, int tag,
+			   struct mmc_data *data)
+{
+	u64 *task = (u64 *)(cq_host->desc_base + tag * cq_host->slot_sz);
+	u8 *desc = cqhci_trans_desc(cq_host, tag);
+	bool read = data->flags == MMC_DATA_READ;
+	ulong addr = (ulong)data->dest;
+	ulong len = data->blocks * data->blocksize;
+	ulong chunk;
+	u32 attr;
+	int n;
+
+	if (!IS_ALIGNED(addr, ARCH_DMA_MINALIGN) ||
+	    data->blocksize != MMC_MAX_BLOCK_LEN || data->blocks > 0xffff ||
+	    (!cq_host->dma64 && upper_32_bits((u64)addr + len - 1)))
+		return -EINVAL;
+
+	for (n = 0; len; n++) {
+		if (n == CQHCI_TRAN_DESC_NUM)
+			return -EINVAL;
+
+		chunk = min(len, CQHCI_SEG_LEN - (addr & (CQHCI_SEG_LEN - 1)));
+		attr = CQHCI_VALID(1) | CQHCI_END(chunk == len) |
+		       CQHCI_ACT(CQHCI_ACT_TRAN) | CQHCI_DAT_LENGTH(chunk);
+		cqhci_set_desc(cq_host, desc + n * cq_host->trans_desc_len,
+			       attr, addr);
+		addr += chunk;
+		len -= chunk;
+	}
+	flush_dcache_range((ulong)desc,
+			   (ulong)desc + ALIGN(n * cq_host->trans_desc_len,
+					       ARCH_DMA_MINALIGN));
+
+	addr = (ulong)data->dest;
+	len = data->blocks * data->blocksize;
+	flush_dcache_range(addr, addr + ALIGN(len, ARCH_DMA_MINALIGN));
+
+	*task = cpu_to_le64(CQHCI_VALID(1) | CQHCI_END(1) | CQHCI_INT(1) |
+			    CQHCI_ACT(CQHCI_ACT_TASK) | CQHCI_DATA_DIR(read) |
+			    CQHCI_BLK_COUNT(data->blocks) |
+			    CQHCI_BLK_ADDR(data->blk_addr));
+
+	return 0;
+}
+
+int cqhci_request(struct cqhci_host *cq_host, struct mmc_data *data,
+		  int count)
+{
+	u32 mask = 0, is, tcn;
+	ulong start, addr;
+	int tag, ret;
+
+	if (!cq_host->enabled || count > CQHCI_NUM_SLOTS)
+		return -EINVAL;
+
+	for (tag = 0; tag < count; tag++) {
+		ret = cqhci_prep_task(cq_host, tag, &data[tag]);
+		if (ret)
+			return ret;
+		mask |= BIT(tag);
+	}
+	flush_dcache_range((ulong)cq_host->desc_base,
+			   (ulong)cq_host->desc_base +
+			   ALIGN(count * cq_host->slot_sz, ARCH_DMA_MINALIGN));
+
+	cqhci_writel(cq_host, mask, CQHCI_TDBR);
+
+	start = get_timer(0);
+	ret = 0;
+	do {
+		is = cqhci_readl(cq_host, CQHCI_IS);
+		tcn = cqhci_readl(cq_host, CQHCI_TCN);
+		if (is & CQHCI_IS_ERROR) {
+			printf("%s: Task error, status 0x%x, TERRI 0x%x\n",
+			       __func__, is,
+			       cqhci_readl(cq_host, CQHCI_TERRI));
+			ret = -EIO;
+			break;
+		}
+		if (get_timer(start) > CQHCI_TASK_TIMEOUT) {
+			printf("%s: Timeout, 0x%x of 0x%x done\n", __func__,
+			       tcn, mask);
+			ret = -ETIMEDOUT;
+			break;
+		}
+	} while ((tcn & mask) != mask);
+
+	if (ret) {
+		cqhci_halt(cq_host);
+		cqhci_clear_tasks(cq_host);
+		cq_host->recovery = true;
+	}
+	cqhci_writel(cq_host, tcn, CQHCI_TCN);
+	cqhci_writel(cq_host, is, CQHCI_IS);
+	if (ret)
+		return ret;
+
+	for (tag = 0; tag < count; tag++) {
+		if (data[tag].flags != MMC_DATA_READ)
+			continue;
+		addr = (ulong)data[tag].dest;
+		invalidate_dcache_range(addr, addr +
+					ALIGN(data[tag].blocks *
+					      data[tag].blocksize,
+					      ARCH_DMA_MINALIGN));
+	}
+
+	return 0;
+}
+
+int cqhci_enable(struct cqhci_host *cq_host, bool enable)
+{
+	u32 cfg;
+
+	if (enable == cq_host->enabled)
+		return 0;
+
+	cfg = cqhci_readl(cq_host, CQHCI_CFG);
+	if (!enable) {
+		cqhci_halt(cq_host);
+		cqhci_writel(cq_host, cfg & ~CQHCI_ENABLE, CQHCI_CFG);
+		cq_host->ops->disable(cq_host, cq_host->recovery);
+		cq_host->recovery = false;
+		cq_host->enabled = false;
+		return 0;
+	}
+
+	if (cfg & CQHCI_ENABLE)
+		cqhci_writel(cq_host, cfg & ~CQHCI_ENABLE, CQHCI_CFG);
+	/* 64-bit task descriptors, no direct commands */
+	cfg &= ~(CQHCI_DCMD | CQHCI_TASK_DESC_SZ | CQHCI_ENABLE);
+	cqhci_writel(cq_host, cfg, CQHCI_CFG);
+
+	cqhci_writel(cq_host, lower_32_bits((ulong)cq_host->desc_base),
+		     CQHCI_TDLBA);
+	cqhci_writel(cq_host, upper_32_bits((ulong)cq_host->desc_base),
+		     CQHCI_TDLBAU);
+	cqhci_writel(cq_host, cq_host->mmc->rca, CQHCI_SSC2);
+
+	/* Polled: latch status, never signal */
+	cqhci_writel(cq_host, 0, CQHCI_ISGE);
+	cqhci_writel(cq_host, CQHCI_IS_MASK, CQHCI_ISTE);
+	cqhci_writel(cq_host, cqhci_readl(cq_host, CQHCI_IS), CQHCI_IS);
+
+	cqhci_writel(cq_host, cfg | CQHCI_ENABLE, CQHCI_CFG);
+	if (cqhci_readl(cq_host, CQHCI_CTL) & CQHCI_HALT)
+		cqhci_writel(cq_host, 0, CQHCI_CTL);
+
+	cq_host->ops->enable(cq_host);
+	cq_host->enabled = true;
+
+	return 0;
+}
+
+int cqhci_init(struct cqhci_host *cq_host, struct mmc_config *cfg)
+{
+	unsigned int desc_sz;
+	int tag;
+
+	cq_host->task_desc_len = 8;
+	cq_host->link_desc_len = cq_host->dma64 ? 16 : 8;
+	cq_host->trans_desc_len = cq_host->dma64 ? 16 : 8;
+	cq_host->slot_sz = cq_host->task_desc_len + cq_host->link_desc_len;
+	cq_host->trans_area_sz = ALIGN(CQHCI_TRAN_DESC_NUM *
+				       cq_host->trans_desc_len,
+				       ARCH_DMA_MINALIGN);
+
+	desc_sz = ALIGN(CQHCI_NUM_SLOTS * cq_host->slot_sz, ARCH_DMA_MINALIGN);
+	cq_host->desc_base = memalign(ARCH_DMA_MINALIGN, desc_sz);
+	cq_host->trans_base = memalign(ARCH_DMA_MINALIGN, CQHCI_NUM_SLOTS *
+				       cq_host->trans_area_sz);
+	if (!cq_host->desc_base || !cq_host->trans_base) {
+		free(cq_host->desc_base);
+		free(cq_host->trans_base);
+		return -ENOMEM;
+	}
+
+	/* Each slot links to its own list of transfer descriptors */
+	memset(cq_host->desc_base, 0, desc_sz);
+	for (tag = 0; tag < CQHCI_NUM_SLOTS; tag++)
+		cqhci_set_desc(cq_host, cqhci_link_desc(cq_host, tag),
+			       CQHCI_VALID(1) | CQHCI_ACT(CQHCI_ACT_LINK),
+			       (ulong)cqhci_trans_desc(cq_host, tag));
+	flush_dcache_range((ulong)cq_host->desc_base,
+			   (ulong)cq_host->desc_base + desc_sz);
+
+	cfg->cqe_depth = CQHCI_NUM_SLOTS;
+	cfg->cqe_b_max = (CQHCI_TRAN_DESC_NUM - 1) * CQHCI_SEG_LEN /
+			 MMC_MAX_BLOCK_LEN;
+
+	return 0;
+}
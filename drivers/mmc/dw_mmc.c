@@ -18,8 +18,6 @@
 #include <asm-generic/gpio.h>
 #endif
 
-#define PAGE_SIZE 4096
-
 /*
  * Currently it supports read/write up to 8*8*4 Bytes per
  * stride as a burst mode. Please note that if you change
@@ -107,17 +105,27 @@ static void dwmci_set_idma_desc(struct dwmci_idmac *idmac,
 	desc->next_addr = (ulong)desc + sizeof(struct dwmci_idmac);
 }
 
+/* Number of IDMAC descriptors needed to map @data */
+static unsigned int dwmci_idmac_num(struct mmc_data *data)
+{
+	unsigned int blks = DWMCI_IDMAC_MAX_LEN / data->blocksize;
+
+	return DIV_ROUND_UP(data->blocks, blks);
+}
+
 static void dwmci_prepare_data(struct dwmci_host *host,
 			       struct mmc_data *data,
 			       struct dwmci_idmac *cur_idmac,
 			       void *bounce_buffer)
 {
 	unsigned long ctrl;
-	unsigned int i = 0, flags, cnt, blk_cnt;
+	unsigned int i = 0, flags, cnt, blk_cnt, desc_blks, desc_len;
 	ulong data_start, data_end;
 
-
 	blk_cnt = data->blocks;
+	/* Each descriptor maps as many whole blocks as buffer 1 can hold */
+	desc_blks = DWMCI_IDMAC_MAX_LEN / data->blocksize;
+	desc_len = desc_blks * data->blocksize;
 
 	dwmci_wait_reset(host, DWMCI_CTRL_FIFO_RESET);
 
@@ -127,18 +135,18 @@ static void dwmci_prepare_data(struct dwmci_host *host,
 	do {
 		flags = DWMCI_IDMAC_OWN | DWMCI_IDMAC_CH ;
 		flags |= (i == 0) ? DWMCI_IDMAC_FS : 0;
-		if (blk_cnt <= 8) {
+		if (blk_cnt <= desc_blks) {
 			flags |= DWMCI_IDMAC_LD;
 			cnt = data->blocksize * blk_cnt;
 		} else
-			cnt = data->blocksize * 8;
+			cnt = desc_len;
 
 		dwmci_set_idma_desc(cur_idmac, flags, cnt,
-				    (ulong)bounce_buffer + (i * PAGE_SIZE));
+				    (ulong)bounce_buffer + (i * desc_len));
 
-		if (blk_cnt <= 8)
+		if (blk_cnt <= desc_blks)
 			break;
-		blk_cnt -= 8;
+		blk_cnt -= desc_blks;
 		cur_idmac++;
 		i++;
 	} while(1);
@@ -172,11 +180,34 @@ static unsigned int dwmci_get_timeout(struct mmc *mmc, const unsigned int size)
 	return timeout;
 }
 
+/* Recover the controller after a data error */
+static void dwmci_data_reset(struct dwmci_host *host)
+{
+	int reset_timeout = 100;
+	u32 status, ctrl;
+
+	dwmci_wait_reset(host, DWMCI_RESET_ALL);
+	dwmci_writel(host, DWMCI_CMD, DWMCI_CMD_PRV_DAT_WAIT |
+		     DWMCI_CMD_UPD_CLK | DWMCI_CMD_START);
+
+	do {
+		status = dwmci_readl(host, DWMCI_CMD);
+		if (reset_timeout-- < 0)
+			break;
+		udelay(100);
+	} while (status & DWMCI_CMD_START);
+
+	if (!host->fifo_mode) {
+		ctrl = dwmci_readl(host, DWMCI_BMOD);
+		ctrl |= DWMCI_BMOD_IDMAC_RESET;
+		dwmci_writel(host, DWMCI_BMOD, ctrl);
+	}
+}
+
 static int dwmci_data_transfer(struct dwmci_host *host, struct mmc_data *data)
 {
 	int ret = 0;
-	int reset_timeout = 100;
-	u32 timeout, status, ctrl, mask, size, i, len = 0;
+	u32 timeout, mask, size, i, len = 0;
 	u32 *buf = NULL;
 	ulong start = get_timer(0);
 	u32 fifo_depth = (((host->fifoth_val & RX_WMARK_MASK) >>
@@ -199,23 +230,7 @@ static int dwmci_data_transfer(struct dwmci_host *host, struct mmc_data *data)
 		/* Error during data transfer. */
 		if (mask & (DWMCI_DATA_ERR | DWMCI_DATA_TOUT)) {
 			debug("%s: DATA ERROR!\n", __func__);
-			dwmci_wait_reset(host, DWMCI_RESET_ALL);
-			dwmci_writel(host, DWMCI_CMD, DWMCI_CMD_PRV_DAT_WAIT |
-				     DWMCI_CMD_UPD_CLK | DWMCI_CMD_START);
-
-			do {
-				status = dwmci_readl(host, DWMCI_CMD);
-				if (reset_timeout-- < 0)
-					break;
-				udelay(100);
-			} while (status & DWMCI_CMD_START);
-
-			if (!host->fifo_mode) {
-				ctrl = dwmci_readl(host, DWMCI_BMOD);
-				ctrl |= DWMCI_BMOD_IDMAC_RESET;
-				dwmci_writel(host, DWMCI_BMOD, ctrl);
-			}
-
+			dwmci_data_reset(host);
 			ret = -EINVAL;
 			break;
 		}
@@ -315,25 +330,16 @@ static int dwmci_set_transfer_mode(struct dwmci_host *host,
 	return mode;
 }
 
-#ifdef CONFIG_DM_MMC
-static int dwmci_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
-		   struct mmc_data *data)
-{
-	struct mmc *mmc = mmc_get_mmc_dev(dev);
-#else
-static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
-		struct mmc_data *data)
+static int dwmci_send_cmd_common(struct dwmci_host *host,
+				 struct mmc_cmd *cmd, struct mmc_data *data,
+				 struct dwmci_idmac *cur_idmac,
+				 struct bounce_buffer *bbstate, bool async)
 {
-#endif
-	struct dwmci_host *host = mmc->priv;
-	ALLOC_CACHE_ALIGN_BUFFER(struct dwmci_idmac, cur_idmac,
-				 data ? DIV_ROUND_UP(data->blocks, 8) : 0);
 	int ret = 0, flags = 0, i;
 	unsigned int timeout = 500;
 	u32 retry = 100000;
 	u32 mask, ctrl;
 	ulong start = get_timer(0);
-	struct bounce_buffer bbstate;
 
 	while (dwmci_readl(host, DWMCI_STATUS) & DWMCI_BUSY) {
 		if (get_timer(start) > timeout) {
@@ -352,16 +358,16 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 			dwmci_wait_reset(host, DWMCI_CTRL_FIFO_RESET);
 		} else {
 			if (data->flags == MMC_DATA_READ) {
-				bounce_buffer_start(&bbstate, (void*)data->dest,
+				bounce_buffer_start(bbstate, (void*)data->dest,
 						data->blocksize *
 						data->blocks, GEN_BB_WRITE);
 			} else {
-				bounce_buffer_start(&bbstate, (void*)data->src,
+				bounce_buffer_start(bbstate, (void*)data->src,
 						data->blocksize *
 						data->blocks, GEN_BB_READ);
 			}
 			dwmci_prepare_data(host, data, cur_idmac,
-					   bbstate.bounce_buffer);
+					   bbstate->bounce_buffer);
 		}
 	}
 
@@ -435,6 +441,15 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 		}
 	}
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	if (data && async) {
+		/* dwmci_data_poll() finishes the transfer */
+		host->async_data = data;
+		host->async_start = get_timer(0);
+		return 0;
+	}
+#endif
+
 	if (data) {
 		ret = dwmci_data_transfer(host, data);
 
@@ -443,7 +458,7 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 			ctrl = dwmci_readl(host, DWMCI_CTRL);
 			ctrl &= ~(DWMCI_DMA_EN);
 			dwmci_writel(host, DWMCI_CTRL, ctrl);
-			bounce_buffer_stop(&bbstate);
+			bounce_buffer_stop(bbstate);
 		}
 	}
 
@@ -452,130 +467,85 @@ static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 	return ret;
 }
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
 #ifdef CONFIG_DM_MMC
-static int dwmci_send_cmd_prepare(struct udevice *dev, struct mmc_cmd *cmd,
-				  struct mmc_data *data)
+static int dwmci_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
+		   struct mmc_data *data)
 {
 	struct mmc *mmc = mmc_get_mmc_dev(dev);
 #else
-static int dwmci_send_cmd_prepare(struct mmc *mmc, struct mmc_cmd *cmd,
-				  struct mmc_data *data)
+static int dwmci_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
+		struct mmc_data *data)
 {
 #endif
 	struct dwmci_host *host = mmc->priv;
-	struct dwmci_idmac *cur_idmac;
-	int ret = 0, flags = 0, i;
-	unsigned int timeout = 500;
-	u32 retry = 100000;
-	u32 mask;
-	ulong start = get_timer(0);
+	unsigned int num = data ? dwmci_idmac_num(data) : 0;
+	bool pool = num <= host->idmac_num;
+	/* Only used when the descriptor pool is missing or too small */
+	ALLOC_CACHE_ALIGN_BUFFER(struct dwmci_idmac, stack_idmac,
+				 pool ? 0 : num);
 	struct bounce_buffer bbstate;
 
-	cur_idmac = malloc(ROUND(DIV_ROUND_UP(data->blocks, 8) *
-			   sizeof(struct dwmci_idmac),
-			   ARCH_DMA_MINALIGN) + ARCH_DMA_MINALIGN - 1);
-	if (!cur_idmac)
-		return -ENODATA;
-
-	while (dwmci_readl(host, DWMCI_STATUS) & DWMCI_BUSY) {
-		if (get_timer(start) > timeout) {
-			debug("%s: Timeout on data busy\n", __func__);
-			return -ETIMEDOUT;
-		}
-	}
-
-	dwmci_writel(host, DWMCI_RINTSTS, DWMCI_INTMSK_ALL);
-
-	if (data) {
-		if (host->fifo_mode) {
-			dwmci_writel(host, DWMCI_BLKSIZ, data->blocksize);
-			dwmci_writel(host, DWMCI_BYTCNT,
-				     data->blocksize * data->blocks);
-			dwmci_wait_reset(host, DWMCI_CTRL_FIFO_RESET);
-		} else {
-			if (data->flags == MMC_DATA_READ) {
-				bounce_buffer_start(&bbstate, (void *)data->dest,
-						    data->blocksize *
-						    data->blocks, GEN_BB_WRITE);
-			} else {
-				bounce_buffer_start(&bbstate, (void *)data->src,
-						    data->blocksize *
-						    data->blocks, GEN_BB_READ);
-			}
-			dwmci_prepare_data(host, data, cur_idmac,
-					   bbstate.bounce_buffer);
-		}
-	}
-
-	dwmci_writel(host, DWMCI_CMDARG, cmd->cmdarg);
-
-	if (data)
-		flags = dwmci_set_transfer_mode(host, data);
+	return dwmci_send_cmd_common(host, cmd, data,
+				     pool ? host->idmac : stack_idmac,
+				     &bbstate, false);
+}
 
-	if ((cmd->resp_type & MMC_RSP_136) && (cmd->resp_type & MMC_RSP_BUSY))
-		return -1;
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+static int dwmci_send_cmd_submit(struct udevice *dev, struct mmc_cmd *cmd,
+				 struct mmc_data *data)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct dwmci_host *host = mmc->priv;
 
-	if (cmd->cmdidx == MMC_CMD_STOP_TRANSMISSION)
-		flags |= DWMCI_CMD_ABORT_STOP;
-	else
-		flags |= DWMCI_CMD_PRV_DAT_WAIT;
+	host->async_data = NULL;
 
-	if (cmd->resp_type & MMC_RSP_PRESENT) {
-		flags |= DWMCI_CMD_RESP_EXP;
-		if (cmd->resp_type & MMC_RSP_136)
-			flags |= DWMCI_CMD_RESP_LENGTH;
-	}
+	/* Only IDMAC reads mapped by the descriptor pool run in background */
+	if (host->fifo_mode || data->flags != MMC_DATA_READ ||
+	    dwmci_idmac_num(data) > host->idmac_num)
+		return dwmci_send_cmd(dev, cmd, data);
 
-	if (cmd->resp_type & MMC_RSP_CRC)
-		flags |= DWMCI_CMD_CHECK_CRC;
+	host->async_timeout = dwmci_get_timeout(mmc, data->blocksize *
+						data->blocks);
 
-	flags |= (cmd->cmdidx | DWMCI_CMD_START | DWMCI_CMD_USE_HOLD_REG);
+	return dwmci_send_cmd_common(host, cmd, data, host->idmac,
+				     &host->async_bbstate, true);
+}
 
-	debug("Sending CMD%d\n", cmd->cmdidx);
+static int dwmci_data_poll(struct udevice *dev, struct mmc_data *data)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct dwmci_host *host = mmc->priv;
+	u32 mask, ctrl;
+	int ret;
 
-	dwmci_writel(host, DWMCI_CMD, flags);
+	/* Completed by dwmci_send_cmd_submit() */
+	if (host->async_data != data)
+		return 0;
 
-	for (i = 0; i < retry; i++) {
-		mask = dwmci_readl(host, DWMCI_RINTSTS);
-		if (mask & DWMCI_INTMSK_CDONE) {
-			if (!data)
-				dwmci_writel(host, DWMCI_RINTSTS, mask);
-			break;
-		}
+	mask = dwmci_readl(host, DWMCI_RINTSTS);
+	if (mask & (DWMCI_DATA_ERR | DWMCI_DATA_TOUT)) {
+		debug("%s: DATA ERROR!\n", __func__);
+		dwmci_data_reset(host);
+		ret = -EINVAL;
+	} else if (mask & DWMCI_INTMSK_DTO) {
+		ret = 0;
+	} else if (get_timer(host->async_start) > host->async_timeout) {
+		debug("%s: Timeout waiting for data!\n", __func__);
+		dwmci_data_reset(host);
+		ret = -ETIMEDOUT;
+	} else {
+		return -EINPROGRESS;
 	}
 
-	if (i == retry) {
-		debug("%s: Timeout.\n", __func__);
-		return -ETIMEDOUT;
-	}
+	dwmci_writel(host, DWMCI_RINTSTS, mask);
 
-	if (mask & DWMCI_INTMSK_RTO) {
-		/*
-		 * Timeout here is not necessarily fatal. (e)MMC cards
-		 * will splat here when they receive CMD55 as they do
-		 * not support this command and that is exactly the way
-		 * to tell them apart from SD cards. Thus, this output
-		 * below shall be debug(). eMMC cards also do not favor
-		 * CMD8, please keep that in mind.
-		 */
-		debug("%s: Response Timeout.\n", __func__);
-		return -ETIMEDOUT;
-	} else if (mask & DWMCI_INTMSK_RE) {
-		debug("%s: Response Error.\n", __func__);
-		return -EIO;
-	}
+	ctrl = dwmci_readl(host, DWMCI_CTRL);
+	ctrl &= ~(DWMCI_DMA_EN);
+	dwmci_writel(host, DWMCI_CTRL, ctrl);
+	bounce_buffer_stop(&host->async_bbstate);
+	host->async_data = NULL;
 
-	if (cmd->resp_type & MMC_RSP_PRESENT) {
-		if (cmd->resp_type & MMC_RSP_136) {
-			cmd->response[0] = dwmci_readl(host, DWMCI_RESP3);
-			cmd->response[1] = dwmci_readl(host, DWMCI_RESP2);
-			cmd->response[2] = dwmci_readl(host, DWMCI_RESP1);
-			cmd->response[3] = dwmci_readl(host, DWMCI_RESP0);
-		} else {
-			cmd->response[0] = dwmci_readl(host, DWMCI_RESP0);
-		}
-	}
+	udelay(100);
 
 	return ret;
 }
@@ -721,6 +691,22 @@ static int dwmci_set_ios(struct mmc *mmc)
 	return 0;
 }
 
+/*
+ * Allocate descriptors for the largest transfer once, so requests do not
+ * need to build their descriptor chain on the stack. On failure requests
+ * keep using the stack.
+ */
+static void dwmci_alloc_idmac(struct dwmci_host *host, unsigned int b_max)
+{
+	unsigned int num;
+
+	num = DIV_ROUND_UP(b_max, DWMCI_IDMAC_MAX_LEN / MMC_MAX_BLOCK_LEN);
+	host->idmac = memalign(ARCH_DMA_MINALIGN,
+			       ALIGN(num * sizeof(struct dwmci_idmac),
+				     ARCH_DMA_MINALIGN));
+	host->idmac_num = host->idmac ? num : 0;
+}
+
 static int dwmci_init(struct mmc *mmc)
 {
 	struct dwmci_host *host = mmc->priv;
@@ -756,6 +742,9 @@ static int dwmci_init(struct mmc *mmc)
 		host->fifo_mode = 1;
 	}
 
+	if (!host->fifo_mode && !host->idmac)
+		dwmci_alloc_idmac(host, mmc->cfg->b_max);
+
 	/* Enumerate at 400KHz */
 	dwmci_setup_bus(host, mmc->cfg->f_min);
 
@@ -813,8 +802,9 @@ int dwmci_probe(struct udevice *dev)
 const struct dm_mmc_ops dm_dwmci_ops = {
 	.card_busy	= dwmci_card_busy,
 	.send_cmd	= dwmci_send_cmd,
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-	.send_cmd_prepare = dwmci_send_cmd_prepare,
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	.send_cmd_submit = dwmci_send_cmd_submit,
+	.data_poll	= dwmci_data_poll,
 #endif
 	.set_ios	= dwmci_set_ios,
 	.get_cd         = dwmci_get_cd,
@@ -36,37 +36,83 @@ int dm_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 	return ret;
 }
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-int dm_mmc_send_cmd_prepare(struct udevice *dev, struct mmc_cmd *cmd,
-			    struct mmc_data *data)
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int dm_mmc_send_cmd_submit(struct udevice *dev, struct mmc_cmd *cmd,
+			   struct mmc_data *data)
 {
 	struct mmc *mmc = mmc_get_mmc_dev(dev);
 	struct dm_mmc_ops *ops = mmc_get_ops(dev);
 	int ret;
 
+	if (!ops->send_cmd_submit || !ops->data_poll)
+		return -ENOSYS;
+
 	mmmc_trace_before_send(mmc, cmd);
-	if (ops->send_cmd_prepare)
-		ret = ops->send_cmd_prepare(dev, cmd, data);
-	else
-		ret = -ENOSYS;
+	ret = ops->send_cmd_submit(dev, cmd, data);
 	mmmc_trace_after_send(mmc, cmd, ret);
-	if (ret && cmd->cmdidx != SD_CMD_SEND_IF_COND
-	    && cmd->cmdidx != MMC_CMD_APP_CMD)
-		printf("MMC error: The cmd index is %d, ret is %d\n", cmd->cmdidx, ret);
+	if (ret)
+		printf("MMC error: The cmd index is %d, ret is %d\n",
+		       cmd->cmdidx, ret);
 
 	return ret;
 }
+
+int dm_mmc_data_poll(struct udevice *dev, struct mmc_data *data)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(dev);
+
+	if (!ops->data_poll)
+		return -ENOSYS;
+
+	return ops->data_poll(dev, data);
+}
+#endif
+
+#if CONFIG_IS_ENABLED(MMC_CQE)
+int dm_mmc_cqe_enable(struct udevice *dev, bool enable)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(dev);
+
+	if (!ops->cqe_enable)
+		return -ENOSYS;
+
+	return ops->cqe_enable(dev, enable);
+}
+
+int dm_mmc_cqe_request(struct udevice *dev, struct mmc_data *data, int count)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(dev);
+
+	if (!ops->cqe_request)
+		return -ENOSYS;
+
+	return ops->cqe_request(dev, data, count);
+}
 #endif
 
 int mmc_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 {
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	if (mmc->cqe_on)
+		mmc_cqe_off(mmc, cmd, data);
+#endif
 	return dm_mmc_send_cmd(mmc->dev, cmd, data);
 }
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-int mmc_send_cmd_prepare(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int mmc_send_cmd_submit(struct mmc *mmc, struct mmc_cmd *cmd,
+			struct mmc_data *data)
 {
-	return dm_mmc_send_cmd_prepare(mmc->dev, cmd, data);
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	if (mmc->cqe_on)
+		mmc_cqe_off(mmc, cmd, data);
+#endif
+	return dm_mmc_send_cmd_submit(mmc->dev, cmd, data);
+}
+
+int mmc_data_poll(struct mmc *mmc, struct mmc_data *data)
+{
+	return dm_mmc_data_poll(mmc->dev, data);
 }
 #endif
 
@@ -327,6 +373,10 @@ static const struct blk_ops mmc_blk_ops = {
 	.erase	= mmc_berase,
 #endif
 	.select_hwpart	= mmc_select_hwpart,
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	.read_submit	= mmc_bread_submit,
+	.read_poll	= mmc_bread_poll,
+#endif
 };
 
 U_BOOT_DRIVER(mmc_blk) = {
@@ -215,6 +215,12 @@ int mmc_set_blocklen(struct mmc *mmc, int len)
 	if (mmc_card_ddr(mmc))
 		return 0;
 
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	/* Queued tasks are always 512 bytes per block */
+	if (mmc->cqe_on && len == MMC_MAX_BLOCK_LEN)
+		return 0;
+#endif
+
 	cmd.cmdidx = MMC_CMD_SET_BLOCKLEN;
 	cmd.resp_type = MMC_RSP_R1;
 	cmd.cmdarg = len;
@@ -222,148 +228,261 @@ int mmc_set_blocklen(struct mmc *mmc, int len)
 	return mmc_send_cmd(mmc, &cmd, NULL);
 }
 
-static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
-			   lbaint_t blkcnt)
+int mmc_set_blockcount(struct mmc *mmc, unsigned int blockcount,
+		       bool is_rel_write)
 {
-	struct mmc_cmd cmd;
-	struct mmc_data data;
+	struct mmc_cmd cmd = {0};
+
+	cmd.cmdidx = MMC_CMD_SET_BLOCK_COUNT;
+	cmd.cmdarg = blockcount & 0x0000FFFF;
+	if (is_rel_write)
+		cmd.cmdarg |= 1 << 31;
+	cmd.resp_type = MMC_RSP_R1;
+
+	return mmc_send_cmd(mmc, &cmd, NULL);
+}
 
+static void mmc_setup_read(struct mmc *mmc, struct mmc_cmd *cmd,
+			   struct mmc_data *data, void *dst, lbaint_t start,
+			   lbaint_t blkcnt)
+{
 	if (blkcnt > 1)
-		cmd.cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
+		cmd->cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
 	else
-		cmd.cmdidx = MMC_CMD_READ_SINGLE_BLOCK;
+		cmd->cmdidx = MMC_CMD_READ_SINGLE_BLOCK;
 
 	if (mmc->high_capacity)
-		cmd.cmdarg = start;
+		cmd->cmdarg = start;
 	else
-		cmd.cmdarg = start * mmc->read_bl_len;
+		cmd->cmdarg = start * mmc->read_bl_len;
 
-	cmd.resp_type = MMC_RSP_R1;
+	cmd->resp_type = MMC_RSP_R1;
 
-	data.dest = dst;
-	data.blocks = blkcnt;
-	data.blocksize = mmc->read_bl_len;
-	data.flags = MMC_DATA_READ;
+	data->dest = dst;
+	data->blocks = blkcnt;
+	data->blocksize = mmc->read_bl_len;
+	data->flags = MMC_DATA_READ;
+}
 
-	if (mmc_send_cmd(mmc, &cmd, &data))
-		return 0;
+static int mmc_stop_read(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
 
-	if (blkcnt > 1) {
-		cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
-		cmd.cmdarg = 0;
-		cmd.resp_type = MMC_RSP_R1b;
-		if (mmc_send_cmd(mmc, &cmd, NULL)) {
+	cmd.cmdidx = MMC_CMD_STOP_TRANSMISSION;
+	cmd.cmdarg = 0;
+	cmd.resp_type = MMC_RSP_R1b;
+	if (mmc_send_cmd(mmc, &cmd, NULL)) {
 #if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_SPL_LIBCOMMON_SUPPORT)
-			printf("mmc fail to send stop cmd\n");
+		printf("mmc fail to send stop cmd\n");
 #endif
-			return 0;
-		}
+		return -EIO;
 	}
 
-	return blkcnt;
+	return 0;
 }
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-static int mmc_read_blocks_prepare(struct mmc *mmc, void *dst, lbaint_t start,
-				   lbaint_t blkcnt)
+static int mmc_read_blocks(struct mmc *mmc, void *dst, lbaint_t start,
+			   lbaint_t blkcnt)
 {
 	struct mmc_cmd cmd;
 	struct mmc_data data;
+	bool cmd23 = mmc_use_cmd23(mmc, blkcnt);
 
-	if (blkcnt > 1)
-		cmd.cmdidx = MMC_CMD_READ_MULTIPLE_BLOCK;
-	else
-		cmd.cmdidx = MMC_CMD_READ_SINGLE_BLOCK;
-
-	if (mmc->high_capacity)
-		cmd.cmdarg = start;
-	else
-		cmd.cmdarg = start * mmc->read_bl_len;
+	if (cmd23 && mmc_set_blockcount(mmc, blkcnt, false))
+		return 0;
 
-	cmd.resp_type = MMC_RSP_R1;
+	mmc_setup_read(mmc, &cmd, &data, dst, start, blkcnt);
 
-	data.dest = dst;
-	data.blocks = blkcnt;
-	data.blocksize = mmc->read_bl_len;
-	data.flags = MMC_DATA_READ;
+	if (mmc_send_cmd(mmc, &cmd, &data))
+		return 0;
 
-	if (mmc_send_cmd_prepare(mmc, &cmd, &data))
+	if (blkcnt > 1 && !cmd23 && mmc_stop_read(mmc))
 		return 0;
 
 	return blkcnt;
 }
-#endif
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-#if CONFIG_IS_ENABLED(BLK)
-ulong mmc_bread_prepare(struct udevice *dev, lbaint_t start, lbaint_t blkcnt, void *dst)
-#else
-ulong mmc_bread_prepare(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
-			void *dst)
-#endif
+/*
+ * Check the range and select the hardware partition before reading
+ * @blkcnt blocks from @start. Returns 0 if the read may go ahead.
+ */
+static int mmc_bread_setup(struct blk_desc *block_dev, struct mmc *mmc,
+			   lbaint_t start, lbaint_t blkcnt)
 {
-#if CONFIG_IS_ENABLED(BLK)
-	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
-#endif
-	int dev_num = block_dev->devnum;
-	int timeout = 0;
 	int err;
 
-	if (blkcnt == 0)
-		return 0;
-
-	struct mmc *mmc = find_mmc_device(dev_num);
-
-	if (!mmc)
-		return 0;
-
 	if (CONFIG_IS_ENABLED(MMC_TINY))
 		err = mmc_switch_part(mmc, block_dev->hwpart);
 	else
 		err = blk_dselect_hwpart(block_dev, block_dev->hwpart);
 
 	if (err < 0)
-		return 0;
+		return err;
 
 	if ((start + blkcnt) > block_dev->lba) {
 #if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_SPL_LIBCOMMON_SUPPORT)
 		printf("MMC: block number 0x" LBAF " exceeds max(0x" LBAF ")\n",
-		       start + blkcnt, block_dev->lba);
+			start + blkcnt, block_dev->lba);
 #endif
-		return 0;
+		return -EINVAL;
 	}
 
 	if (mmc_set_blocklen(mmc, mmc->read_bl_len)) {
 		debug("%s: Failed to set blocklen\n", __func__);
-		return 0;
+		return -EIO;
 	}
 
-	if (mmc_read_blocks_prepare(mmc, dst, start, blkcnt) != blkcnt) {
-		debug("%s: Failed to read blocks\n", __func__);
+	return 0;
+}
+
+/* Read in commands of at most b_max blocks, re-initialising on failure */
+static ulong mmc_bread_blocks(struct mmc *mmc, lbaint_t start, lbaint_t blkcnt,
+			      void *dst)
+{
+	lbaint_t cur, blocks_todo = blkcnt;
+
+	do {
+		cur = (blocks_todo > mmc->cfg->b_max) ?
+			mmc->cfg->b_max : blocks_todo;
+		if (mmc_read_blocks(mmc, dst, start, cur) != cur) {
+			debug("%s: Failed to read blocks\n", __func__);
+			int timeout = 0;
 re_init_retry:
-		timeout++;
-		/*
-		 * Try re-init seven times.
-		 */
-		if (timeout > 7) {
-			printf("Re-init retry timeout\n");
-			return 0;
-		}
+			timeout++;
+			/*
+			 * Try re-init seven times.
+			 */
+			if (timeout > 7) {
+				printf("Re-init retry timeout\n");
+				return 0;
+			}
 
-		mmc->has_init = 0;
-		if (mmc_init(mmc))
-			return 0;
+			mmc->has_init = 0;
+			if (mmc_init(mmc))
+				return 0;
 
-		if (mmc_read_blocks_prepare(mmc, dst, start, blkcnt) != blkcnt) {
-			printf("%s: Re-init mmc_read_blocks_prepare error\n",
-			       __func__);
-			goto re_init_retry;
+			if (mmc_read_blocks(mmc, dst, start, cur) != cur) {
+				printf("%s: Re-init mmc_read_blocks error\n",
+				       __func__);
+				goto re_init_retry;
+			}
 		}
+		blocks_todo -= cur;
+		start += cur;
+		dst += cur * mmc->read_bl_len;
+	} while (blocks_todo > 0);
+
+	return blkcnt;
+}
+
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+/* Start the next command of an asynchronous read */
+static int mmc_bread_next(struct mmc *mmc)
+{
+	struct blk_req *req = mmc->async_req;
+	struct mmc_cmd cmd;
+	lbaint_t cur;
+
+	cur = min(req->blkcnt - req->done, (lbaint_t)mmc->cfg->b_max);
+	if (mmc_use_cmd23(mmc, cur) && mmc_set_blockcount(mmc, cur, false))
+		return -EIO;
+
+	mmc_setup_read(mmc, &cmd, &mmc->async_data,
+		       req->buffer + req->done * mmc->read_bl_len,
+		       req->start + req->done, cur);
+
+	return mmc_send_cmd_submit(mmc, &cmd, &mmc->async_data);
+}
+
+/*
+ * Finish @req with ordinary reads, which also handle re-init and retry.
+ * Used when the host cannot read in the background or a command failed.
+ */
+static int mmc_bread_finish(struct mmc *mmc, struct blk_req *req)
+{
+	lbaint_t todo = req->blkcnt - req->done;
+
+	mmc->async_req = NULL;
+	req->done += mmc_bread_blocks(mmc, req->start + req->done, todo,
+				      req->buffer +
+				      req->done * mmc->read_bl_len);
+
+	return req->done == req->blkcnt ? 0 : -EIO;
+}
+
+int mmc_bread_submit(struct udevice *dev, struct blk_req *req)
+{
+	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
+	struct mmc *mmc = find_mmc_device(block_dev->devnum);
+	int err;
+
+	if (!mmc)
+		return -ENODEV;
+	if (!req->blkcnt)
+		return 0;
+
+	err = mmc_bread_setup(block_dev, mmc, req->start, req->blkcnt);
+	if (err)
+		return err;
+
+	mmc->async_req = req;
+	if (mmc_bread_next(mmc))
+		return mmc_bread_finish(mmc, req);
+
+	return 0;
+}
+
+int mmc_bread_poll(struct udevice *dev, struct blk_req *req)
+{
+	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
+	struct mmc *mmc = find_mmc_device(block_dev->devnum);
+	int err;
+
+	if (!mmc)
+		return -ENODEV;
+	/* Completed by submit, or nothing to do */
+	if (mmc->async_req != req)
+		return req->done == req->blkcnt ? 0 : -EIO;
+
+	err = mmc_data_poll(mmc, &mmc->async_data);
+	if (err == -EINPROGRESS)
+		return err;
+	if (!err && mmc->async_data.blocks > 1 &&
+	    !mmc_use_cmd23(mmc, mmc->async_data.blocks))
+		err = mmc_stop_read(mmc);
+	if (err)
+		return mmc_bread_finish(mmc, req);
+
+	req->done += mmc->async_data.blocks;
+	if (req->done < req->blkcnt) {
+		if (mmc_bread_next(mmc))
+			return mmc_bread_finish(mmc, req);
+		return -EINPROGRESS;
 	}
 
+	mmc->async_req = NULL;
+
+	return 0;
+}
+
+#ifdef CONFIG_SPL_BLK_READ_PREPARE
+/* Start the read and return at once, it completes on the next access */
+ulong mmc_bread_prepare(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
+			void *dst)
+{
+	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
+	struct mmc *mmc = find_mmc_device(block_dev->devnum);
+
+	if (!mmc)
+		return 0;
+
+	if (blk_dread_submit(block_dev, &mmc->prepare_req, start, blkcnt, dst))
+		return 0;
+
 	return blkcnt;
 }
 #endif
+#endif
 
 #if CONFIG_IS_ENABLED(BLK)
 ulong mmc_bread(struct udevice *dev, lbaint_t start, lbaint_t blkcnt, void *dst)
@@ -376,16 +495,11 @@ ulong mmc_bread(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 	struct blk_desc *block_dev = dev_get_uclass_platdata(dev);
 #endif
 	int dev_num = block_dev->devnum;
-	int err;
-	lbaint_t cur, blocks_todo = blkcnt;
+	lbaint_t done;
 
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_SPL_BLK_READ_PREPARE)
 	if (block_dev->op_flag == BLK_PRE_RW)
-#if CONFIG_IS_ENABLED(BLK)
 		return mmc_bread_prepare(dev, start, blkcnt, dst);
-#else
-		return mmc_bread_prepare(block_dev, start, blkcnt, dst);
-#endif
 #endif
 	if (blkcnt == 0)
 		return 0;
@@ -394,60 +508,164 @@ ulong mmc_bread(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 	if (!mmc)
 		return 0;
 
-	if (CONFIG_IS_ENABLED(MMC_TINY))
-		err = mmc_switch_part(mmc, block_dev->hwpart);
-	else
-		err = blk_dselect_hwpart(block_dev, block_dev->hwpart);
-
-	if (err < 0)
+	if (mmc_bread_setup(block_dev, mmc, start, blkcnt))
 		return 0;
 
-	if ((start + blkcnt) > block_dev->lba) {
-#if !defined(CONFIG_SPL_BUILD) || defined(CONFIG_SPL_LIBCOMMON_SUPPORT)
-		printf("MMC: block number 0x" LBAF " exceeds max(0x" LBAF ")\n",
-			start + blkcnt, block_dev->lba);
-#endif
-		return 0;
+	done = mmc_cqe_rw(mmc, start, blkcnt, dst, false);
+	if (done == blkcnt)
+		return done;
+
+	return done + mmc_bread_blocks(mmc, start + done, blkcnt - done,
+				       dst + done * mmc->read_bl_len);
+}
+
+#if CONFIG_IS_ENABLED(MMC_CQE)
+static int mmc_cqe_on(struct mmc *mmc)
+{
+	int err;
+
+	/* The card may still be in command queue mode, the host is not */
+	if (mmc->cqe_on)
+		return dm_mmc_cqe_enable(mmc->dev, true);
+
+	err = mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_CMDQ_MODE_EN, 1);
+	if (err)
+		return err;
+
+	err = dm_mmc_cqe_enable(mmc->dev, true);
+	if (err) {
+		mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_CMDQ_MODE_EN, 0);
+		return err;
 	}
+	mmc->cqe_on = true;
 
-	if (mmc_set_blocklen(mmc, mmc->read_bl_len)) {
-		debug("%s: Failed to set blocklen\n", __func__);
-		return 0;
+	return 0;
+}
+
+static void mmc_cqe_leave(struct mmc *mmc, bool discard)
+{
+	struct mmc_cmd cmd;
+
+	mmc->cqe_on = false;
+	dm_mmc_cqe_enable(mmc->dev, false);
+
+	if (discard) {
+		cmd.cmdidx = MMC_CMD_CMDQ_TASK_MGMT;
+		cmd.cmdarg = MMC_CMDQ_DISCARD_QUEUE;
+		cmd.resp_type = MMC_RSP_R1b;
+		mmc_send_cmd(mmc, &cmd, NULL);
 	}
 
-	do {
-		cur = (blocks_todo > mmc->cfg->b_max) ?
-			mmc->cfg->b_max : blocks_todo;
-		if (mmc_read_blocks(mmc, dst, start, cur) != cur) {
-			debug("%s: Failed to read blocks\n", __func__);
-			int timeout = 0;
-re_init_retry:
-			timeout++;
-			/*
-			 * Try re-init seven times.
-			 */
-			if (timeout > 7) {
-				printf("Re-init retry timeout\n");
-				return 0;
-			}
+	if (mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_CMDQ_MODE_EN, 0))
+		debug("%s: Failed to leave command queue mode\n", __func__);
+}
 
-			mmc->has_init = 0;
-			if (mmc_init(mmc))
-				return 0;
+/*
+ * Called before any command that is not a queued task. The host always
+ * stops queueing so that the command can be sent. The card only leaves
+ * command queue mode for a command it does not accept there: a legacy
+ * data transfer, a block count or length, or a partition switch. It leaves
+ * it by itself on CMD0.
+ */
+void mmc_cqe_off(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
+{
+	dm_mmc_cqe_enable(mmc->dev, false);
+
+	if (cmd->cmdidx == MMC_CMD_GO_IDLE_STATE) {
+		mmc->cqe_on = false;
+		return;
+	}
+
+	if (data || cmd->cmdidx == MMC_CMD_SET_BLOCK_COUNT ||
+	    cmd->cmdidx == MMC_CMD_SET_BLOCKLEN ||
+	    (cmd->cmdidx == MMC_CMD_SWITCH &&
+	     ((cmd->cmdarg >> 16) & 0xff) == EXT_CSD_PART_CONF))
+		mmc_cqe_leave(mmc, false);
+}
+
+/* Queue tasks for a buffer aligned for DMA, see mmc_cqe_rw() */
+static lbaint_t mmc_cqe_rw_aligned(struct mmc *mmc, lbaint_t start,
+				   lbaint_t blkcnt, void *buf, bool write)
+{
+	struct mmc_data data[EXT_CSD_CMDQ_DEPTH_MASK + 1];
+	uint blksz = write ? mmc->write_bl_len : mmc->read_bl_len;
+	lbaint_t done = 0, queued, cur;
+	int n, err;
+
+	while (done < blkcnt) {
+		queued = 0;
+		for (n = 0; n < mmc->cqe_depth && done + queued < blkcnt; n++) {
+			cur = min(blkcnt - done - queued,
+				  (lbaint_t)mmc->cfg->cqe_b_max);
+			data[n].dest = buf + (done + queued) * blksz;
+			data[n].blocks = cur;
+			data[n].blocksize = blksz;
+			data[n].flags = write ? MMC_DATA_WRITE : MMC_DATA_READ;
+			data[n].blk_addr = start + done + queued;
+			if (!mmc->high_capacity)
+				data[n].blk_addr *= blksz;
+			queued += cur;
+		}
 
-			if (mmc_read_blocks(mmc, dst, start, cur) != cur) {
-				printf("%s: Re-init mmc_read_blocks error\n",
-				       __func__);
-				goto re_init_retry;
-			}
+		err = dm_mmc_cqe_request(mmc->dev, data, n);
+		if (err) {
+			debug("%s: Queued transfer failed (%d)\n", __func__,
+			      err);
+			/* -EINVAL: nothing was queued, the queue is fine */
+			if (err != -EINVAL)
+				mmc_cqe_leave(mmc, true);
+			break;
 		}
-		blocks_todo -= cur;
-		start += cur;
-		dst += cur * mmc->read_bl_len;
-	} while (blocks_todo > 0);
+		done += queued;
+	}
 
-	return blkcnt;
+	return done;
+}
+
+/*
+ * Move @blkcnt blocks through the command queue, cqe_depth tasks of up to
+ * cqe_b_max blocks at a time. A buffer that is not aligned for DMA goes
+ * through an aligned bounce buffer, so that the card need not leave
+ * command queue mode for it. The card stays in command queue mode until a
+ * command it does not accept there, see mmc_cqe_off(). Returns the number
+ * of blocks transferred; the caller moves the rest with ordinary commands.
+ */
+lbaint_t mmc_cqe_rw(struct mmc *mmc, lbaint_t start, lbaint_t blkcnt,
+		    void *buf, bool write)
+{
+	uint blksz = write ? mmc->write_bl_len : mmc->read_bl_len;
+	lbaint_t done = 0, cur, ret;
+	void *bounce;
+
+	if (!mmc->cqe_depth || !blkcnt || blksz != MMC_MAX_BLOCK_LEN ||
+	    start + blkcnt > mmc_get_blk_desc(mmc)->lba || mmc_cqe_on(mmc))
+		return 0;
+
+	if (IS_ALIGNED((ulong)buf, ARCH_DMA_MINALIGN))
+		return mmc_cqe_rw_aligned(mmc, start, blkcnt, buf, write);
+
+	cur = min(blkcnt, (lbaint_t)mmc->cfg->cqe_b_max);
+	bounce = memalign(ARCH_DMA_MINALIGN, cur * blksz);
+	if (!bounce)
+		return 0;
+
+	while (done < blkcnt) {
+		cur = min(blkcnt - done, (lbaint_t)mmc->cfg->cqe_b_max);
+		if (write)
+			memcpy(bounce, buf + done * blksz, cur * blksz);
+		ret = mmc_cqe_rw_aligned(mmc, start + done, cur, bounce,
+					 write);
+		if (!write)
+			memcpy(buf + done * blksz, bounce, ret * blksz);
+		done += ret;
+		if (ret != cur)
+			break;
+	}
+	free(bounce);
+
+	return done;
 }
+#endif
 
 void mmc_set_clock(struct mmc *mmc, uint clock)
 {
@@ -1810,6 +2028,9 @@ static int mmc_startup(struct mmc *mmc)
 	 */
 	mmc->erase_grp_size = 1;
 	mmc->part_config = MMCPART_NOAVAILABLE;
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	mmc->cqe_depth = 0;
+#endif
 	if (!IS_SD(mmc) && (mmc->version >= MMC_VERSION_4)) {
 		/* check  ext_csd version and capacity */
 		err = mmc_send_ext_csd(mmc, ext_csd);
@@ -1873,6 +2094,14 @@ static int mmc_startup(struct mmc *mmc)
 		if (ext_csd[EXT_CSD_SEC_FEATURE_SUPPORT] & EXT_CSD_SEC_GB_CL_EN)
 			mmc->esr.mmc_can_trim = 1;
 
+#if CONFIG_IS_ENABLED(MMC_CQE)
+		if (mmc->version >= MMC_VERSION_5_1 &&
+		    (ext_csd[EXT_CSD_CMDQ_SUPPORT] & EXT_CSD_CMDQ_SUPPORTED))
+			mmc->cqe_depth = min_t(uint, mmc->cfg->cqe_depth,
+					       (ext_csd[EXT_CSD_CMDQ_DEPTH] &
+						EXT_CSD_CMDQ_DEPTH_MASK) + 1);
+#endif
+
 		mmc->capacity_boot = ext_csd[EXT_CSD_BOOT_MULT] << 17;
 
 		mmc->capacity_rpmb = ext_csd[EXT_CSD_RPMB_MULT] << 17;
@@ -14,12 +14,45 @@
 
 extern int mmc_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd,
 			struct mmc_data *data);
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-int mmc_send_cmd_prepare(struct mmc *mmc, struct mmc_cmd *cmd,
-			 struct mmc_data *data);
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int mmc_send_cmd_submit(struct mmc *mmc, struct mmc_cmd *cmd,
+			struct mmc_data *data);
+int mmc_data_poll(struct mmc *mmc, struct mmc_data *data);
 #endif
 extern int mmc_send_status(struct mmc *mmc, int timeout);
 extern int mmc_set_blocklen(struct mmc *mmc, int len);
+int mmc_set_blockcount(struct mmc *mmc, unsigned int blockcount,
+		       bool is_rel_write);
+
+/*
+ * A multi-block transfer may announce its length with CMD23 and skip the
+ * CMD12 that would otherwise end it. Every eMMC from v3.1 on supports this,
+ * SD cards report it in their SCR.
+ */
+static inline bool mmc_use_cmd23(struct mmc *mmc, lbaint_t blkcnt)
+{
+	if (!IS_ENABLED(CONFIG_MMC_CMD23) || mmc_host_is_spi(mmc) ||
+	    blkcnt < 2 || blkcnt > 0xffff)
+		return false;
+
+	if (IS_SD(mmc))
+		return mmc->scr[0] & SD_CMD23_SUPPORT;
+
+	return mmc->version >= MMC_VERSION_3;
+}
+
+#if CONFIG_IS_ENABLED(MMC_CQE)
+lbaint_t mmc_cqe_rw(struct mmc *mmc, lbaint_t start, lbaint_t blkcnt,
+		    void *buf, bool write);
+void mmc_cqe_off(struct mmc *mmc, struct mmc_cmd *cmd,
+		 struct mmc_data *data);
+#else
+static inline lbaint_t mmc_cqe_rw(struct mmc *mmc, lbaint_t start,
+				  lbaint_t blkcnt, void *buf, bool write)
+{
+	return 0;
+}
+#endif
 #ifdef CONFIG_FSL_ESDHC_ADAPTER_IDENT
 void mmc_adapter_card_type_ident(void);
 #endif
@@ -27,17 +60,17 @@ void mmc_adapter_card_type_ident(void);
 #if CONFIG_IS_ENABLED(BLK)
 ulong mmc_bread(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 		void *dst);
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int mmc_bread_submit(struct udevice *dev, struct blk_req *req);
+int mmc_bread_poll(struct udevice *dev, struct blk_req *req);
 #ifdef CONFIG_SPL_BLK_READ_PREPARE
 ulong mmc_bread_prepare(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 			void *dst);
 #endif
+#endif
 #else
 ulong mmc_bread(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 		void *dst);
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-ulong mmc_bread_prepare(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
-			void *dst);
-#endif
 #endif
 
 #if CONFIG_IS_ENABLED(MMC_WRITE)
@@ -56,6 +56,8 @@ DECLARE_GLOBAL_DATA_PTR;
 #define DLL_RXCLK_NO_INVERTER		1
 #define DLL_RXCLK_INVERTER		0
 #define DWCMSHC_ENHANCED_STROBE		BIT(8)
+#define DWCMSHC_P_VENDOR_AREA2		0xea
+#define DWCMSHC_AREA2_MASK		GENMASK(11, 0)
 #define DLL_LOCK_WO_TMOUT(x) \
 	((((x) & DWCMSHC_EMMC_DLL_LOCKED) == DWCMSHC_EMMC_DLL_LOCKED) && \
 	(((x) & DWCMSHC_EMMC_DLL_TIMEOUT) == 0))
@@ -87,6 +89,7 @@ struct sdhci_data {
 	int (*emmc_set_clock)(struct sdhci_host *host, unsigned int clock);
 	int (*emmc_phy_init)(struct udevice *dev);
 	int (*get_phy)(struct udevice *dev);
+	void *(*get_cqe_base)(struct sdhci_host *host);
 };
 
 static int rk3399_emmc_phy_init(struct udevice *dev)
@@ -361,6 +364,13 @@ static int rk3568_sdhci_emmc_set_clock(struct sdhci_host *host, unsigned int clo
 	return ret;
 }
 
+/* The CQHCI registers sit in the second vendor specific area */
+static void *rk3568_sdhci_get_cqe_base(struct sdhci_host *host)
+{
+	return host->ioaddr + (sdhci_readw(host, DWCMSHC_P_VENDOR_AREA2) &
+			       DWCMSHC_AREA2_MASK);
+}
+
 static int rk3568_emmc_get_phy(struct udevice *dev)
 {
 	return 0;
@@ -452,6 +462,12 @@ static int arasan_sdhci_probe(struct udevice *dev)
 	host->mmc->dev = dev;
 	upriv->mmc = host->mmc;
 
+#if CONFIG_IS_ENABLED(MMC_CQHCI) && !CONFIG_IS_ENABLED(OF_PLATDATA)
+	if (data->get_cqe_base && dev_read_bool(dev, "supports-cqe") &&
+	    sdhci_cqe_init(host, &plat->cfg, data->get_cqe_base(host)))
+		printf("%s: command queue engine unavailable\n", dev->name);
+#endif
+
 	return sdhci_probe(dev);
 }
 
@@ -484,6 +500,7 @@ static const struct sdhci_data snps_data = {
 	.emmc_set_clock = rk3568_sdhci_emmc_set_clock,
 	.get_phy = rk3568_emmc_get_phy,
 	.emmc_phy_init = rk3568_emmc_phy_init,
+	.get_cqe_base = rk3568_sdhci_get_cqe_base,
 };
 
 static const struct udevice_id arasan_sdhci_ids[] = {
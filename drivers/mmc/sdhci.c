@@ -13,6 +13,7 @@
 #include <malloc.h>
 #include <mmc.h>
 #include <sdhci.h>
+#include <cqhci.h>
 
 #if defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
 void *aligned_buffer = (void *)CONFIG_FIXED_SDHCI_ALIGNED_BUFFER;
@@ -123,6 +124,122 @@ static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data,
 	return 0;
 }
 
+#ifdef CONFIG_MMC_SDHCI_ADMA
+static void sdhci_set_dma_ctrl(struct sdhci_host *host, u8 dma)
+{
+	u8 ctrl;
+
+	ctrl = sdhci_readb(host, SDHCI_HOST_CONTROL);
+	ctrl &= ~SDHCI_CTRL_DMA_MASK;
+	ctrl |= dma;
+	sdhci_writeb(host, ctrl, SDHCI_HOST_CONTROL);
+}
+
+static void sdhci_adma_write_desc(struct sdhci_host *host, void **desc,
+				  dma_addr_t addr, int len, bool end)
+{
+	struct sdhci_adma_desc *dma_desc = *desc;
+
+	dma_desc->attr = SDHCI_ADMA_TRAN_VALID;
+	if (end)
+		dma_desc->attr |= SDHCI_ADMA_END;
+	dma_desc->reserved = 0;
+	dma_desc->len = cpu_to_le16(len);
+	dma_desc->addr_lo = cpu_to_le32(lower_32_bits(addr));
+	if (host->flags & SDHCI_USE_64BIT_DMA)
+		dma_desc->addr_hi = cpu_to_le32(upper_32_bits(addr));
+
+	*desc += host->adma_desc_sz;
+}
+
+/*
+ * Build the descriptor table for the whole request so the controller can
+ * move every block without any help from the CPU. Returns -EINVAL if the
+ * buffer cannot be used for DMA, in which case the caller falls back to the
+ * non-ADMA path.
+ */
+static int sdhci_adma_prepare(struct sdhci_host *host, struct mmc_data *data)
+{
+	dma_addr_t start, addr;
+	unsigned int size, len, chunk;
+	void *desc = host->adma_desc;
+
+	if (!(host->flags & SDHCI_USE_ADMA) || !desc)
+		return -EINVAL;
+
+	if (data->flags == MMC_DATA_READ)
+		start = (dma_addr_t)(ulong)data->dest;
+	else
+		start = (dma_addr_t)(ulong)data->src;
+	size = data->blocks * data->blocksize;
+
+	if (!IS_ALIGNED(start, ARCH_DMA_MINALIGN) ||
+	    DIV_ROUND_UP(size, SDHCI_ADMA_MAX_LEN) + 1 > host->adma_desc_num)
+		return -EINVAL;
+	if (!(host->flags & SDHCI_USE_64BIT_DMA) &&
+	    upper_32_bits(start + size - 1))
+		return -EINVAL;
+
+	for (addr = start, len = size; len; addr += chunk, len -= chunk) {
+		chunk = SDHCI_ADMA_MAX_LEN - (addr & (SDHCI_ADMA_MAX_LEN - 1));
+		chunk = min(chunk, len);
+		sdhci_adma_write_desc(host, &desc, addr, chunk, chunk == len);
+	}
+
+	flush_dcache_range((ulong)host->adma_desc,
+			   ALIGN((ulong)desc, ARCH_DMA_MINALIGN));
+	flush_dcache_range(start, ALIGN(start + size, ARCH_DMA_MINALIGN));
+
+	sdhci_writel(host, lower_32_bits((ulong)host->adma_desc),
+		     SDHCI_ADMA_ADDRESS);
+	if (host->flags & SDHCI_USE_64BIT_DMA)
+		sdhci_writel(host, upper_32_bits((ulong)host->adma_desc),
+			     SDHCI_ADMA_ADDRESS_HI);
+
+	if (host->flags & SDHCI_USE_64BIT_DMA)
+		sdhci_set_dma_ctrl(host, SDHCI_CTRL_ADMA64);
+	else
+		sdhci_set_dma_ctrl(host, SDHCI_CTRL_ADMA32);
+
+	return 0;
+}
+
+#define SDHCI_ADMA_TIMEOUT	10000
+
+/*
+ * The descriptor table covers the whole request, so there is nothing to do
+ * until the controller raises DATA_END (or an error).
+ */
+static int sdhci_adma_transfer_data(struct sdhci_host *host,
+				    struct mmc_data *data)
+{
+	unsigned long start = get_timer(0);
+	ulong buf = (ulong)data->dest;
+	unsigned int stat;
+
+	do {
+		stat = sdhci_readl(host, SDHCI_INT_STATUS);
+		if (stat & SDHCI_INT_ERROR) {
+			printf("%s: Error detected in status(0x%X), adma 0x%x!\n",
+			       __func__, stat,
+			       sdhci_readb(host, SDHCI_ADMA_ERROR));
+			return -EIO;
+		}
+		if (get_timer(start) > SDHCI_ADMA_TIMEOUT) {
+			printf("%s: Transfer data timeout\n", __func__);
+			return -ETIMEDOUT;
+		}
+	} while (!(stat & SDHCI_INT_DATA_END));
+
+	if (data->flags == MMC_DATA_READ)
+		invalidate_dcache_range(buf, ALIGN(buf + data->blocks *
+						   data->blocksize,
+						   ARCH_DMA_MINALIGN));
+
+	return 0;
+}
+#endif
+
 /*
  * No command will be sent by driver if card is busy, so driver must wait
  * for card ready state.
@@ -134,21 +251,14 @@ static int sdhci_transfer_data(struct sdhci_host *host, struct mmc_data *data,
 #define SDHCI_CMD_DEFAULT_TIMEOUT		100
 #define SDHCI_READ_STATUS_TIMEOUT		1000
 
-#ifdef CONFIG_DM_MMC
-static int sdhci_send_command(struct udevice *dev, struct mmc_cmd *cmd,
-			      struct mmc_data *data)
-{
-	struct mmc *mmc = mmc_get_mmc_dev(dev);
-
-#else
-static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
-			      struct mmc_data *data)
+static int sdhci_send_cmd_common(struct mmc *mmc, struct mmc_cmd *cmd,
+				 struct mmc_data *data, bool async)
 {
-#endif
 	struct sdhci_host *host = mmc->priv;
 	unsigned int stat = 0;
 	int ret = 0;
 	int trans_bytes = 0, is_aligned = 1;
+	bool __maybe_unused use_adma = false;
 	u32 mask, flags, mode;
 	unsigned int time = 0, start_addr = 0;
 	int mmc_dev = mmc_get_blk_desc(mmc)->devnum;
@@ -221,32 +331,43 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 		if (data->flags == MMC_DATA_READ)
 			mode |= SDHCI_TRNS_READ;
 
+#ifdef CONFIG_MMC_SDHCI_ADMA
+		use_adma = !sdhci_adma_prepare(host, data);
+		if (use_adma)
+			mode |= SDHCI_TRNS_DMA;
+#endif
 #ifdef CONFIG_MMC_SDHCI_SDMA
-		if (data->flags == MMC_DATA_READ)
-			start_addr = (unsigned long)data->dest;
-		else
-			start_addr = (unsigned long)data->src;
-		if ((host->quirks & SDHCI_QUIRK_32BIT_DMA_ADDR) &&
-				(start_addr & 0x7) != 0x0) {
+		if (!use_adma) {
+#ifdef CONFIG_MMC_SDHCI_ADMA
+			sdhci_set_dma_ctrl(host, SDHCI_CTRL_SDMA);
+#endif
+			if (data->flags == MMC_DATA_READ)
+				start_addr = (unsigned long)data->dest;
+			else
+				start_addr = (unsigned long)data->src;
+			if ((host->quirks & SDHCI_QUIRK_32BIT_DMA_ADDR) &&
+					(start_addr & 0x7) != 0x0) {
+				is_aligned = 0;
+				start_addr = (unsigned long)aligned_buffer;
+				if (data->flags != MMC_DATA_READ)
+					memcpy(aligned_buffer, data->src,
+					       trans_bytes);
+			}
+
+#if defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
+			/*
+			 * Always use this bounce-buffer when
+			 * CONFIG_FIXED_SDHCI_ALIGNED_BUFFER is defined
+			 */
 			is_aligned = 0;
 			start_addr = (unsigned long)aligned_buffer;
 			if (data->flags != MMC_DATA_READ)
 				memcpy(aligned_buffer, data->src, trans_bytes);
-		}
-
-#if defined(CONFIG_FIXED_SDHCI_ALIGNED_BUFFER)
-		/*
-		 * Always use this bounce-buffer when
-		 * CONFIG_FIXED_SDHCI_ALIGNED_BUFFER is defined
-		 */
-		is_aligned = 0;
-		start_addr = (unsigned long)aligned_buffer;
-		if (data->flags != MMC_DATA_READ)
-			memcpy(aligned_buffer, data->src, trans_bytes);
 #endif
 
-		sdhci_writel(host, start_addr, SDHCI_DMA_ADDRESS);
-		mode |= SDHCI_TRNS_DMA;
+			sdhci_writel(host, start_addr, SDHCI_DMA_ADDRESS);
+			mode |= SDHCI_TRNS_DMA;
+		}
 #endif
 		sdhci_writew(host, SDHCI_MAKE_BLKSZ(SDHCI_DEFAULT_BOUNDARY_ARG,
 				data->blocksize),
@@ -259,7 +380,7 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 
 	sdhci_writel(host, cmd->cmdarg, SDHCI_ARGUMENT);
 #ifdef CONFIG_MMC_SDHCI_SDMA
-	if (data != 0) {
+	if (data != 0 && !use_adma) {
 		trans_bytes = ALIGN(trans_bytes, CONFIG_SYS_CACHELINE_SIZE);
 		flush_cache(start_addr, trans_bytes);
 	}
@@ -288,6 +409,19 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 	} else
 		ret = -1;
 
+#ifdef CONFIG_MMC_SDHCI_ADMA
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	if (!ret && use_adma && async) {
+		/* sdhci_data_poll() waits for DATA_END */
+		host->async_data = data;
+		host->async_start = get_timer(0);
+		return 0;
+	}
+#endif
+	if (!ret && use_adma)
+		ret = sdhci_adma_transfer_data(host, data);
+	else
+#endif
 	if (!ret && data)
 		ret = sdhci_transfer_data(host, data, start_addr);
 
@@ -311,6 +445,72 @@ static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
 		return -ECOMM;
 }
 
+#ifdef CONFIG_DM_MMC
+static int sdhci_send_command(struct udevice *dev, struct mmc_cmd *cmd,
+			      struct mmc_data *data)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+
+#else
+static int sdhci_send_command(struct mmc *mmc, struct mmc_cmd *cmd,
+			      struct mmc_data *data)
+{
+#endif
+	return sdhci_send_cmd_common(mmc, cmd, data, false);
+}
+
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_MMC_SDHCI_ADMA)
+static int sdhci_send_cmd_submit(struct udevice *dev, struct mmc_cmd *cmd,
+				 struct mmc_data *data)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct sdhci_host *host = mmc->priv;
+
+	host->async_data = NULL;
+
+	/* Only ADMA reads are left running, anything else completes here */
+	return sdhci_send_cmd_common(mmc, cmd, data,
+				     data->flags == MMC_DATA_READ);
+}
+
+static int sdhci_data_poll(struct udevice *dev, struct mmc_data *data)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct sdhci_host *host = mmc->priv;
+	ulong buf = (ulong)data->dest;
+	unsigned int stat;
+	int ret = 0;
+
+	if (host->async_data != data)
+		return 0;
+
+	stat = sdhci_readl(host, SDHCI_INT_STATUS);
+	if (stat & SDHCI_INT_ERROR) {
+		printf("%s: Error detected in status(0x%X), adma 0x%x!\n",
+		       __func__, stat, sdhci_readb(host, SDHCI_ADMA_ERROR));
+		ret = -EIO;
+	} else if (stat & SDHCI_INT_DATA_END) {
+		invalidate_dcache_range(buf, ALIGN(buf + data->blocks *
+						   data->blocksize,
+						   ARCH_DMA_MINALIGN));
+	} else if (get_timer(host->async_start) > SDHCI_ADMA_TIMEOUT) {
+		printf("%s: Transfer data timeout\n", __func__);
+		ret = -ETIMEDOUT;
+	} else {
+		return -EINPROGRESS;
+	}
+
+	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
+	host->async_data = NULL;
+	if (ret) {
+		sdhci_reset(host, SDHCI_RESET_CMD);
+		sdhci_reset(host, SDHCI_RESET_DATA);
+	}
+
+	return ret;
+}
+#endif
+
 int sdhci_set_clock(struct sdhci_host *host, unsigned int clock)
 {
 	unsigned int div, clk = 0, timeout;
@@ -555,6 +755,22 @@ static int sdhci_init(struct mmc *mmc)
 		}
 	}
 
+#ifdef CONFIG_MMC_SDHCI_ADMA
+	if ((host->flags & SDHCI_USE_ADMA) && !host->adma_desc) {
+		/* One spare entry for a buffer that is not window aligned */
+		host->adma_desc_num = DIV_ROUND_UP(mmc->cfg->b_max *
+						   MMC_MAX_BLOCK_LEN,
+						   SDHCI_ADMA_MAX_LEN) + 1;
+		host->adma_desc = memalign(ARCH_DMA_MINALIGN,
+					   ALIGN(host->adma_desc_num *
+						 host->adma_desc_sz,
+						 ARCH_DMA_MINALIGN));
+		if (!host->adma_desc)
+			printf("%s: ADMA table alloc failed, using PIO\n",
+			       __func__);
+	}
+#endif
+
 	sdhci_set_power(host, fls(mmc->cfg->voltages) - 1);
 
 	if (host->ops && host->ops->get_cd)
@@ -671,6 +887,92 @@ static int sdhci_execute_tuning(struct mmc *mmc, u32 opcode)
 	return __sdhci_execute_tuning(host, opcode);
 }
 
+#if CONFIG_IS_ENABLED(MMC_CQHCI)
+static void sdhci_cqhci_enable(struct cqhci_host *cq_host)
+{
+	struct sdhci_host *host = cq_host->priv;
+
+	sdhci_set_dma_ctrl(host, host->flags & SDHCI_USE_64BIT_DMA ?
+			   SDHCI_CTRL_ADMA64 : SDHCI_CTRL_ADMA32);
+	sdhci_writew(host, SDHCI_MAKE_BLKSZ(SDHCI_DEFAULT_BOUNDARY_ARG,
+					    MMC_MAX_BLOCK_LEN),
+		     SDHCI_BLOCK_SIZE);
+	sdhci_writeb(host, 0xe, SDHCI_TIMEOUT_CONTROL);
+	sdhci_writel(host, SDHCI_INT_CQE | SDHCI_INT_ERROR_MASK,
+		     SDHCI_INT_ENABLE);
+	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
+}
+
+static void sdhci_cqhci_disable(struct cqhci_host *cq_host, bool recovery)
+{
+	struct sdhci_host *host = cq_host->priv;
+
+	sdhci_writel(host, SDHCI_INT_DATA_MASK | SDHCI_INT_CMD_MASK,
+		     SDHCI_INT_ENABLE);
+	sdhci_writel(host, SDHCI_INT_ALL_MASK, SDHCI_INT_STATUS);
+	if (recovery) {
+		sdhci_reset(host, SDHCI_RESET_CMD);
+		sdhci_reset(host, SDHCI_RESET_DATA);
+	}
+}
+
+static const struct cqhci_host_ops sdhci_cqhci_ops = {
+	.enable		= sdhci_cqhci_enable,
+	.disable	= sdhci_cqhci_disable,
+};
+
+int sdhci_cqe_init(struct sdhci_host *host, struct mmc_config *cfg,
+		   void *mmio)
+{
+	struct cqhci_host *cq_host;
+	int ret;
+
+	if (!(host->flags & SDHCI_USE_ADMA))
+		return -ENOSYS;
+
+	cq_host = calloc(1, sizeof(*cq_host));
+	if (!cq_host)
+		return -ENOMEM;
+
+	cq_host->mmio = mmio;
+	cq_host->mmc = host->mmc;
+	cq_host->ops = &sdhci_cqhci_ops;
+	cq_host->priv = host;
+	cq_host->dma64 = host->flags & SDHCI_USE_64BIT_DMA;
+	ret = cqhci_init(cq_host, cfg);
+	if (ret) {
+		free(cq_host);
+		return ret;
+	}
+	host->cq_host = cq_host;
+
+	return 0;
+}
+
+static int sdhci_cqe_enable(struct udevice *dev, bool enable)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct sdhci_host *host = mmc->priv;
+
+	if (!host->cq_host)
+		return -ENOSYS;
+
+	return cqhci_enable(host->cq_host, enable);
+}
+
+static int sdhci_cqe_request(struct udevice *dev, struct mmc_data *data,
+			     int count)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+	struct sdhci_host *host = mmc->priv;
+
+	if (!host->cq_host)
+		return -ENOSYS;
+
+	return cqhci_request(host->cq_host, data, count);
+}
+#endif
+
 #ifdef CONFIG_DM_MMC
 int sdhci_probe(struct udevice *dev)
 {
@@ -684,6 +986,14 @@ const struct dm_mmc_ops sdhci_ops = {
 	.send_cmd	= sdhci_send_command,
 	.set_ios	= sdhci_set_ios,
 	.execute_tuning = sdhci_execute_tuning,
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_MMC_SDHCI_ADMA)
+	.send_cmd_submit = sdhci_send_cmd_submit,
+	.data_poll	= sdhci_data_poll,
+#endif
+#if CONFIG_IS_ENABLED(MMC_CQHCI)
+	.cqe_enable	= sdhci_cqe_enable,
+	.cqe_request	= sdhci_cqe_request,
+#endif
 };
 #else
 static const struct mmc_ops sdhci_ops = {
@@ -708,6 +1018,17 @@ int sdhci_setup_cfg(struct mmc_config *cfg, struct sdhci_host *host,
 		       __func__);
 		return -EINVAL;
 	}
+#endif
+#ifdef CONFIG_MMC_SDHCI_ADMA
+	if (caps & SDHCI_CAN_DO_ADMA2) {
+		host->flags |= SDHCI_USE_ADMA;
+		host->adma_desc_sz = SDHCI_ADMA_32_DESC_SZ;
+		if (IS_ENABLED(CONFIG_DMA_ADDR_T_64BIT) &&
+		    (caps & SDHCI_CAN_64BIT)) {
+			host->flags |= SDHCI_USE_64BIT_DMA;
+			host->adma_desc_sz = SDHCI_ADMA_64_DESC_SZ;
+		}
+	}
 #endif
 	if (host->quirks & SDHCI_QUIRK_REG32_RW)
 		host->version =
@@ -366,6 +366,7 @@ static int _dw_eth_send(struct dw_eth_dev *priv, void *packet, int length)
 	/* Check if the descriptor is owned by CPU */
 	if (desc_p->txrx_status & DESC_TXSTS_OWNBYDMA) {
 		printf("CPU not owner of tx frame\n");
+		priv->tx_dropped++;
 		return -EPERM;
 	}
 
@@ -426,6 +427,9 @@ static int _dw_eth_recv(struct dw_eth_dev *priv, uchar **packetp)
 		length = (status & DESC_RXSTS_FRMLENMSK) >>
 			 DESC_RXSTS_FRMLENSHFT;
 
+		if (status & DESC_RXSTS_ERROR)
+			priv->rx_errors++;
+
 		/* Invalidate received data */
 		data_end = data_start + roundup(length, ARCH_DMA_MINALIGN);
 		invalidate_dcache_range(data_start, data_end);
@@ -638,6 +642,24 @@ int designware_eth_write_hwaddr(struct udevice *dev)
 	return _dw_write_hwaddr(priv, pdata->enetaddr);
 }
 
+int designware_eth_get_stats(struct udevice *dev, struct eth_stats *stats)
+{
+	struct dw_eth_dev *priv = dev_get_priv(dev);
+	u32 mfc;
+
+	/* The counter clears on read, so every read is a delta */
+	mfc = readl(&priv->dma_regs_p->missedframecount);
+	stats->rx_dropped += (mfc & MFC_MISSED_MASK) >> MFC_MISSED_SHIFT;
+	stats->rx_overruns += (mfc & MFC_OVERFLOW_MASK) >> MFC_OVERFLOW_SHIFT;
+
+	stats->rx_errors += priv->rx_errors;
+	stats->tx_dropped += priv->tx_dropped;
+	priv->rx_errors = 0;
+	priv->tx_dropped = 0;
+
+	return 0;
+}
+
 static int designware_eth_bind(struct udevice *dev)
 {
 #ifdef CONFIG_DM_PCI
@@ -727,6 +749,7 @@ const struct eth_ops designware_eth_ops = {
 	.free_pkt		= designware_eth_free_pkt,
 	.stop			= designware_eth_stop,
 	.write_hwaddr		= designware_eth_write_hwaddr,
+	.get_stats		= designware_eth_get_stats,
 };
 
 int designware_eth_ofdata_to_platdata(struct udevice *dev)
@@ -12,8 +12,16 @@
 #include <asm-generic/gpio.h>
 #endif
 
+#ifdef CONFIG_DW_ETH_TX_DESCR_NUM
+#define CONFIG_TX_DESCR_NUM	CONFIG_DW_ETH_TX_DESCR_NUM
+#else
 #define CONFIG_TX_DESCR_NUM	16
+#endif
+#ifdef CONFIG_DW_ETH_RX_DESCR_NUM
+#define CONFIG_RX_DESCR_NUM	CONFIG_DW_ETH_RX_DESCR_NUM
+#else
 #define CONFIG_RX_DESCR_NUM	16
+#endif
 #define CONFIG_ETH_BUFSIZE	2048
 #define TX_TOTAL_BUFSIZE	(CONFIG_ETH_BUFSIZE * CONFIG_TX_DESCR_NUM)
 #define RX_TOTAL_BUFSIZE	(CONFIG_ETH_BUFSIZE * CONFIG_RX_DESCR_NUM)
@@ -72,7 +80,8 @@ struct eth_dma_regs {
 	u32 status;		/* 0x14 */
 	u32 opmode;		/* 0x18 */
 	u32 intenable;		/* 0x1c */
-	u32 reserved1[2];
+	u32 missedframecount;	/* 0x20 */
+	u32 reserved1[1];
 	u32 axibus;		/* 0x28 */
 	u32 reserved2[7];
 	u32 currhosttxdesc;	/* 0x48 */
@@ -83,6 +92,12 @@ struct eth_dma_regs {
 
 #define DW_DMA_BASE_OFFSET	(0x1000)
 
+/* Missed frame and buffer overflow counter definitions (clear on read) */
+#define MFC_MISSED_MASK		(0xFFFF << 0)
+#define MFC_MISSED_SHIFT	(0)
+#define MFC_OVERFLOW_MASK	(0x7FF << 17)
+#define MFC_OVERFLOW_SHIFT	(17)
+
 /* Default DMA Burst length */
 #ifndef CONFIG_DW_GMAC_DEFAULT_DMA_PBL
 #define CONFIG_DW_GMAC_DEFAULT_DMA_PBL 8
@@ -230,6 +245,8 @@ struct dw_eth_dev {
 	u32 max_speed;
 	u32 tx_currdescnum;
 	u32 rx_currdescnum;
+	u32 rx_errors;		/* not yet reported through get_stats() */
+	u32 tx_dropped;		/* not yet reported through get_stats() */
 
 	struct eth_mac_regs *mac_regs_p;
 	struct eth_dma_regs *dma_regs_p;
@@ -262,6 +279,7 @@ int designware_eth_free_pkt(struct udevice *dev, uchar *packet,
 				   int length);
 void designware_eth_stop(struct udevice *dev);
 int designware_eth_write_hwaddr(struct udevice *dev);
+int designware_eth_get_stats(struct udevice *dev, struct eth_stats *stats);
 #endif
 
 #endif
@@ -1298,6 +1298,9 @@ const struct eth_ops gmac_rockchip_eth_ops = {
 	.free_pkt		= gmac_rockchip_eth_free_pkt,
 	.stop			= gmac_rockchip_eth_stop,
 	.write_hwaddr		= gmac_rockchip_eth_write_hwaddr,
+#ifndef CONFIG_DWC_ETH_QOS
+	.get_stats		= designware_eth_get_stats,
+#endif
 };
 
 #ifndef CONFIG_DWC_ETH_QOS
@@ -13,13 +13,13 @@
 #include <dm/device-internal.h>
 #include "nvme.h"
 
-#define NVME_Q_DEPTH		2
+#define NVME_Q_DEPTH		CONFIG_NVME_QUEUE_DEPTH
 #define NVME_AQ_DEPTH		2
 #define NVME_SQ_SIZE(depth)	(depth * sizeof(struct nvme_command))
 #define NVME_CQ_SIZE(depth)	(depth * sizeof(struct nvme_completion))
 #define ADMIN_TIMEOUT		60
 #define IO_TIMEOUT		30
-#define MAX_PRP_POOL		512
+#define NVME_MAX_TRANSFER_SHIFT	20
 
 enum nvme_queue_id {
 	NVME_ADMIN_Q,
@@ -66,12 +66,19 @@ static int nvme_wait_ready(struct nvme_dev *dev, bool enabled)
 	return -ETIME;
 }
 
-static int nvme_setup_prps(struct nvme_dev *dev, u64 *prp2,
+/* PRP entries of a list page, the last one chains to the next page */
+static u32 nvme_prps_per_page(struct nvme_dev *dev)
+{
+	return (dev->page_size >> 3) - 1;
+}
+
+static int nvme_setup_prps(struct nvme_dev *dev, int slot, u64 *prp2,
 			   int total_len, u64 dma_addr)
 {
 	u32 page_size = dev->page_size;
+	u32 per_page = nvme_prps_per_page(dev);
 	int offset = dma_addr & (page_size - 1);
-	u64 *prp_pool;
+	u64 *prp_list, *prp_pool;
 	int length = total_len;
 	int i, nprps;
 	length -= (page_size - offset);
@@ -90,31 +97,29 @@ static int nvme_setup_prps(struct nvme_dev *dev, u64 *prp2,
 	}
 
 	nprps = DIV_ROUND_UP(length, page_size);
-
-	if (nprps > dev->prp_entry_num) {
-		free(dev->prp_pool);
-		dev->prp_pool = malloc(nprps << 3);
-		if (!dev->prp_pool) {
-			printf("Error: malloc prp_pool fail\n");
-			return -ENOMEM;
-		}
-		dev->prp_entry_num = nprps;
+	if (nprps > dev->prp_pages * per_page) {
+		printf("Error: %d PRP entries exceed the PRP pool\n", nprps);
+		return -EINVAL;
 	}
 
-	prp_pool = dev->prp_pool;
+	prp_list = (void *)dev->prp_pool +
+		   (ulong)slot * dev->prp_pages * page_size;
+	prp_pool = prp_list;
 	i = 0;
 	while (nprps) {
-		if (i == ((page_size >> 3) - 1)) {
+		if (i == per_page) {
 			*(prp_pool + i) = cpu_to_le64((ulong)prp_pool +
 					page_size);
 			i = 0;
-			prp_pool += page_size;
+			prp_pool += page_size >> 3;
 		}
 		*(prp_pool + i++) = cpu_to_le64(dma_addr);
 		dma_addr += page_size;
 		nprps--;
 	}
-	*prp2 = (ulong)dev->prp_pool;
+	flush_dcache_range((ulong)prp_list,
+			   ALIGN((ulong)(prp_pool + i), ARCH_DMA_MINALIGN));
+	*prp2 = (ulong)prp_list;
 
 	return 0;
 }
@@ -137,12 +142,12 @@ static u16 nvme_read_completion_status(struct nvme_queue *nvmeq, u16 index)
 }
 
 /**
- * nvme_submit_cmd() - copy a command into a queue and ring the doorbell
+ * nvme_queue_cmd() - copy a command into a queue without ringing the doorbell
  *
  * @nvmeq:	The queue to use
  * @cmd:	The command to send
  */
-static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
+static void nvme_queue_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
 {
 	u16 tail = nvmeq->sq_tail;
 
@@ -152,50 +157,51 @@ static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
 
 	if (++tail == nvmeq->q_depth)
 		tail = 0;
-	writel(tail, nvmeq->q_db);
 	nvmeq->sq_tail = tail;
 }
 
-static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
-				struct nvme_command *cmd,
-				u32 *result, unsigned timeout)
+/**
+ * nvme_submit_cmd() - copy a command into a queue and ring the doorbell
+ *
+ * @nvmeq:	The queue to use
+ * @cmd:	The command to send
+ */
+static void nvme_submit_cmd(struct nvme_queue *nvmeq, struct nvme_command *cmd)
+{
+	nvme_queue_cmd(nvmeq, cmd);
+	writel(nvmeq->sq_tail, nvmeq->q_db);
+}
+
+/**
+ * nvme_poll_cqe() - wait for the next completion of a queue and consume it
+ *
+ * @nvmeq:	The queue to poll
+ * @status:	Returns the status field of the completion, without phase
+ * @result:	Returns the command specific result, may be NULL
+ * @timeout_us:	Time to wait, 0 to wait forever
+ * @return identifier of the completed command, -ETIMEDOUT if nothing
+ * completed in time
+ */
+static int nvme_poll_cqe(struct nvme_queue *nvmeq, u16 *status, u32 *result,
+			 ulong timeout_us)
 {
 	u16 head = nvmeq->cq_head;
 	u16 phase = nvmeq->cq_phase;
-	u16 status;
-	ulong start_time;
-	ulong timeout_us = timeout * 100000;
-
-	cmd->common.command_id = nvme_get_cmd_id();
-	nvme_submit_cmd(nvmeq, cmd);
-
-	start_time = timer_get_us();
+	ulong start_time = timer_get_us();
+	int cmdid;
+	u16 val;
 
 	for (;;) {
-		status = nvme_read_completion_status(nvmeq, head);
-		if ((status & 0x01) == phase)
+		val = nvme_read_completion_status(nvmeq, head);
+		if ((val & 0x01) == phase)
 			break;
 		if (timeout_us > 0 && (timer_get_us() - start_time)
 		    >= timeout_us)
 			return -ETIMEDOUT;
 	}
 
-	status >>= 1;
-	if (status) {
-		printf("ERROR: status = %x, phase = %d, head = %d\n",
-		       status, phase, head);
-		status = 0;
-		if (++head == nvmeq->q_depth) {
-			head = 0;
-			phase = !phase;
-		}
-		writel(head, nvmeq->q_db + nvmeq->dev->db_stride);
-		nvmeq->cq_head = head;
-		nvmeq->cq_phase = phase;
-
-		return -EIO;
-	}
-
+	*status = val >> 1;
+	cmdid = le16_to_cpu(readw(&(nvmeq->cqes[head].command_id)));
 	if (result)
 		*result = le32_to_cpu(readl(&(nvmeq->cqes[head].result)));
 
@@ -207,7 +213,30 @@ static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
 	nvmeq->cq_head = head;
 	nvmeq->cq_phase = phase;
 
-	return status;
+	return cmdid;
+}
+
+static int nvme_submit_sync_cmd(struct nvme_queue *nvmeq,
+				struct nvme_command *cmd,
+				u32 *result, unsigned timeout)
+{
+	ulong timeout_us = timeout * 100000;
+	u16 status;
+	int ret;
+
+	cmd->common.command_id = nvme_get_cmd_id();
+	nvme_submit_cmd(nvmeq, cmd);
+
+	ret = nvme_poll_cqe(nvmeq, &status, result, timeout_us);
+	if (ret < 0)
+		return ret;
+
+	if (status) {
+		printf("ERROR: status = %x, command id = %d\n", status, ret);
+		return -EIO;
+	}
+
+	return 0;
 }
 
 static int nvme_submit_admin_cmd(struct nvme_dev *dev, struct nvme_command *cmd,
@@ -610,6 +639,27 @@ static int nvme_get_info_from_identify(struct nvme_dev *dev)
 		 */
 		dev->max_transfer_shift = 20;
 	}
+	/* Bounds the PRP list reserved for each I/O queue entry */
+	dev->max_transfer_shift = min_t(u32, dev->max_transfer_shift,
+					NVME_MAX_TRANSFER_SHIFT);
+
+	return 0;
+}
+
+/*
+ * Reserve a PRP list for every I/O queue entry, large enough for the
+ * maximum transfer at any buffer offset, so that commands in flight
+ * never share a list and nothing is allocated on the I/O path.
+ */
+static int nvme_alloc_prp_pool(struct nvme_dev *dev)
+{
+	u32 nprps = (1 << dev->max_transfer_shift) / dev->page_size + 1;
+
+	dev->prp_pages = DIV_ROUND_UP(nprps, nvme_prps_per_page(dev));
+	dev->prp_pool = memalign(dev->page_size, (ulong)dev->q_depth *
+				 dev->prp_pages * dev->page_size);
+	if (!dev->prp_pool)
+		return -ENOMEM;
 
 	return 0;
 }
@@ -670,65 +720,161 @@ static int nvme_blk_probe(struct udevice *udev)
 	return 0;
 }
 
+/* An I/O command in flight, indexed by its PRP list slot */
+struct nvme_io_slot {
+	u64 slba;
+	u32 lbas;
+	u16 cmdid;
+	ulong start;
+};
+
+static void nvme_account(struct nvme_dev *dev, ulong bytes, ulong start,
+			 bool error)
+{
+	struct nvme_stats *st = &dev->stats;
+	ulong us = timer_get_us() - start;
+	int i;
+
+	st->cmds++;
+	if (error) {
+		st->errors++;
+		return;
+	}
+
+	st->bytes += bytes;
+	st->lat_total += us;
+	if (us < st->lat_min || st->cmds == st->errors + 1)
+		st->lat_min = us;
+	if (us > st->lat_max)
+		st->lat_max = us;
+	for (i = 0; i < NVME_LAT_BUCKETS - 1 && us >= (64UL << i); i++)
+		;
+	st->hist[i]++;
+}
+
+static int nvme_find_slot(struct nvme_io_slot *slots, u64 busy, int cmdid)
+{
+	int slot;
+
+	for (slot = 0; busy; slot++, busy >>= 1)
+		if ((busy & 1) && slots[slot].cmdid == cmdid)
+			return slot;
+
+	return -ENOENT;
+}
+
+/*
+ * Split the request into commands of the maximum transfer size and keep
+ * up to q_depth - 1 of them in flight. New commands are queued as slots
+ * free up and the doorbell is rung once per batch. After a failure no
+ * more commands are issued; the blocks below the first failed command
+ * are reported as transferred.
+ */
 static ulong nvme_blk_rw(struct udevice *udev, lbaint_t blknr,
 			 lbaint_t blkcnt, void *buffer, bool read)
 {
 	struct nvme_ns *ns = dev_get_priv(udev);
 	struct nvme_dev *dev = ns->dev;
+	struct nvme_queue *nvmeq = dev->queues[NVME_IO_Q];
+	struct nvme_io_slot slots[NVME_Q_DEPTH];
 	struct nvme_command c;
 	struct blk_desc *desc = dev_get_uclass_platdata(udev);
-	int status;
-	u64 prp2;
 	u64 total_len = blkcnt << desc->log2blksz;
-	u64 temp_len = total_len;
-
+	u32 max_lbas = 1 << (dev->max_transfer_shift - ns->lba_shift);
+	u64 all_slots = GENMASK_ULL(dev->q_depth - 2, 0);
+	u64 free_slots = all_slots;
 	u64 slba = blknr;
-	u16 lbas = 1 << (dev->max_transfer_shift - ns->lba_shift);
+	u64 fail_lba = blknr + blkcnt;
 	u64 total_lbas = blkcnt;
+	void *buf = buffer;
+	int inflight = 0;
+	int slot, cmdid;
+	bool queued;
+	u16 status;
+	u32 lbas;
+	u64 prp2;
 
 	if (!read)
 		flush_dcache_range((unsigned long)buffer,
 				   (unsigned long)buffer + total_len);
 
+	memset(&c, 0, sizeof(c));
 	c.rw.opcode = read ? nvme_cmd_read : nvme_cmd_write;
-	c.rw.flags = 0;
 	c.rw.nsid = cpu_to_le32(ns->ns_id);
-	c.rw.control = 0;
-	c.rw.dsmgmt = 0;
-	c.rw.reftag = 0;
-	c.rw.apptag = 0;
-	c.rw.appmask = 0;
-	c.rw.metadata = 0;
-
-	while (total_lbas) {
-		if (total_lbas < lbas) {
-			lbas = (u16)total_lbas;
-			total_lbas = 0;
-		} else {
+
+	for (;;) {
+		queued = false;
+		while (total_lbas && free_slots && slba < fail_lba) {
+			slot = __ffs64(free_slots);
+			lbas = min_t(u64, total_lbas, max_lbas);
+			if (nvme_setup_prps(dev, slot, &prp2,
+					    lbas << ns->lba_shift, (ulong)buf)) {
+				fail_lba = slba;
+				break;
+			}
+
+			slots[slot].cmdid = le16_to_cpu(nvme_get_cmd_id());
+			slots[slot].slba = slba;
+			slots[slot].lbas = lbas;
+			slots[slot].start = timer_get_us();
+			c.rw.command_id = cpu_to_le16(slots[slot].cmdid);
+			c.rw.slba = cpu_to_le64(slba);
+			c.rw.length = cpu_to_le16(lbas - 1);
+			c.rw.prp1 = cpu_to_le64((ulong)buf);
+			c.rw.prp2 = cpu_to_le64(prp2);
+			nvme_queue_cmd(nvmeq, &c);
+
+			free_slots &= ~BIT_ULL(slot);
+			inflight++;
+			queued = true;
+			slba += lbas;
 			total_lbas -= lbas;
+			buf += lbas << ns->lba_shift;
 		}
+		if (queued) {
+			writel(nvmeq->sq_tail, nvmeq->q_db);
+			dev->stats.max_inflight = max_t(u32, inflight,
+						dev->stats.max_inflight);
+		}
+		if (!inflight)
+			break;
 
-		if (nvme_setup_prps(dev, &prp2,
-				    lbas << ns->lba_shift, (ulong)buffer))
-			return -EIO;
-		c.rw.slba = cpu_to_le64(slba);
-		slba += lbas;
-		c.rw.length = cpu_to_le16(lbas - 1);
-		c.rw.prp1 = cpu_to_le64((ulong)buffer);
-		c.rw.prp2 = cpu_to_le64(prp2);
-		status = nvme_submit_sync_cmd(dev->queues[NVME_IO_Q],
-				&c, NULL, IO_TIMEOUT);
-		if (status)
+		cmdid = nvme_poll_cqe(nvmeq, &status, NULL,
+				      IO_TIMEOUT * 100000);
+		if (cmdid < 0) {
+			printf("ERROR: timeout, %d commands in flight\n",
+			       inflight);
+			for (slot = 0; slot < dev->q_depth - 1; slot++) {
+				if (free_slots & BIT_ULL(slot))
+					continue;
+				fail_lba = min(fail_lba, slots[slot].slba);
+				nvme_account(dev, 0, 0, true);
+			}
 			break;
-		temp_len -= (u32)lbas << ns->lba_shift;
-		buffer += lbas << ns->lba_shift;
+		}
+
+		slot = nvme_find_slot(slots, all_slots & ~free_slots, cmdid);
+		if (slot < 0) {
+			debug("%s: stale completion %d\n", __func__, cmdid);
+			continue;
+		}
+
+		nvme_account(dev, slots[slot].lbas << ns->lba_shift,
+			     slots[slot].start, status);
+		if (status) {
+			printf("ERROR: status = %x, lba = %llu\n", status,
+			       slots[slot].slba);
+			fail_lba = min(fail_lba, slots[slot].slba);
+		}
+		free_slots |= BIT_ULL(slot);
+		inflight--;
 	}
 
 	if (read)
 		invalidate_dcache_range((unsigned long)buffer,
 					(unsigned long)buffer + total_len);
 
-	return (total_len - temp_len) >> desc->log2blksz;
+	return fail_lba - blknr;
 }
 
 static ulong nvme_blk_read(struct udevice *udev, lbaint_t blknr,
@@ -790,14 +936,6 @@ static int nvme_probe(struct udevice *udev)
 	}
 	memset(ndev->queues, 0, NVME_Q_NUM * sizeof(struct nvme_queue *));
 
-	ndev->prp_pool = malloc(MAX_PRP_POOL);
-	if (!ndev->prp_pool) {
-		ret = -ENOMEM;
-		printf("Error: %s: Out of memory!\n", udev->name);
-		goto free_nvme;
-	}
-	ndev->prp_entry_num = MAX_PRP_POOL >> 3;
-
 	ndev->cap = nvme_readq(&ndev->bar->cap);
 	ndev->q_depth = min_t(int, NVME_CAP_MQES(ndev->cap) + 1, NVME_Q_DEPTH);
 	ndev->db_stride = 1 << NVME_CAP_STRIDE(ndev->cap);
@@ -813,6 +951,12 @@ static int nvme_probe(struct udevice *udev)
 
 	nvme_get_info_from_identify(ndev);
 
+	ret = nvme_alloc_prp_pool(ndev);
+	if (ret) {
+		printf("Error: %s: Out of memory!\n", udev->name);
+		goto free_queue;
+	}
+
 	return 0;
 
 free_queue:
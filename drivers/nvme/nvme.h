@@ -603,6 +603,20 @@ enum {
 	NVME_CSTS_SHST_MASK	= 3 << 2,
 };
 
+#define NVME_LAT_BUCKETS	8
+
+/* I/O command statistics, see nvme_print_stats() */
+struct nvme_stats {
+	u64 cmds;
+	u64 bytes;
+	u64 lat_total;		/* us, of the successful commands */
+	u32 lat_min;
+	u32 lat_max;
+	u32 errors;
+	u32 max_inflight;
+	u32 hist[NVME_LAT_BUCKETS];	/* < 64us, doubling up to >= 4096us */
+};
+
 /* Represents an NVM Express device. Each nvme_dev is a PCI function. */
 struct nvme_dev {
 	struct list_head node;
@@ -625,9 +639,10 @@ struct nvme_dev {
 	u32 stripe_size;
 	u32 page_size;
 	u8 vwc;
-	u64 *prp_pool;
-	u32 prp_entry_num;
+	u64 *prp_pool;		/* one PRP list per I/O queue entry */
+	u32 prp_pages;		/* pages of each PRP list */
 	u32 nn;
+	struct nvme_stats stats;
 };
 
 /*
@@ -6,6 +6,7 @@
  */
 
 #include <common.h>
+#include <div64.h>
 #include <dm.h>
 #include <errno.h>
 #include <memalign.h>
@@ -128,3 +129,32 @@ int nvme_print_info(struct udevice *udev)
 
 	return 0;
 }
+
+void nvme_print_stats(struct udevice *udev)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
+	struct nvme_stats *st = &ns->dev->stats;
+	u64 done = st->cmds - st->errors;
+	int i;
+
+	printf("%s: I/O statistics:\n", udev->parent->name);
+	printf("\tCommands: %llu, errors: %u, max in flight: %u\n",
+	       st->cmds, st->errors, st->max_inflight);
+	printf("\tData: ");
+	print_size(st->bytes, "\n");
+	if (!done)
+		return;
+
+	printf("\tLatency: min %u us, avg %llu us, max %u us\n",
+	       st->lat_min, lldiv(st->lat_total, done), st->lat_max);
+	for (i = 0; i < NVME_LAT_BUCKETS - 1; i++)
+		printf("\t  < %5u us: %u\n", 64 << i, st->hist[i]);
+	printf("\t >= %5u us: %u\n", 64 << (i - 1), st->hist[i]);
+}
+
+void nvme_reset_stats(struct udevice *udev)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
+
+	memset(&ns->dev->stats, 0, sizeof(ns->dev->stats));
+}
@@ -9,6 +9,9 @@
 #include <dm/pinctrl.h>
 #include <dm/ofnode.h>
 #include <linux/bitops.h>
+#include <linux/err.h>
+#include <linux/list.h>
+#include <malloc.h>
 #include <regmap.h>
 #include <syscon.h>
 #include <asm/arch/cpu.h>
@@ -17,6 +20,8 @@
 #define MAX_ROCKCHIP_GPIO_PER_BANK	32
 #define RK_FUNC_GPIO			0
 #define MAX_ROCKCHIP_PINS_ENTRIES	30
+/* Mux, route and a few settings, some of which take two registers */
+#define MAX_ROCKCHIP_WRITES_PER_PIN	8
 
 enum rockchip_pinctrl_type {
 	PX30,
@@ -389,14 +394,116 @@ struct rockchip_pin_ctrl {
 };
 
 /**
+ * struct rockchip_pin_write - one register update of a pinctrl state
+ *
+ * @regmap: GRF or PMUGRF
+ * @reg: Register offset
+ * @mask: Bits to change
+ * @val: New value of those bits
+ * @hiword: true if the register has write enable bits in its upper half,
+ *	    false if it must be read, modified and written
+ */
+struct rockchip_pin_write {
+	struct regmap *regmap;
+	u32 reg;
+	u32 mask;
+	u32 val;
+	bool hiword;
+};
+
+/**
+ * struct rockchip_pin_state - a pinctrl state compiled to register updates
+ *
+ * The first time a pinconfig device is selected, its pins and settings are
+ * turned into a list of updates, merged per register. The list is kept so
+ * that selecting the state again does not parse the device tree.
+ *
+ * @node: Entry in rockchip_pinctrl_priv.states
+ * @config: pinconfig device this was compiled from
+ * @count: Number of entries used in @writes
+ * @max: Number of entries allocated in @writes
+ * @writes: Register updates, in the order first seen
+ */
+struct rockchip_pin_state {
+	struct list_head node;
+	struct udevice *config;
+	int count;
+	int max;
+	struct rockchip_pin_write writes[];
+};
+
+/**
+ * @record: State being compiled, NULL to write the registers directly
+ * @states: Compiled states, list of struct rockchip_pin_state
  */
 struct rockchip_pinctrl_priv {
 	struct rockchip_pin_ctrl	*ctrl;
 	struct regmap			*regmap_base;
 	struct regmap			*regmap_pmu;
-
+	struct rockchip_pin_state	*record;
+	struct list_head		states;
 };
 
+static int rockchip_pin_apply(const struct rockchip_pin_write *w)
+{
+	u32 data;
+	int ret;
+
+	if (w->hiword)
+		return regmap_write(w->regmap, w->reg, w->mask << 16 | w->val);
+
+	ret = regmap_read(w->regmap, w->reg, &data);
+	if (ret)
+		return ret;
+
+	return regmap_write(w->regmap, w->reg, (data & ~w->mask) | w->val);
+}
+
+/*
+ * Change the @mask bits of a register to @val, or add this to the state
+ * being compiled. Updates which only touch their own mask are merged with
+ * an earlier update of the same register.
+ */
+static int rockchip_pin_update(struct rockchip_pinctrl_priv *priv,
+			       struct regmap *regmap, u32 reg, u32 mask,
+			       u32 val, bool hiword)
+{
+	struct rockchip_pin_state *state = priv->record;
+	struct rockchip_pin_write *w;
+	int i;
+
+	if (!state) {
+		struct rockchip_pin_write one = {
+			regmap, reg, mask, val, hiword
+		};
+
+		return rockchip_pin_apply(&one);
+	}
+
+	if (!(val & ~mask)) {
+		for (i = 0; i < state->count; i++) {
+			w = &state->writes[i];
+			if (w->regmap != regmap || w->reg != reg ||
+			    w->hiword != hiword || (w->val & ~w->mask))
+				continue;
+			w->val = (w->val & ~mask) | val;
+			w->mask |= mask;
+			return 0;
+		}
+	}
+
+	if (state->count == state->max)
+		return -ENOSPC;
+	w = &state->writes[state->count++];
+	w->regmap = regmap;
+	w->reg = reg;
+	w->mask = mask;
+	w->val = val;
+	w->hiword = hiword;
+
+	return 0;
+}
+
 static int rockchip_verify_config(struct udevice *dev, u32 bank, u32 pin)
 {
 	struct rockchip_pinctrl_priv *priv = dev_get_priv(dev);
@@ -1685,7 +1792,6 @@ static int rockchip_set_mux(struct rockchip_pin_bank *bank, int pin, int mux)
 	struct regmap *regmap;
 	int reg, ret, mask, mux_type;
 	u8 bit;
-	u32 data;
 
 	ret = rockchip_verify_mux(bank, pin, mux);
 	if (ret < 0)
@@ -1731,31 +1837,32 @@ static int rockchip_set_mux(struct rockchip_pin_bank *bank, int pin, int mux)
 					     &route_reg, &route_val);
 		switch (ret) {
 		case ROUTE_TYPE_DEFAULT:
-			regmap_write(regmap, route_reg, route_val);
+			ret = rockchip_pin_update(priv, regmap, route_reg,
+						  route_val >> 16,
+						  route_val & 0xffff, true);
 			break;
 		case ROUTE_TYPE_TOPGRF:
-			regmap_write(priv->regmap_base, route_reg, route_val);
+			ret = rockchip_pin_update(priv, priv->regmap_base,
+						  route_reg, route_val >> 16,
+						  route_val & 0xffff, true);
 			break;
 		case ROUTE_TYPE_PMUGRF:
-			regmap_write(priv->regmap_pmu, route_reg, route_val);
+			ret = rockchip_pin_update(priv, priv->regmap_pmu,
+						  route_reg, route_val >> 16,
+						  route_val & 0xffff, true);
 			break;
 		case ROUTE_TYPE_INVALID: /* Fall through */
 		default:
+			ret = 0;
 			break;
 		}
+		if (ret == -ENOSPC)
+			return ret;
 	}
 
-	if (mux_type & IOMUX_WRITABLE_32BIT) {
-		regmap_read(regmap, reg, &data);
-		data &= ~(mask << bit);
-	} else {
-		data = (mask << (bit + 16));
-	}
-
-	data |= (mux & mask) << bit;
-	ret = regmap_write(regmap, reg, data);
-
-	return ret;
+	return rockchip_pin_update(priv, regmap, reg, mask << bit,
+				   (mux & mask) << bit,
+				   !(mux_type & IOMUX_WRITABLE_32BIT));
 }
 
 #define PX30_PULL_PMU_OFFSET		0x10
@@ -2529,16 +2636,14 @@ static int rockchip_set_drive_perpin(struct rockchip_pin_bank *bank,
 			data = (ret & 0x1) << 15;
 			temp = (ret >> 0x1) & 0x3;
 
-			data |= BIT(31);
-			ret = regmap_write(regmap, reg, data);
+			ret = rockchip_pin_update(priv, regmap, reg, BIT(15),
+						  data, true);
 			if (ret)
 				return ret;
 
-			temp |= (0x3 << 16);
 			reg += 0x4;
-			ret = regmap_write(regmap, reg, temp);
-
-			return ret;
+			return rockchip_pin_update(priv, regmap, reg, 0x3,
+						   temp, true);
 		case 18 ... 21:
 			/* setting fully enclosed in the second register */
 			reg += 4;
@@ -2562,17 +2667,10 @@ static int rockchip_set_drive_perpin(struct rockchip_pin_bank *bank,
 	}
 
 config:
-	if (bank->drv[pin_num / 8].drv_type & DRV_TYPE_WRITABLE_32BIT) {
-		regmap_read(regmap, reg, &data);
-		data &= ~(((1 << rmask_bits) - 1) << bit);
-	} else {
-		/* enable the write to the equivalent lower bits */
-		data = ((1 << rmask_bits) - 1) << (bit + 16);
-	}
-
-	data |= (ret << bit);
-	ret = regmap_write(regmap, reg, data);
-	return ret;
+	return rockchip_pin_update(priv, regmap, reg,
+				   ((1 << rmask_bits) - 1) << bit, ret << bit,
+				   !(bank->drv[pin_num / 8].drv_type &
+				     DRV_TYPE_WRITABLE_32BIT));
 }
 
 static int rockchip_pull_list[PULL_TYPE_MAX][4] = {
@@ -2612,10 +2710,11 @@ static int rockchip_set_pull(struct rockchip_pin_bank *bank,
 	switch (ctrl->type) {
 	case RK2928:
 	case RK3128:
-		data = BIT(bit + 16);
+		data = 0;
 		if (pull == PIN_CONFIG_BIAS_DISABLE)
 			data |= BIT(bit);
-		ret = regmap_write(regmap, reg, data);
+		ret = rockchip_pin_update(priv, regmap, reg, BIT(bit), data,
+					  true);
 		break;
 	case PX30:
 	case RV1108:
@@ -2645,16 +2744,11 @@ static int rockchip_set_pull(struct rockchip_pin_bank *bank,
 			return ret;
 		}
 
-		if (bank->pull_type[pin_num / 8] & PULL_TYPE_WRITABLE_32BIT) {
-			regmap_read(regmap, reg, &data);
-			data &= ~(((1 << RK3188_PULL_BITS_PER_PIN) - 1) << bit);
-		} else {
-			/* enable the write to the equivalent lower bits */
-			data = ((1 << RK3188_PULL_BITS_PER_PIN) - 1) << (bit + 16);
-		}
-
-		data |= (ret << bit);
-		ret = regmap_write(regmap, reg, data);
+		ret = rockchip_pin_update(priv, regmap, reg,
+					  ((1 << RK3188_PULL_BITS_PER_PIN) - 1) << bit,
+					  ret << bit,
+					  !(bank->pull_type[pin_num / 8] &
+					    PULL_TYPE_WRITABLE_32BIT));
 		break;
 	default:
 		debug("unsupported pinctrl type\n");
@@ -2694,7 +2788,6 @@ static int rockchip_set_schmitt(struct rockchip_pin_bank *bank,
 	struct regmap *regmap;
 	int reg, ret;
 	u8 bit;
-	u32 data;
 
 	debug("setting input schmitt of GPIO%d-%d to %d\n", bank->bank_num,
 	      pin_num, enable);
@@ -2703,10 +2796,8 @@ static int rockchip_set_schmitt(struct rockchip_pin_bank *bank,
 	if (ret)
 		return ret;
 
-	/* enable the write to the equivalent lower bits */
-	data = BIT(bit + 16) | (enable << bit);
-
-	return regmap_write(regmap, reg, data);
+	return rockchip_pin_update(priv, regmap, reg, BIT(bit), enable << bit,
+				   true);
 }
 
 #define PX30_SLEW_RATE_PMU_OFFSET		0x30
@@ -2747,7 +2838,6 @@ static int rockchip_set_slew_rate(struct rockchip_pin_bank *bank,
 	struct regmap *regmap;
 	int reg, ret;
 	u8 bit;
-	u32 data;
 
 	debug("setting slew rate of GPIO%d-%d to %d\n", bank->bank_num,
 	      pin_num, speed);
@@ -2756,10 +2846,8 @@ static int rockchip_set_slew_rate(struct rockchip_pin_bank *bank,
 	if (ret)
 		return ret;
 
-	/* enable the write to the equivalent lower bits */
-	data = BIT(bit + 16) | (speed << bit);
-
-	return regmap_write(regmap, reg, data);
+	return rockchip_pin_update(priv, regmap, reg, BIT(bit), speed << bit,
+				   true);
 }
 
 /*
@@ -2888,8 +2976,8 @@ static int rockchip_pinconf_prop_name_to_param(const char *property,
 	return -EPERM;
 }
 
-static int rockchip_pinctrl_set_state(struct udevice *dev,
-				      struct udevice *config)
+static int rockchip_pinctrl_config(struct udevice *dev,
+				   struct udevice *config)
 {
 	struct rockchip_pinctrl_priv *priv = dev_get_priv(dev);
 	struct rockchip_pin_ctrl *ctrl = priv->ctrl;
@@ -2978,6 +3066,73 @@ static int rockchip_pinctrl_set_state(struct udevice *dev,
 	return 0;
 }
 
+#ifndef CONFIG_SPL_BUILD
+static struct rockchip_pin_state *
+rockchip_pinctrl_compile(struct udevice *dev, struct udevice *config)
+{
+	struct rockchip_pinctrl_priv *priv = dev_get_priv(dev);
+	struct rockchip_pin_state *state;
+	int count, max, ret;
+
+	if (!dev_read_prop(config, "rockchip,pins", &count))
+		return ERR_PTR(-EINVAL);
+	max = max(count / (int)(4 * sizeof(u32)), 1) *
+	      MAX_ROCKCHIP_WRITES_PER_PIN;
+
+	state = malloc(sizeof(*state) + max * sizeof(state->writes[0]));
+	if (!state)
+		return ERR_PTR(-ENOMEM);
+	state->config = config;
+	state->count = 0;
+	state->max = max;
+
+	priv->record = state;
+	ret = rockchip_pinctrl_config(dev, config);
+	priv->record = NULL;
+	if (ret) {
+		free(state);
+		return ERR_PTR(ret);
+	}
+	debug("%s: %s: %d register updates\n", __func__, config->name,
+	      state->count);
+
+	return state;
+}
+#endif
+
+static int rockchip_pinctrl_set_state(struct udevice *dev,
+				      struct udevice *config)
+{
+#ifndef CONFIG_SPL_BUILD
+	struct rockchip_pinctrl_priv *priv = dev_get_priv(dev);
+	struct rockchip_pin_state *state;
+	int i, ret;
+
+	list_for_each_entry(state, &priv->states, node) {
+		if (state->config == config)
+			goto apply;
+	}
+
+	state = rockchip_pinctrl_compile(dev, config);
+	if (PTR_ERR(state) == -ENOSPC)
+		return rockchip_pinctrl_config(dev, config);
+	if (IS_ERR(state))
+		return PTR_ERR(state);
+	list_add(&state->node, &priv->states);
+
+apply:
+	for (i = 0; i < state->count; i++) {
+		ret = rockchip_pin_apply(&state->writes[i]);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+#else
+	return rockchip_pinctrl_config(dev, config);
+#endif
+}
+
 static int rockchip_pinctrl_get_pins_count(struct udevice *dev)
 {
 	struct rockchip_pinctrl_priv *priv = dev_get_priv(dev);
@@ -3210,6 +3365,8 @@ static int rockchip_pinctrl_probe(struct udevice *dev)
 	}
 
 	priv->ctrl = (struct rockchip_pin_ctrl *)ctrl;
+	INIT_LIST_HEAD(&priv->states);
+
 	return 0;
 }
 
@@ -9,6 +9,7 @@
 #include <fdtdec.h>
 #include <errno.h>
 #include <dm.h>
+#include <malloc.h>
 #include <vsprintf.h>
 #include <dm/lists.h>
 #include <dm/device-internal.h>
@@ -126,9 +127,318 @@ int pmic_reg_count(struct udevice *dev)
 	return ops->reg_count(dev);
 }
 
+#if CONFIG_IS_ENABLED(DM_PMIC_CACHE)
+#define PMIC_CACHE_QUEUE_LEN	32
+
+/* A write to a cached register held back until pmic_cache_commit() */
+struct pmic_cache_write {
+	uint reg;
+	u8 val;
+};
+
+/**
+ * struct pmic_uc_priv - per-device data of the PMIC uclass
+ *
+ * @ranges:	Cached registers, as given to pmic_cache_init()
+ * @range_count: Number of entries in @ranges
+ * @reg_count:	Size of @vals and @valid
+ * @vals:	Cached register values, including queued writes
+ * @valid:	Non-zero for each register whose value is in @vals
+ * @deferred:	Writes to cached registers are queued
+ * @queue_len:	Number of entries in @queue
+ * @queue:	Queued writes, in the order they were made
+ * @stats:	Bus transfer counters
+ */
+struct pmic_uc_priv {
+	const struct pmic_reg_range *ranges;
+	int range_count;
+	int reg_count;
+	u8 *vals;
+	u8 *valid;
+	bool deferred;
+	int queue_len;
+	struct pmic_cache_write queue[PMIC_CACHE_QUEUE_LEN];
+	struct pmic_stats stats;
+};
+
+static struct pmic_uc_priv *pmic_uc_priv(struct udevice *dev)
+{
+	if (device_get_uclass_id(dev) != UCLASS_PMIC)
+		return NULL;
+
+	return dev_get_uclass_priv(dev);
+}
+
+static bool pmic_cache_reg(struct pmic_uc_priv *priv, uint reg)
+{
+	int i;
+
+	if (!priv || !priv->vals || reg >= priv->reg_count)
+		return false;
+
+	for (i = 0; i < priv->range_count; i++) {
+		if (reg >= priv->ranges[i].first && reg <= priv->ranges[i].last)
+			return true;
+	}
+
+	return false;
+}
+
+/* Record what the registers from @reg on hold after a bus transfer */
+static void pmic_cache_update(struct pmic_uc_priv *priv, uint reg,
+			      const u8 *buffer, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++) {
+		if (pmic_cache_reg(priv, reg + i)) {
+			priv->vals[reg + i] = buffer[i];
+			priv->valid[reg + i] = 1;
+		}
+	}
+}
+
+/* Send the queued writes, one bus write per run of consecutive registers */
+static int pmic_cache_flush(struct udevice *dev, struct pmic_uc_priv *priv)
+{
+	const struct dm_pmic_ops *ops = dev_get_driver_ops(dev);
+	struct pmic_cache_write *queue = priv->queue;
+	u8 buffer[PMIC_CACHE_QUEUE_LEN];
+	int i, j, n, err, ret = 0;
+
+	if (!priv->queue_len)
+		return 0;
+	if (!ops || !ops->write)
+		return -ENOSYS;
+
+	for (i = 0; i < priv->queue_len; i += n) {
+		buffer[0] = queue[i].val;
+		for (n = 1; i + n < priv->queue_len &&
+		     queue[i + n].reg == queue[i].reg + n; n++)
+			buffer[n] = queue[i + n].val;
+
+		err = ops->write(dev, queue[i].reg, buffer, n);
+		priv->stats.writes++;
+		priv->stats.write_merges += n - 1;
+		if (err) {
+			/* The registers now hold something unknown */
+			for (j = 0; j < n; j++)
+				priv->valid[queue[i + j].reg] = 0;
+			if (!ret)
+				ret = err;
+		}
+	}
+	priv->queue_len = 0;
+
+	return ret;
+}
+
+static int pmic_cache_queue(struct udevice *dev, struct pmic_uc_priv *priv,
+			    uint reg, u8 val)
+{
+	struct pmic_cache_write *last = NULL;
+	int ret;
+
+	if (priv->queue_len)
+		last = &priv->queue[priv->queue_len - 1];
+
+	if (last && last->reg == reg) {
+		last->val = val;
+		priv->stats.write_merges++;
+	} else {
+		if (priv->queue_len == PMIC_CACHE_QUEUE_LEN) {
+			ret = pmic_cache_flush(dev, priv);
+			if (ret)
+				return ret;
+		}
+		priv->queue[priv->queue_len].reg = reg;
+		priv->queue[priv->queue_len].val = val;
+		priv->queue_len++;
+	}
+	priv->vals[reg] = val;
+	priv->valid[reg] = 1;
+
+	return 0;
+}
+
+/* Called before a bus transfer: queued writes must reach the device first */
+static int pmic_cache_sync(struct udevice *dev, struct pmic_uc_priv *priv)
+{
+	return priv ? pmic_cache_flush(dev, priv) : 0;
+}
+
+static void pmic_cache_read_done(struct pmic_uc_priv *priv, uint reg,
+				 const u8 *buffer, int len, int ret)
+{
+	if (!priv)
+		return;
+
+	priv->stats.reads++;
+	if (!ret)
+		pmic_cache_update(priv, reg, buffer, len);
+}
+
+static void pmic_cache_write_done(struct pmic_uc_priv *priv, uint reg,
+				  const u8 *buffer, int len, int ret)
+{
+	int i;
+
+	if (!priv)
+		return;
+
+	priv->stats.writes++;
+	if (!ret) {
+		pmic_cache_update(priv, reg, buffer, len);
+		return;
+	}
+	for (i = 0; i < len; i++) {
+		if (pmic_cache_reg(priv, reg + i))
+			priv->valid[reg + i] = 0;
+	}
+}
+
+/* Returns the cached value of @reg, or -ENOENT if it must be read */
+static int pmic_cache_read_reg(struct pmic_uc_priv *priv, uint reg)
+{
+	if (!pmic_cache_reg(priv, reg) || !priv->valid[reg])
+		return -ENOENT;
+
+	priv->stats.read_hits++;
+
+	return priv->vals[reg];
+}
+
+/* Returns -ENOENT if the write to @reg must go to the bus now */
+static int pmic_cache_write_reg(struct udevice *dev, struct pmic_uc_priv *priv,
+				uint reg, u8 val)
+{
+	if (!pmic_cache_reg(priv, reg))
+		return -ENOENT;
+
+	if (priv->valid[reg] && priv->vals[reg] == val) {
+		priv->stats.write_skips++;
+		return 0;
+	}
+	if (!priv->deferred)
+		return -ENOENT;
+
+	return pmic_cache_queue(dev, priv, reg, val);
+}
+
+int pmic_cache_init(struct udevice *dev, const struct pmic_reg_range *ranges,
+		    int count)
+{
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+	int reg_count;
+
+	if (!priv)
+		return -EINVAL;
+
+	reg_count = pmic_reg_count(dev);
+	if (reg_count <= 0)
+		return reg_count ? reg_count : -EINVAL;
+
+	free(priv->vals);
+	priv->vals = calloc(2, reg_count);
+	if (!priv->vals)
+		return -ENOMEM;
+	priv->valid = priv->vals + reg_count;
+	priv->reg_count = reg_count;
+	priv->ranges = ranges;
+	priv->range_count = count;
+
+	return 0;
+}
+
+int pmic_cache_begin(struct udevice *dev)
+{
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+
+	if (!priv)
+		return -EINVAL;
+
+	priv->deferred = true;
+
+	return 0;
+}
+
+int pmic_cache_commit(struct udevice *dev)
+{
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+
+	if (!priv)
+		return -EINVAL;
+
+	priv->deferred = false;
+
+	return pmic_cache_flush(dev, priv);
+}
+
+int pmic_get_stats(struct udevice *dev, struct pmic_stats *stats)
+{
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+
+	if (!priv)
+		return -EINVAL;
+
+	*stats = priv->stats;
+
+	return 0;
+}
+
+static int pmic_pre_remove(struct udevice *dev)
+{
+	struct pmic_uc_priv *priv = dev_get_uclass_priv(dev);
+
+	/* A failed write is reported by the driver, carry on removing */
+	pmic_cache_commit(dev);
+	free(priv->vals);
+	priv->vals = NULL;
+
+	return 0;
+}
+#else
+struct pmic_uc_priv;
+
+static inline struct pmic_uc_priv *pmic_uc_priv(struct udevice *dev)
+{
+	return NULL;
+}
+
+static inline int pmic_cache_sync(struct udevice *dev,
+				  struct pmic_uc_priv *priv)
+{
+	return 0;
+}
+
+static inline void pmic_cache_read_done(struct pmic_uc_priv *priv, uint reg,
+					const u8 *buffer, int len, int ret)
+{
+}
+
+static inline void pmic_cache_write_done(struct pmic_uc_priv *priv, uint reg,
+					 const u8 *buffer, int len, int ret)
+{
+}
+
+static inline int pmic_cache_read_reg(struct pmic_uc_priv *priv, uint reg)
+{
+	return -ENOENT;
+}
+
+static inline int pmic_cache_write_reg(struct udevice *dev,
+				       struct pmic_uc_priv *priv,
+				       uint reg, u8 val)
+{
+	return -ENOENT;
+}
+#endif
+
 int pmic_read(struct udevice *dev, uint reg, uint8_t *buffer, int len)
 {
 	const struct dm_pmic_ops *ops = dev_get_driver_ops(dev);
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+	int ret;
 
 	if (!buffer)
 		return -EFAULT;
@@ -136,12 +446,21 @@ int pmic_read(struct udevice *dev, uint reg, uint8_t *buffer, int len)
 	if (!ops || !ops->read)
 		return -ENOSYS;
 
-	return ops->read(dev, reg, buffer, len);
+	ret = pmic_cache_sync(dev, priv);
+	if (ret)
+		return ret;
+
+	ret = ops->read(dev, reg, buffer, len);
+	pmic_cache_read_done(priv, reg, buffer, len, ret);
+
+	return ret;
 }
 
 int pmic_write(struct udevice *dev, uint reg, const uint8_t *buffer, int len)
 {
 	const struct dm_pmic_ops *ops = dev_get_driver_ops(dev);
+	struct pmic_uc_priv *priv = pmic_uc_priv(dev);
+	int ret;
 
 	if (!buffer)
 		return -EFAULT;
@@ -149,7 +468,14 @@ int pmic_write(struct udevice *dev, uint reg, const uint8_t *buffer, int len)
 	if (!ops || !ops->write)
 		return -ENOSYS;
 
-	return ops->write(dev, reg, buffer, len);
+	ret = pmic_cache_sync(dev, priv);
+	if (ret)
+		return ret;
+
+	ret = ops->write(dev, reg, buffer, len);
+	pmic_cache_write_done(priv, reg, buffer, len, ret);
+
+	return ret;
 }
 
 int pmic_reg_read(struct udevice *dev, uint reg)
@@ -157,6 +483,10 @@ int pmic_reg_read(struct udevice *dev, uint reg)
 	u8 byte;
 	int ret;
 
+	ret = pmic_cache_read_reg(pmic_uc_priv(dev), reg);
+	if (ret != -ENOENT)
+		return ret;
+
 	debug("%s: reg=%x", __func__, reg);
 	ret = pmic_read(dev, reg, &byte, 1);
 	debug(", value=%x, ret=%d\n", byte, ret);
@@ -169,6 +499,10 @@ int pmic_reg_write(struct udevice *dev, uint reg, uint value)
 	u8 byte = value;
 	int ret;
 
+	ret = pmic_cache_write_reg(dev, pmic_uc_priv(dev), reg, byte);
+	if (ret != -ENOENT)
+		return ret;
+
 	debug("%s: reg=%x, value=%x", __func__, reg, value);
 	ret = pmic_write(dev, reg, &byte, 1);
 	debug(", ret=%d\n", ret);
@@ -222,4 +556,8 @@ int pmic_shutdown(struct udevice *dev)
 UCLASS_DRIVER(pmic) = {
 	.id		= UCLASS_PMIC,
 	.name		= "pmic",
+#if CONFIG_IS_ENABLED(DM_PMIC_CACHE)
+	.pre_remove	= pmic_pre_remove,
+	.per_device_auto_alloc_size = sizeof(struct pmic_uc_priv),
+#endif
 };
@@ -163,6 +163,32 @@ static struct reg_data rk818_init_current[] = {
 	{ REG_USB_CTRL, 0x07, 0x0f}, /* 2A */
 };
 
+/*
+ * Regulator settings which read back what was written. The enable
+ * registers of the RK805, RK816 and RK817 have write-enable bits and are
+ * left out, as are status and interrupt registers.
+ */
+static const struct pmic_reg_range rk805_cache_ranges[] = {
+	{ RK816_REG_DCDC_SLP_EN, RK816_REG_LDO_SLP_EN },
+	{ REG_BUCK1_CONFIG, REG_LDO3_SLP_VSEL },
+};
+
+static const struct pmic_reg_range rk808_cache_ranges[] = {
+	{ REG_DCDC_EN, REG_SLEEP_SET_OFF2 },
+	{ REG_BUCK1_CONFIG, REG_LDO8_SLP_VSEL },
+};
+
+static const struct pmic_reg_range rk816_cache_ranges[] = {
+	{ RK816_REG_DCDC_SLP_EN, RK816_REG_LDO_SLP_EN },
+	{ REG_BUCK1_CONFIG, REG_LDO6_SLP_VSEL },
+};
+
+static const struct pmic_reg_range rk817_cache_ranges[] = {
+	{ 0xb5, 0xb6 },		/* sleep enables */
+	{ 0xba, 0xc6 },		/* buck configuration */
+	{ 0xcc, 0xdf },		/* ldo and RK809 buck5 configuration */
+};
+
 static const struct pmic_child_info pmic_children_info[] = {
 	{ .prefix = "DCDC", .driver = "rk8xx_buck"},
 	{ .prefix = "LDO", .driver = "rk8xx_ldo"},
@@ -479,6 +505,8 @@ static int rk8xx_probe(struct udevice *dev)
 	struct rk8xx_priv *priv = dev_get_priv(dev);
 	struct reg_data *init_current = NULL;
 	struct reg_data *init_data = NULL;
+	const struct pmic_reg_range *cache_ranges;
+	int cache_range_count;
 	int init_current_num = 0;
 	int init_data_num = 0;
 	int ret = 0, i, show_variant;
@@ -512,6 +540,8 @@ static int rk8xx_probe(struct udevice *dev)
 		show_variant = 0x808;	/* RK808 hardware ID is 0 */
 		pwron_key = RK8XX_DEVCTRL_REG;
 		lp_off_msk = RK8XX_LP_OFF_MSK;
+		cache_ranges = rk808_cache_ranges;
+		cache_range_count = ARRAY_SIZE(rk808_cache_ranges);
 		break;
 	case RK805_ID:
 	case RK816_ID:
@@ -520,6 +550,13 @@ static int rk8xx_probe(struct udevice *dev)
 		pwron_key = RK8XX_DEVCTRL_REG;
 		lp_off_msk = RK8XX_LP_OFF_MSK;
 		lp_act_msk = RK8XX_LP_ACTION_MSK;
+		if (priv->variant == RK805_ID) {
+			cache_ranges = rk805_cache_ranges;
+			cache_range_count = ARRAY_SIZE(rk805_cache_ranges);
+		} else {
+			cache_ranges = rk816_cache_ranges;
+			cache_range_count = ARRAY_SIZE(rk816_cache_ranges);
+		}
 		break;
 	case RK818_ID:
 		on_source = RK8XX_ON_SOURCE;
@@ -527,6 +564,8 @@ static int rk8xx_probe(struct udevice *dev)
 		pwron_key = RK8XX_DEVCTRL_REG;
 		lp_off_msk = RK8XX_LP_OFF_MSK;
 		lp_act_msk = RK8XX_LP_ACTION_MSK;
+		cache_ranges = rk808_cache_ranges;
+		cache_range_count = ARRAY_SIZE(rk808_cache_ranges);
 		/* set current if no fuel gauge */
 		if (!ofnode_valid(dev_read_subnode(dev, "battery"))) {
 			init_current = rk818_init_current;
@@ -542,6 +581,8 @@ static int rk8xx_probe(struct udevice *dev)
 		lp_act_msk = RK8XX_LP_ACTION_MSK;
 		init_data = rk817_init_reg;
 		init_data_num = ARRAY_SIZE(rk817_init_reg);
+		cache_ranges = rk817_cache_ranges;
+		cache_range_count = ARRAY_SIZE(rk817_cache_ranges);
 		/* judge whether save the PMIC_POWER_EN register */
 		if (priv->not_save_power_en)
 			break;
@@ -560,6 +601,10 @@ static int rk8xx_probe(struct udevice *dev)
 		return -EINVAL;
 	}
 
+	ret = pmic_cache_init(dev, cache_ranges, cache_range_count);
+	if (ret)
+		debug("%s: No register cache, ret=%d\n", __func__, ret);
+
 	/* common init */
 	for (i = 0; i < init_data_num; i++) {
 		ret = pmic_clrsetbits(dev,
@@ -38,10 +38,22 @@ int regulator_get_value(struct udevice *dev)
 	return ops->get_value(dev);
 }
 
+/* Returns the PMIC holding the registers of @dev, or NULL if none */
+static struct udevice *regulator_pmic(struct udevice *dev)
+{
+	struct udevice *parent = dev_get_parent(dev);
+
+	if (parent && device_get_uclass_id(parent) == UCLASS_PMIC)
+		return parent;
+
+	return NULL;
+}
+
 int regulator_set_value(struct udevice *dev, int uV)
 {
 	const struct dm_regulator_ops *ops = dev_get_driver_ops(dev);
 	struct dm_regulator_uclass_platdata *uc_pdata;
+	struct udevice *pmic;
 	u32 old_uV = -ENODATA, us;
 	int ret;
 
@@ -65,6 +77,10 @@ int regulator_set_value(struct udevice *dev, int uV)
 	ret = ops->set_value(dev, uV);
 
 	if (!ret && (old_uV != -ENODATA) && (old_uV != uV)) {
+		/* The ramp only starts once the new value reaches the PMIC */
+		pmic = regulator_pmic(dev);
+		if (pmic)
+			pmic_cache_commit(pmic);
 		us = DIV_ROUND_UP(abs(uV - old_uV), uc_pdata->ramp_delay);
 		udelay(us);
 		debug("%s: ramp=%d, old_uV=%d, uV=%d, us=%d\n",
@@ -473,11 +489,31 @@ static int regulator_pre_probe(struct udevice *dev)
 	return 0;
 }
 
+/*
+ * Hold back the register writes for consecutive regulators of one PMIC,
+ * so that they reach it in as few bus transfers as possible. The writes
+ * are sent before moving on to a regulator of another device, which keeps
+ * the order between devices. Call with @dev NULL to send the last batch.
+ */
+static int regulator_batch(struct udevice **batchp, struct udevice *dev)
+{
+	struct udevice *pmic = dev ? regulator_pmic(dev) : NULL;
+	int ret = 0;
+
+	if (*batchp && *batchp != pmic)
+		ret = pmic_cache_commit(*batchp);
+	*batchp = pmic;
+	if (pmic)
+		pmic_cache_begin(pmic);
+
+	return ret;
+}
+
 int regulators_enable_state_mem(bool verbose)
 {
-	struct udevice *dev;
+	struct udevice *dev, *batch = NULL;
 	struct uclass *uc;
-	int ret;
+	int ret, err;
 
 	ret = uclass_get(UCLASS_REGULATOR, &uc);
 	if (ret)
@@ -485,6 +521,7 @@ int regulators_enable_state_mem(bool verbose)
 	for (uclass_first_device(UCLASS_REGULATOR, &dev);
 	     dev;
 	     uclass_next_device(&dev)) {
+		regulator_batch(&batch, dev);
 		ret = regulator_init_suspend(dev);
 
 		if (ret == -EMEDIUMTYPE)
@@ -494,15 +531,16 @@ int regulators_enable_state_mem(bool verbose)
 		if (ret == -ENOSYS)
 			ret = 0;
 	}
+	err = regulator_batch(&batch, NULL);
 
-	return ret;
+	return ret ? ret : err;
 }
 
 int regulators_enable_boot_on(bool verbose)
 {
-	struct udevice *dev;
+	struct udevice *dev, *batch = NULL;
 	struct uclass *uc;
-	int ret;
+	int ret, err;
 
 	ret = uclass_get(UCLASS_REGULATOR, &uc);
 	if (ret)
@@ -510,6 +548,7 @@ int regulators_enable_boot_on(bool verbose)
 	for (uclass_first_device(UCLASS_REGULATOR, &dev);
 	     dev;
 	     uclass_next_device(&dev)) {
+		regulator_batch(&batch, dev);
 		ret = regulator_autoset(dev);
 
 		if (ret == -EMEDIUMTYPE)
@@ -519,8 +558,9 @@ int regulators_enable_boot_on(bool verbose)
 		if (ret == -ENOSYS)
 			ret = 0;
 	}
+	err = regulator_batch(&batch, NULL);
 
-	return ret;
+	return ret ? ret : err;
 }
 
 UCLASS_DRIVER(regulator) = {
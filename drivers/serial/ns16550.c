@@ -426,9 +426,12 @@ static int ns16550_serial_putc(struct udevice *dev, const char ch)
 	 * UART_USR: bit1 trans_fifo_not_full:
 	 *	0 = Transmit FIFO is full;
 	 *	1 = Transmit FIFO is not full;
+	 *
+	 * The uclass retries while the FIFO is full, buffered console
+	 * output gets on with something else instead.
 	 */
-	while (!(serial_in(&com_port->rbr + 0x1f) & 0x02))
-		;
+	if (!(serial_in(&com_port->rbr + 0x1f) & 0x02))
+		return -EAGAIN;
 	serial_out(ch, &com_port->thr);
 
 	/*
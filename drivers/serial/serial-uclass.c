@@ -297,6 +297,13 @@ void serial_dev_putc(struct udevice *dev, char ch)
 	_serial_putc(dev, ch);
 }
 
+int serial_dev_try_putc(struct udevice *dev, char ch)
+{
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+
+	return ops->putc(dev, ch);
+}
+
 void serial_dev_puts(struct udevice *dev, const char *str)
 {
 	if (!dev)
@@ -383,21 +383,29 @@ static int rockchip_spi_xfer(struct udevice *dev, unsigned int bitlen,
 		writel(todo - 1, &regs->ctrlr1);
 		rkspi_enable_chip(regs, true);
 
+		/*
+		 * Keep at most SPI_FIFO_DEPTH frames in flight so that the
+		 * RX FIFO cannot overflow, and move whole batches between
+		 * polls of the FIFO levels.
+		 */
 		toread = todo;
 		towrite = todo;
 		while (toread || towrite) {
-			u32 status = readl(&regs->sr);
+			int count;
 
-			if (towrite && !(status & SR_TF_FULL)) {
+			count = min(towrite, SPI_FIFO_DEPTH -
+					     (toread - towrite));
+			towrite -= count;
+			while (count--)
 				writel(out ? *out++ : 0, regs->txdr);
-				towrite--;
-			}
-			if (toread && !(status & SR_RF_EMPT)) {
+
+			count = min(toread, (int)readl(&regs->rxflr));
+			toread -= count;
+			while (count--) {
 				u32 byte = readl(regs->rxdr);
 
 				if (in)
 					*in++ = byte;
-				toread--;
 			}
 		}
 		ret = rkspi_wait_till_not_busy(regs);
@@ -13,8 +13,11 @@
 #include <dm.h>
 #include <dt-structs.h>
 #include <errno.h>
+#include <malloc.h>
 #include <spi.h>
+#include <spi-mem.h>
 #include <linux/errno.h>
+#include <linux/sizes.h>
 #include <asm/io.h>
 #include <asm/arch/clock.h>
 #include <asm/arch/periph.h>
@@ -121,6 +124,13 @@ check_member(rockchip_sfc_reg, data, 0x108);
 #define SFC_DEFAULT_RATE	(80 * 1000 * 1000)
 #define SFC_MIN_RATE		(10 * 1000 * 1000)
 
+/*
+ * Reads of at least this size into an unaligned buffer go through two
+ * bounce buffers: the DMA fills one while the other is copied out.
+ */
+#define SFC_DMA_BOUNCE_SIZE	SZ_32K
+#define SFC_DMA_MIN_LEN		(4 * ARCH_DMA_MINALIGN)
+
 #define SFC_VER_3		0x3
 #define SFC_VER_4		0x4
 #define SFC_VER_5		0x5
@@ -153,6 +163,7 @@ struct rockchip_sfc {
 	u8 dummy_bits;
 	u8 rw;
 	u32 trb;
+	void *bounce[2];
 };
 
 static int rockchip_sfc_ofdata_to_platdata(struct udevice *bus)
@@ -443,6 +454,91 @@ static int rockchip_sfc_dma_xfer_prepare(struct rockchip_sfc *sfc,
 	return 0;
 }
 
+static int rockchip_sfc_dma_wait(struct rockchip_sfc *sfc, u32 len)
+{
+	struct rockchip_sfc_reg *regs = sfc->regbase;
+	unsigned long timeout = 100 + len / SZ_1K;
+	unsigned long tbase = get_timer(0);
+
+	while (!(readl(&regs->risr) & TRANS_FINISH_INT)) {
+		if (get_timer(tbase) > timeout) {
+			debug("dma timeout\n");
+			rockchip_sfc_reset(sfc);
+			return -ETIMEDOUT;
+		}
+		udelay(1);
+	}
+	writel(0xFFFFFFFF, &regs->iclr);
+
+	return 0;
+}
+
+/*
+ * Read @len bytes, a multiple of ARCH_DMA_MINALIGN, from sfc->addr as a
+ * chain of DMA transfers. An aligned @buf is filled directly, otherwise
+ * the data goes through the two bounce buffers. Either way the cache
+ * maintenance or copy of a piece overlaps the transfer of the next one.
+ */
+static int rockchip_sfc_dma_read_chain(struct rockchip_sfc *sfc, void *buf,
+				       u32 len)
+{
+	struct rockchip_sfc_reg *regs = sfc->regbase;
+	bool direct = IS_ALIGNED((ulong)buf, ARCH_DMA_MINALIGN);
+	void *prev_dst = NULL, *prev_buf = NULL;
+	u32 limit, chunk, prev_len = 0;
+	void *dst;
+	int i = 0;
+	int ret = 0;
+
+	limit = rounddown(sfc->max_iosize, ARCH_DMA_MINALIGN);
+	if (!direct) {
+		limit = min_t(u32, limit, SFC_DMA_BOUNCE_SIZE);
+		if (!sfc->bounce[0]) {
+			sfc->bounce[0] = memalign(ARCH_DMA_MINALIGN,
+						  2 * SFC_DMA_BOUNCE_SIZE);
+			if (!sfc->bounce[0])
+				return -ENOMEM;
+			sfc->bounce[1] = sfc->bounce[0] + SFC_DMA_BOUNCE_SIZE;
+		}
+	}
+
+	while (len || prev_len) {
+		chunk = min(len, limit);
+		dst = direct ? buf : sfc->bounce[i];
+		if (chunk) {
+			flush_dcache_range((ulong)dst, (ulong)dst + chunk);
+			rockchip_sfc_setup_xfer(sfc, chunk);
+			writel(0xFFFFFFFF, &regs->iclr);
+			writel((ulong)dst, &regs->dmaaddr);
+			writel(SFC_DMA_START, &regs->dmatr);
+		}
+
+		/* Finish the previous piece while this one is transferred */
+		if (prev_len) {
+			invalidate_dcache_range((ulong)prev_dst,
+						(ulong)prev_dst + prev_len);
+			if (!direct)
+				memcpy(prev_buf, prev_dst, prev_len);
+		}
+		if (!chunk)
+			break;
+
+		ret = rockchip_sfc_dma_wait(sfc, chunk);
+		if (ret)
+			return ret;
+
+		prev_dst = dst;
+		prev_buf = buf;
+		prev_len = chunk;
+		sfc->addr += chunk;
+		buf += chunk;
+		len -= chunk;
+		i ^= 1;
+	}
+
+	return 0;
+}
+
 static int rockchip_sfc_wait_fifo_ready(struct rockchip_sfc *sfc, int rw,
 					u32 timeout)
 {
@@ -559,6 +655,14 @@ static int rockchip_sfc_read(struct rockchip_sfc *sfc, u32 offset,
 		bytes = len;
 	}
 
+	if (dma_trans && !sfc->prepare) {
+		ret = rockchip_sfc_dma_read_chain(sfc, buf, dma_trans);
+		if (ret < 0)
+			return ret;
+		buf += dma_trans;
+		dma_trans = 0;
+	}
+
 	while (dma_trans) {
 		trb = min_t(size_t, dma_trans, sfc->max_iosize);
 		if (sfc->prepare)
@@ -692,6 +796,55 @@ static int rockchip_sfc_xfer(struct udevice *dev, unsigned int bitlen,
 	return ret;
 }
 
+/*
+ * Fast path for reads from the memory array: the command, address and
+ * dummy cycles come straight from @op and the data is read by a chain of
+ * DMA transfers, see rockchip_sfc_dma_read_chain(). Everything else goes
+ * through rockchip_sfc_xfer(), including reads that are only to be started
+ * (SPI_DMA_PREPARE), which spi-mem passes on as SPI_XFER_PREPARE.
+ */
+static int rockchip_sfc_exec_op(struct spi_slave *slave,
+				const struct spi_mem_op *op)
+{
+	struct rockchip_sfc *sfc = dev_get_priv(slave->dev->parent);
+	u32 len = op->data.nbytes;
+	u32 dma_len;
+	int ret;
+
+	if ((slave->mode & SPI_DMA_PREPARE) ||
+	    op->data.dir != SPI_MEM_DATA_IN || len < SFC_DMA_MIN_LEN ||
+	    (op->addr.nbytes != 3 && op->addr.nbytes != 4) ||
+	    op->cmd.buswidth != 1 || op->addr.buswidth != 1)
+		return -ENOTSUPP;
+
+	sfc->rw = SFC_RD;
+	/* The data lines are set from the bus mode, they must agree */
+	if (op->data.buswidth !=
+	    (1 << rockchip_sfc_get_if_type(sfc)))
+		return -ENOTSUPP;
+
+	sfc->cmd = op->cmd.opcode;
+	sfc->addr = op->addr.val;
+	sfc->addr_bits = op->addr.nbytes == 4 ? SFC_ADDR_32BITS :
+						SFC_ADDR_24BITS;
+	sfc->dummy_bits = op->dummy.nbytes ?
+			  op->dummy.nbytes * 8 / op->dummy.buswidth : 0;
+
+	dma_len = rounddown(len, ARCH_DMA_MINALIGN);
+	ret = rockchip_sfc_dma_read_chain(sfc, op->data.buf.in, dma_len);
+	if (ret)
+		return ret;
+	if (len > dma_len)
+		ret = rockchip_sfc_pio_xfer(sfc, op->data.buf.in + dma_len,
+					    len - dma_len);
+
+	return ret;
+}
+
+static const struct spi_controller_mem_ops rockchip_sfc_mem_ops = {
+	.exec_op	= rockchip_sfc_exec_op,
+};
+
 static int rockchip_sfc_set_speed(struct udevice *bus, uint speed)
 {
 	struct rockchip_sfc *sfc = dev_get_priv(bus);
@@ -759,6 +912,7 @@ static const struct dm_spi_ops rockchip_sfc_ops = {
 	.xfer		= rockchip_sfc_xfer,
 	.set_speed	= rockchip_sfc_set_speed,
 	.set_mode	= rockchip_sfc_set_mode,
+	.mem_ops	= &rockchip_sfc_mem_ops,
 };
 
 static const struct udevice_id rockchip_sfc_ids[] = {
@@ -514,6 +514,33 @@ static void abort_td(struct usb_device *udev, int ep_index)
 	xhci_acknowledge_event(ctrl);
 }
 
+/*
+ * Recovers an endpoint halted by a STALL or a transaction error and throws
+ * away all the TRBs still queued on it, like abort_td() does for a running
+ * endpoint.
+ */
+static void reset_halted_ep(struct usb_device *udev, int ep_index)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	struct xhci_ring *ring =  ctrl->devs[udev->slot_id]->eps[ep_index].ring;
+	union xhci_trb *event;
+
+	xhci_queue_command(ctrl, NULL, udev->slot_id, ep_index, TRB_RESET_EP);
+	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
+	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
+		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
+		event->event_cmd.status)) != COMP_SUCCESS);
+	xhci_acknowledge_event(ctrl);
+
+	xhci_queue_command(ctrl, (void *)((uintptr_t)ring->enqueue |
+		ring->cycle_state), udev->slot_id, ep_index, TRB_SET_DEQ);
+	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
+	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
+		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
+		event->event_cmd.status)) != COMP_SUCCESS);
+	xhci_acknowledge_event(ctrl);
+}
+
 static void record_transfer_result(struct usb_device *udev,
 				   union xhci_trb *event, int length)
 {
@@ -544,19 +571,61 @@ static void record_transfer_result(struct usb_device *udev,
 
 /**** Bulk and Control transfer methods ****/
 /**
- * Queues up the BULK Request
+ * Counts the TRBs needed for a BULK Request
+ *
+ * XHCI Spec puts restriction( TABLE 49 and 6.4.1 section of XHCI Spec)
+ * that the buffer should not span 64KB boundary. if so
+ * we send request in more than 1 TRB by chaining them.
+ *
+ * @param buffer	buffer to be read/written
+ * @param length	length of the buffer
+ * @return number of TRBs
+ */
+static int xhci_bulk_num_trbs(void *buffer, int length)
+{
+	u64 val_64 = (uintptr_t)buffer;
+	int running_total;
+	int num_trbs = 0;
+
+	/* How much data is (potentially) left before the 64KB boundary? */
+	running_total = TRB_MAX_BUFF_SIZE -
+			(lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
+	running_total &= TRB_MAX_BUFF_SIZE - 1;
+
+	/*
+	 * If there's some data on this 64KB chunk, or we have to send a
+	 * zero-length transfer, we need at least one TRB
+	 */
+	if (running_total != 0 || length == 0)
+		num_trbs++;
+
+	/* How many more 64KB chunks to transfer, how many more TRBs? */
+	while (running_total < length) {
+		num_trbs++;
+		running_total += TRB_MAX_BUFF_SIZE;
+	}
+
+	return num_trbs;
+}
+
+/**
+ * Queues up the BULK Request and rings the doorbell, without waiting
  *
  * @param udev		pointer to the USB device structure
  * @param pipe		contains the DIR_IN or OUT , devnum
  * @param length	length of the buffer
  * @param buffer	buffer to be read/written based on the request
- * @return returns 0 if successful else -1 on failure
+ * @param firstp	if not NULL, returns the first TRB of the TD
+ * @param lastp		if not NULL, returns the last TRB of the TD
+ * @return returns 0 if successful else error code on failure
  */
-int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
-			int length, void *buffer)
+static int xhci_bulk_queue(struct usb_device *udev, unsigned long pipe,
+			   int length, void *buffer,
+			   struct xhci_generic_trb **firstp,
+			   struct xhci_generic_trb **lastp)
 {
-	int num_trbs = 0;
-	struct xhci_generic_trb *start_trb;
+	int num_trbs;
+	struct xhci_generic_trb *start_trb, *trb;
 	bool first_trb = false;
 	int start_cycle;
 	u32 field = 0;
@@ -567,7 +636,6 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	struct xhci_virt_device *virt_dev;
 	struct xhci_ep_ctx *ep_ctx;
 	struct xhci_ring *ring;		/* EP transfer ring */
-	union xhci_trb *event;
 
 	int running_total, trb_buff_len;
 	unsigned int total_packet_count;
@@ -589,29 +657,9 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	ep_ctx = xhci_get_ep_ctx(ctrl, virt_dev->out_ctx, ep_index);
 
 	ring = virt_dev->eps[ep_index].ring;
-	/*
-	 * How much data is (potentially) left before the 64KB boundary?
-	 * XHCI Spec puts restriction( TABLE 49 and 6.4.1 section of XHCI Spec)
-	 * that the buffer should not span 64KB boundary. if so
-	 * we send request in more than 1 TRB by chaining them.
-	 */
-	running_total = TRB_MAX_BUFF_SIZE -
-			(lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
-	trb_buff_len = running_total;
-	running_total &= TRB_MAX_BUFF_SIZE - 1;
-
-	/*
-	 * If there's some data on this 64KB chunk, or we have to send a
-	 * zero-length transfer, we need at least one TRB
-	 */
-	if (running_total != 0 || length == 0)
-		num_trbs++;
-
-	/* How many more 64KB chunks to transfer, how many more TRBs? */
-	while (running_total < length) {
-		num_trbs++;
-		running_total += TRB_MAX_BUFF_SIZE;
-	}
+	num_trbs = xhci_bulk_num_trbs(buffer, length);
+	trb_buff_len = TRB_MAX_BUFF_SIZE -
+		       (lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
 
 	/*
 	 * XXX: Calling routine prepare_ring() called in place of
@@ -637,12 +685,6 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	total_packet_count = DIV_ROUND_UP(length, maxpacketsize);
 
 	/* How much data is in the first TRB? */
-	/*
-	 * How much data is (potentially) left before the 64KB boundary?
-	 * XHCI Spec puts restriction( TABLE 49 and 6.4.1 section of XHCI Spec)
-	 * that the buffer should not span 64KB boundary. if so
-	 * we send request in more than 1 TRB by chaining them.
-	 */
 	addr = val_64;
 
 	if (trb_buff_len > length)
@@ -699,7 +741,7 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 		trb_fields[2] = length_field;
 		trb_fields[3] = field | (TRB_NORMAL << TRB_TYPE_SHIFT);
 
-		queue_trb(ctrl, ring, (num_trbs > 1), trb_fields);
+		trb = queue_trb(ctrl, ring, (num_trbs > 1), trb_fields);
 
 		--num_trbs;
 
@@ -712,6 +754,37 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 
 	giveback_first_trb(udev, ep_index, start_cycle, start_trb);
 
+	if (firstp)
+		*firstp = start_trb;
+	if (lastp)
+		*lastp = trb;
+
+	return 0;
+}
+
+/**
+ * Queues up the BULK Request
+ *
+ * @param udev		pointer to the USB device structure
+ * @param pipe		contains the DIR_IN or OUT , devnum
+ * @param length	length of the buffer
+ * @param buffer	buffer to be read/written based on the request
+ * @return returns 0 if successful else -1 on failure
+ */
+int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
+			int length, void *buffer)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int slot_id = udev->slot_id;
+	int ep_index = usb_pipe_ep_index(pipe);
+	union xhci_trb *event;
+	u32 field;
+	int ret;
+
+	ret = xhci_bulk_queue(udev, pipe, length, buffer, NULL, NULL);
+	if (ret < 0)
+		return ret;
+
 	event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
 	if (!event) {
 		debug("XHCI bulk transfer timed out, aborting...\n");
@@ -734,6 +807,124 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	return (udev->status != USB_ST_NOT_PROC) ? 0 : -1;
 }
 
+/*
+ * Whether @trb is one of the TRBs of the TD from @first to @last, on a
+ * single-segment ring
+ */
+static bool trb_in_td(struct xhci_generic_trb *first,
+		      struct xhci_generic_trb *last,
+		      struct xhci_generic_trb *trb)
+{
+	if (first <= last)
+		return trb >= first && trb <= last;
+
+	/* The TD wraps round the link TRB at the end of the segment */
+	return trb >= first || trb <= last;
+}
+
+/**
+ * Queues up several BULK Requests at once and waits for all of them
+ *
+ * Each request is a TD on the ring of its endpoint, so the controller
+ * moves from one to the next without waiting for software. TDs on the
+ * same endpoint complete in order, and each event is matched to its TD
+ * by the TRB it points to. On error or timeout the TDs still
+ * queued are thrown away, resetting the endpoint that halted.
+ *
+ * @param udev		pointer to the USB device structure
+ * @param xfer		requests, act_len and status are filled in
+ * @param count		number of requests, at most 32
+ * @return returns 0 if successful, -E2BIG if the requests do not fit in
+ * the transfer rings, else error code on failure
+ */
+int xhci_bulk_chain(struct usb_device *udev, struct usb_bulk_xfer *xfer,
+		    int count)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int ring_trbs[MAX_EP_CTX_NUM] = { 0 };
+	struct xhci_generic_trb *td_first[32], *td_last[32], *trb;
+	union xhci_trb *event;
+	u32 field, pending = 0;
+	int i, j, ep_index, halted = -1;
+	int ret = 0;
+
+	if (count > 32)
+		return -EINVAL;
+
+	/* The link TRB takes one slot of each single-segment ring */
+	for (i = 0; i < count; i++) {
+		ep_index = usb_pipe_ep_index(xfer[i].pipe);
+		ring_trbs[ep_index] += xhci_bulk_num_trbs(xfer[i].buffer,
+							  xfer[i].length);
+		if (ring_trbs[ep_index] > TRBS_PER_SEGMENT - 1)
+			return -E2BIG;
+	}
+
+	for (i = 0; i < count; i++) {
+		xfer[i].status = USB_ST_NOT_PROC;
+		xfer[i].act_len = 0;
+		ret = xhci_bulk_queue(udev, xfer[i].pipe, xfer[i].length,
+				      xfer[i].buffer, &td_first[i],
+				      &td_last[i]);
+		if (ret < 0)
+			break;
+		pending |= BIT(i);
+	}
+
+	while (!ret && pending) {
+		event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
+		if (!event) {
+			debug("XHCI bulk chain timed out, aborting...\n");
+			ret = -ETIMEDOUT;
+			break;
+		}
+		field = le32_to_cpu(event->trans_event.flags);
+		BUG_ON(TRB_TO_SLOT_ID(field) != udev->slot_id);
+		ep_index = TRB_TO_EP_INDEX(field);
+		trb = (struct xhci_generic_trb *)(uintptr_t)
+			le64_to_cpu(event->trans_event.buffer);
+
+		/* The request whose TD holds the TRB of the event */
+		for (i = 0; i < count; i++) {
+			if ((pending & BIT(i)) &&
+			    usb_pipe_ep_index(xfer[i].pipe) == ep_index &&
+			    trb_in_td(td_first[i], td_last[i], trb))
+				break;
+		}
+		BUG_ON(i == count);
+
+		record_transfer_result(udev, event, xfer[i].length);
+		xhci_acknowledge_event(ctrl);
+		xhci_inval_cache((uintptr_t)xfer[i].buffer, xfer[i].length);
+		xfer[i].act_len = udev->act_len;
+		xfer[i].status = udev->status;
+		pending &= ~BIT(i);
+
+		if (udev->status) {
+			/* Any error halts the endpoint */
+			halted = ep_index;
+			ret = -EIO;
+		}
+	}
+
+	if (halted >= 0)
+		reset_halted_ep(udev, halted);
+	for (i = 0; i < count && pending; i++) {
+		if (!(pending & BIT(i)))
+			continue;
+		ep_index = usb_pipe_ep_index(xfer[i].pipe);
+		if (ep_index != halted)
+			abort_td(udev, ep_index);
+		/* The abort dropped every TD queued on that endpoint */
+		for (j = i; j < count; j++) {
+			if (usb_pipe_ep_index(xfer[j].pipe) == ep_index)
+				pending &= ~BIT(j);
+		}
+	}
+
+	return ret;
+}
+
 /**
  * Queues up the Control Transfer Request
  *
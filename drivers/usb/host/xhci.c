@@ -1387,6 +1387,24 @@ static int xhci_submit_bulk_msg(struct udevice *dev, struct usb_device *udev,
 	return _xhci_submit_bulk_msg(udev, pipe, buffer, length);
 }
 
+static int xhci_submit_bulk_chain(struct udevice *dev,
+				  struct usb_device *udev,
+				  struct usb_bulk_xfer *xfer, int count)
+{
+	int i;
+
+	debug("%s: dev='%s', udev=%p\n", __func__, dev->name, udev);
+	for (i = 0; i < count; i++) {
+		if (usb_pipetype(xfer[i].pipe) != PIPE_BULK) {
+			printf("non-bulk pipe (type=%lu)",
+			       usb_pipetype(xfer[i].pipe));
+			return -EINVAL;
+		}
+	}
+
+	return xhci_bulk_chain(udev, xfer, count);
+}
+
 static int xhci_submit_int_msg(struct udevice *dev, struct usb_device *udev,
 			       unsigned long pipe, void *buffer, int length,
 			       int interval, bool nonblock)
@@ -1476,8 +1494,11 @@ static int xhci_get_max_xfer_size(struct udevice *dev, size_t *size)
 	 * a TRB ring. Each TRB can transfer up to 64K bytes, however data
 	 * buffers referenced by transfer TRBs shall not span 64KB boundaries.
 	 * Hence the maximum number of TRBs we can use in one transfer is 62.
+	 * A buffer that does not start on a 64K boundary needs one TRB more
+	 * than its size suggests, and a mass storage CSW may be chained on
+	 * the same ring, so leave room for both.
 	 */
-	*size = (TRBS_PER_SEGMENT - 2) * TRB_MAX_BUFF_SIZE;
+	*size = (TRBS_PER_SEGMENT - 3) * TRB_MAX_BUFF_SIZE;
 
 	return 0;
 }
@@ -1532,6 +1553,7 @@ int xhci_deregister(struct udevice *dev)
 struct dm_usb_ops xhci_usb_ops = {
 	.control = xhci_submit_control_msg,
 	.bulk = xhci_submit_bulk_msg,
+	.bulk_chain = xhci_submit_bulk_chain,
 	.interrupt = xhci_submit_int_msg,
 	.alloc_device = xhci_alloc_device,
 	.update_hub_device = xhci_update_hub_device,
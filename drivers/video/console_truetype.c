@@ -92,6 +92,50 @@ struct pos_info {
  */
 #define POS_HISTORY_SIZE	(CONFIG_SYS_CBSIZE * 11 / 10)
 
+/*
+ * Number of sub-pixel X positions a glyph is rendered at. The fractional
+ * cursor position is rounded down to one of these.
+ */
+#define TT_SUBPIX		4
+
+/**
+ * struct tt_glyph - A rendered character
+ *
+ * @width:	Width of the bitmap in pixels, 0 for an empty character
+ * @height:	Height of the bitmap in pixels
+ * @xoff:	X offset of the bitmap from the cursor position
+ * @yoff:	Y offset of the bitmap from the baseline
+ * @bitmap:	8-bit coverage values, @width x @height
+ */
+struct tt_glyph {
+	short width;
+	short height;
+	short xoff;
+	short yoff;
+	u8 bitmap[];
+};
+
+/**
+ * struct tt_glyph_cache - Rendered characters of a font at one size
+ *
+ * Glyphs are rendered on first use and kept until U-Boot exits. Consoles
+ * which use the same font at the same size share a cache.
+ *
+ * @font_data:	TrueType font file contents
+ * @font_size:	Vertical font size in pixels
+ * @next:	Next cache in the list
+ * @glyphs:	Glyphs indexed by character and sub-pixel position, NULL if not
+ *		yet rendered
+ */
+struct tt_glyph_cache {
+	u8 *font_data;
+	int font_size;
+	struct tt_glyph_cache *next;
+	struct tt_glyph *glyphs[256][TT_SUBPIX];
+};
+
+static struct tt_glyph_cache *tt_glyph_caches;
+
 /**
  * struct console_tt_priv - Private data for this driver
  *
@@ -111,6 +155,7 @@ struct pos_info {
  * @scale:	Scale of the font. This is calculated from the pixel height
  *		of the font. It is used by the STB library to generate images
  *		of the correct size.
+ * @cache:	Rendered characters of this font and size
  */
 struct console_tt_priv {
 	int font_size;
@@ -120,6 +165,7 @@ struct console_tt_priv {
 	int pos_ptr;
 	int baseline;
 	double scale;
+	struct tt_glyph_cache *cache;
 };
 
 static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
@@ -127,7 +173,7 @@ static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
 	void *line;
-	int pixels = priv->font_size * vid_priv->line_length;
+	int pixels = priv->font_size * vid_priv->xsize;
 	int i;
 
 	line = vid_priv->fb + row * priv->font_size * vid_priv->line_length;
@@ -162,6 +208,8 @@ static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
 	default:
 		return -ENOSYS;
 	}
+	video_damage(dev->parent, 0, row * priv->font_size, vid_priv->xsize,
+		     priv->font_size);
 
 	return 0;
 }
@@ -178,6 +226,8 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 	dst = vid_priv->fb + rowdst * priv->font_size * vid_priv->line_length;
 	src = vid_priv->fb + rowsrc * priv->font_size * vid_priv->line_length;
 	memmove(dst, src, priv->font_size * vid_priv->line_length * count);
+	video_damage(dev->parent, 0, rowdst * priv->font_size, vid_priv->xsize,
+		     priv->font_size * count);
 
 	/* Scroll up our position history */
 	diff = (rowsrc - rowdst) * priv->font_size;
@@ -187,6 +237,79 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 	return 0;
 }
 
+/**
+ * console_truetype_get_glyph() - Look up a rendered character
+ *
+ * The character is rendered and added to the cache if it is not there yet.
+ *
+ * @priv:	Private data of the console
+ * @ch:		Character to look up
+ * @subpix:	Sub-pixel X position, 0 to TT_SUBPIX - 1
+ * @return the glyph, or NULL if out of memory
+ */
+static struct tt_glyph *console_truetype_get_glyph(struct console_tt_priv *priv,
+						   char ch, int subpix)
+{
+	struct tt_glyph **slot = &priv->cache->glyphs[(u8)ch][subpix];
+	struct tt_glyph *glyph;
+	int width, height, xoff, yoff;
+	u8 *data;
+
+	if (*slot)
+		return *slot;
+
+	/*
+	 * Pass the sub-pixel position into the render, which will return a
+	 * 8-bit-per-pixel image of the character. For empty characters, like
+	 * ' ', data will return NULL.
+	 */
+	data = stbtt_GetCodepointBitmapSubpixel(&priv->font, priv->scale,
+						priv->scale,
+						(double)subpix / TT_SUBPIX, 0,
+						ch, &width, &height, &xoff,
+						&yoff);
+	if (!data)
+		width = 0;
+
+	glyph = malloc(sizeof(*glyph) + width * height);
+	if (!glyph) {
+		free(data);
+		return NULL;
+	}
+	glyph->width = width;
+	glyph->height = width ? height : 0;
+	glyph->xoff = xoff;
+	glyph->yoff = yoff;
+	if (data) {
+		memcpy(glyph->bitmap, data, width * height);
+		free(data);
+	}
+	*slot = glyph;
+
+	return glyph;
+}
+
+/* Mix a colour channel of @fg over @bg with the given coverage (0-255) */
+static inline uint tt_blend(uint bg, uint fg, uint alpha)
+{
+	return (bg * (255 - alpha) + fg * alpha + 127) / 255;
+}
+
+static uint16_t tt_blend16(uint16_t bg, uint16_t fg, uint alpha)
+{
+	return tt_blend(bg >> 11, fg >> 11, alpha) << 11 |
+		tt_blend((bg >> 5) & 0x3f, (fg >> 5) & 0x3f, alpha) << 5 |
+		tt_blend(bg & 0x1f, fg & 0x1f, alpha);
+}
+
+static uint32_t tt_blend32(uint32_t bg, uint32_t fg, uint alpha)
+{
+	return (bg & 0xff000000) |
+		tt_blend((bg >> 16) & 0xff, (fg >> 16) & 0xff, alpha) << 16 |
+		tt_blend((bg >> 8) & 0xff, (fg >> 8) & 0xff, alpha) << 8 |
+		tt_blend(bg & 0xff, fg & 0xff, alpha);
+}
+
 static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 				    char ch)
 {
@@ -195,15 +318,16 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	struct video_priv *vid_priv = dev_get_uclass_priv(vid);
 	struct console_tt_priv *priv = dev_get_priv(dev);
 	stbtt_fontinfo *font = &priv->font;
-	int width, height, xoff, yoff;
+	struct tt_glyph *glyph;
 	double xpos, x_shift;
 	int lsb;
 	int width_frac, linenum;
+	int xstart, ystart;
 	struct pos_info *pos;
-	u8 *bits, *data;
+	u8 *bits;
 	int advance;
 	void *line;
-	int row;
+	int row, i;
 
 	/* First get some basic metrics about this character */
 	stbtt_GetCodepointHMetrics(font, ch, &advance, &lsb);
@@ -239,63 +363,70 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	}
 
 	/*
-	 * Figure out how much past the start of a pixel we are, and pass this
-	 * information into the render, which will return a 8-bit-per-pixel
-	 * image of the character. For empty characters, like ' ', data will
-	 * return NULL;
+	 * Figure out how much past the start of a pixel we are and fetch the
+	 * character rendered at that position.
 	 */
-	data = stbtt_GetCodepointBitmapSubpixel(font, priv->scale, priv->scale,
-						x_shift, 0, ch, &width, &height,
-						&xoff, &yoff);
-	if (!data)
+	glyph = console_truetype_get_glyph(priv, ch,
+					   (int)(x_shift * TT_SUBPIX));
+	if (!glyph || !glyph->width)
 		return width_frac;
 
 	/* Figure out where to write the character in the frame buffer */
-	bits = data;
-	line = vid_priv->fb + y * vid_priv->line_length +
-		VID_TO_PIXEL(x) * VNBYTES(vid_priv->bpix);
-	linenum = priv->baseline + yoff;
+	bits = glyph->bitmap;
+	xstart = VID_TO_PIXEL(x) + glyph->xoff;
+	ystart = y;
+	linenum = priv->baseline + glyph->yoff;
 	if (linenum > 0)
-		line += linenum * vid_priv->line_length;
+		ystart += linenum;
+	line = vid_priv->fb + ystart * vid_priv->line_length +
+		xstart * VNBYTES(vid_priv->bpix);
 
 	/*
-	 * Write a row at a time, converting the 8bpp image into the colour
-	 * depth of the display. We only expect white-on-black or the reverse
-	 * so the code only handles this simple case.
+	 * Write a row at a time, blending the foreground colour into the
+	 * frame buffer using the 8bpp image as coverage. Most pixels are
+	 * either fully covered or not at all, so skip the blend for those.
 	 */
-	for (row = 0; row < height; row++) {
+	for (row = 0; row < glyph->height; row++) {
 		switch (vid_priv->bpix) {
 #ifdef CONFIG_VIDEO_BPP16
 		case VIDEO_BPP16: {
-			uint16_t *dst = (uint16_t *)line + xoff;
-			int i;
-
-			for (i = 0; i < width; i++) {
-				int val = *bits;
-				int out;
-
-				if (vid_priv->colour_bg)
-					val = 255 - val;
-				out = val >> 3 |
-					(val >> 2) << 5 |
-					(val >> 3) << 11;
-				if (vid_priv->colour_fg)
-					*dst++ |= out;
-				else
-					*dst++ &= out;
-				bits++;
+			uint16_t *dst = line;
+			uint16_t fg = vid_priv->colour_fg;
+
+			for (i = 0; i < glyph->width; i++, dst++) {
+				uint alpha = *bits++;
+
+				if (alpha == 255)
+					*dst = fg;
+				else if (alpha)
+					*dst = tt_blend16(*dst, fg, alpha);
+			}
+			break;
+		}
+#endif
+#ifdef CONFIG_VIDEO_BPP32
+		case VIDEO_BPP32: {
+			uint32_t *dst = line;
+			uint32_t fg = vid_priv->colour_fg;
+
+			for (i = 0; i < glyph->width; i++, dst++) {
+				uint alpha = *bits++;
+
+				if (alpha == 255)
+					*dst = fg;
+				else if (alpha)
+					*dst = tt_blend32(*dst, fg, alpha);
 			}
 			break;
 		}
 #endif
 		default:
-			free(data);
 			return -ENOSYS;
 		}
 
 		line += vid_priv->line_length;
 	}
-	free(data);
+	video_damage(vid, xstart, ystart, glyph->width, glyph->height);
 
 	return width_frac;
 }
@@ -358,6 +489,7 @@ static int console_truetype_erase(struct udevice *dev, int xstart, int ystart,
 		}
 		line += vid_priv->line_length;
 	}
+	video_damage(dev->parent, xstart, ystart, pixels, yend - ystart);
 
 	return 0;
 }
@@ -493,6 +625,35 @@ static u8 *console_truetype_find_font(void)
 	return NULL;
 }
 
+/**
+ * console_truetype_find_cache() - Find or create the glyph cache for a font
+ *
+ * @font_data:	TrueType font file contents
+ * @font_size:	Vertical font size in pixels
+ * @return the cache, or NULL if out of memory
+ */
+static struct tt_glyph_cache *console_truetype_find_cache(u8 *font_data,
+							  int font_size)
+{
+	struct tt_glyph_cache *cache;
+
+	for (cache = tt_glyph_caches; cache; cache = cache->next) {
+		if (cache->font_data == font_data &&
+		    cache->font_size == font_size)
+			return cache;
+	}
+
+	cache = calloc(1, sizeof(*cache));
+	if (!cache)
+		return NULL;
+	cache->font_data = font_data;
+	cache->font_size = font_size;
+	cache->next = tt_glyph_caches;
+	tt_glyph_caches = cache;
+
+	return cache;
+}
+
 static int console_truetype_probe(struct udevice *dev)
 {
 	struct vidconsole_priv *vc_priv = dev_get_uclass_priv(dev);
@@ -512,6 +673,10 @@ static int console_truetype_probe(struct udevice *dev)
 		debug("%s: Could not find any fonts\n", __func__);
 		return -EBFONT;
 	}
+	priv->cache = console_truetype_find_cache(priv->font_data,
+						  priv->font_size);
+	if (!priv->cache)
+		return -ENOMEM;
 
 	vc_priv->x_charsize = priv->font_size;
 	vc_priv->y_charsize = priv->font_size;
@@ -15,6 +15,61 @@
 #define BMP_RLE8_EOBMP		1
 #define BMP_RLE8_DELTA		2
 
+#ifdef CONFIG_ARM64
+#define BMP_NEON_BYTES		64
+
+/* bmp_helper_neon.S */
+void bmp_neon_swap(void *a, void *b, ulong len);
+#endif
+
+static void bmp_swap_row(uint8_t *a, uint8_t *b, ulong len)
+{
+	ulong i = 0;
+	uint8_t tmp;
+
+#ifdef CONFIG_ARM64
+	i = len & ~(BMP_NEON_BYTES - 1);
+	if (i)
+		bmp_neon_swap(a, b, i);
+#endif
+	for (; i < len; i++) {
+		tmp = a[i];
+		a[i] = b[i];
+		b[i] = tmp;
+	}
+}
+
+void bmp_flip_rows(void *bits, int stride, int height)
+{
+	uint8_t *top = bits;
+	uint8_t *bottom = top + (height - 1) * stride;
+
+	while (top < bottom) {
+		bmp_swap_row(top, bottom, stride);
+		top += stride;
+		bottom -= stride;
+	}
+}
+
+/*
+ * 64-bit FNV-1a over whole words; only tells identical logo files apart,
+ * so the weaker mixing of word-at-a-time hashing does not matter.
+ */
+u64 bmp_content_hash(const void *buf, ulong len)
+{
+	const u64 *word = buf;
+	const uint8_t *byte;
+	u64 hash = 0xcbf29ce484222325ULL;
+	ulong i;
+
+	for (i = 0; i < len / 8; i++)
+		hash = (hash ^ word[i]) * 0x100000001b3ULL;
+	for (byte = buf, i *= 8; i < len; i++)
+		hash = (hash ^ byte[i]) * 0x100000001b3ULL;
+
+	return hash;
+}
+
 static void draw_unencoded_bitmap(uint16_t **dst, uint8_t *bmap, uint16_t *cmap,
 				  uint32_t cnt)
 {
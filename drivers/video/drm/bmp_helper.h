@@ -16,4 +16,19 @@
 #define range(x, min, max) ((x) < (min)) ? (min) : (((x) > (max)) ? (max) : (x))
 
 int bmpdecoder(void *bmp_addr, void *dst, int dst_bpp);
+
+/*
+ * bmp_flip_rows - turn a bottom-up image upside down in place
+ * @bits: first row
+ * @stride: bytes per row
+ * @height: number of rows
+ */
+void bmp_flip_rows(void *bits, int stride, int height);
+
+/*
+ * bmp_content_hash - hash a loaded bmp file to find duplicate logos
+ * @buf: file data, 8-byte aligned
+ * @len: file size
+ */
+u64 bmp_content_hash(const void *buf, ulong len);
 #endif /* _BMP_HELPER_H_ */
@@ -16,6 +16,7 @@
 #include <linux/list.h>
 #include <linux/compat.h>
 #include <linux/media-bus-format.h>
+#include <linux/sizes.h>
 #include <malloc.h>
 #include <video.h>
 #include <video_rockchip.h>
@@ -1142,6 +1143,142 @@ struct rockchip_logo_cache *find_or_alloc_logo_cache(const char *bmp)
 	return logo_cache;
 }
 
+static u64 logo_cache_hash(struct rockchip_logo_cache *logo_cache)
+{
+	if (!logo_cache->hashed) {
+		logo_cache->hash = bmp_content_hash(logo_cache->src,
+						    logo_cache->src_size);
+		logo_cache->hashed = true;
+	}
+
+	return logo_cache->hash;
+}
+
+/* Compare the file of @cached with @logo_cache, read with the same size */
+static bool logo_cache_same(struct rockchip_logo_cache *cached,
+			    struct rockchip_logo_cache *logo_cache)
+{
+	const u8 *a = cached->src, *b = logo_cache->src;
+	u32 offset, stride, height, i;
+
+	if (!cached->flipped)
+		return !memcmp(a, b, logo_cache->src_size);
+
+	/* The rows of a direct logo were turned upside down for vop2 */
+	offset = cached->logo.offset;
+	stride = ALIGN(cached->logo.width * cached->logo.bpp >> 3, 4);
+	height = cached->logo.height;
+	if (memcmp(a, b, offset))
+		return false;
+	for (i = 0; i < height; i++)
+		if (memcmp(a + offset + i * stride,
+			   b + offset + (height - 1 - i) * stride, stride))
+			return false;
+	i = offset + height * stride;
+
+	return !memcmp(a + i, b + i, logo_cache->src_size - i);
+}
+
+/*
+ * Find an already decoded logo with the same content as @logo_cache,
+ * which has just been read. Files are only hashed when another cached
+ * logo has the same size, so a single logo costs nothing extra; a hash
+ * match is then confirmed byte by byte.
+ */
+static struct rockchip_logo_cache *
+find_logo_cache_by_content(struct rockchip_logo_cache *logo_cache)
+{
+	struct rockchip_logo_cache *tmp;
+
+	list_for_each_entry(tmp, &logo_cache_list, head) {
+		if (tmp == logo_cache || !tmp->logo.mem ||
+		    tmp->src_size != logo_cache->src_size)
+			continue;
+		if (logo_cache_hash(tmp) == logo_cache_hash(logo_cache) &&
+		    logo_cache_same(tmp, logo_cache))
+			return tmp;
+	}
+
+	return NULL;
+}
+
+static void logo_from_cache(struct logo_info *logo,
+			    struct rockchip_logo_cache *logo_cache)
+{
+	int mode = logo->mode;
+
+	memcpy(logo, &logo_cache->logo, sizeof(*logo));
+	logo->mode = mode;
+}
+
+#ifdef CONFIG_DRM_ROCKCHIP_LOGO_LZ4
+#define LOGO_LZ4_CHUNK		SZ_256K
+
+struct logo_lz4_stream {
+	struct ulz4_stream lz4;
+	void *dst;
+	ulong dst_size;
+	const void *in;		/* start of the file */
+	ulong in_len;		/* bytes of it read so far */
+	bool done;		/* end of frame seen, ignore the trailer */
+};
+
+static int logo_lz4_process(void *priv, void *buf, ulong len)
+{
+	struct logo_lz4_stream *ls = priv;
+	int ret;
+
+	if (ls->done)
+		return 0;
+	if (!ls->in) {
+		ret = ulz4fn_stream_init(&ls->lz4, buf, len, ls->dst,
+					 ls->dst_size);
+		if (ret)
+			return ret;
+		ls->in = buf;
+	}
+	ls->in_len += len;
+
+	ret = ulz4fn_stream(&ls->lz4, ls->in + ls->in_len);
+	ls->done = !ret;
+
+	return ret == -EAGAIN ? 0 : ret;
+}
+
+/*
+ * Decode an LZ4 framed bmp into the display buffer while it is read, the
+ * frame must carry its content size. @header is the first block of it.
+ */
+static void *load_lz4_logo(const char *bmp_name, void *header, int *size)
+{
+	struct logo_lz4_stream ls;
+	int ret;
+
+	memset(&ls, 0, sizeof(ls));
+	ret = ulz4fn_stream_init(&ls.lz4, header, RK_BLK_SIZE, NULL, 0);
+	if (ret || !ls.lz4.content_size ||
+	    ls.lz4.content_size > MEMORY_POOL_SIZE) {
+		printf("unsupported lz4 bmp %s\n", bmp_name);
+		return NULL;
+	}
+
+	ls.dst_size = ls.lz4.content_size;
+	ls.dst = get_display_buffer(ls.dst_size);
+	if (!ls.dst)
+		return NULL;
+
+	ret = rockchip_read_resource_file_stream(bmp_name, LOGO_LZ4_CHUNK,
+						 logo_lz4_process, &ls);
+	if (ret < 0 || ls.lz4.out != ls.dst + ls.dst_size) {
+		printf("failed to decode lz4 bmp %s: %d\n", bmp_name, ret);
+		return NULL;
+	}
+	*size = ls.dst_size;
+
+	return ls.dst;
+}
+#endif
+
 /* Note: used only for rkfb kernel driver */
 static int load_kernel_bmp_logo(struct logo_info *logo, const char *bmp_name)
 {
@@ -1177,24 +1314,27 @@ static int load_kernel_bmp_logo(struct logo_info *logo, const char *bmp_name)
 	return 0;
 }
 
-static int load_bmp_logo(struct logo_info *logo, const char *bmp_name)
+static int load_bmp_logo(struct display_state *state, const char *bmp_name)
 {
 #ifdef CONFIG_ROCKCHIP_RESOURCE_IMAGE
-	struct rockchip_logo_cache *logo_cache;
+	struct logo_info *logo = &state->logo;
+	struct rockchip_logo_cache *logo_cache, *same;
 	struct bmp_header *header;
+	unsigned long mem_end = memory_end;
 	void *dst = NULL, *pdst;
 	int size, len;
+	bool lz4 = false;
 	int ret = 0;
 	int reserved = 0;
 
-	if (!logo || !bmp_name)
+	if (!bmp_name)
 		return -EINVAL;
 	logo_cache = find_or_alloc_logo_cache(bmp_name);
 	if (!logo_cache)
 		return -ENOMEM;
 
 	if (logo_cache->logo.mem) {
-		memcpy(logo, &logo_cache->logo, sizeof(*logo));
+		logo_from_cache(logo, logo_cache);
 		return 0;
 	}
 
@@ -1202,36 +1342,64 @@ static int load_bmp_logo(struct logo_info *logo, const char *bmp_name)
 	if (!header)
 		return -ENOMEM;
 
+	bootstage_start(BOOTSTAGE_ID_ACCUM_LOGO, "logo");
 	len = rockchip_read_resource_file(header, bmp_name, 0, RK_BLK_SIZE);
 	if (len != RK_BLK_SIZE) {
 		ret = -EINVAL;
 		goto free_header;
 	}
 
+#ifdef CONFIG_DRM_ROCKCHIP_LOGO_LZ4
+	if (lz4_is_valid_header((void *)header)) {
+		pdst = load_lz4_logo(bmp_name, header, &size);
+		if (!pdst) {
+			ret = -EINVAL;
+			goto free_header;
+		}
+		memcpy(header, pdst, sizeof(*header));
+		lz4 = true;
+	}
+#endif
+
 	logo->bpp = get_unaligned_le16(&header->bit_count);
 	logo->width = get_unaligned_le32(&header->width);
 	logo->height = get_unaligned_le32(&header->height);
 	reserved = get_unaligned_le32(&header->reserved);
 	if (logo->height < 0)
 	    logo->height = -logo->height;
-	size = get_unaligned_le32(&header->file_size);
-	if (!can_direct_logo(logo->bpp)) {
-		if (size > MEMORY_POOL_SIZE) {
+	if (!lz4) {
+		size = get_unaligned_le32(&header->file_size);
+		if (!can_direct_logo(logo->bpp) && size > MEMORY_POOL_SIZE) {
 			printf("failed to use boot buf as temp bmp buffer\n");
 			ret = -ENOMEM;
 			goto free_header;
 		}
 		pdst = get_display_buffer(size);
+		if (!pdst) {
+			ret = -ENOMEM;
+			goto free_header;
+		}
 
-	} else {
-		pdst = get_display_buffer(size);
-		dst = pdst;
+		len = rockchip_read_resource_file(pdst, bmp_name, 0, size);
+		if (len != size) {
+			printf("failed to load bmp %s\n", bmp_name);
+			ret = -ENOENT;
+			goto free_header;
+		}
 	}
+	if (can_direct_logo(logo->bpp))
+		dst = pdst;
 
-	len = rockchip_read_resource_file(pdst, bmp_name, 0, size);
-	if (len != size) {
-		printf("failed to load bmp %s\n", bmp_name);
-		ret = -ENOENT;
+	logo_cache->src = pdst;
+	logo_cache->src_size = size;
+	same = find_logo_cache_by_content(logo_cache);
+	if (same) {
+		/* Give the copy back to the display buffer and share */
+		memory_end = mem_end;
+		memcpy(&logo_cache->logo, &same->logo, sizeof(*logo));
+		logo_cache->src = same->src;
+		logo_cache->flipped = same->flipped;
+		logo_from_cache(logo, logo_cache);
 		goto free_header;
 	}
 
@@ -1241,7 +1409,8 @@ static int load_bmp_logo(struct logo_info *logo, const char *bmp_name)
 		 * TODO: force use 16bpp if bpp less than 16;
 		 */
 		logo->bpp = (logo->bpp <= 16) ? 16 : logo->bpp;
-		dst_size = logo->width * logo->height * logo->bpp >> 3;
+		dst_size = ALIGN(logo->width * logo->bpp >> 3, 4) *
+			   logo->height;
 
 		dst = get_display_buffer(dst_size);
 		if (!dst) {
@@ -1266,11 +1435,29 @@ static int load_bmp_logo(struct logo_info *logo, const char *bmp_name)
 		else
 			logo->ymirror = 1;
 	}
+
+	/*
+	 * The vop2 windows do not mirror the logo, turn a bottom-up bmp
+	 * upside down here. The file is hashed first as it is modified.
+	 */
+	if (logo->ymirror && state->crtc_state.ports_node) {
+		int stride = ALIGN(logo->width * logo->bpp >> 3, 4);
+		ulong bits = (ulong)dst + logo->offset;
+
+		logo_cache_hash(logo_cache);
+		bmp_flip_rows((void *)bits, stride, logo->height);
+		logo_cache->flipped = true;
+		flush_dcache_range(bits & ~(CONFIG_SYS_CACHELINE_SIZE - 1),
+				   ALIGN(bits + stride * logo->height,
+					 CONFIG_SYS_CACHELINE_SIZE));
+		logo->ymirror = 0;
+	}
 	logo->mem = dst;
 
 	memcpy(&logo_cache->logo, logo, sizeof(*logo));
 
 free_header:
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_LOGO);
 
 	free(header);
 
@@ -1309,7 +1496,7 @@ int rockchip_show_bmp(const char *bmp)
 
 	list_for_each_entry(s, &rockchip_display_list, head) {
 		s->logo.mode = s->charge_logo_mode;
-		if (load_bmp_logo(&s->logo, bmp))
+		if (load_bmp_logo(s, bmp))
 			continue;
 		ret = display_logo(s);
 	}
@@ -1324,7 +1511,7 @@ int rockchip_show_logo(void)
 
 	list_for_each_entry(s, &rockchip_display_list, head) {
 		s->logo.mode = s->logo_mode;
-		if (load_bmp_logo(&s->logo, s->ulogo_name))
+		if (load_bmp_logo(s, s->ulogo_name))
 			printf("failed to display uboot logo\n");
 		else
 			ret = display_logo(s);
@@ -1824,7 +2011,7 @@ void rockchip_display_fixup(void *blob)
 
 	if (fdt_node_offset_by_compatible(blob, 0, "rockchip,drm-logo") >= 0) {
 		list_for_each_entry(s, &rockchip_display_list, head)
-			load_bmp_logo(&s->logo, s->klogo_name);
+			load_bmp_logo(s, s->klogo_name);
 
 		if (!get_display_size())
 			return;
@@ -167,6 +167,11 @@ struct rockchip_logo_cache {
 	struct list_head head;
 	char name[20];
 	struct logo_info logo;
+	void *src;		/* bmp file as read from the resource image */
+	u32 src_size;
+	bool hashed;
+	u64 hash;		/* bmp_content_hash() of src, valid if hashed */
+	bool flipped;		/* rows of src turned upside down in place */
 };
 
 struct display_state {
@@ -118,10 +118,71 @@ static int video_clear(struct udevice *dev)
 	} else {
 		memset(priv->fb, priv->colour_bg, priv->fb_size);
 	}
+	video_damage(dev, 0, 0, priv->xsize, priv->ysize);
 
 	return 0;
 }
 
+void video_damage(struct udevice *vid, int x, int y, int width, int height)
+{
+	struct video_priv *priv = dev_get_uclass_priv(vid);
+	int x1 = min(x + width, (int)priv->xsize);
+	int y1 = min(y + height, (int)priv->ysize);
+
+	x = max(x, 0);
+	y = max(y, 0);
+	if (x1 <= x || y1 <= y)
+		return;
+
+	if (priv->damage.x1 <= priv->damage.x0) {
+		priv->damage.x0 = x;
+		priv->damage.y0 = y;
+		priv->damage.x1 = x1;
+		priv->damage.y1 = y1;
+		return;
+	}
+	priv->damage.x0 = min(priv->damage.x0, x);
+	priv->damage.y0 = min(priv->damage.y0, y);
+	priv->damage.x1 = max(priv->damage.x1, x1);
+	priv->damage.y1 = max(priv->damage.y1, y1);
+}
+
+#if defined(CONFIG_ARM) && !defined(CONFIG_SYS_DCACHE_OFF)
+static void video_flush_range(ulong start, ulong end)
+{
+	flush_dcache_range(start & ~(CONFIG_SYS_CACHELINE_SIZE - 1),
+			   ALIGN(end, CONFIG_SYS_CACHELINE_SIZE));
+}
+
+/*
+ * Flush the damaged rectangle. A narrow one, such as a character written
+ * to a console on a wide display, is flushed a line at a time so that the
+ * rest of each line is left alone; otherwise all the lines it covers are
+ * flushed in one go.
+ */
+static void video_flush_damage(struct video_priv *priv)
+{
+	int pbytes = VNBYTES(priv->bpix);
+	ulong start, len;
+	int y;
+
+	start = (ulong)priv->fb + priv->damage.y0 * priv->line_length;
+	if ((priv->damage.x1 - priv->damage.x0) * pbytes * 2 >
+	    priv->line_length) {
+		video_flush_range(start, (ulong)priv->fb +
+				  priv->damage.y1 * priv->line_length);
+		return;
+	}
+
+	start += priv->damage.x0 * pbytes;
+	len = (priv->damage.x1 - priv->damage.x0) * pbytes;
+	for (y = priv->damage.y0; y < priv->damage.y1; y++) {
+		video_flush_range(start, start + len);
+		start += priv->line_length;
+	}
+}
+#endif
+
 /* Flush video activity to the caches */
 void video_sync(struct udevice *vid)
 {
@@ -133,11 +194,11 @@ void video_sync(struct udevice *vid)
 #if defined(CONFIG_ARM) && !defined(CONFIG_SYS_DCACHE_OFF)
 	struct video_priv *priv = dev_get_uclass_priv(vid);
 
-	if (priv->flush_dcache) {
-		flush_dcache_range((ulong)priv->fb,
-				   ALIGN((ulong)priv->fb + priv->fb_size,
-					 CONFIG_SYS_CACHELINE_SIZE));
-	}
+	if (priv->damage.x1 <= priv->damage.x0)
+		return;
+	if (priv->flush_dcache)
+		video_flush_damage(priv);
+	priv->damage.x1 = priv->damage.x0;
 #elif defined(CONFIG_VIDEO_SANDBOX_SDL)
 	struct video_priv *priv = dev_get_uclass_priv(vid);
 	static ulong last_sync;
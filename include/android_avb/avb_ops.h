@@ -81,6 +81,13 @@ typedef enum {
 struct AvbOps;
 typedef struct AvbOps AvbOps;
 
+/* Called by |read_from_partition_stream| with each chunk of the data, in
+ * order, as soon as the chunk is in the caller's buffer.
+ */
+typedef void (*AvbReadChunkFunc)(void* user_data,
+                                 const uint8_t* data,
+                                 size_t num_bytes);
+
 /* Forward-declaration of operations in libavb_ab. */
 struct AvbABOps;
 
@@ -157,6 +164,25 @@ struct AvbOps {
                                          size_t* out_num_bytes_preloaded,
                                          int allow_verification_error);
 
+  /* Like |read_from_partition| but hands each chunk of the data to
+   * |chunk_done| together with |user_data| once it has been read into
+   * |buffer|. Chunks are passed in order and cover all of the bytes read;
+   * the implementation may already be reading the next chunk while
+   * |chunk_done| runs, which lets the caller hash a partition while it is
+   * being loaded. |buffer| holds the whole data on return.
+   *
+   * This operation is optional, when it is NULL |read_from_partition|
+   * is used instead.
+   */
+  AvbIOResult (*read_from_partition_stream)(AvbOps* ops,
+                                            const char* partition,
+                                            int64_t offset,
+                                            size_t num_bytes,
+                                            void* buffer,
+                                            AvbReadChunkFunc chunk_done,
+                                            void* user_data,
+                                            size_t* out_num_read);
+
   /* Writes |num_bytes| from |bffer| at offset |offset| to partition
    * with name |partition| (NUL-terminated UTF-8 string). If |offset|
    * is negative, its absolute value should be interpreted as the
@@ -96,6 +96,10 @@ typedef struct global_data {
 	unsigned long fdt_size;		/* Space reserved for relocated FDT */
 #ifdef CONFIG_OF_LIVE
 	struct device_node *of_root;
+#endif
+#ifdef CONFIG_FDTDEC_INDEX
+	void *fdt_index;		/* Side index of fdt_blob */
+	const void *fdt_index_failed;	/* Blob which could not be indexed */
 #endif
 	struct jt_funcs *jt;		/* jump table */
 	char env_buf[32];		/* buffer for env_get() before reloc. */
@@ -84,6 +84,9 @@ struct blk_desc {
 	unsigned char	type;		/* device type */
 	unsigned char	removable;	/* removable device */
 	unsigned char	op_flag;	/* Some special operation flags */
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	struct blk_req	*async_req;	/* Asynchronous read in flight */
+#endif
 #ifdef CONFIG_LBA48
 	/* device can use 48bit addr (ATA/ATAPI v7) */
 	unsigned char	lba48;
@@ -214,6 +217,25 @@ static inline void blkcache_invalidate(int iftype, int dev) {}
 #if CONFIG_IS_ENABLED(BLK)
 struct udevice;
 
+/**
+ * struct blk_req - an asynchronous block read request
+ *
+ * @dev:	Block device the request was submitted to
+ * @start:	Start block number to read (0=first)
+ * @blkcnt:	Number of blocks to read
+ * @buffer:	Destination buffer for data read
+ * @done:	Number of blocks transferred so far, updated by the driver
+ * @status:	-EINPROGRESS while in flight, then 0 or -ve error number
+ */
+struct blk_req {
+	struct udevice *dev;
+	lbaint_t start;
+	lbaint_t blkcnt;
+	void *buffer;
+	lbaint_t done;
+	int status;
+};
+
 /* Operations on block devices */
 struct blk_ops {
 	/**
@@ -272,6 +294,36 @@ struct blk_ops {
 	 * @return 0 if OK, -ve on error
 	 */
 	int (*select_hwpart)(struct udevice *dev, int hwpart);
+
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	/**
+	 * read_submit() - start reading from a block device
+	 *
+	 * Start @req and return as soon as the transfer is under way. A
+	 * driver which cannot run the transfer in the background may
+	 * complete it before returning.
+	 *
+	 * Only one request is in flight per device; the uclass completes it
+	 * before any other operation is passed to the driver.
+	 *
+	 * @dev:	Device to read from
+	 * @req:	Request to start
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*read_submit)(struct udevice *dev, struct blk_req *req);
+
+	/**
+	 * read_poll() - check a read started by read_submit()
+	 *
+	 * The driver is responsible for timing the request out.
+	 *
+	 * @dev:	Device the request was submitted to
+	 * @req:	Request to check
+	 * @return 0 if complete, -EINPROGRESS if still running, other -ve
+	 * value on error
+	 */
+	int (*read_poll)(struct udevice *dev, struct blk_req *req);
+#endif
 };
 
 #define blk_get_ops(dev)	((struct blk_ops *)(dev)->driver->ops)
@@ -289,6 +341,63 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			 lbaint_t blkcnt);
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+/**
+ * blk_dread_submit() - start an asynchronous read
+ *
+ * Any request already in flight on @block_dev is completed first. Devices
+ * without asynchronous support complete the read before this returns.
+ *
+ * @block_dev:	Block device to read from
+ * @req:	Request to fill in and start; must stay valid until complete
+ * @start:	Start block number to read (0=first)
+ * @blkcnt:	Number of blocks to read
+ * @buffer:	Destination buffer for data read
+ * @return 0 if OK, -ve on error
+ */
+int blk_dread_submit(struct blk_desc *block_dev, struct blk_req *req,
+		     lbaint_t start, lbaint_t blkcnt, void *buffer);
+
+/**
+ * blk_dread_poll() - check whether an asynchronous read is complete
+ *
+ * @req:	Request started with blk_dread_submit()
+ * @return 0 if complete, -EINPROGRESS if still running, other -ve value
+ * on error
+ */
+int blk_dread_poll(struct blk_req *req);
+
+/**
+ * blk_dread_wait() - wait for an asynchronous read to complete
+ *
+ * @req:	Request started with blk_dread_submit()
+ * @return 0 if OK, -ve on error
+ */
+int blk_dread_wait(struct blk_req *req);
+
+/**
+ * blk_dread_pipeline() - read data and process it while the rest arrives
+ *
+ * Read @size bytes starting at block @start in chunks of @chunk bytes. Each
+ * chunk is handed to @process while the next one is being read, so hashing,
+ * decompression or parsing overlaps with the transfer.
+ *
+ * @block_dev:	Block device to read from
+ * @start:	Start block number to read (0=first)
+ * @size:	Number of bytes to read and process
+ * @buffer:	Destination buffer, at least @size rounded up to a block
+ * @chunk:	Chunk size in bytes, rounded up to a block
+ * @process:	Called in order for each chunk with its data and length in
+ *		bytes; returns 0 if OK or -ve to stop the read
+ * @priv:	Private data passed to @process
+ * @return 0 if OK, -ve on error
+ */
+int blk_dread_pipeline(struct blk_desc *block_dev, lbaint_t start,
+		       ulong size, void *buffer, ulong chunk,
+		       int (*process)(void *priv, void *buf, ulong len),
+		       void *priv);
+#endif
+
 /**
  * blk_find_device() - Find a block device
  *
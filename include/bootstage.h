@@ -205,6 +205,10 @@ enum bootstage_id {
 	BOOTSTATE_ID_ACCUM_DM_SPL,
 	BOOTSTATE_ID_ACCUM_DM_F,
 	BOOTSTATE_ID_ACCUM_DM_R,
+	BOOTSTAGE_ID_ACCUM_LOGO,
+	BOOTSTAGE_ID_ACCUM_FDT_INDEX_F,
+	BOOTSTAGE_ID_ACCUM_FDT_INDEX_R,
+	BOOTSTAGE_ID_ACCUM_HUSH,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -315,6 +315,14 @@ int clk_disable_bulk(struct clk_bulk *bulk);
 
 int soc_clk_dump(void);
 
+/**
+ * soc_clk_dump_timing() - print how long the clock setup took
+ *
+ * Called by 'clk dump -t' after the dump, for SoCs which keep track of
+ * it, e.g. the time spent waiting for PLLs to lock.
+ */
+void soc_clk_dump_timing(void);
+
 int clks_probe(void);
 
 /**
@@ -671,6 +671,28 @@ int gzwrite(unsigned char *src, int len,
 bool lz4_is_valid_header(const unsigned char *h);
 int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
 
+/* Decoder state of an LZ4 frame which arrives piece by piece */
+struct ulz4_stream {
+	const void *in;		/* next block header */
+	void *out;		/* next decoded byte */
+	void *end;		/* end of the output buffer */
+	u64 content_size;	/* from the frame header, 0 if not present */
+	bool has_block_checksum;
+};
+
+/*
+ * ulz4fn_stream_init() - parse an LZ4 frame header
+ * @return 0 if OK, -ve if @srcn bytes do not hold a supported header
+ */
+int ulz4fn_stream_init(struct ulz4_stream *s, const void *src, size_t srcn,
+		       void *dst, size_t dstn);
+/*
+ * ulz4fn_stream() - decode every complete block before @avail
+ * @return 0 at the end of the frame, -EAGAIN if more input is needed,
+ * other -ve value on error
+ */
+int ulz4fn_stream(struct ulz4_stream *s, const void *avail);
+
 /* lib/qsort.c */
 void qsort(void *base, size_t nmemb, size_t size,
 	   int(*compar)(const void *, const void *));
@@ -47,6 +47,47 @@ void console_record_reset_enable(void);
  */
 void console_record_print_purge(void);
 
+#if CONFIG_IS_ENABLED(CONSOLE_ASYNC)
+/**
+ * console_drain() - send buffered serial output without waiting
+ *
+ * With CONFIG_CONSOLE_ASYNC, output for the serial console is buffered and
+ * sent as the UART accepts it. This sends as much as the UART accepts now.
+ * It is called from getc(), tstc() and WATCHDOG_RESET().
+ */
+void console_drain(void);
+
+/**
+ * console_flush() - send all buffered serial output
+ *
+ * This waits until the UART has accepted all buffered output. It is called
+ * before waiting for input and by flushc(), e.g. before booting an OS.
+ */
+void console_flush(void);
+
+/**
+ * console_async_stop() - send buffered serial output and stop buffering
+ *
+ * Output after this call is sent directly, so that it is seen even if
+ * U-Boot stops running. This is used on panic.
+ */
+void console_async_stop(void);
+
+/**
+ * console_async_print_stats() - print statistics of the output buffer
+ */
+void console_async_print_stats(void);
+
+/**
+ * console_async_reset_stats() - clear statistics of the output buffer
+ */
+void console_async_reset_stats(void);
+#else
+static inline void console_drain(void) {}
+static inline void console_flush(void) {}
+static inline void console_async_stop(void) {}
+#endif
+
 /**
  * console_announce_r() - print a U-Boot console on non-serial consoles
  *
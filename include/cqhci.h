@@ -0,0 +1,158 @@
+/*
+ * eMMC Command Queue Host Controller Interface (CQHCI)
+ *
+ * Register and descriptor layout follow JEDEC JESD84-B51, Appendix B.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+#ifndef __CQHCI_H
+#define __CQHCI_H
+
+#include <asm/io.h>
+#include <mmc.h>
+
+/*
+ * Controller registers, relative to the CQHCI base
+ */
+
+#define CQHCI_VER		0x00
+#define CQHCI_CAP		0x04
+
+#define CQHCI_CFG		0x08
+#define  CQHCI_DCMD		BIT(12)
+#define  CQHCI_TASK_DESC_SZ	BIT(8)
+#define  CQHCI_ENABLE		BIT(0)
+
+#define CQHCI_CTL		0x0C
+#define  CQHCI_CLEAR_ALL_TASKS	BIT(8)
+#define  CQHCI_HALT		BIT(0)
+
+#define CQHCI_IS		0x10
+#define CQHCI_ISTE		0x14
+#define CQHCI_ISGE		0x18
+#define  CQHCI_IS_HAC		BIT(0)
+#define  CQHCI_IS_TCC		BIT(1)
+#define  CQHCI_IS_RED		BIT(2)
+#define  CQHCI_IS_TCL		BIT(3)
+#define  CQHCI_IS_GCE		BIT(4)
+#define  CQHCI_IS_ICCE		BIT(5)
+#define  CQHCI_IS_ERROR		(CQHCI_IS_RED | CQHCI_IS_GCE | CQHCI_IS_ICCE)
+#define  CQHCI_IS_MASK		(CQHCI_IS_TCC | CQHCI_IS_ERROR)
+
+#define CQHCI_IC		0x1C
+#define CQHCI_TDLBA		0x20
+#define CQHCI_TDLBAU		0x24
+#define CQHCI_TDBR		0x28
+#define CQHCI_TCN		0x2C
+#define CQHCI_DQS		0x30
+#define CQHCI_DPT		0x34
+#define CQHCI_TCLR		0x38
+#define CQHCI_SSC1		0x40
+#define CQHCI_SSC2		0x44
+#define CQHCI_CRDCT		0x48
+#define CQHCI_RMEM		0x50
+#define CQHCI_TERRI		0x54
+#define CQHCI_CRI		0x58
+#define CQHCI_CRA		0x5C
+
+/*
+ * Descriptor fields
+ */
+
+#define CQHCI_VALID(x)		(((x) & 1) << 0)
+#define CQHCI_END(x)		(((x) & 1) << 1)
+#define CQHCI_INT(x)		(((x) & 1) << 2)
+#define CQHCI_ACT(x)		(((x) & 0x7) << 3)
+#define  CQHCI_ACT_TRAN		0x4
+#define  CQHCI_ACT_TASK		0x5
+#define  CQHCI_ACT_LINK		0x6
+
+/* Task descriptor */
+#define CQHCI_FORCED_PROG(x)	(((x) & 1) << 6)
+#define CQHCI_CONTEXT(x)	(((x) & 0xF) << 7)
+#define CQHCI_DATA_TAG(x)	(((x) & 1) << 11)
+#define CQHCI_DATA_DIR(x)	(((x) & 1) << 12)
+#define CQHCI_PRIORITY(x)	(((x) & 1) << 13)
+#define CQHCI_QBAR(x)		(((x) & 1) << 14)
+#define CQHCI_REL_WRITE(x)	(((x) & 1) << 15)
+#define CQHCI_BLK_COUNT(x)	(((u64)(x) & 0xFFFF) << 16)
+#define CQHCI_BLK_ADDR(x)	(((u64)(x) & 0xFFFFFFFF) << 32)
+
+/* Transfer and link descriptors */
+#define CQHCI_DAT_LENGTH(x)	(((x) & 0xFFFF) << 16)
+
+#define CQHCI_NUM_SLOTS		32
+#define CQHCI_SEG_LEN		0x8000	/* bytes per transfer descriptor */
+#define CQHCI_TRAN_DESC_NUM	65	/* transfer descriptors per task */
+
+struct cqhci_host;
+
+struct cqhci_host_ops {
+	/* Prepare the SD host for queued transfers */
+	void (*enable)(struct cqhci_host *cq_host);
+	/* Return the SD host to ordinary commands, resetting after an error */
+	void (*disable)(struct cqhci_host *cq_host, bool recovery);
+};
+
+struct cqhci_host {
+	void *mmio;		/* CQHCI register base */
+	struct mmc *mmc;
+	const struct cqhci_host_ops *ops;
+	void *priv;		/* SD host driver data */
+	bool dma64;		/* 64-bit descriptor addresses */
+
+	bool enabled;
+	bool recovery;		/* a task failed, reset on disable */
+	unsigned int task_desc_len;
+	unsigned int link_desc_len;
+	unsigned int trans_desc_len;
+	unsigned int slot_sz;
+	unsigned int trans_area_sz;	/* transfer descriptors of one slot */
+	u8 *desc_base;		/* task descriptor list */
+	u8 *trans_base;		/* transfer descriptors, per slot */
+};
+
+static inline void cqhci_writel(struct cqhci_host *cq_host, u32 val, int reg)
+{
+	writel(val, cq_host->mmio + reg);
+}
+
+static inline u32 cqhci_readl(struct cqhci_host *cq_host, int reg)
+{
+	return readl(cq_host->mmio + reg);
+}
+
+/**
+ * cqhci_init() - Allocate the descriptor lists of a command queue engine
+ *
+ * @mmio, @mmc, @ops, @priv and @dma64 must be set up by the caller. On
+ * success the queue depth and task size limit are stored in @cfg.
+ *
+ * @cq_host:	Command queue engine
+ * @cfg:	MMC configuration of the SD host
+ * @return 0 if OK, -ve on error
+ */
+int cqhci_init(struct cqhci_host *cq_host, struct mmc_config *cfg);
+
+/**
+ * cqhci_enable() - Start or stop the command queue engine
+ *
+ * @cq_host:	Command queue engine
+ * @enable:	true to start queueing, false to return to ordinary commands
+ * @return 0 if OK, -ve on error
+ */
+int cqhci_enable(struct cqhci_host *cq_host, bool enable);
+
+/**
+ * cqhci_request() - Queue data transfers and wait until all are complete
+ *
+ * @cq_host:	Command queue engine
+ * @data:	Transfers, see dm_mmc_ops.cqe_request()
+ * @count:	Number of transfers
+ * @return 0 if OK, -EINVAL if a buffer cannot be mapped, other -ve value
+ * if a task failed
+ */
+int cqhci_request(struct cqhci_host *cq_host, struct mmc_data *data,
+		  int count);
+
+#endif /* __CQHCI_H */
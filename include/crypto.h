@@ -198,6 +198,34 @@ int crypto_sha_regions_csum(struct udevice *dev, sha_context *ctx,
  */
 int crypto_rsa_verify(struct udevice *dev, rsa_key *ctx, u8 *sign, u8 *output);
 
+/**
+ * crypto_rsa_algo() - Get rsa algorithm accroding to key bits
+ * @n_bits: rsa key bits, eg. 2048/4096
+ *
+ * @return CRYPTO_RSA512...CRYPTO_RSA4096, or 0 if unsupported
+ */
+u32 crypto_rsa_algo(u32 n_bits);
+
+/**
+ * crypto_rsa_verify_be() - Crypto rsa verify with big-endian factors
+ *
+ * This is the common entry of rsa verify for FIT and AVB. It takes the
+ * big-endian factors as they are stored in images, finds a crypto device
+ * capable of the key bits, eg. rockchip PKA, and converts them for
+ * crypto_rsa_verify(). Callers should fall back to software if it fails.
+ *
+ * @n_bits: rsa key bits
+ * @n: public key factor N, big-endian, n_bits / 8 bytes
+ * @e: public key factor E, big-endian, n_bits / 8 bytes
+ * @c: optional accelerate factor, big-endian, NULL if absent
+ * @sign: signature, big-endian, n_bits / 8 bytes
+ * @output: output buffer for sign ^ E mod N, big-endian, n_bits / 8 bytes
+ *
+ * @return 0 on success, -ENODEV if no capable device, otherwise failed
+ */
+int crypto_rsa_verify_be(u32 n_bits, const u8 *n, const u8 *e, const u8 *c,
+			 const u8 *sign, u8 *output);
+
 /**
  * crypto_hmac_init() - Crypto hmac init
  *
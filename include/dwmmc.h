@@ -9,6 +9,7 @@
 #define __DWMMC_HW_H
 
 #include <asm/io.h>
+#include <bouncebuf.h>
 #include <mmc.h>
 
 #define DWMCI_CTRL		0x000
@@ -124,6 +125,8 @@
 #define DWMCI_IDMAC_CH		(1 << 4)
 #define DWMCI_IDMAC_FS		(1 << 3)
 #define DWMCI_IDMAC_LD		(1 << 2)
+/* Largest buffer 1 size (13 bits) that is a multiple of 512 bytes */
+#define DWMCI_IDMAC_MAX_LEN	0x1e00
 
 /*  Bus Mode Register */
 #define DWMCI_BMOD_IDMAC_RESET	(1 << 0)
@@ -206,6 +209,17 @@ struct dwmci_host {
 
 	/* use fifo mode to read and write data */
 	bool fifo_mode;
+	/* IDMAC descriptor pool, allocated by dwmci_init() */
+	struct dwmci_idmac *idmac;
+	unsigned int idmac_num;
+
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	/* Read left running by send_cmd_submit() */
+	struct mmc_data *async_data;
+	struct bounce_buffer async_bbstate;
+	ulong async_start;
+	unsigned int async_timeout;
+#endif
 };
 
 struct dwmci_idmac {
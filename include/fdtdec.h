@@ -647,6 +647,78 @@ int fdtdec_get_chosen_node(const void *blob, const char *name);
  */
 const char *fdtdec_get_compatible(enum fdt_compat_id id);
 
+#if CONFIG_IS_ENABLED(FDTDEC_INDEX)
+/**
+ * fdtdec_node_offset_by_phandle() - find the node with a given phandle
+ *
+ * Same as fdt_node_offset_by_phandle(), using the index of the control
+ * device tree if @blob is that tree.
+ *
+ * @blob:	FDT blob
+ * @phandle:	Phandle to look for
+ * @return node offset, or -ve FDT_ERR_... value if not found
+ */
+int fdtdec_node_offset_by_phandle(const void *blob, uint32_t phandle);
+
+/**
+ * fdtdec_node_offset_by_compatible() - find the next compatible node
+ *
+ * Same as fdt_node_offset_by_compatible(), using the index of the control
+ * device tree if @blob is that tree.
+ *
+ * @blob:	FDT blob
+ * @node:	Node to start after, -1 to start with the root node
+ * @compat:	Compatible string to look for
+ * @return node offset, or -ve FDT_ERR_... value if not found
+ */
+int fdtdec_node_offset_by_compatible(const void *blob, int node,
+				     const char *compat);
+
+/**
+ * fdtdec_parent_offset() - find the parent of a node
+ *
+ * Same as fdt_parent_offset(), using the index of the control device tree
+ * if @blob is that tree.
+ *
+ * @blob:	FDT blob
+ * @node:	Node to look up
+ * @return parent node offset, or -ve FDT_ERR_... value on error
+ */
+int fdtdec_parent_offset(const void *blob, int node);
+
+/**
+ * fdtdec_index_alias_seq() - fdtdec_get_alias_seq() using the index
+ *
+ * @return 0 if a sequence was found, -ENOENT if not, -ENOSYS if @blob is
+ * not indexed
+ */
+int fdtdec_index_alias_seq(const void *blob, const char *base, int node,
+			   int *seqp);
+#else
+static inline int fdtdec_node_offset_by_phandle(const void *blob,
+						uint32_t phandle)
+{
+	return fdt_node_offset_by_phandle(blob, phandle);
+}
+
+static inline int fdtdec_node_offset_by_compatible(const void *blob, int node,
+						   const char *compat)
+{
+	return fdt_node_offset_by_compatible(blob, node, compat);
+}
+
+static inline int fdtdec_parent_offset(const void *blob, int node)
+{
+	return fdt_parent_offset(blob, node);
+}
+
+static inline int fdtdec_index_alias_seq(const void *blob, const char *base,
+					 int node, int *seqp)
+{
+	return -ENOSYS;
+}
+#endif
+
 /* Look up a phandle and follow it to its node. Then return the offset
  * of that node.
  *
@@ -1047,10 +1047,12 @@ int fit_set_version(void *fit, int noffset, int version);
  * @comment:	Comment to add to signature nodes
  * @require_keys: Mark all keys as 'required'
  * @engine_id:	Engine to use for signing
+ * @threads:	Number of threads to hash component images with
  *
  * Adds hash values for all component images in the FIT blob.
  * Hashes are calculated for all component images which have hash subnodes
  * with algorithm property set to one of the supported hash algorithms.
+ * The result does not depend on the number of threads.
  *
  * Also add signatures if signature nodes are present.
  *
@@ -1060,7 +1062,7 @@ int fit_set_version(void *fit, int noffset, int version);
  */
 int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 			      const char *comment, int require_keys,
-			      const char *engine_id);
+			      const char *engine_id, int threads);
 
 int fit_image_verify_with_data(const void *fit, int image_noffset,
 			       const void *data, size_t size);
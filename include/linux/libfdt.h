@@ -305,6 +305,51 @@ int fdt_next_region(const void *fdt,
  */
 int fdt_add_alias_regions(const void *fdt, struct fdt_region *region, int count,
 			  int max_regions, struct fdt_region_state *info);
+
+struct fdt_overlay_index;
+
+/**
+ * fdt_overlay_index_create() - index a base tree for applying overlays
+ *
+ * fdt_overlay_apply() finds fragment targets and __fixups__ labels by
+ * scanning the base tree, once for every fragment and every fixup. The
+ * index maps phandles to node offsets and __symbols__ labels to phandles
+ * so that each of those is a hash lookup instead.
+ *
+ * The index only stays valid while the tree is changed through
+ * fdt_overlay_apply_index(). It is not affected by moving or resizing the
+ * tree, e.g. with fdt_open_into().
+ *
+ * @fdt:	Base device tree
+ * @idxp:	Returns the new index
+ * @return 0 if OK, -FDT_ERR_NOSPACE if out of memory, other -FDT_ERR_...
+ * value if the tree is invalid
+ */
+int fdt_overlay_index_create(const void *fdt, struct fdt_overlay_index **idxp);
+
+/**
+ * fdt_overlay_index_free() - free an index of a base tree
+ *
+ * @idx:	Index to free, may be NULL
+ */
+void fdt_overlay_index_free(struct fdt_overlay_index *idx);
+
+/**
+ * fdt_overlay_apply_index() - apply an overlay using an index
+ *
+ * Same as fdt_overlay_apply(), producing the same tree, but uses and
+ * updates @idx instead of scanning @fdt. Symbols and phandles of the
+ * overlay are added to the index so that stacked overlays can refer to
+ * them. If this fails, both trees are left damaged as with
+ * fdt_overlay_apply() and the index cannot be used again.
+ *
+ * @fdt:	Base device tree, indexed by @idx
+ * @fdto:	Device tree overlay
+ * @idx:	Index of @fdt
+ * @return 0 if OK, -FDT_ERR_... value on error
+ */
+int fdt_overlay_apply_index(void *fdt, void *fdto,
+			    struct fdt_overlay_index *idx);
 #endif /* SWIG */
 
 extern struct fdt_header *working_fdt;  /* Pointer to the working fdt */
@@ -63,6 +63,7 @@
 #define MMC_MODE_HS400ES	(1 << 8)
 
 #define SD_DATA_4BIT	0x00040000
+#define SD_CMD23_SUPPORT	0x00000002	/* SCR CMD_SUPPORT, CMD23 */
 
 #define IS_SD(x)	((x)->version & SD_VERSION_SD)
 #define IS_MMC(x)	((x)->version & MMC_VERSION_MMC)
@@ -93,6 +94,7 @@
 #define MMC_CMD_ERASE_GROUP_START	35
 #define MMC_CMD_ERASE_GROUP_END		36
 #define MMC_CMD_ERASE			38
+#define MMC_CMD_CMDQ_TASK_MGMT		48
 #define MMC_CMD_APP_CMD			55
 #define MMC_CMD_SPI_READ_OCR		58
 #define MMC_CMD_SPI_CRC_ON_OFF		59
@@ -172,6 +174,7 @@
 /*
  * EXT_CSD fields
  */
+#define EXT_CSD_CMDQ_MODE_EN		15	/* R/W */
 #define EXT_CSD_ENH_START_ADDR		136	/* R/W */
 #define EXT_CSD_ENH_SIZE_MULT		140	/* R/W */
 #define EXT_CSD_GP_SIZE_MULT		143	/* R/W */
@@ -197,6 +200,8 @@
 #define EXT_CSD_HC_ERASE_GRP_SIZE	224	/* RO */
 #define EXT_CSD_BOOT_MULT		226	/* RO */
 #define EXT_CSD_SEC_FEATURE_SUPPORT     231     /* RO */
+#define EXT_CSD_CMDQ_DEPTH		307	/* RO */
+#define EXT_CSD_CMDQ_SUPPORT		308	/* RO */
 #define EXT_CSD_BKOPS_SUPPORT		502	/* RO */
 
 /*
@@ -257,6 +262,11 @@
 
 #define EXT_CSD_PARTITION_SETTING_COMPLETED	(1 << 0)
 
+#define EXT_CSD_CMDQ_SUPPORTED		(1 << 0)
+#define EXT_CSD_CMDQ_DEPTH_MASK		0x1f
+
+#define MMC_CMDQ_DISCARD_QUEUE		1	/* CMD48 TM op code */
+
 #define EXT_CSD_ENH_USR		(1 << 0)	/* user data area is enhanced */
 #define EXT_CSD_ENH_GP(x)	(1 << ((x)+1))	/* GP part (x+1) is enhanced */
 
@@ -398,6 +408,9 @@ struct mmc_data {
 	uint flags;
 	uint blocks;
 	uint blocksize;
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	uint blk_addr;	/* card address of a command queue task */
+#endif
 };
 
 /* forward decl. */
@@ -416,18 +429,65 @@ struct dm_mmc_ops {
 	int (*send_cmd)(struct udevice *dev, struct mmc_cmd *cmd,
 			struct mmc_data *data);
 
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
 	/**
-	 * send_cmd_prepare() - Send a command to the MMC device
+	 * send_cmd_submit() - Send a command and leave its data phase running
+	 *
+	 * This behaves like send_cmd() but returns as soon as the response
+	 * has arrived, while the data is still being transferred by DMA. The
+	 * transfer is finished with data_poll(). A driver which cannot do
+	 * this for a particular request may complete the transfer before
+	 * returning.
 	 *
 	 * @dev:	Device to receive the command
 	 * @cmd:	Command to send
-	 * @data:	Additional data to send/receive
+	 * @data:	Data to receive; must stay valid until data_poll()
+	 *		reports completion
 	 * @return 0 if OK, -ve on error
 	 */
-#ifdef CONFIG_SPL_BLK_READ_PREPARE
-	int (*send_cmd_prepare)(struct udevice *dev, struct mmc_cmd *cmd,
-				struct mmc_data *data);
+	int (*send_cmd_submit)(struct udevice *dev, struct mmc_cmd *cmd,
+			       struct mmc_data *data);
+
+	/**
+	 * data_poll() - Check the data phase started by send_cmd_submit()
+	 *
+	 * On error the driver resets its data path before returning.
+	 *
+	 * @dev:	Device the command was sent to
+	 * @data:	Data passed to send_cmd_submit()
+	 * @return 0 if complete, -EINPROGRESS if still running, other -ve
+	 * value on error
+	 */
+	int (*data_poll)(struct udevice *dev, struct mmc_data *data);
 #endif
+
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	/**
+	 * cqe_enable() - Switch the host in or out of command queue mode
+	 *
+	 * The card has already been switched into command queue mode when
+	 * enabling; the core switches it back after disabling.
+	 *
+	 * @dev:	Device to update
+	 * @enable:	true to hand data transfers to the command queue engine
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*cqe_enable)(struct udevice *dev, bool enable);
+
+	/**
+	 * cqe_request() - Queue data transfers and wait for all of them
+	 *
+	 * @dev:	Device to use
+	 * @data:	Transfers, each with its card address in @blk_addr and
+	 *		no more than cfg->cqe_b_max blocks
+	 * @count:	Number of transfers, no more than the queue depth
+	 * @return 0 if OK, -EINVAL if the host cannot map a buffer, other -ve
+	 * value on error
+	 */
+	int (*cqe_request)(struct udevice *dev, struct mmc_data *data,
+			   int count);
+#endif
+
 	/**
 	 * card_busy() - Query the card device status
 	 *
@@ -476,6 +536,15 @@ struct dm_mmc_ops {
 
 int dm_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 		    struct mmc_data *data);
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+int dm_mmc_send_cmd_submit(struct udevice *dev, struct mmc_cmd *cmd,
+			   struct mmc_data *data);
+int dm_mmc_data_poll(struct udevice *dev, struct mmc_data *data);
+#endif
+#if CONFIG_IS_ENABLED(MMC_CQE)
+int dm_mmc_cqe_enable(struct udevice *dev, bool enable);
+int dm_mmc_cqe_request(struct udevice *dev, struct mmc_data *data, int count);
+#endif
 int dm_mmc_set_ios(struct udevice *dev);
 int dm_mmc_get_cd(struct udevice *dev);
 int dm_mmc_get_wp(struct udevice *dev);
@@ -511,6 +580,10 @@ struct mmc_config {
 	uint f_max;
 	uint b_max;
 	unsigned char part_type;
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	uint cqe_depth;		/* command queue slots, 0 if none */
+	uint cqe_b_max;		/* max blocks per command queue task */
+#endif
 };
 
 struct sd_ssr {
@@ -598,6 +671,17 @@ struct mmc {
 #if CONFIG_IS_ENABLED(DM_MMC)
 	struct udevice *dev;	/* Device for this MMC controller */
 #endif
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	struct blk_req *async_req;	/* Asynchronous read in flight */
+	struct mmc_data async_data;	/* Data phase of its current command */
+#ifdef CONFIG_SPL_BLK_READ_PREPARE
+	struct blk_req prepare_req;	/* Request behind BLK_PRE_RW reads */
+#endif
+#endif
+#if CONFIG_IS_ENABLED(MMC_CQE)
+	uint cqe_depth;		/* tasks to queue at once, 0 if no CQE */
+	bool cqe_on;		/* card is in command queue mode */
+#endif
 };
 
 struct mmc_hwpart_conf {
@@ -107,6 +107,36 @@ enum eth_recv_flags {
 	ETH_RECV_CHECK_DEVICE		= 1 << 0,
 };
 
+/**
+ * struct eth_stats - traffic counters of an Ethernet device
+ *
+ * The uclass counts packets and bytes passed to and from the driver, the
+ * driver adds what only the hardware knows about through get_stats().
+ *
+ * @rx_packets: Packets handed to the network stack
+ * @rx_bytes: Bytes handed to the network stack
+ * @rx_errors: recv() failures and frames flagged bad by the MAC
+ * @rx_dropped: Frames lost because no receive descriptor was free
+ * @rx_overruns: Frames lost because the receive FIFO overflowed
+ * @rx_batch_max: Most packets drained from the device in one eth_rx() call
+ * @tx_packets: Packets accepted by send()
+ * @tx_bytes: Bytes accepted by send()
+ * @tx_errors: send() failures
+ * @tx_dropped: Packets refused because the transmit ring was full
+ */
+struct eth_stats {
+	u64 rx_packets;
+	u64 rx_bytes;
+	u32 rx_errors;
+	u32 rx_dropped;
+	u32 rx_overruns;
+	u32 rx_batch_max;
+	u64 tx_packets;
+	u64 tx_bytes;
+	u32 tx_errors;
+	u32 tx_dropped;
+};
+
 /**
  * struct eth_ops - functions of Ethernet MAC controllers
  *
@@ -132,6 +162,9 @@ enum eth_recv_flags {
  *		    ROM on the board. This is how the driver should expose it
  *		    to the network stack. This function should fill in the
  *		    eth_pdata::enetaddr field - optional
+ * get_stats: Add the hardware counters accumulated since the previous call
+ *	      (dropped/overrun frames, MAC flagged errors) to the passed
+ *	      eth_stats - optional
  */
 struct eth_ops {
 	int (*start)(struct udevice *dev);
@@ -144,6 +177,7 @@ struct eth_ops {
 #endif
 	int (*write_hwaddr)(struct udevice *dev);
 	int (*read_rom_hwaddr)(struct udevice *dev);
+	int (*get_stats)(struct udevice *dev, struct eth_stats *stats);
 };
 
 #define eth_get_ops(dev) ((struct eth_ops *)(dev)->driver->ops)
@@ -156,6 +190,23 @@ struct udevice *eth_get_dev(void); /* get the current device */
 struct udevice *eth_get_dev_by_name(const char *devname);
 unsigned char *eth_get_ethaddr(void); /* get the current device MAC */
 
+/**
+ * eth_get_stats() - Read the traffic counters of an Ethernet device
+ *
+ * @dev: Ethernet device, must be probed
+ * @stats: Returns the counters accumulated since probe or the last reset
+ * @return 0 if OK, -ve on error
+ */
+int eth_get_stats(struct udevice *dev, struct eth_stats *stats);
+
+/**
+ * eth_reset_stats() - Clear the traffic counters of an Ethernet device
+ *
+ * @dev: Ethernet device, must be probed
+ * @return 0 if OK, -ve on error
+ */
+int eth_reset_stats(struct udevice *dev);
+
 /* Used only when NetConsole is enabled */
 int eth_is_active(struct udevice *dev); /* Test device for active state */
 int eth_init_state_only(void); /* Set active state */
@@ -79,4 +79,22 @@ int nvme_scan_namespace(void);
  */
 int nvme_print_info(struct udevice *udev);
 
+/**
+ * nvme_print_stats - print I/O command statistics of an NVMe controller
+ *
+ * This prints the number of commands, the amount of data, the deepest
+ * queue and the command latency histogram collected by the block
+ * read/write path since probe or the last nvme_reset_stats().
+ *
+ * @udev:	NVMe block device
+ */
+void nvme_print_stats(struct udevice *udev);
+
+/**
+ * nvme_reset_stats - clear I/O command statistics of an NVMe controller
+ *
+ * @udev:	NVMe block device
+ */
+void nvme_reset_stats(struct udevice *udev);
+
 #endif /* __NVME_H__ */
@@ -21,4 +21,26 @@ struct device_node;
  */
 int of_live_build(const void *fdt_blob, struct device_node **rootp);
 
+/**
+ * of_live_find_node_by_phandle() - look up a phandle in a live tree
+ *
+ * @root: Root of a tree created by of_live_build()
+ * @handle: Phandle to look for
+ * @return node with that phandle, NULL if none, or ERR_PTR(-ENOSYS) if
+ * @root was not created by of_live_build()
+ */
+struct device_node *of_live_find_node_by_phandle(const struct device_node *root,
+						 u32 handle);
+
+/**
+ * of_live_free() - free a live tree
+ *
+ * This releases all nodes and properties of the tree at once. Nothing may
+ * refer to them afterwards, including devices and aliases.
+ *
+ * @root: Root of a tree created by of_live_build()
+ * @return 0 if OK, -EINVAL if @root was not created by of_live_build()
+ */
+int of_live_free(struct device_node *root);
+
 #endif
@@ -328,6 +328,105 @@ int pmic_shutdown(struct udevice *dev);
 
 #endif /* CONFIG_DM_PMIC */
 
+/**
+ * struct pmic_reg_range - range of PMIC registers, for pmic_cache_init()
+ *
+ * @first - first register of the range
+ * @last  - last register of the range
+ */
+struct pmic_reg_range {
+	uint first;
+	uint last;
+};
+
+/**
+ * struct pmic_stats - bus transfer counters of a PMIC device
+ *
+ * @reads        - bus reads
+ * @writes       - bus writes, a burst of registers counts once
+ * @read_hits    - register reads served by the register cache
+ * @write_skips  - writes of the value a register already held
+ * @write_merges - writes merged into the bus write of another register
+ */
+struct pmic_stats {
+	ulong reads;
+	ulong writes;
+	ulong read_hits;
+	ulong write_skips;
+	ulong write_merges;
+};
+
+#if CONFIG_IS_ENABLED(DM_PMIC_CACHE)
+/**
+ * pmic_cache_init() - cache the given registers of a PMIC
+ *
+ * Called by the PMIC driver from its probe method. The registers must
+ * read back what was last written to them and not change on their own,
+ * which rules out status, interrupt and write-masked registers.
+ *
+ * @dev:	PMIC device
+ * @ranges:	Cacheable registers, must stay valid while the device is probed
+ * @count:	Number of entries in @ranges
+ * @return 0 on success or negative value of errno.
+ */
+int pmic_cache_init(struct udevice *dev, const struct pmic_reg_range *ranges,
+		    int count);
+
+/**
+ * pmic_cache_begin() - hold back writes to cached PMIC registers
+ *
+ * Until pmic_cache_commit(), pmic_reg_write() and pmic_clrsetbits() only
+ * update the cache for cached registers and queue the write. pmic_read()
+ * and pmic_write() send the queued writes first.
+ *
+ * @dev:	PMIC device
+ * @return 0 on success or negative value of errno.
+ */
+int pmic_cache_begin(struct udevice *dev);
+
+/**
+ * pmic_cache_commit() - send the writes held back since pmic_cache_begin()
+ *
+ * Queued writes are sent in the order they were made, with a single bus
+ * write for each run of consecutive registers.
+ *
+ * @dev:	PMIC device
+ * @return 0 on success or negative value of errno.
+ */
+int pmic_cache_commit(struct udevice *dev);
+
+/**
+ * pmic_get_stats() - get the bus transfer counters of a PMIC
+ *
+ * @dev:	PMIC device
+ * @stats:	Returns the counters
+ * @return 0 on success or negative value of errno.
+ */
+int pmic_get_stats(struct udevice *dev, struct pmic_stats *stats);
+#else
+static inline int pmic_cache_init(struct udevice *dev,
+				  const struct pmic_reg_range *ranges,
+				  int count)
+{
+	return 0;
+}
+
+static inline int pmic_cache_begin(struct udevice *dev)
+{
+	return 0;
+}
+
+static inline int pmic_cache_commit(struct udevice *dev)
+{
+	return 0;
+}
+
+static inline int pmic_get_stats(struct udevice *dev, struct pmic_stats *stats)
+{
+	return -ENOSYS;
+}
+#endif
+
 #ifdef CONFIG_POWER
 int pmic_init(unsigned char bus);
 int power_init_board(void);
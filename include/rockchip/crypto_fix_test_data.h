@@ -1328,4 +1328,417 @@ const u8 rsa4096_sign_out[] = {
 
 #endif
 
+/* rsa verify benchmark, big-endian as it is in FIT and AVB, E = 65537 */
+const u8 rsa2048_bench_n[] = {
+0xb0, 0x5e, 0x52, 0x55, 0x22, 0x0f, 0xfe, 0x64,
+0xd7, 0xa5, 0x59, 0xc7, 0x2b, 0x5d, 0x0f, 0xe9,
+0x1d, 0x1a, 0x0b, 0x18, 0x81, 0x6e, 0x59, 0x66,
+0xdd, 0x8f, 0x2b, 0x16, 0x70, 0x71, 0x95, 0xc4,
+0x42, 0x20, 0x71, 0x0b, 0xc8, 0x9c, 0xe8, 0xb6,
+0x55, 0xb9, 0x2d, 0xc3, 0x52, 0x6e, 0x12, 0xb8,
+0xc9, 0x1e, 0xbc, 0x5c, 0xfd, 0xeb, 0xd6, 0x20,
+0xd0, 0xd6, 0x81, 0xa5, 0x99, 0x01, 0xa9, 0xf6,
+0x94, 0x91, 0x0d, 0xa1, 0x07, 0x76, 0x5e, 0xd9,
+0xfc, 0xef, 0x50, 0x13, 0xf1, 0xdd, 0xc7, 0x88,
+0x3b, 0xf3, 0xbd, 0xed, 0x8e, 0xce, 0x5d, 0x66,
+0x24, 0x4b, 0x21, 0x9e, 0xef, 0xf6, 0xb7, 0x6b,
+0xed, 0x02, 0x37, 0x30, 0xa8, 0x7c, 0x16, 0x0a,
+0x3d, 0x1a, 0x48, 0x60, 0x84, 0xe1, 0xd6, 0x96,
+0x4e, 0xd8, 0xf9, 0xde, 0xe0, 0x1d, 0x73, 0xc0,
+0x3a, 0xc8, 0x11, 0x25, 0x0b, 0x93, 0x67, 0xfa,
+0xca, 0xff, 0xa5, 0x7c, 0x1e, 0xa0, 0x72, 0x91,
+0x12, 0x53, 0x76, 0xcb, 0x17, 0x72, 0xd5, 0x3e,
+0x24, 0xec, 0x40, 0x17, 0x8a, 0x5d, 0x43, 0x37,
+0x70, 0x40, 0xa8, 0xef, 0x98, 0x9d, 0xa8, 0x11,
+0x5d, 0xf6, 0x76, 0x51, 0xf4, 0x71, 0xdd, 0x46,
+0xfb, 0xd1, 0x0f, 0x70, 0x59, 0xd0, 0x10, 0x17,
+0x77, 0xdf, 0x8c, 0xee, 0xd3, 0xd6, 0xa9, 0x73,
+0x00, 0xc4, 0x80, 0x80, 0x07, 0x17, 0xcb, 0x3a,
+0x62, 0x93, 0xe0, 0xff, 0x91, 0x6d, 0xb9, 0x40,
+0x0a, 0x9a, 0xa0, 0xeb, 0x41, 0x45, 0xd0, 0xff,
+0xfd, 0x9a, 0x8d, 0x96, 0xe5, 0xf0, 0x87, 0xbf,
+0xff, 0x2b, 0xe1, 0x4d, 0xa4, 0xfc, 0x40, 0x04,
+0x37, 0x51, 0x2d, 0x7b, 0xd9, 0x7f, 0xf4, 0xef,
+0x3d, 0x9a, 0x16, 0x3f, 0x76, 0xdb, 0x3b, 0xab,
+0x57, 0xb1, 0xfd, 0xe8, 0x9b, 0x5a, 0x15, 0x21,
+0xbb, 0x86, 0x0d, 0x03, 0x59, 0xef, 0xae, 0x99
+};
+
+const u8 rsa2048_bench_rr[] = {
+0xad, 0x12, 0x5f, 0x34, 0x74, 0xdf, 0x63, 0x50,
+0x42, 0xfa, 0xd9, 0xed, 0xe5, 0xdb, 0x65, 0x26,
+0xc7, 0x5f, 0xc3, 0x47, 0x85, 0x56, 0x66, 0x25,
+0x11, 0xe8, 0xbe, 0xb4, 0xb8, 0x29, 0x83, 0x29,
+0xa2, 0xc4, 0xde, 0xb9, 0x32, 0x60, 0xfe, 0x3d,
+0x8a, 0x82, 0xa5, 0x41, 0x57, 0xbc, 0xa2, 0xbe,
+0xe3, 0xc5, 0xd5, 0x8a, 0x04, 0xf8, 0x63, 0xb9,
+0xf2, 0x6f, 0x1b, 0x06, 0x7a, 0x58, 0xc4, 0x99,
+0x90, 0xd8, 0x76, 0xe5, 0x36, 0xb2, 0x1c, 0x92,
+0xe6, 0xdd, 0xb0, 0x6d, 0x84, 0x6b, 0xf0, 0x33,
+0x28, 0xf0, 0x81, 0x5e, 0x88, 0xa4, 0xda, 0xdc,
+0x4b, 0x07, 0x5b, 0x6c, 0x01, 0xb0, 0xeb, 0x10,
+0xfa, 0xf9, 0xc5, 0x55, 0xe5, 0xd9, 0x20, 0x41,
+0x35, 0x23, 0x55, 0xc3, 0x5c, 0x12, 0xd1, 0xff,
+0x4f, 0x9d, 0xf4, 0xd6, 0x9d, 0x5e, 0x2f, 0x2f,
+0xd1, 0x16, 0x1f, 0xa3, 0xff, 0xb1, 0x53, 0x2b,
+0xbd, 0xe1, 0x8a, 0xc9, 0x7e, 0x16, 0x9e, 0x1b,
+0xd2, 0x84, 0xb2, 0x67, 0xa7, 0x14, 0x6d, 0xe1,
+0x47, 0xb7, 0x46, 0x5b, 0x5f, 0xda, 0xcf, 0x81,
+0x99, 0x2a, 0xce, 0x27, 0xb8, 0x5c, 0xff, 0x96,
+0xed, 0x48, 0x04, 0x16, 0x2c, 0x61, 0x44, 0x31,
+0xa7, 0x32, 0xa2, 0x7a, 0x8f, 0x24, 0x8a, 0xb1,
+0xbf, 0x41, 0xe8, 0xc9, 0x70, 0x28, 0x77, 0x46,
+0x1c, 0x4e, 0x34, 0x7c, 0xd4, 0x5b, 0x16, 0x5b,
+0xfd, 0xe9, 0x05, 0x87, 0xd1, 0x5d, 0x68, 0x74,
+0x2c, 0xc2, 0x76, 0xca, 0x9e, 0xed, 0xa7, 0x87,
+0x43, 0xad, 0xfe, 0x28, 0xa7, 0x91, 0xe8, 0x3e,
+0xd0, 0x98, 0x5e, 0xc5, 0xeb, 0x95, 0x33, 0x18,
+0x84, 0x07, 0x8e, 0xa6, 0x3b, 0x19, 0x7c, 0x74,
+0x9d, 0xf6, 0x29, 0x19, 0xf5, 0xc2, 0x17, 0x06,
+0xbd, 0x49, 0x82, 0x84, 0xe5, 0x3b, 0x70, 0x1a,
+0xc6, 0x56, 0x93, 0xfe, 0xdc, 0x09, 0x88, 0xe5
+};
+
+const u8 rsa2048_bench_sign[] = {
+0x32, 0xa1, 0x30, 0x09, 0xc4, 0x01, 0x0f, 0x98,
+0x8b, 0x9c, 0x1f, 0x62, 0x1a, 0xa4, 0xf1, 0x86,
+0x21, 0xe4, 0xd7, 0xf2, 0xad, 0x11, 0x86, 0x4a,
+0xd4, 0xee, 0x18, 0x4a, 0x9b, 0x8e, 0x43, 0x00,
+0x24, 0x48, 0x0a, 0xc5, 0xc5, 0x05, 0x70, 0x2e,
+0x9b, 0xeb, 0xf4, 0xa8, 0x8f, 0xee, 0xcc, 0xdd,
+0x45, 0x4d, 0x33, 0x6b, 0x04, 0xd4, 0x93, 0x8a,
+0xae, 0x35, 0x3e, 0xd8, 0xcf, 0x3d, 0x3b, 0xdf,
+0xaf, 0x9b, 0x61, 0x8d, 0xbb, 0xf3, 0x1d, 0x25,
+0xb1, 0xa1, 0x30, 0xf9, 0xb4, 0x11, 0x19, 0xed,
+0xd0, 0x71, 0xd3, 0x69, 0x93, 0x19, 0x72, 0xd7,
+0x1a, 0xee, 0x28, 0xb5, 0xc2, 0x8e, 0xc7, 0x3e,
+0x29, 0x55, 0xce, 0xed, 0x06, 0x2d, 0x63, 0x17,
+0xa1, 0xc7, 0x53, 0x5f, 0xa9, 0x94, 0xbb, 0x4f,
+0x1d, 0x07, 0xe7, 0x9f, 0x63, 0x3b, 0xa8, 0x37,
+0xc3, 0xba, 0xe9, 0xd6, 0x03, 0x2c, 0x51, 0xf2,
+0x41, 0xe7, 0xbd, 0xcc, 0x23, 0x2a, 0x99, 0x5d,
+0x6e, 0x43, 0x15, 0x0c, 0xc3, 0xd4, 0x69, 0x42,
+0xeb, 0x6b, 0x00, 0xcb, 0x6d, 0x37, 0xe8, 0x14,
+0xbe, 0x72, 0xd9, 0x82, 0x7f, 0xd8, 0x5d, 0x71,
+0xf2, 0xdd, 0x51, 0x55, 0x0b, 0x92, 0x97, 0x0d,
+0x5d, 0x11, 0xe0, 0x0f, 0x21, 0xea, 0x8f, 0x6a,
+0x43, 0xcf, 0x3f, 0x6c, 0xfe, 0xf6, 0x46, 0xb3,
+0xc0, 0x07, 0x27, 0x29, 0xb7, 0x76, 0x69, 0xfd,
+0x5c, 0x4a, 0xb9, 0xf5, 0x15, 0x87, 0x61, 0x08,
+0xf1, 0xf1, 0x9a, 0xaf, 0xb2, 0x17, 0x7f, 0x63,
+0xf9, 0x08, 0x5c, 0xa9, 0x73, 0x4b, 0xa2, 0x6b,
+0xdd, 0x94, 0xff, 0x93, 0x05, 0x6e, 0x6d, 0x75,
+0x7a, 0x82, 0x9b, 0x65, 0x62, 0x8c, 0xb6, 0xf0,
+0xd1, 0x6a, 0x41, 0x26, 0x93, 0x7a, 0xb6, 0x97,
+0x0a, 0x4e, 0xd5, 0x5e, 0xee, 0x84, 0x49, 0x04,
+0x3a, 0xd7, 0x2a, 0x22, 0xd0, 0x1d, 0x6d, 0x73
+};
+
+const u8 rsa2048_bench_msg[] = {
+0x00, 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0x00, 0x30, 0x31, 0x30,
+0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
+0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20,
+0x40, 0xb7, 0x29, 0x27, 0x6d, 0x39, 0x04, 0xf3,
+0xb3, 0xe9, 0x3e, 0xe7, 0x86, 0xa3, 0x48, 0x15,
+0x9e, 0x78, 0x12, 0x88, 0xd0, 0xc8, 0xe4, 0x21,
+0x8a, 0x00, 0x12, 0x84, 0xb4, 0x0c, 0x0e, 0xe9
+};
+
+#define RSA2048_BENCH_N0INV	0x21053a57
+
+const u8 rsa4096_bench_n[] = {
+0x9d, 0xfa, 0xd1, 0xe4, 0x7d, 0xfd, 0x53, 0xa9,
+0x73, 0x46, 0x7c, 0x44, 0xa3, 0xb1, 0x2a, 0xee,
+0xce, 0xea, 0x13, 0xe1, 0x52, 0x37, 0x2a, 0x2d,
+0xfc, 0xe0, 0xb8, 0x7f, 0x62, 0x01, 0x74, 0x97,
+0x8d, 0xc9, 0xb5, 0x39, 0xad, 0x93, 0x97, 0xb8,
+0x8f, 0xf6, 0x0a, 0x98, 0xc4, 0x04, 0xc4, 0x9f,
+0xf5, 0x01, 0xa8, 0xfd, 0xec, 0xb9, 0x52, 0xe6,
+0x30, 0x57, 0xdb, 0x6f, 0x16, 0x02, 0x7c, 0xf3,
+0xc6, 0xdc, 0xae, 0x89, 0xe2, 0x63, 0xfb, 0x24,
+0x25, 0xc2, 0x75, 0xad, 0x0f, 0x07, 0xe5, 0x85,
+0x64, 0xa2, 0x64, 0x51, 0xb9, 0x84, 0x5f, 0x13,
+0x6f, 0x8c, 0xe2, 0x8b, 0x8f, 0xf1, 0x35, 0x10,
+0x12, 0x90, 0xd0, 0x40, 0x36, 0x06, 0xdd, 0xcd,
+0xe2, 0x6a, 0xa7, 0xdc, 0x7e, 0x92, 0xae, 0xda,
+0xa0, 0x66, 0xa8, 0x58, 0x67, 0x29, 0xd0, 0xcc,
+0xdb, 0x0c, 0x74, 0x15, 0x41, 0x3d, 0x37, 0xb8,
+0xe9, 0x45, 0x19, 0x05, 0x50, 0x8a, 0x93, 0x06,
+0xe4, 0x98, 0x0c, 0xb1, 0x46, 0xef, 0xab, 0x24,
+0x70, 0x74, 0x12, 0x44, 0x27, 0x96, 0x72, 0xc7,
+0x5a, 0xcf, 0x42, 0x49, 0xe9, 0x75, 0x6f, 0x95,
+0x6d, 0x8d, 0xa1, 0x1d, 0xbf, 0x71, 0x29, 0x43,
+0x09, 0x5b, 0xd2, 0x8b, 0xf0, 0x2f, 0xe7, 0xf5,
+0xaa, 0xca, 0x80, 0x6d, 0x4f, 0x2c, 0xc5, 0x84,
+0x15, 0x46, 0xfb, 0xc4, 0x01, 0x5e, 0x2f, 0x73,
+0x78, 0x6d, 0x34, 0xdf, 0x8e, 0xb0, 0x00, 0xba,
+0x3c, 0xbb, 0x0c, 0x21, 0xd4, 0x8b, 0x00, 0xfc,
+0x0b, 0xb2, 0xf1, 0xf4, 0x70, 0x90, 0x44, 0x05,
+0xe4, 0x7b, 0x88, 0x89, 0x66, 0x61, 0xff, 0x6f,
+0xc4, 0x23, 0x71, 0x06, 0x46, 0xaf, 0x9f, 0x92,
+0xb3, 0xb1, 0x90, 0x57, 0x67, 0xbb, 0x8d, 0x39,
+0x8a, 0x17, 0xfd, 0x8f, 0xf3, 0xcc, 0xa4, 0x5c,
+0x70, 0x63, 0x50, 0xce, 0x46, 0x84, 0x8e, 0x78,
+0x48, 0xd4, 0xdb, 0x53, 0x1a, 0xfc, 0xf8, 0x40,
+0x12, 0xdc, 0xdb, 0x1d, 0x19, 0x69, 0x36, 0x00,
+0x2a, 0x7a, 0x3f, 0x8a, 0x05, 0x66, 0xf2, 0x7c,
+0x91, 0x29, 0x40, 0x8b, 0x2d, 0x7d, 0xfc, 0x75,
+0x87, 0x95, 0x5a, 0xa2, 0x6d, 0xaf, 0x43, 0x6b,
+0x59, 0xfa, 0x4a, 0x3f, 0xfd, 0x69, 0x80, 0x85,
+0x1b, 0xe0, 0xf2, 0x03, 0xe3, 0x9b, 0xfc, 0x2c,
+0x2a, 0xde, 0x22, 0x44, 0x21, 0xf0, 0x68, 0x8c,
+0x29, 0xaa, 0x0f, 0x55, 0xfa, 0x3a, 0x18, 0x7f,
+0x85, 0x9b, 0xe6, 0x8e, 0xd2, 0x54, 0xdc, 0x22,
+0xb4, 0x5f, 0xa1, 0xbb, 0xb7, 0x2c, 0xae, 0x6a,
+0x16, 0xd9, 0x7e, 0x39, 0x30, 0xba, 0xcd, 0x5e,
+0xde, 0x6f, 0xc9, 0x42, 0x45, 0xdf, 0xe2, 0x45,
+0x4d, 0x9b, 0x57, 0x3e, 0xaa, 0x9a, 0x8d, 0x52,
+0xa8, 0x41, 0xad, 0x93, 0x69, 0x4a, 0x98, 0x18,
+0x93, 0xd3, 0x55, 0x00, 0xa7, 0x5a, 0x4b, 0xd4,
+0x59, 0x87, 0xd1, 0xd9, 0x29, 0xd2, 0xfa, 0x9d,
+0x28, 0x1b, 0x6f, 0xa1, 0x42, 0x3e, 0x0d, 0x89,
+0x8f, 0x57, 0x6d, 0x1c, 0xc7, 0xe1, 0xe4, 0xe6,
+0xa4, 0xf8, 0x4d, 0xfb, 0x91, 0x23, 0x27, 0x7f,
+0x42, 0xb7, 0x4c, 0x25, 0x7d, 0x23, 0xbd, 0xf9,
+0x89, 0x06, 0x2e, 0xa1, 0x6e, 0x94, 0xca, 0x50,
+0xaa, 0x18, 0x27, 0x57, 0x25, 0x71, 0x84, 0xf9,
+0x8c, 0xaa, 0x8c, 0x83, 0x6e, 0x78, 0xa4, 0x2b,
+0x94, 0xd9, 0x8f, 0x78, 0x56, 0x95, 0x03, 0x2e,
+0x57, 0xd7, 0x3d, 0xe8, 0x5d, 0x8c, 0x81, 0xd5,
+0x0f, 0x76, 0x3c, 0x35, 0xdd, 0xb2, 0x65, 0x33,
+0xb0, 0xe5, 0xf7, 0x6f, 0xf6, 0xb2, 0x2d, 0xb7,
+0x9d, 0xd7, 0x31, 0xea, 0x47, 0xed, 0x47, 0xe3,
+0x2b, 0xed, 0xee, 0x2d, 0xc6, 0xe0, 0x10, 0x42,
+0x8a, 0x1d, 0x46, 0x1b, 0x5e, 0xd6, 0x41, 0x2d,
+0x1b, 0xf9, 0xba, 0x25, 0xec, 0xd9, 0xf5, 0xe7
+};
+
+const u8 rsa4096_bench_rr[] = {
+0x67, 0x4d, 0x45, 0xf9, 0xb8, 0xb7, 0x47, 0x81,
+0x4e, 0x87, 0x4d, 0xa2, 0xc4, 0xcb, 0xc5, 0x7c,
+0xba, 0x21, 0x21, 0x64, 0x9a, 0x68, 0x0b, 0x06,
+0x64, 0xfc, 0x96, 0x1b, 0x3e, 0xbf, 0xd5, 0xe8,
+0xc8, 0x16, 0xcd, 0xdf, 0x94, 0x8f, 0x87, 0x4d,
+0x1c, 0x6d, 0xb2, 0x35, 0xe1, 0xe0, 0xe3, 0x77,
+0x70, 0x42, 0x31, 0xda, 0x7a, 0x9e, 0xca, 0x83,
+0xdb, 0x86, 0x6f, 0xaf, 0x7c, 0x48, 0x16, 0xd0,
+0xaa, 0xbc, 0x69, 0xcb, 0xca, 0x4f, 0x9f, 0xba,
+0x31, 0xa9, 0x65, 0xa3, 0x3c, 0x4f, 0x95, 0x8a,
+0x79, 0x65, 0x2c, 0x2e, 0x74, 0x74, 0xce, 0x54,
+0xfa, 0x84, 0x93, 0x90, 0x1b, 0x40, 0xf5, 0x40,
+0x78, 0xdf, 0x6c, 0x5c, 0x5a, 0x49, 0x50, 0x24,
+0x88, 0x2f, 0x03, 0xbd, 0x03, 0x6a, 0xa6, 0x63,
+0x9b, 0xfd, 0x00, 0xf7, 0x51, 0x79, 0xaa, 0xfb,
+0xee, 0x59, 0xfb, 0xc0, 0xc2, 0x58, 0x83, 0x16,
+0xea, 0x95, 0xda, 0x0d, 0xcd, 0x87, 0x5d, 0x85,
+0x74, 0xe2, 0xaf, 0x42, 0x1a, 0xae, 0x80, 0x52,
+0x0b, 0xfe, 0x73, 0xd2, 0x23, 0x63, 0x64, 0x30,
+0x32, 0x99, 0x97, 0x35, 0xe2, 0xfd, 0xa7, 0xb4,
+0x1b, 0xf2, 0x41, 0x93, 0xa0, 0xbe, 0x94, 0x4c,
+0x24, 0x44, 0x55, 0x0c, 0xc1, 0xbf, 0x9f, 0x84,
+0x48, 0x01, 0x05, 0xfd, 0xdb, 0x07, 0xed, 0x28,
+0xc8, 0xfd, 0x6d, 0xf3, 0xf6, 0x26, 0x0b, 0x09,
+0x8a, 0x95, 0xe4, 0xe0, 0x60, 0x4a, 0xde, 0xab,
+0x89, 0xa8, 0xe5, 0xdf, 0x6d, 0x6c, 0x07, 0xe0,
+0x04, 0x0c, 0x3e, 0xa7, 0xbb, 0x88, 0x0d, 0xdb,
+0x5f, 0xc5, 0x0d, 0xf6, 0x49, 0xc0, 0x94, 0x12,
+0x24, 0x80, 0xdd, 0xc1, 0xa7, 0xb1, 0xd8, 0x70,
+0x64, 0x47, 0xdd, 0xd7, 0x1f, 0x7d, 0x18, 0xc7,
+0xa0, 0x71, 0x62, 0xc6, 0xec, 0x1c, 0x8b, 0x5f,
+0x62, 0x33, 0xe6, 0xf5, 0xd2, 0x53, 0xdf, 0xa1,
+0xb4, 0x1d, 0xa4, 0x45, 0x78, 0x6d, 0xbe, 0x1a,
+0xd6, 0x13, 0x26, 0x0b, 0x4b, 0x8a, 0x14, 0x05,
+0x0b, 0x2e, 0x44, 0x6e, 0x06, 0x9a, 0xfd, 0x6d,
+0xd9, 0x99, 0xbe, 0x38, 0xc9, 0xd7, 0x80, 0xc4,
+0xe5, 0xa4, 0x41, 0x37, 0x31, 0x87, 0x49, 0x9d,
+0x75, 0x42, 0x38, 0x19, 0x9d, 0x4b, 0x35, 0x70,
+0x03, 0xa6, 0x12, 0x69, 0x46, 0xc3, 0xc3, 0x0e,
+0x9d, 0x4f, 0x5e, 0x35, 0xb6, 0xbc, 0x6e, 0x55,
+0x2f, 0x82, 0xbd, 0xb3, 0x8d, 0x7e, 0x74, 0x00,
+0x71, 0xbb, 0xa3, 0x3a, 0x22, 0x98, 0xd6, 0x93,
+0x04, 0xf0, 0x20, 0x98, 0x4d, 0x03, 0x81, 0xca,
+0xd8, 0x35, 0xa4, 0xd2, 0xf0, 0xc6, 0x38, 0x75,
+0xf7, 0x36, 0x17, 0x70, 0x20, 0xef, 0xd4, 0xcc,
+0xd1, 0xcd, 0x15, 0xe3, 0xdb, 0x07, 0x59, 0xe6,
+0x6b, 0xc7, 0x74, 0xf9, 0xf5, 0xeb, 0x48, 0xae,
+0x57, 0x96, 0x37, 0xf7, 0x04, 0xd8, 0x31, 0xcd,
+0x9b, 0xd5, 0xd3, 0x63, 0xee, 0xec, 0x02, 0x7f,
+0x6f, 0xd2, 0xcd, 0x0c, 0x12, 0x24, 0x79, 0xfc,
+0xd0, 0xa9, 0x56, 0xdc, 0xbf, 0x0c, 0x69, 0x30,
+0x77, 0xdd, 0x0d, 0xfe, 0xf9, 0x4e, 0x1e, 0x0c,
+0x07, 0xe2, 0x8f, 0x7d, 0x83, 0x1e, 0x4a, 0x95,
+0x04, 0x6f, 0x16, 0x2a, 0x4d, 0x1f, 0x37, 0x85,
+0x50, 0xc7, 0x24, 0x10, 0xdb, 0x4c, 0xc6, 0x4c,
+0x71, 0x2a, 0x91, 0xd1, 0xf0, 0xac, 0x0b, 0x99,
+0xe5, 0x59, 0x93, 0xd8, 0xa8, 0xe0, 0xc3, 0x85,
+0x20, 0x29, 0x1f, 0x09, 0x91, 0xa8, 0x47, 0x39,
+0xa4, 0xb5, 0xe7, 0xaf, 0x23, 0x1f, 0xfa, 0x92,
+0x64, 0x71, 0x0c, 0xc1, 0x41, 0xfb, 0xcd, 0xfe,
+0x51, 0x70, 0x5b, 0x3b, 0xe1, 0x7a, 0x2e, 0x11,
+0x85, 0xbc, 0xdb, 0x24, 0xc1, 0xae, 0x80, 0xfe,
+0x85, 0x5f, 0xb2, 0x46, 0xd8, 0x7b, 0xaf, 0xe1,
+0x9a, 0xe7, 0x9f, 0xe2, 0xc6, 0x77, 0xea, 0xfa
+};
+
+const u8 rsa4096_bench_sign[] = {
+0x7e, 0x3a, 0x99, 0x89, 0xf0, 0xe7, 0x08, 0xba,
+0xe8, 0x4f, 0x4b, 0xa4, 0x69, 0x8a, 0x9c, 0x25,
+0x01, 0xa3, 0xbf, 0xa9, 0x5a, 0x7d, 0x22, 0x7c,
+0xca, 0x58, 0x85, 0x45, 0x23, 0xf1, 0x1d, 0x1e,
+0x93, 0x05, 0x67, 0x69, 0xcf, 0x4a, 0xdf, 0x4d,
+0xb7, 0x2b, 0xeb, 0x34, 0x1a, 0x02, 0x73, 0x02,
+0x5b, 0x76, 0x28, 0x0f, 0xfa, 0x33, 0xe8, 0x22,
+0x4a, 0xb4, 0x69, 0x55, 0xa3, 0xc3, 0x28, 0x29,
+0x57, 0xb5, 0x7c, 0x62, 0xed, 0x0a, 0x62, 0xd5,
+0xf6, 0x9b, 0x91, 0x70, 0x73, 0x10, 0xc6, 0xa5,
+0x41, 0x62, 0x42, 0x2e, 0xe1, 0x2a, 0x63, 0x83,
+0x68, 0x3c, 0xa6, 0x15, 0x45, 0x36, 0x7a, 0x91,
+0x5a, 0x75, 0x09, 0xba, 0x3c, 0x42, 0x8c, 0xee,
+0x52, 0x59, 0x8c, 0x66, 0x8c, 0x5a, 0xed, 0x44,
+0xc7, 0x1b, 0x29, 0xac, 0xc6, 0x03, 0xcc, 0x34,
+0xf2, 0x7d, 0x93, 0x06, 0x7b, 0xaa, 0x2d, 0x29,
+0xb0, 0xef, 0xcc, 0x22, 0x8f, 0x80, 0x80, 0x1e,
+0x11, 0x8a, 0xbf, 0x27, 0x6e, 0xe7, 0x9d, 0xe0,
+0xec, 0xbe, 0x72, 0x54, 0x5c, 0x6f, 0xe3, 0x14,
+0xfe, 0x4c, 0x38, 0xf8, 0x1c, 0x9d, 0xf6, 0x4f,
+0xc9, 0x3d, 0x0f, 0xa4, 0x7e, 0x27, 0x7b, 0x39,
+0x5c, 0x09, 0xc7, 0x94, 0x09, 0xe9, 0xeb, 0x59,
+0xad, 0xc1, 0x91, 0x37, 0x4f, 0x70, 0xef, 0x64,
+0x7c, 0xf7, 0x63, 0xf2, 0x5a, 0xdd, 0x40, 0x5c,
+0xbd, 0x7a, 0x84, 0xbe, 0x25, 0x76, 0x7f, 0x8e,
+0x99, 0x58, 0x83, 0xad, 0xd7, 0x1d, 0xff, 0xa5,
+0xe4, 0x38, 0xe2, 0x88, 0xd1, 0x76, 0x9c, 0xc6,
+0xe3, 0x1e, 0x02, 0x3e, 0xb3, 0xa6, 0x87, 0x26,
+0x51, 0x82, 0x28, 0xc4, 0xd1, 0xee, 0x18, 0xf1,
+0x22, 0xaa, 0x91, 0x88, 0x89, 0xaa, 0x93, 0xa4,
+0xd9, 0xaf, 0x88, 0xcb, 0xdb, 0x45, 0x34, 0x6b,
+0x0c, 0xd3, 0x4c, 0x57, 0x3e, 0x21, 0xfc, 0x5c,
+0xc8, 0xbf, 0xec, 0x41, 0xa0, 0x27, 0xf8, 0x23,
+0x77, 0x41, 0x14, 0xe1, 0x89, 0x08, 0x66, 0xfa,
+0xf7, 0x25, 0x32, 0x09, 0xb8, 0x68, 0x08, 0x53,
+0x86, 0x49, 0x86, 0xf3, 0xda, 0x8d, 0xdd, 0xee,
+0x15, 0xde, 0xe8, 0x7f, 0x39, 0x51, 0x98, 0x0a,
+0x08, 0xd5, 0x86, 0x9a, 0xea, 0x80, 0x14, 0x64,
+0x48, 0x10, 0x5d, 0x3a, 0xbb, 0x4a, 0x5a, 0x4e,
+0xd7, 0x11, 0xa0, 0x36, 0x93, 0x36, 0x9f, 0x1b,
+0x5e, 0x69, 0x68, 0x6a, 0x61, 0x79, 0x7f, 0xf1,
+0xdd, 0x7d, 0xc5, 0x40, 0xa8, 0x85, 0x7e, 0x65,
+0x1c, 0x18, 0x21, 0xee, 0xe8, 0xf0, 0xd5, 0x03,
+0x81, 0x60, 0x4c, 0xd8, 0x76, 0xa1, 0xd6, 0x13,
+0xe9, 0x26, 0xd2, 0x7a, 0xc2, 0x72, 0x2b, 0x75,
+0x8d, 0x1c, 0x76, 0x94, 0x34, 0x6d, 0xf6, 0x62,
+0x10, 0x05, 0xb0, 0xd2, 0x77, 0x4c, 0xaf, 0x92,
+0xb4, 0xab, 0xd3, 0xd9, 0xd3, 0xc7, 0x34, 0x78,
+0x47, 0x70, 0x49, 0x9d, 0xd1, 0xfb, 0x32, 0x07,
+0x67, 0x6a, 0xe1, 0x0c, 0x2e, 0x48, 0xca, 0xa3,
+0xc0, 0x74, 0xc1, 0x98, 0x57, 0xb6, 0x57, 0x99,
+0x58, 0xfa, 0xbc, 0xcc, 0xbc, 0x27, 0xf9, 0xe7,
+0x14, 0xdd, 0x73, 0x25, 0xa3, 0x07, 0xa1, 0xaa,
+0xc5, 0xbc, 0xdf, 0x59, 0xd8, 0x3e, 0x07, 0xcb,
+0x23, 0x00, 0x13, 0x58, 0x73, 0x8a, 0xbc, 0xaa,
+0x39, 0x39, 0xf4, 0x8f, 0x4c, 0x33, 0x04, 0x24,
+0x66, 0x6d, 0x12, 0x53, 0xeb, 0xea, 0xe2, 0x10,
+0x0e, 0x6a, 0x40, 0x42, 0x3c, 0xa3, 0xd5, 0xa6,
+0x57, 0xae, 0xfd, 0xe8, 0xd2, 0xb5, 0x23, 0x02,
+0x06, 0xc0, 0x2d, 0x60, 0x7c, 0x57, 0xba, 0x27,
+0x56, 0xf7, 0x3c, 0xde, 0x1f, 0x5d, 0x96, 0x53,
+0x28, 0x9f, 0x41, 0x30, 0x3d, 0x27, 0x37, 0x0c,
+0x67, 0xa0, 0x41, 0xf4, 0x67, 0x17, 0xce, 0x57,
+0x2e, 0xf7, 0x68, 0x41, 0xbb, 0x19, 0xf7, 0x7f
+};
+
+const u8 rsa4096_bench_msg[] = {
+0x00, 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+0xff, 0xff, 0xff, 0xff, 0x00, 0x30, 0x31, 0x30,
+0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
+0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20,
+0x40, 0xb7, 0x29, 0x27, 0x6d, 0x39, 0x04, 0xf3,
+0xb3, 0xe9, 0x3e, 0xe7, 0x86, 0xa3, 0x48, 0x15,
+0x9e, 0x78, 0x12, 0x88, 0xd0, 0xc8, 0xe4, 0x21,
+0x8a, 0x00, 0x12, 0x84, 0xb4, 0x0c, 0x0e, 0xe9
+};
+
+#define RSA4096_BENCH_N0INV	0xad5bb229
+
 #endif
@@ -121,6 +121,7 @@
 #define  SDHCI_INT_CARD_INSERT	BIT(6)
 #define  SDHCI_INT_CARD_REMOVE	BIT(7)
 #define  SDHCI_INT_CARD_INT	BIT(8)
+#define  SDHCI_INT_CQE		BIT(14)
 #define  SDHCI_INT_ERROR	BIT(15)
 #define  SDHCI_INT_TIMEOUT	BIT(16)
 #define  SDHCI_INT_CRC		BIT(17)
@@ -200,6 +201,7 @@
 /* 55-57 reserved */
 
 #define SDHCI_ADMA_ADDRESS	0x58
+#define SDHCI_ADMA_ADDRESS_HI	0x5C
 
 /* 60-FB reserved */
 
@@ -242,6 +244,35 @@ struct sdhci_host;
  */
 #define SDHCI_DEFAULT_BOUNDARY_SIZE	(512 * 1024)
 #define SDHCI_DEFAULT_BOUNDARY_ARG	(7)
+
+/*
+ * ADMA2 descriptor attributes and limits. A descriptor never covers more
+ * than SDHCI_ADMA_MAX_LEN bytes nor crosses a SDHCI_ADMA_MAX_LEN aligned
+ * boundary, which also keeps it clear of the 128MiB data boundary some
+ * controllers (e.g. the DWC MSHC) cannot cross.
+ */
+#define SDHCI_ADMA_VALID	BIT(0)
+#define SDHCI_ADMA_END		BIT(1)
+#define SDHCI_ADMA_INT		BIT(2)
+#define SDHCI_ADMA_TRAN_VALID	0x21
+#define SDHCI_ADMA_MAX_LEN	(32 * 1024)
+#define SDHCI_ADMA_32_DESC_SZ	8
+#define SDHCI_ADMA_64_DESC_SZ	12
+
+struct sdhci_adma_desc {
+	u8	attr;
+	u8	reserved;
+	u16	len;
+	u32	addr_lo;
+	u32	addr_hi;	/* Only present in 64-bit descriptors */
+} __packed;
+
+/*
+ * host flags
+ */
+#define SDHCI_USE_ADMA		BIT(0)
+#define SDHCI_USE_64BIT_DMA	BIT(1)
+
 struct sdhci_ops {
 #ifdef CONFIG_MMC_SDHCI_IO_ACCESSORS
 	u32	(*read_l)(struct sdhci_host *host, int reg);
@@ -278,6 +309,18 @@ struct sdhci_host {
 	uint	voltages;
 
 	struct mmc_config cfg;
+
+	unsigned int flags;
+	void *adma_desc;	/* ADMA2 descriptor table */
+	unsigned int adma_desc_sz;	/* Size of one descriptor in bytes */
+	unsigned int adma_desc_num;	/* Descriptors in the table */
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC) && defined(CONFIG_MMC_SDHCI_ADMA)
+	struct mmc_data *async_data;	/* ADMA read left running */
+	ulong async_start;
+#endif
+#if CONFIG_IS_ENABLED(MMC_CQHCI)
+	struct cqhci_host *cq_host;	/* Command queue engine, if any */
+#endif
 };
 
 int sdhci_set_clock(struct sdhci_host *host, unsigned int clock);
@@ -438,4 +481,20 @@ extern const struct dm_mmc_ops sdhci_ops;
 #else
 #endif
 
+#if CONFIG_IS_ENABLED(MMC_CQHCI)
+/**
+ * sdhci_cqe_init() - Attach a CQHCI command queue engine to an SDHCI host
+ *
+ * The engine needs ADMA2, so this fails if sdhci_setup_cfg() did not select
+ * it. host->mmc must be set up.
+ *
+ * @host:	SDHCI host structure
+ * @cfg:	Configuration of the host, receives the queue limits
+ * @mmio:	Base address of the CQHCI registers
+ * @return 0 if OK, -ve on error
+ */
+int sdhci_cqe_init(struct sdhci_host *host, struct mmc_config *cfg,
+		   void *mmio);
+#endif
+
 #endif /* __SDHCI_HW_H */
@@ -211,6 +211,8 @@ void zynq_serial_initialize(void);
 int serial_dev_getc(struct udevice *dev);
 int serial_dev_tstc(struct udevice *dev);
 void serial_dev_putc(struct udevice *dev, char ch);
+/* Send one character as is, returning -EAGAIN if the UART is busy */
+int serial_dev_try_putc(struct udevice *dev, char ch);
 void serial_dev_puts(struct udevice *dev, const char *str);
 void serial_dev_setbrg(struct udevice *dev, int baudrate);
 void serial_dev_clear(struct udevice *dev);
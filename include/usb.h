@@ -262,6 +262,23 @@ int usb_control_msg(struct usb_device *dev, unsigned int pipe,
 			void *data, unsigned short size, int timeout);
 int usb_bulk_msg(struct usb_device *dev, unsigned int pipe,
 			void *data, int len, int *actual_length, int timeout);
+
+/**
+ * struct usb_bulk_xfer - One bulk message of a chain, see usb_bulk_chain()
+ *
+ * @pipe:	Bulk pipe
+ * @buffer:	Data to send or receive
+ * @length:	Number of bytes
+ * @act_len:	Returns the number of bytes transferred
+ * @status:	Returns the USB_ST_... status, 0 if OK
+ */
+struct usb_bulk_xfer {
+	unsigned long pipe;
+	void *buffer;
+	int length;
+	int act_len;
+	unsigned long status;
+};
 int usb_int_msg(struct usb_device *dev, unsigned long pipe,
 		void *buffer, int transfer_len, int interval, bool nonblock);
 int usb_disable_asynch(int disable);
@@ -700,6 +717,21 @@ struct dm_usb_ops {
 	 */
 	int (*bulk)(struct udevice *bus, struct usb_device *udev,
 		    unsigned long pipe, void *buffer, int length);
+	/**
+	 * bulk_chain() - Queue several bulk messages and wait for them all
+	 *
+	 * The messages are started together, so the device can move from
+	 * one to the next without waiting for software. Messages on the
+	 * same endpoint complete in order. On error the messages still
+	 * queued are cancelled.
+	 *
+	 * @xfer: Messages, see struct usb_bulk_xfer
+	 * @count: Number of messages
+	 * @return 0 if OK, -E2BIG if the messages do not fit in the
+	 * controller queues, other -ve on error
+	 */
+	int (*bulk_chain)(struct udevice *bus, struct usb_device *udev,
+			  struct usb_bulk_xfer *xfer, int count);
 	/**
 	 * interrupt() - Send an interrupt message
 	 *
@@ -981,6 +1013,21 @@ int usb_update_hub_device(struct usb_device *dev);
  */
 int usb_get_max_xfer_size(struct usb_device *dev, size_t *size);
 
+/**
+ * usb_bulk_chain() - Queue several bulk messages and wait for them all
+ *
+ * See dm_usb_ops.bulk_chain(). Callers fall back to usb_bulk_msg() when
+ * this fails with -ENOSYS or -E2BIG; nothing has been sent then.
+ *
+ * @dev:		USB device
+ * @xfer:		Messages, act_len and status are filled in
+ * @count:		Number of messages
+ * @return 0 if OK, -ENOSYS if the HCD cannot chain messages, -E2BIG if
+ * the messages do not fit in its queues, other -ve on error
+ */
+int usb_bulk_chain(struct usb_device *dev, struct usb_bulk_xfer *xfer,
+		   int count);
+
 /**
  * usb_emul_setup_device() - Set up a new USB device emulation
  *
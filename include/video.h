@@ -67,6 +67,8 @@ enum video_log2_bpp {
  * @flush_dcache:	true to enable flushing of the data cache after
  *		the LCD is updated
  * @cmap:	Colour map for 8-bit-per-pixel displays
+ * @damage:	Frame buffer area written since the last video_sync(), in
+ *		pixels. It is empty when @damage.x1 <= @damage.x0
  */
 struct video_priv {
 	/* Things set up by the driver: */
@@ -88,6 +90,10 @@ struct video_priv {
 	int colour_bg;
 	bool flush_dcache;
 	ushort *cmap;
+	struct {
+		int x0, y0;
+		int x1, y1;
+	} damage;
 };
 
 /* Placeholder - there are no video operations at present */
@@ -125,6 +131,20 @@ int video_reserve(ulong *addrp);
  */
 void video_sync(struct udevice *vid);
 
+/**
+ * video_damage() - Record that part of the frame buffer was written
+ *
+ * The area is added to the rectangle that the next video_sync() will flush
+ * from the data cache. It is clipped to the display.
+ *
+ * @vid:	Video device
+ * @x:		X position of the area in pixels from the left
+ * @y:		Y position of the area in pixels from the top
+ * @width:	Width of the area in pixels
+ * @height:	Height of the area in pixels
+ */
+void video_damage(struct udevice *vid, int x, int y, int width, int height);
+
 /**
  * video_sync_all() - Sync all devices' frame buffers with there hardware
  *
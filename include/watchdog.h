@@ -62,6 +62,12 @@ int init_func_watchdog_reset(void);
 		 */
 		#if defined(__ASSEMBLY__)
 			#define WATCHDOG_RESET /*XXX DO_NOT_DEL_THIS_COMMENT*/
+		#elif defined(CONFIG_CONSOLE_ASYNC) && \
+		      !defined(CONFIG_SPL_BUILD) && !defined(USE_HOSTCC)
+			/* Send buffered console output while waiting */
+			extern void console_drain(void);
+
+			#define WATCHDOG_RESET console_drain
 		#else
 			#define WATCHDOG_RESET() {}
 		#endif /* __ASSEMBLY__ */
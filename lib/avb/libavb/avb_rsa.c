@@ -225,6 +225,32 @@ out:
   }
 }
 
+#ifdef CONFIG_DM_CRYPTO
+/* In-place public exponentiation by crypto device, e.g. rockchip PKA.
+ * Returns false if there is no capable device, then go with modpowF4().
+ */
+static bool modpowF4_hw(const uint8_t* key_data,
+                        const IAvbKey* key,
+                        uint8_t* inout) {
+  size_t num_bytes = key->len * sizeof(uint32_t);
+  const uint8_t* n = key_data + sizeof(AvbRSAPublicKeyHeader);
+  uint8_t* e = (uint8_t*)avb_calloc(num_bytes);
+  bool ret;
+
+  if (e == NULL) {
+    return false;
+  }
+
+  /* F4 = 65537, big-endian. */
+  e[num_bytes - 3] = 0x01;
+  e[num_bytes - 1] = 0x01;
+  ret = !crypto_rsa_verify_be(key->len * 32, n, e, NULL, inout, inout);
+  avb_free(e);
+
+  return ret;
+}
+#endif
+
 /* Verify a RSA PKCS1.5 signature against an expected hash.
  * Returns false on failure, true on success.
  */
@@ -268,7 +294,10 @@ bool avb_rsa_verify(const uint8_t* key,
   }
   avb_memcpy(buf, sig, sig_num_bytes);
 
-  modpowF4(parsed_key, buf);
+#ifdef CONFIG_DM_CRYPTO
+  if (!modpowF4_hw(key, parsed_key, buf))
+#endif
+    modpowF4(parsed_key, buf);
 
   /* Check padding bytes.
    *
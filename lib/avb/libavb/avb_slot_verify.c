@@ -75,12 +75,43 @@ static inline bool result_should_continue(AvbSlotVerifyResult result) {
   return false;
 }
 
-static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
-                                               const char* part_name,
-                                               uint64_t image_size,
-                                               uint8_t** out_image_buf,
-                                               bool* out_image_preloaded,
-                                               int allow_verification_error) {
+/* Hash state of a partition which is hashed while it is being read. */
+typedef struct {
+  AvbSHA256Ctx* sha256_ctx;
+  AvbSHA512Ctx* sha512_ctx;
+  size_t bytes_to_hash;
+  bool streamed;
+} AvbHashStream;
+
+/* Adds a chunk read by ops->read_from_partition_stream() to the hash,
+ * ignoring anything past the size in the hash descriptor.
+ */
+static void hash_stream_chunk(void* user_data,
+                              const uint8_t* data,
+                              size_t num_bytes) {
+  AvbHashStream* hash = (AvbHashStream*)user_data;
+
+  if (num_bytes > hash->bytes_to_hash) {
+    num_bytes = hash->bytes_to_hash;
+  }
+  if (hash->sha256_ctx != NULL) {
+    avb_sha256_update(hash->sha256_ctx, data, num_bytes);
+  } else {
+    avb_sha512_update(hash->sha512_ctx, data, num_bytes);
+  }
+  hash->bytes_to_hash -= num_bytes;
+}
+
+/* Looks up a partition which is already in memory. |*out_image_preloaded|
+ * is left false if there is none.
+ */
+static AvbSlotVerifyResult load_preloaded_partition(
+    AvbOps* ops,
+    const char* part_name,
+    uint64_t image_size,
+    uint8_t** out_image_buf,
+    bool* out_image_preloaded,
+    int allow_verification_error) {
   size_t part_num_read;
   AvbIOResult io_ret;
 
@@ -116,34 +147,81 @@ static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
     }
   }
 
-  /* Allocate and copy the partition. */
-  if (!*out_image_preloaded) {
-    *out_image_buf = sysmem_alloc(MEM_AVB_ANDROID, image_size);
-    if (*out_image_buf == NULL) {
-      return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
-    }
+  return AVB_SLOT_VERIFY_RESULT_OK;
+}
 
+/* Allocates a buffer and reads the partition into it. If |hash| is not NULL
+ * and the partition can be streamed, the data is added to the hash as it
+ * arrives and |hash->streamed| is set.
+ */
+static AvbSlotVerifyResult read_full_partition(AvbOps* ops,
+                                               const char* part_name,
+                                               uint64_t image_size,
+                                               uint8_t** out_image_buf,
+                                               AvbHashStream* hash) {
+  size_t part_num_read;
+  AvbIOResult io_ret;
+
+  *out_image_buf = sysmem_alloc(MEM_AVB_ANDROID, image_size);
+  if (*out_image_buf == NULL) {
+    return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
+  }
+
+  if (hash != NULL && ops->read_from_partition_stream != NULL) {
+    io_ret = ops->read_from_partition_stream(ops,
+                                             part_name,
+                                             0 /* offset */,
+                                             image_size,
+                                             *out_image_buf,
+                                             hash_stream_chunk,
+                                             hash,
+                                             &part_num_read);
+    hash->streamed = true;
+  } else {
     io_ret = ops->read_from_partition(ops,
                                       part_name,
                                       0 /* offset */,
                                       image_size,
                                       *out_image_buf,
                                       &part_num_read);
-    if (io_ret == AVB_IO_RESULT_ERROR_OOM) {
-      return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
-    } else if (io_ret != AVB_IO_RESULT_OK) {
-      avb_errorv(part_name, ": Error loading data from partition.\n", NULL);
-      return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
-    }
-    if (part_num_read != image_size) {
-      avb_errorv(part_name, ": Read incorrect number of bytes.\n", NULL);
-      return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
-    }
+  }
+  if (io_ret == AVB_IO_RESULT_ERROR_OOM) {
+    return AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
+  } else if (io_ret != AVB_IO_RESULT_OK) {
+    avb_errorv(part_name, ": Error loading data from partition.\n", NULL);
+    return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+  }
+  if (part_num_read != image_size) {
+    avb_errorv(part_name, ": Read incorrect number of bytes.\n", NULL);
+    return AVB_SLOT_VERIFY_RESULT_ERROR_IO;
   }
 
   return AVB_SLOT_VERIFY_RESULT_OK;
 }
 
+static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
+                                               const char* part_name,
+                                               uint64_t image_size,
+                                               uint8_t** out_image_buf,
+                                               bool* out_image_preloaded,
+                                               int allow_verification_error) {
+  AvbSlotVerifyResult ret;
+
+  ret = load_preloaded_partition(ops,
+                                 part_name,
+                                 image_size,
+                                 out_image_buf,
+                                 out_image_preloaded,
+                                 allow_verification_error);
+  if (ret != AVB_SLOT_VERIFY_RESULT_OK || *out_image_preloaded) {
+    return ret;
+  }
+
+  /* Allocate and copy the partition. */
+  return read_full_partition(
+      ops, part_name, image_size, out_image_buf, NULL /* hash */);
+}
+
 /* Reads a persistent digest stored as a named persistent value corresponding to
  * the given |part_name|. The value is returned in |out_digest| which must point
  * to |expected_digest_size| bytes. If there is no digest stored for |part_name|
@@ -301,6 +379,10 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
   size_t expected_digest_len = 0;
   uint8_t expected_digest_buf[AVB_SHA512_DIGEST_SIZE];
   const uint8_t* expected_digest = NULL;
+  AvbSHA256Ctx sha256_ctx;
+  AvbSHA512Ctx sha512_ctx;
+  AvbHashStream hash = {NULL, NULL, 0, false};
+  size_t image_size_to_hash;
 
   if (!avb_hash_descriptor_validate_and_byteswap(
           (const AvbHashDescriptor*)descriptor, &hash_desc)) {
@@ -383,7 +465,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     avb_debugv(part_name, ": Loading entire partition.\n", NULL);
   }
 
-  ret = load_full_partition(
+  ret = load_preloaded_partition(
       ops, part_name, image_size, &image_buf, &image_preloaded,
       allow_verification_error);
   if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
@@ -392,36 +474,48 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     goto out;
   }
 
-  // Although only one of the type might be used, we have to defined the
-  // structure here so that they would live outside the 'if/else' scope to be
-  // used later.
-  AvbSHA256Ctx sha256_ctx;
-  AvbSHA512Ctx sha512_ctx;
-  size_t image_size_to_hash = hash_desc.image_size;
+  image_size_to_hash = hash_desc.image_size;
   // If we allow verification error and the whole partition is smaller than
   // image size in hash descriptor, we just hash the whole partition.
   if (image_size_to_hash > image_size) {
     image_size_to_hash = image_size;
   }
+
+  /* Start the hash before reading so that the image can be hashed while it
+   * is being read, if the ops support that.
+   */
   if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
     sha256_ctx.tot_len = hash_desc.salt_len + image_size_to_hash;
     avb_sha256_init(&sha256_ctx);
     avb_sha256_update(&sha256_ctx, desc_salt, hash_desc.salt_len);
-    avb_sha256_update(&sha256_ctx, image_buf, image_size_to_hash);
-    digest = avb_sha256_final(&sha256_ctx);
-    digest_len = AVB_SHA256_DIGEST_SIZE;
+    hash.sha256_ctx = &sha256_ctx;
   } else if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha512") == 0) {
     sha512_ctx.tot_len = hash_desc.salt_len + image_size_to_hash;
     avb_sha512_init(&sha512_ctx);
     avb_sha512_update(&sha512_ctx, desc_salt, hash_desc.salt_len);
-    avb_sha512_update(&sha512_ctx, image_buf, image_size_to_hash);
-    digest = avb_sha512_final(&sha512_ctx);
-    digest_len = AVB_SHA512_DIGEST_SIZE;
+    hash.sha512_ctx = &sha512_ctx;
   } else {
     avb_errorv(part_name, ": Unsupported hash algorithm.\n", NULL);
     ret = AVB_SLOT_VERIFY_RESULT_ERROR_INVALID_METADATA;
     goto out;
   }
+  hash.bytes_to_hash = image_size_to_hash;
+
+  ret = read_full_partition(ops, part_name, image_size, &image_buf, &hash);
+  if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
+    goto out;
+  }
+  if (!hash.streamed) {
+    hash_stream_chunk(&hash, image_buf, image_size_to_hash);
+  }
+
+  if (hash.sha256_ctx != NULL) {
+    digest = avb_sha256_final(&sha256_ctx);
+    digest_len = AVB_SHA256_DIGEST_SIZE;
+  } else {
+    digest = avb_sha512_final(&sha512_ctx);
+    digest_len = AVB_SHA512_DIGEST_SIZE;
+  }
 
   if (hash_desc.digest_len == 0) {
     /* Expect a match to a persistent digest. */
@@ -32,6 +32,7 @@
 #include <mmc.h>
 #include <blk.h>
 #include <part.h>
+#include <linux/sizes.h>
 #include <stdio.h>
 #include <android_avb/avb_ops_user.h>
 #include <android_avb/libavb_ab.h>
@@ -145,6 +146,120 @@ static AvbIOResult read_from_partition(AvbOps *ops,
 	return AVB_IO_RESULT_OK;
 }
 
+/* Bytes read before a chunk is handed to the caller of a streamed read */
+#define AVB_STREAM_CHUNK_SIZE	SZ_2M
+
+struct avb_stream {
+	AvbReadChunkFunc chunk_done;
+	void *user_data;
+};
+
+static int avb_stream_chunk(void *priv, void *buf, ulong len)
+{
+	struct avb_stream *stream = priv;
+
+	stream->chunk_done(stream->user_data, buf, len);
+
+	return 0;
+}
+
+static AvbIOResult read_from_partition_stream(AvbOps *ops,
+					      const char *partition,
+					      int64_t offset,
+					      size_t num_bytes,
+					      void *buffer,
+					      AvbReadChunkFunc chunk_done,
+					      void *user_data,
+					      size_t *out_num_read)
+{
+	struct avb_stream stream = { chunk_done, user_data };
+	struct blk_desc *dev_desc;
+	disk_partition_t part_info;
+	uint64_t partition_size;
+	lbaint_t start, blkcnt;
+	size_t tail;
+	AvbIOResult ret;
+	char *block;
+
+	if (offset < 0) {
+		if (get_size_of_partition(ops, partition, &partition_size))
+			return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
+
+		if (-offset > partition_size)
+			return AVB_IO_RESULT_ERROR_RANGE_OUTSIDE_PARTITION;
+
+		offset = partition_size - (-offset);
+	}
+
+	/* Unaligned starts are rare, read them in one go */
+	if (offset % 512) {
+		ret = read_from_partition(ops, partition, offset, num_bytes,
+					  buffer, out_num_read);
+		if (ret == AVB_IO_RESULT_OK)
+			chunk_done(user_data, buffer, *out_num_read);
+		return ret;
+	}
+
+	dev_desc = rockchip_get_bootdev();
+	if (!dev_desc) {
+		printf("%s: Could not find device\n", __func__);
+		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
+	}
+
+	if (part_get_info_by_name(dev_desc, partition, &part_info) < 0) {
+		printf("Could not find \"%s\" partition\n", partition);
+		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
+	}
+
+	start = part_info.start + offset / 512;
+	blkcnt = num_bytes / 512;
+	tail = num_bytes % 512;
+
+	/*
+	 * Whole blocks go straight to the caller's buffer, the chunk that
+	 * has arrived is hashed while the next one is read.
+	 */
+#if CONFIG_IS_ENABLED(BLK_READ_ASYNC)
+	if (blkcnt && blk_dread_pipeline(dev_desc, start, blkcnt * 512, buffer,
+					 AVB_STREAM_CHUNK_SIZE,
+					 avb_stream_chunk, &stream))
+		return AVB_IO_RESULT_ERROR_IO;
+#else
+	{
+		lbaint_t chunk_blks = AVB_STREAM_CHUNK_SIZE / 512;
+		lbaint_t done, cur;
+
+		for (done = 0; done < blkcnt; done += cur) {
+			cur = min(blkcnt - done, chunk_blks);
+			if (blk_dread(dev_desc, start + done, cur,
+				      buffer + done * 512) != cur)
+				return AVB_IO_RESULT_ERROR_IO;
+			avb_stream_chunk(&stream, buffer + done * 512,
+					 cur * 512);
+		}
+	}
+#endif
+
+	/* The buffer ends inside the last block, bounce it */
+	if (tail) {
+		block = malloc(512);
+		if (!block) {
+			printf("malloc error!\n");
+			return AVB_IO_RESULT_ERROR_OOM;
+		}
+		if (blk_dread(dev_desc, start + blkcnt, 1, block) != 1) {
+			free(block);
+			return AVB_IO_RESULT_ERROR_IO;
+		}
+		memcpy(buffer + blkcnt * 512, block, tail);
+		free(block);
+		avb_stream_chunk(&stream, buffer + blkcnt * 512, tail);
+	}
+	*out_num_read = num_bytes;
+
+	return AVB_IO_RESULT_OK;
+}
+
 static AvbIOResult write_to_partition(AvbOps *ops,
 				      const char *partition,
 				      int64_t offset,
@@ -514,6 +629,7 @@ AvbOps *avb_ops_user_new(void)
 	ops->atx_ops->ops = ops;
 
 	ops->read_from_partition = read_from_partition;
+	ops->read_from_partition_stream = read_from_partition_stream;
 	ops->write_to_partition = write_to_partition;
 	ops->validate_vbmeta_public_key = validate_vbmeta_public_key;
 	ops->read_rollback_index = read_rollback_index;
@@ -0,0 +1,360 @@
+/*
+ * Side index of the control device tree
+ *
+ * Finding a node by phandle or compatible string, or the parent of a
+ * node, means scanning the flat tree from the start. This index is built
+ * in one walk over the tree the first time it is needed and holds, in a
+ * single allocation:
+ *
+ * - the offset of every node and of its parent, in tree order
+ * - phandle -> node offset, sorted by phandle
+ * - hash of each compatible string -> node offset, sorted by hash and then
+ *   by offset
+ * - the /aliases properties with their sequence numbers
+ *
+ * Only gd->fdt_blob is indexed. The index is rebuilt when the blob moves,
+ * e.g. on relocation, or when a node or property is added or removed,
+ * which changes the size of the structure or strings block. A phandle,
+ * compatible or parent found in the index is checked against the tree and
+ * a phandle or parent that is not found falls back to the normal scan, so
+ * that these cannot be wrong after e.g. fdt_nop_node(). A compatible
+ * string changed in place to another of the same length is not found
+ * until the index is next rebuilt.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <errno.h>
+#include <fdtdec.h>
+#include <malloc.h>
+#include <vsprintf.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define FDT_INDEX_MAX_DEPTH	32
+
+struct fdtdec_index_key {
+	u32 key;
+	int offset;
+};
+
+struct fdtdec_index_alias {
+	const char *name;
+	const char *leaf;	/* last component of the path */
+	int len;		/* length of the path property */
+	int seq;
+};
+
+struct fdtdec_index {
+	const void *blob;
+	u32 size_struct;
+	u32 size_strings;
+	bool can_free;		/* allocated by the full malloc() */
+
+	int node_count;
+	int phandle_count;
+	int compat_count;
+	int alias_count;
+	int *nodes;
+	int *parents;
+	struct fdtdec_index_key *phandles;
+	struct fdtdec_index_key *compats;
+	struct fdtdec_index_alias *aliases;
+};
+
+static u32 fdtdec_index_hash(const char *str)
+{
+	u32 hash = 0x811c9dc5;
+
+	while (*str)
+		hash = (hash ^ (u8)*str++) * 0x01000193;
+
+	return hash;
+}
+
+static int fdtdec_index_key_cmp(const void *a, const void *b)
+{
+	const struct fdtdec_index_key *ka = a, *kb = b;
+
+	if (ka->key != kb->key)
+		return ka->key < kb->key ? -1 : 1;
+
+	return ka->offset - kb->offset;
+}
+
+/*
+ * Walk the tree, counting what is to be indexed if @idx has no arrays yet
+ * and filling them in otherwise
+ */
+static int fdtdec_index_walk(const void *blob, struct fdtdec_index *idx)
+{
+	int parents[FDT_INDEX_MAX_DEPTH + 1];
+	int node, depth, len, aliases, prop;
+	const char *compat, *end, *name, *path;
+	bool fill = idx->nodes;
+	u32 phandle;
+
+	idx->node_count = 0;
+	idx->phandle_count = 0;
+	idx->compat_count = 0;
+	idx->alias_count = 0;
+
+	parents[0] = -FDT_ERR_NOTFOUND;
+	depth = 0;
+	for (node = 0; node >= 0 && depth >= 0;
+	     node = fdt_next_node(blob, node, &depth)) {
+		if (depth > FDT_INDEX_MAX_DEPTH)
+			return -E2BIG;
+		if (fill) {
+			idx->nodes[idx->node_count] = node;
+			idx->parents[idx->node_count] = parents[depth];
+		}
+		idx->node_count++;
+		if (depth < FDT_INDEX_MAX_DEPTH)
+			parents[depth + 1] = node;
+
+		phandle = fdt_get_phandle(blob, node);
+		if (phandle) {
+			if (fill) {
+				idx->phandles[idx->phandle_count].key = phandle;
+				idx->phandles[idx->phandle_count].offset = node;
+			}
+			idx->phandle_count++;
+		}
+
+		compat = fdt_getprop(blob, node, "compatible", &len);
+		if (!compat)
+			continue;
+		for (end = compat + len; compat < end;
+		     compat += strnlen(compat, end - compat) + 1) {
+			if (fill) {
+				idx->compats[idx->compat_count].key =
+					fdtdec_index_hash(compat);
+				idx->compats[idx->compat_count].offset = node;
+			}
+			idx->compat_count++;
+		}
+	}
+	if (node < 0 && node != -FDT_ERR_NOTFOUND)
+		return node;
+
+	aliases = fdt_path_offset(blob, "/aliases");
+	if (aliases < 0)
+		return 0;
+	fdt_for_each_property_offset(prop, blob, aliases) {
+		path = fdt_getprop_by_offset(blob, prop, &name, &len);
+		if (!path || len < 1 || *path != '/' || path[len - 1])
+			continue;
+		if (fill) {
+			struct fdtdec_index_alias *alias;
+
+			alias = &idx->aliases[idx->alias_count];
+			alias->name = name;
+			alias->leaf = strrchr(path, '/') + 1;
+			alias->len = len;
+			alias->seq = trailing_strtol(name);
+		}
+		idx->alias_count++;
+	}
+
+	return 0;
+}
+
+static struct fdtdec_index *fdtdec_index_build(const void *blob)
+{
+	struct fdtdec_index count = { 0 }, *idx;
+	size_t size;
+	int ret;
+
+	ret = fdtdec_index_walk(blob, &count);
+	if (ret) {
+		debug("%s: Cannot index tree (err=%d)\n", __func__, ret);
+		return NULL;
+	}
+
+	size = sizeof(*idx) +
+	       2 * count.node_count * sizeof(int) +
+	       (count.phandle_count + count.compat_count) *
+	       sizeof(struct fdtdec_index_key) +
+	       count.alias_count * sizeof(struct fdtdec_index_alias);
+	idx = malloc(size);
+	if (!idx) {
+		debug("%s: Out of memory for %zu bytes\n", __func__, size);
+		return NULL;
+	}
+
+	memset(idx, 0, sizeof(*idx));
+	idx->aliases = (void *)(idx + 1);
+	idx->phandles = (void *)(idx->aliases + count.alias_count);
+	idx->compats = idx->phandles + count.phandle_count;
+	idx->nodes = (void *)(idx->compats + count.compat_count);
+	idx->parents = idx->nodes + count.node_count;
+	fdtdec_index_walk(blob, idx);
+
+	qsort(idx->phandles, idx->phandle_count, sizeof(*idx->phandles),
+	      fdtdec_index_key_cmp);
+	qsort(idx->compats, idx->compat_count, sizeof(*idx->compats),
+	      fdtdec_index_key_cmp);
+
+	idx->blob = blob;
+	idx->size_struct = fdt_size_dt_struct(blob);
+	idx->size_strings = fdt_size_dt_strings(blob);
+	idx->can_free = gd->flags & GD_FLG_FULL_MALLOC_INIT;
+	debug("%s: %d nodes, %d phandles, %d compatibles, %zu bytes\n",
+	      __func__, idx->node_count, idx->phandle_count,
+	      idx->compat_count, size);
+
+	return idx;
+}
+
+/* Returns the index of @blob, building it if needed, or NULL if none */
+static struct fdtdec_index *fdtdec_index_get(const void *blob)
+{
+	struct fdtdec_index *idx = gd->fdt_index;
+
+	if (!blob || blob != gd->fdt_blob)
+		return NULL;
+
+	if (idx && idx->blob == blob &&
+	    idx->size_struct == fdt_size_dt_struct(blob) &&
+	    idx->size_strings == fdt_size_dt_strings(blob))
+		return idx;
+
+	/* Do not retry a tree which cannot be indexed */
+	if (gd->fdt_index_failed == blob)
+		return NULL;
+
+	if (idx && idx->can_free)
+		free(idx);
+
+	if (gd->flags & GD_FLG_RELOC) {
+		bootstage_start(BOOTSTAGE_ID_ACCUM_FDT_INDEX_R, "fdt_index_r");
+		idx = fdtdec_index_build(blob);
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_FDT_INDEX_R);
+	} else {
+		bootstage_start(BOOTSTAGE_ID_ACCUM_FDT_INDEX_F, "fdt_index_f");
+		idx = fdtdec_index_build(blob);
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_FDT_INDEX_F);
+	}
+	gd->fdt_index = idx;
+	gd->fdt_index_failed = idx ? NULL : blob;
+
+	return idx;
+}
+
+/* Returns the first entry with @key and an offset above @offset */
+static struct fdtdec_index_key *fdtdec_index_find(
+		struct fdtdec_index_key *keys, int count, u32 key, int offset)
+{
+	int lo = 0, hi = count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (keys[mid].key < key ||
+		    (keys[mid].key == key && keys[mid].offset <= offset))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo < count && keys[lo].key == key ? &keys[lo] : NULL;
+}
+
+int fdtdec_node_offset_by_phandle(const void *blob, uint32_t phandle)
+{
+	struct fdtdec_index *idx = fdtdec_index_get(blob);
+	struct fdtdec_index_key *ent;
+
+	if (!idx || !phandle || phandle == (uint32_t)-1)
+		return fdt_node_offset_by_phandle(blob, phandle);
+
+	ent = fdtdec_index_find(idx->phandles, idx->phandle_count, phandle,
+				-1);
+	if (ent && fdt_get_phandle(blob, ent->offset) == phandle)
+		return ent->offset;
+
+	return fdt_node_offset_by_phandle(blob, phandle);
+}
+
+int fdtdec_node_offset_by_compatible(const void *blob, int node,
+				     const char *compat)
+{
+	struct fdtdec_index *idx = fdtdec_index_get(blob);
+	struct fdtdec_index_key *ent, *end;
+	u32 hash;
+
+	if (!idx)
+		return fdt_node_offset_by_compatible(blob, node, compat);
+
+	hash = fdtdec_index_hash(compat);
+	ent = fdtdec_index_find(idx->compats, idx->compat_count, hash, node);
+	if (!ent)
+		return -FDT_ERR_NOTFOUND;
+
+	/* Different strings may share a hash */
+	for (end = idx->compats + idx->compat_count;
+	     ent < end && ent->key == hash; ent++)
+		if (!fdt_node_check_compatible(blob, ent->offset, compat))
+			return ent->offset;
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+int fdtdec_parent_offset(const void *blob, int node)
+{
+	struct fdtdec_index *idx = fdtdec_index_get(blob);
+	int lo = 0, hi, mid, parent, next;
+
+	if (!idx)
+		return fdt_parent_offset(blob, node);
+
+	hi = idx->node_count;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (idx->nodes[mid] < node)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == idx->node_count || idx->nodes[lo] != node)
+		return fdt_parent_offset(blob, node);
+
+	/* Both must still start a node, i.e. not have been nop'ed out */
+	parent = idx->parents[lo];
+	if (fdt_next_tag(blob, node, &next) != FDT_BEGIN_NODE ||
+	    (parent >= 0 && fdt_next_tag(blob, parent, &next) != FDT_BEGIN_NODE))
+		return fdt_parent_offset(blob, node);
+
+	return parent;
+}
+
+int fdtdec_index_alias_seq(const void *blob, const char *base, int node,
+			   int *seqp)
+{
+	struct fdtdec_index *idx = fdtdec_index_get(blob);
+	int base_len = strlen(base);
+	const char *find_name;
+	int find_namelen;
+	int i;
+
+	if (!idx)
+		return -ENOSYS;
+
+	find_name = fdt_get_name(blob, node, &find_namelen);
+	for (i = 0; i < idx->alias_count; i++) {
+		struct fdtdec_index_alias *alias = &idx->aliases[i];
+
+		if (alias->len < find_namelen ||
+		    strncmp(alias->name, base, base_len) ||
+		    strcmp(alias->leaf, find_name))
+			continue;
+		if (alias->seq != -1) {
+			*seqp = alias->seq;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
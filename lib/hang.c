@@ -10,6 +10,7 @@
 
 #include <common.h>
 #include <bootstage.h>
+#include <console.h>
 
 #ifdef CONFIG_SPL_BUILD
 __weak void spl_hang_reset(void) {}
@@ -28,6 +29,8 @@ void hang(void)
 		defined(CONFIG_SPL_SERIAL_SUPPORT))
 	puts("### ERROR ### Please RESET the board ###\n");
 #endif
+	/* Nothing runs after this to send buffered output */
+	console_async_stop();
 	bootstage_error(BOOTSTAGE_ID_NEED_RESET);
 #ifdef CONFIG_SPL_BUILD
 	spl_hang_reset();
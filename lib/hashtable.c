@@ -159,6 +159,7 @@ void hdestroy_r(struct hsearch_data *htab)
 
 	/* the sign for an existing table is an value != NULL in htable */
 	htab->table = NULL;
+	htab->gen++;
 }
 
 /*
@@ -254,6 +255,7 @@ static inline int _compare_and_overwrite_entry(ENTRY item, ACTION action,
 
 			free(htab->table[idx].entry.data);
 			htab->table[idx].entry.data = strdup(item.data);
+			htab->gen++;
 			if (!htab->table[idx].entry.data) {
 				__set_errno(ENOMEM);
 				*retval = NULL;
@@ -375,6 +377,7 @@ int hsearch_r(ENTRY item, ACTION action, ENTRY ** retval,
 		}
 
 		++htab->filled;
+		htab->gen++;
 
 		/* This is a new entry, so look up a possible callback */
 		env_callback_init(&htab->table[idx].entry);
@@ -437,6 +440,7 @@ static void _hdelete(const char *key, struct hsearch_data *htab, ENTRY *ep,
 	htab->table[idx].used = -1;
 
 	--htab->filled;
+	htab->gen++;
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
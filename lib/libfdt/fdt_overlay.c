@@ -1,2 +1,877 @@
 #include <linux/libfdt_env.h>
 #include "../../scripts/dtc/libfdt/fdt_overlay.c"
+
+#ifdef CONFIG_OF_LIBFDT_OVERLAY_INDEX
+/*
+ * U-Boot own additions: apply overlays with an index of the base tree
+ *
+ * The phandle table maps a phandle to the offset of its node. Offsets
+ * move when properties and nodes are inserted, so every change to the
+ * base tree goes through a wrapper which shifts the offsets behind the
+ * changed node. The symbol table maps a __symbols__ label to the phandle
+ * of its node, which does not move. The path of a labelled node is kept
+ * with its phandle, for the __symbols__ of overlays that target it.
+ *
+ * Paths within a tree which is not changed, the overlay or the base tree
+ * while it is indexed, are looked up through a hash of all node paths.
+ */
+#include <malloc.h>
+
+#define FDT_INDEX_MAX_DEPTH	32
+
+struct fdt_index_ent {
+	uint32_t key;
+	uint32_t val;
+	uint32_t aux;
+	uint32_t used;
+};
+
+struct fdt_index_tab {
+	struct fdt_index_ent *ent;
+	uint32_t size;		/* power of two */
+	uint32_t count;
+};
+
+struct fdt_overlay_index {
+	struct fdt_index_tab phandles;	/* phandle -> node offset, path + 1 */
+	struct fdt_index_tab symbols;	/* label hash -> phandle, label */
+	char *names;			/* labels and paths */
+	uint32_t names_len;
+	uint32_t names_size;
+	uint32_t max_phandle;
+	int broken;
+};
+
+static uint32_t fdt_index_hash_str(uint32_t hash, const char *s, int len)
+{
+	while (len--)
+		hash = (hash ^ (uint8_t)*s++) * 0x01000193;
+
+	return hash;
+}
+
+static uint32_t fdt_index_slot(const struct fdt_index_tab *tab, uint32_t key)
+{
+	key ^= key >> 16;
+	key *= 0x7feb352d;
+	key ^= key >> 15;
+
+	return key & (tab->size - 1);
+}
+
+/* Returns the next entry after @prev (or the first if NULL) with @key */
+static struct fdt_index_ent *fdt_index_find(const struct fdt_index_tab *tab,
+					    uint32_t key,
+					    struct fdt_index_ent *prev)
+{
+	uint32_t i;
+
+	if (!tab->size)
+		return NULL;
+
+	i = prev ? (prev - tab->ent + 1) & (tab->size - 1) :
+		   fdt_index_slot(tab, key);
+	for (; tab->ent[i].used; i = (i + 1) & (tab->size - 1))
+		if (tab->ent[i].key == key)
+			return &tab->ent[i];
+
+	return NULL;
+}
+
+static int fdt_index_add(struct fdt_index_tab *tab, uint32_t key,
+			 uint32_t val, uint32_t aux)
+{
+	struct fdt_index_ent *ent;
+	uint32_t i;
+
+	if ((tab->count + 1) * 2 > tab->size) {
+		struct fdt_index_tab grown;
+
+		grown.size = tab->size ? tab->size * 2 : 64;
+		grown.count = 0;
+		grown.ent = calloc(grown.size, sizeof(*grown.ent));
+		if (!grown.ent)
+			return -FDT_ERR_NOSPACE;
+		for (i = 0; i < tab->size; i++) {
+			ent = &tab->ent[i];
+			if (ent->used)
+				fdt_index_add(&grown, ent->key, ent->val,
+					      ent->aux);
+		}
+		free(tab->ent);
+		*tab = grown;
+	}
+
+	for (i = fdt_index_slot(tab, key); tab->ent[i].used;
+	     i = (i + 1) & (tab->size - 1))
+		;
+	ent = &tab->ent[i];
+	ent->key = key;
+	ent->val = val;
+	ent->aux = aux;
+	ent->used = 1;
+	tab->count++;
+
+	return 0;
+}
+
+static int fdt_index_set_phandle(struct fdt_overlay_index *idx,
+				 uint32_t phandle, int node)
+{
+	struct fdt_index_ent *ent;
+
+	if (!phandle || phandle == (uint32_t)-1)
+		return 0;
+	if (phandle > idx->max_phandle)
+		idx->max_phandle = phandle;
+
+	ent = fdt_index_find(&idx->phandles, phandle, NULL);
+	if (ent) {
+		ent->val = node;
+		return 0;
+	}
+
+	return fdt_index_add(&idx->phandles, phandle, node, 0);
+}
+
+static int fdt_index_get_phandle(struct fdt_overlay_index *idx,
+				 uint32_t phandle)
+{
+	struct fdt_index_ent *ent;
+
+	ent = fdt_index_find(&idx->phandles, phandle, NULL);
+
+	return ent ? (int)ent->val : -FDT_ERR_NOTFOUND;
+}
+
+/* Copies @len bytes of @name and a terminator, returns the offset */
+static int fdt_index_add_name(struct fdt_overlay_index *idx, const char *name,
+			      int len)
+{
+	uint32_t off = idx->names_len;
+
+	if (idx->names_len + len + 1 > idx->names_size) {
+		uint32_t size = idx->names_size ? idx->names_size * 2 : 1024;
+		char *names;
+
+		while (idx->names_len + len + 1 > size)
+			size *= 2;
+		names = realloc(idx->names, size);
+		if (!names)
+			return -FDT_ERR_NOSPACE;
+		idx->names = names;
+		idx->names_size = size;
+	}
+	memcpy(idx->names + off, name, len);
+	idx->names[off + len] = '\0';
+	idx->names_len += len + 1;
+
+	return off;
+}
+
+static int fdt_index_set_symbol(struct fdt_overlay_index *idx,
+				const char *label, uint32_t phandle)
+{
+	int len = strlen(label);
+	uint32_t hash = fdt_index_hash_str(0x811c9dc5, label, len);
+	struct fdt_index_ent *ent = NULL;
+	int off;
+
+	while ((ent = fdt_index_find(&idx->symbols, hash, ent))) {
+		if (!strcmp(idx->names + ent->aux, label)) {
+			ent->val = phandle;
+			return 0;
+		}
+	}
+
+	off = fdt_index_add_name(idx, label, len);
+	if (off < 0)
+		return off;
+
+	return fdt_index_add(&idx->symbols, hash, phandle, off);
+}
+
+/* Remembers the path of the node with @phandle, unless already known */
+static int fdt_index_set_path(struct fdt_overlay_index *idx,
+			      uint32_t phandle, const char *path, int len)
+{
+	struct fdt_index_ent *ent;
+	int off;
+
+	ent = fdt_index_find(&idx->phandles, phandle, NULL);
+	if (!ent || ent->aux)
+		return 0;
+
+	off = fdt_index_add_name(idx, path, len);
+	if (off < 0)
+		return off;
+	ent->aux = off + 1;
+
+	return 0;
+}
+
+static const char *fdt_index_get_path(struct fdt_overlay_index *idx,
+				      uint32_t phandle)
+{
+	struct fdt_index_ent *ent;
+
+	ent = fdt_index_find(&idx->phandles, phandle, NULL);
+	if (!ent || !ent->aux)
+		return NULL;
+
+	return idx->names + ent->aux - 1;
+}
+
+/* Returns the phandle of the node labelled @label, 0 if not known */
+static uint32_t fdt_index_get_symbol(struct fdt_overlay_index *idx,
+				     const char *label)
+{
+	uint32_t hash = fdt_index_hash_str(0x811c9dc5, label, strlen(label));
+	struct fdt_index_ent *ent = NULL;
+
+	while ((ent = fdt_index_find(&idx->symbols, hash, ent)))
+		if (!strcmp(idx->names + ent->aux, label))
+			return ent->val;
+
+	return 0;
+}
+
+/*
+ * The structure block of @fdt has changed size by @delta inside @node, so
+ * every node after it has moved
+ */
+static void fdt_index_shift(struct fdt_overlay_index *idx, int node,
+			    int delta)
+{
+	struct fdt_index_ent *ent = idx->phandles.ent;
+	uint32_t i;
+
+	if (!delta)
+		return;
+
+	for (i = 0; i < idx->phandles.size; i++, ent++)
+		if (ent->used && (int)ent->val > node)
+			ent->val += delta;
+}
+
+static int fdt_index_setprop(struct fdt_overlay_index *idx, void *fdt,
+			     int node, const char *name, const void *val,
+			     int len)
+{
+	int size = fdt_size_dt_struct(fdt);
+	int ret;
+
+	ret = fdt_setprop(fdt, node, name, val, len);
+	if (ret)
+		return ret;
+	fdt_index_shift(idx, node, fdt_size_dt_struct(fdt) - size);
+
+	return 0;
+}
+
+static int fdt_index_setprop_placeholder(struct fdt_overlay_index *idx,
+					 void *fdt, int node, const char *name,
+					 int len, void **prop_data)
+{
+	int size = fdt_size_dt_struct(fdt);
+	int ret;
+
+	ret = fdt_setprop_placeholder(fdt, node, name, len, prop_data);
+	if (ret)
+		return ret;
+	fdt_index_shift(idx, node, fdt_size_dt_struct(fdt) - size);
+
+	return 0;
+}
+
+static int fdt_index_add_subnode(struct fdt_overlay_index *idx, void *fdt,
+				 int parent, const char *name)
+{
+	int size = fdt_size_dt_struct(fdt);
+	int ret;
+
+	ret = fdt_add_subnode(fdt, parent, name);
+	if (ret < 0)
+		return ret;
+	/* The new node is not indexed yet, it cannot be shifted wrongly */
+	fdt_index_shift(idx, parent, fdt_size_dt_struct(fdt) - size);
+
+	return ret;
+}
+
+void fdt_overlay_index_free(struct fdt_overlay_index *idx)
+{
+	if (!idx)
+		return;
+
+	free(idx->phandles.ent);
+	free(idx->symbols.ent);
+	free(idx->names);
+	free(idx);
+}
+
+struct fdt_index_node {
+	int offset;
+	int parent;		/* index in the node array, -1 for the root */
+};
+
+struct fdt_index_paths {
+	struct fdt_index_tab tab;	/* path hash -> node index */
+	struct fdt_index_node *nodes;
+	int count;
+	int size;
+};
+
+static void fdt_index_paths_free(struct fdt_index_paths *paths)
+{
+	free(paths->tab.ent);
+	free(paths->nodes);
+}
+
+/* Hashes the path of every node of @fdt, in a single walk over the tree */
+static int fdt_index_paths_build(const void *fdt, struct fdt_index_paths *paths)
+{
+	uint32_t hashes[FDT_INDEX_MAX_DEPTH + 1];
+	int parents[FDT_INDEX_MAX_DEPTH + 1];
+	struct fdt_index_node *nodes;
+	int node, depth, len, ret;
+	const char *name;
+
+	memset(paths, 0, sizeof(*paths));
+	hashes[0] = 0x811c9dc5;
+	parents[0] = -1;
+	depth = 0;
+	for (node = 0; node >= 0 && depth >= 0;
+	     node = fdt_next_node(fdt, node, &depth)) {
+		if (depth > FDT_INDEX_MAX_DEPTH)
+			continue;
+
+		if (paths->count == paths->size) {
+			paths->size = paths->size ? paths->size * 2 : 256;
+			nodes = realloc(paths->nodes,
+					paths->size * sizeof(*nodes));
+			if (!nodes)
+				return -FDT_ERR_NOSPACE;
+			paths->nodes = nodes;
+		}
+		paths->nodes[paths->count].offset = node;
+		paths->nodes[paths->count].parent = parents[depth];
+		if (depth < FDT_INDEX_MAX_DEPTH)
+			parents[depth + 1] = paths->count;
+
+		if (depth > 0) {
+			name = fdt_get_name(fdt, node, &len);
+			if (!name)
+				return len;
+			hashes[depth] = fdt_index_hash_str(hashes[depth - 1],
+							   "/", 1);
+			hashes[depth] = fdt_index_hash_str(hashes[depth], name,
+							   len);
+			ret = fdt_index_add(&paths->tab, hashes[depth],
+					    paths->count, 0);
+			if (ret)
+				return ret;
+		}
+		paths->count++;
+	}
+	if (node < 0 && node != -FDT_ERR_NOTFOUND)
+		return node;
+
+	return 0;
+}
+
+/* Checks that node @n has the path @path of @len bytes */
+static int fdt_index_path_match(const void *fdt,
+				const struct fdt_index_paths *paths, int n,
+				const char *path, int len)
+{
+	const char *end = path + len, *s, *name;
+	int name_len;
+
+	for (; paths->nodes[n].parent >= 0; n = paths->nodes[n].parent) {
+		for (s = end; s > path && s[-1] != '/'; s--)
+			;
+		if (s == path)
+			return 0;
+		name = fdt_get_name(fdt, paths->nodes[n].offset, &name_len);
+		if (!name || name_len != end - s || memcmp(name, s, name_len))
+			return 0;
+		end = s - 1;
+	}
+
+	return end == path;
+}
+
+/*
+ * Same as fdt_path_offset_namelen() for a tree indexed by @paths, falling
+ * back to it for paths which are not indexed, e.g. because they are too
+ * deep
+ */
+static int fdt_index_path_offset(const void *fdt,
+				 const struct fdt_index_paths *paths,
+				 const char *path, int len)
+{
+	uint32_t hash = fdt_index_hash_str(0x811c9dc5, path, len);
+	struct fdt_index_ent *ent = NULL;
+
+	while ((ent = fdt_index_find(&paths->tab, hash, ent)))
+		if (fdt_index_path_match(fdt, paths, ent->val, path, len))
+			return paths->nodes[ent->val].offset;
+
+	return fdt_path_offset_namelen(fdt, path, len);
+}
+
+int fdt_overlay_index_create(const void *fdt, struct fdt_overlay_index **idxp)
+{
+	struct fdt_overlay_index *idx;
+	struct fdt_index_paths paths;
+	int i, node, symbols, prop;
+	const char *name, *path;
+	uint32_t phandle;
+	int len, ret;
+
+	FDT_CHECK_HEADER(fdt);
+
+	idx = calloc(1, sizeof(*idx));
+	if (!idx)
+		return -FDT_ERR_NOSPACE;
+
+	ret = fdt_index_paths_build(fdt, &paths);
+	if (ret)
+		goto err;
+
+	for (i = 0; i < paths.count; i++) {
+		node = paths.nodes[i].offset;
+		ret = fdt_index_set_phandle(idx, fdt_get_phandle(fdt, node),
+					    node);
+		if (ret)
+			goto err;
+	}
+
+	symbols = fdt_subnode_offset(fdt, 0, "__symbols__");
+	if (symbols < 0 && symbols != -FDT_ERR_NOTFOUND) {
+		ret = symbols;
+		goto err;
+	}
+	if (symbols >= 0) {
+		fdt_for_each_property_offset(prop, fdt, symbols) {
+			path = fdt_getprop_by_offset(fdt, prop, &name, &len);
+			if (!path) {
+				ret = len;
+				goto err;
+			}
+			len = strnlen(path, len);
+			node = fdt_index_path_offset(fdt, &paths, path, len);
+			phandle = node < 0 ? 0 : fdt_get_phandle(fdt, node);
+			ret = fdt_index_set_symbol(idx, name, phandle);
+			if (!ret && phandle)
+				ret = fdt_index_set_path(idx, phandle, path,
+							 len);
+			if (ret)
+				goto err;
+		}
+	}
+
+	fdt_index_paths_free(&paths);
+	*idxp = idx;
+
+	return 0;
+
+err:
+	fdt_index_paths_free(&paths);
+	fdt_overlay_index_free(idx);
+
+	return ret;
+}
+
+/* Same as overlay_get_target(), with phandles taken from the index */
+static int fdt_index_get_target(const void *fdt, const void *fdto,
+				struct fdt_overlay_index *idx, int fragment,
+				char const **pathp)
+{
+	const char *path = NULL;
+	int path_len = 0, ret;
+	uint32_t phandle;
+
+	phandle = overlay_get_target_phandle(fdto, fragment);
+	if (phandle == (uint32_t)-1)
+		return -FDT_ERR_BADPHANDLE;
+
+	if (!phandle) {
+		path = fdt_getprop(fdto, fragment, "target-path", &path_len);
+		if (path)
+			ret = fdt_path_offset(fdt, path);
+		else
+			ret = path_len;
+	} else {
+		ret = fdt_index_get_phandle(idx, phandle);
+	}
+
+	if (ret < 0 && path_len == -FDT_ERR_NOTFOUND)
+		ret = -FDT_ERR_BADOVERLAY;
+	if (ret < 0)
+		return ret;
+
+	if (pathp)
+		*pathp = path;
+
+	return ret;
+}
+
+/* Same as overlay_fixup_phandle(), with the label taken from the index */
+static int fdt_index_fixup_phandle(void *fdto, struct fdt_overlay_index *idx,
+				   const struct fdt_index_paths *ov_paths,
+				   int property)
+{
+	const char *value, *label;
+	fdt32_t phandle_prop;
+	uint32_t phandle;
+	int len;
+
+	value = fdt_getprop_by_offset(fdto, property, &label, &len);
+	if (!value) {
+		if (len == -FDT_ERR_NOTFOUND)
+			return -FDT_ERR_INTERNAL;
+
+		return len;
+	}
+
+	phandle = fdt_index_get_symbol(idx, label);
+	if (!phandle)
+		return -FDT_ERR_NOTFOUND;
+	phandle_prop = cpu_to_fdt32(phandle);
+
+	do {
+		const char *path, *name, *fixup_end;
+		const char *fixup_str = value;
+		uint32_t path_len, name_len;
+		uint32_t fixup_len;
+		char *sep, *endptr;
+		int poffset, fixup_off, ret;
+
+		fixup_end = memchr(value, '\0', len);
+		if (!fixup_end)
+			return -FDT_ERR_BADOVERLAY;
+		fixup_len = fixup_end - fixup_str;
+
+		len -= fixup_len + 1;
+		value += fixup_len + 1;
+
+		path = fixup_str;
+		sep = memchr(fixup_str, ':', fixup_len);
+		if (!sep)
+			return -FDT_ERR_BADOVERLAY;
+
+		path_len = sep - path;
+		if (path_len == (fixup_len - 1))
+			return -FDT_ERR_BADOVERLAY;
+
+		fixup_len -= path_len + 1;
+		name = sep + 1;
+		sep = memchr(name, ':', fixup_len);
+		if (!sep)
+			return -FDT_ERR_BADOVERLAY;
+
+		name_len = sep - name;
+		if (!name_len)
+			return -FDT_ERR_BADOVERLAY;
+
+		poffset = strtoul(sep + 1, &endptr, 10);
+		if ((*endptr != '\0') || (endptr <= (sep + 1)))
+			return -FDT_ERR_BADOVERLAY;
+
+		fixup_off = fdt_index_path_offset(fdto, ov_paths, path,
+						  path_len);
+		if (fixup_off == -FDT_ERR_NOTFOUND)
+			return -FDT_ERR_BADOVERLAY;
+		if (fixup_off < 0)
+			return fixup_off;
+
+		ret = fdt_setprop_inplace_namelen_partial(fdto, fixup_off,
+							  name, name_len,
+							  poffset,
+							  &phandle_prop,
+							  sizeof(phandle_prop));
+		if (ret)
+			return ret;
+	} while (len > 0);
+
+	return 0;
+}
+
+static int fdt_index_fixup_phandles(void *fdto, struct fdt_overlay_index *idx,
+				    const struct fdt_index_paths *ov_paths)
+{
+	int fixups_off, property, ret;
+
+	fixups_off = fdt_path_offset(fdto, "/__fixups__");
+	if (fixups_off == -FDT_ERR_NOTFOUND)
+		return 0;
+	if (fixups_off < 0)
+		return fixups_off;
+
+	fdt_for_each_property_offset(property, fdto, fixups_off) {
+		ret = fdt_index_fixup_phandle(fdto, idx, ov_paths, property);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* Same as overlay_apply_node(), keeping the index up to date */
+static int fdt_index_apply_node(void *fdt, int target, void *fdto, int node,
+				struct fdt_overlay_index *idx)
+{
+	int property, subnode, nnode, prop_len, ret;
+	const char *name;
+	const void *prop;
+
+	fdt_for_each_property_offset(property, fdto, node) {
+		prop = fdt_getprop_by_offset(fdto, property, &name, &prop_len);
+		if (prop_len == -FDT_ERR_NOTFOUND)
+			return -FDT_ERR_INTERNAL;
+		if (prop_len < 0)
+			return prop_len;
+
+		ret = fdt_index_setprop(idx, fdt, target, name, prop,
+					prop_len);
+		if (ret)
+			return ret;
+
+		if (prop_len == sizeof(fdt32_t) &&
+		    (!strcmp(name, "phandle") ||
+		     !strcmp(name, "linux,phandle"))) {
+			ret = fdt_index_set_phandle(idx,
+					fdt32_to_cpu(*(fdt32_t *)prop), target);
+			if (ret)
+				return ret;
+		}
+	}
+
+	fdt_for_each_subnode(subnode, fdto, node) {
+		name = fdt_get_name(fdto, subnode, NULL);
+
+		nnode = fdt_index_add_subnode(idx, fdt, target, name);
+		if (nnode == -FDT_ERR_EXISTS) {
+			nnode = fdt_subnode_offset(fdt, target, name);
+			if (nnode == -FDT_ERR_NOTFOUND)
+				return -FDT_ERR_INTERNAL;
+		}
+		if (nnode < 0)
+			return nnode;
+
+		ret = fdt_index_apply_node(fdt, nnode, fdto, subnode, idx);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int fdt_index_merge(void *fdt, void *fdto,
+			   struct fdt_overlay_index *idx)
+{
+	int fragment, overlay, target, ret;
+
+	fdt_for_each_subnode(fragment, fdto, 0) {
+		overlay = fdt_subnode_offset(fdto, fragment, "__overlay__");
+		if (overlay == -FDT_ERR_NOTFOUND)
+			continue;
+		if (overlay < 0)
+			return overlay;
+
+		target = fdt_index_get_target(fdt, fdto, idx, fragment, NULL);
+		if (target < 0)
+			return target;
+
+		ret = fdt_index_apply_node(fdt, target, fdto, overlay, idx);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Same as overlay_symbol_update(), also adding the new labels to the
+ * index. Their phandles are taken from the overlay, which has already
+ * been merged. Paths of fragment targets come from the index where known.
+ */
+static int fdt_index_symbol_update(void *fdt, void *fdto,
+				   struct fdt_overlay_index *idx,
+				   const struct fdt_index_paths *ov_paths)
+{
+	int root_sym, ov_sym, prop, path_len, fragment, target;
+	int len, frag_name_len, ret, rel_path_len, node;
+	uint32_t phandle;
+	const char *s, *e;
+	const char *path;
+	const char *name;
+	const char *rel_path;
+	const char *target_path;
+	char *buf;
+	void *p;
+
+	ov_sym = fdt_subnode_offset(fdto, 0, "__symbols__");
+	if (ov_sym < 0)
+		return 0;
+
+	root_sym = fdt_subnode_offset(fdt, 0, "__symbols__");
+	if (root_sym == -FDT_ERR_NOTFOUND)
+		root_sym = fdt_index_add_subnode(idx, fdt, 0, "__symbols__");
+	if (root_sym < 0)
+		return root_sym;
+
+	fdt_for_each_property_offset(prop, fdto, ov_sym) {
+		path = fdt_getprop_by_offset(fdto, prop, &name, &path_len);
+		if (!path)
+			return path_len;
+
+		if (path_len < 1 ||
+		    memchr(path, '\0', path_len) != &path[path_len - 1])
+			return -FDT_ERR_BADVALUE;
+
+		e = path + path_len;
+
+		if (*path != '/')
+			return -FDT_ERR_BADVALUE;
+
+		s = strchr(path + 1, '/');
+		if (!s)
+			return -FDT_ERR_BADOVERLAY;
+
+		frag_name_len = s - path - 1;
+
+		len = sizeof("/__overlay__/") - 1;
+		if ((e - s) < len || memcmp(s, "/__overlay__/", len))
+			return -FDT_ERR_BADOVERLAY;
+
+		rel_path = s + len;
+		rel_path_len = e - rel_path;
+
+		ret = fdt_index_path_offset(fdto, ov_paths, path,
+					    frag_name_len + 1);
+		if (ret < 0)
+			return -FDT_ERR_BADOVERLAY;
+		fragment = ret;
+
+		ret = fdt_subnode_offset(fdto, fragment, "__overlay__");
+		if (ret < 0)
+			return -FDT_ERR_BADOVERLAY;
+
+		ret = fdt_index_get_target(fdt, fdto, idx, fragment,
+					   &target_path);
+		if (ret < 0)
+			return ret;
+		target = ret;
+
+		if (!target_path)
+			target_path = fdt_index_get_path(idx,
+				overlay_get_target_phandle(fdto, fragment));
+		if (!target_path) {
+			ret = get_path_len(fdt, target);
+			if (ret < 0)
+				return ret;
+			len = ret;
+		} else {
+			len = strlen(target_path);
+		}
+
+		ret = fdt_index_setprop_placeholder(idx, fdt, root_sym, name,
+				len + (len > 1) + rel_path_len + 1, &p);
+		if (ret < 0)
+			return ret;
+
+		if (!target_path) {
+			/* again in case setprop_placeholder changed it */
+			ret = fdt_index_get_target(fdt, fdto, idx, fragment,
+						   &target_path);
+			if (ret < 0)
+				return ret;
+			target = ret;
+		}
+
+		buf = p;
+		if (len > 1) {
+			if (!target_path) {
+				ret = fdt_get_path(fdt, target, buf, len + 1);
+				if (ret < 0)
+					return ret;
+			} else {
+				memcpy(buf, target_path, len + 1);
+			}
+		} else {
+			len--;
+		}
+
+		buf[len] = '/';
+		memcpy(buf + len + 1, rel_path, rel_path_len);
+		buf[len + 1 + rel_path_len] = '\0';
+
+		node = fdt_index_path_offset(fdto, ov_paths, path,
+					     path_len - 1);
+		phandle = node < 0 ? 0 : fdt_get_phandle(fdto, node);
+		ret = fdt_index_set_symbol(idx, name, phandle);
+		if (!ret && phandle)
+			ret = fdt_index_set_path(idx, phandle, buf,
+						 len + 1 + rel_path_len);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+int fdt_overlay_apply_index(void *fdt, void *fdto,
+			    struct fdt_overlay_index *idx)
+{
+	uint32_t delta = idx->max_phandle;
+	struct fdt_index_paths ov_paths;
+	int ret;
+
+	FDT_CHECK_HEADER(fdt);
+	FDT_CHECK_HEADER(fdto);
+
+	if (idx->broken)
+		return -FDT_ERR_BADSTATE;
+
+	/* The overlay is only changed in place, its offsets stay valid */
+	ret = fdt_index_paths_build(fdto, &ov_paths);
+	if (ret)
+		goto err;
+
+	ret = overlay_adjust_local_phandles(fdto, delta);
+	if (ret)
+		goto err;
+
+	ret = overlay_update_local_references(fdto, delta);
+	if (ret)
+		goto err;
+
+	ret = fdt_index_fixup_phandles(fdto, idx, &ov_paths);
+	if (ret)
+		goto err;
+
+	ret = fdt_index_merge(fdt, fdto, idx);
+	if (ret)
+		goto err;
+
+	ret = fdt_index_symbol_update(fdt, fdto, idx, &ov_paths);
+	if (ret)
+		goto err;
+
+	fdt_index_paths_free(&ov_paths);
+	fdt_set_magic(fdto, ~0);
+
+	return 0;
+
+err:
+	fdt_index_paths_free(&ov_paths);
+	idx->broken = 1;
+	fdt_set_magic(fdto, ~0);
+	fdt_set_magic(fdt, ~0);
+
+	return ret;
+}
+#endif /* CONFIG_OF_LIBFDT_OVERLAY_INDEX */
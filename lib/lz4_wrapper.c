@@ -77,54 +77,73 @@ bool lz4_is_valid_header(const unsigned char *h)
 	return true;
 }
 
-int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+int ulz4fn_stream_init(struct ulz4_stream *s, const void *src, size_t srcn,
+		       void *dst, size_t dstn)
 {
-	const void *end = dst + *dstn;
-	const void *in = src;
-	void *out = dst;
-	int has_block_checksum;
-	int ret;
-	*dstn = 0;
+	const struct lz4_frame_header *h = src;
+	const void *in = src + sizeof(*h);
 
-	{ /* With in-place decompression the header may become invalid later. */
-		const struct lz4_frame_header *h = in;
+	if (srcn < sizeof(*h) + sizeof(u8))
+		return -EINVAL;	/* input overrun */
 
+	/* We assume there's always only a single, standard frame. */
+	if (le32_to_cpu(h->magic) != LZ4F_MAGIC || h->version != 1)
+		return -EPROTONOSUPPORT;	/* unknown format */
+	if (h->reserved0 || h->reserved1 || h->reserved2)
+		return -EINVAL;	/* reserved must be zero */
+	if (!h->independent_blocks)
+		return -EPROTONOSUPPORT; /* we can't support this yet */
+
+	s->content_size = 0;
+	if (h->has_content_size) {
 		if (srcn < sizeof(*h) + sizeof(u64) + sizeof(u8))
 			return -EINVAL;	/* input overrun */
-
-		/* We assume there's always only a single, standard frame. */
-		if (le32_to_cpu(h->magic) != LZ4F_MAGIC || h->version != 1)
-			return -EPROTONOSUPPORT;	/* unknown format */
-		if (h->reserved0 || h->reserved1 || h->reserved2)
-			return -EINVAL;	/* reserved must be zero */
-		if (!h->independent_blocks)
-			return -EPROTONOSUPPORT; /* we can't support this yet */
-		has_block_checksum = h->has_block_checksum;
-
-		in += sizeof(*h);
-		if (h->has_content_size)
-			in += sizeof(u64);
-		in += sizeof(u8);
+		s->content_size = le64_to_cpu(*(u64 *)in);
+		in += sizeof(u64);
 	}
+	in += sizeof(u8);
+
+	s->has_block_checksum = h->has_block_checksum;
+	s->in = in;
+	s->out = dst;
+	s->end = dst + dstn;
+
+	return 0;
+}
+
+int ulz4fn_stream(struct ulz4_stream *s, const void *avail)
+{
+	const void *in = s->in;
+	void *out = s->out;
+	int ret;
 
 	while (1) {
 		struct lz4_block_header b;
+		size_t need;
 
-		b.raw = le32_to_cpu(*(u32 *)in);
-		in += sizeof(struct lz4_block_header);
-
-		if (in - src + b.size > srcn) {
-			ret = -EINVAL;		/* input overrun */
+		if (avail - in < sizeof(struct lz4_block_header)) {
+			ret = -EAGAIN;		/* block header not there yet */
 			break;
 		}
+		b.raw = le32_to_cpu(*(u32 *)in);
 
 		if (!b.size) {
+			in += sizeof(struct lz4_block_header);
 			ret = 0;	/* decompression successful */
 			break;
 		}
 
+		need = sizeof(struct lz4_block_header) + b.size;
+		if (s->has_block_checksum)
+			need += sizeof(u32);
+		if (avail - in < need) {
+			ret = -EAGAIN;		/* block not complete yet */
+			break;
+		}
+		in += sizeof(struct lz4_block_header);
+
 		if (b.not_compressed) {
-			size_t size = min((ptrdiff_t)b.size, end - out);
+			size_t size = min((ptrdiff_t)b.size, s->end - out);
 			memcpy(out, in, size);
 			out += size;
 			if (size < b.size) {
@@ -134,7 +153,7 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 		} else {
 			/* constant folding essential, do not touch params! */
 			ret = LZ4_decompress_generic(in, out, b.size,
-					end - out, endOnInputSize,
+					s->end - out, endOnInputSize,
 					full, 0, noDict, out, NULL, 0);
 			if (ret < 0) {
 				ret = -EPROTO;	/* decompression error */
@@ -143,11 +162,28 @@ int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
 			out += ret;
 		}
 
-		in += b.size;
-		if (has_block_checksum)
-			in += sizeof(u32);
+		in += need - sizeof(struct lz4_block_header);
 	}
 
-	*dstn = out - dst;
+	s->in = in;
+	s->out = out;
+	return ret;
+}
+
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	struct ulz4_stream s;
+	int ret;
+
+	ret = ulz4fn_stream_init(&s, src, srcn, dst, *dstn);
+	*dstn = 0;
+	if (ret)
+		return ret;
+
+	ret = ulz4fn_stream(&s, src + srcn);
+	if (ret == -EAGAIN)
+		ret = -EINVAL;		/* input overrun */
+
+	*dstn = s.out - dst;
 	return ret;
 }
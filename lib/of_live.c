@@ -18,6 +18,76 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#define OF_LIVE_MAGIC		0x6f666c76	/* "oflv" */
+#define OF_LIVE_HDR_SIZE	ALIGN(sizeof(struct of_live_tree), 16)
+
+/**
+ * struct of_live_tree - header of the block holding a live tree
+ *
+ * All nodes and properties of a tree are allocated from a single block,
+ * starting with this header and followed immediately by the root node.
+ * Property names and values point into the flat tree, so it must not move
+ * while the live tree is in use.
+ *
+ * @magic: OF_LIVE_MAGIC
+ * @root: Root node of the tree
+ * @phandle_mask: Number of entries in @phandles, minus one
+ * @phandles: Hash table of the nodes which have a phandle, open addressing
+ */
+struct of_live_tree {
+	u32 magic;
+	struct device_node *root;
+	unsigned int phandle_mask;
+	struct device_node **phandles;
+};
+
+static struct of_live_tree *of_live_tree_of(const struct device_node *root)
+{
+	struct of_live_tree *tree;
+
+	if (!root)
+		return NULL;
+	tree = (void *)root - OF_LIVE_HDR_SIZE;
+	if (tree->magic != OF_LIVE_MAGIC || tree->root != root)
+		return NULL;
+
+	return tree;
+}
+
+static unsigned int of_live_hash(struct of_live_tree *tree, u32 handle)
+{
+	return (handle * 0x9e3779b1) & tree->phandle_mask;
+}
+
+/* Add all nodes with a phandle, in tree order so the first one wins */
+static void of_live_hash_phandles(struct of_live_tree *tree)
+{
+	struct device_node *np = tree->root;
+	unsigned int i;
+
+	while (np) {
+		if (np->phandle) {
+			for (i = of_live_hash(tree, np->phandle);
+			     tree->phandles[i];
+			     i = (i + 1) & tree->phandle_mask) {
+				if (tree->phandles[i]->phandle == np->phandle)
+					break;
+			}
+			if (!tree->phandles[i])
+				tree->phandles[i] = np;
+		}
+
+		if (np->child) {
+			np = np->child;
+			continue;
+		}
+		while (np && !np->sibling)
+			np = np->parent;
+		if (np)
+			np = np->sibling;
+	}
+}
+
 static void *unflatten_dt_alloc(void **mem, unsigned long size,
 				unsigned long align)
 {
@@ -38,13 +108,15 @@ static void *unflatten_dt_alloc(void **mem, unsigned long size,
  * @dad: Parent struct device_node
  * @nodepp: The device_node tree created by the call
  * @fpsize: Size of the node path up at t05he current depth.
+ * @phandlesp: Incremented for each phandle property seen in a dry run
  * @dryrun: If true, do not allocate device nodes but still calculate needed
  * memory size
  */
 static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 			       struct device_node *dad,
 			       struct device_node **nodepp,
-			       unsigned long fpsize, bool dryrun)
+			       unsigned long fpsize, unsigned int *phandlesp,
+			       bool dryrun)
 {
 	const __be32 *p;
 	struct device_node *np;
@@ -143,6 +215,10 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		}
 		if (strcmp(pname, "name") == 0)
 			has_name = 1;
+		if (dryrun && (strcmp(pname, "phandle") == 0 ||
+			       strcmp(pname, "linux,phandle") == 0 ||
+			       strcmp(pname, "ibm,phandle") == 0))
+			(*phandlesp)++;
 		pp = unflatten_dt_alloc(&mem, sizeof(struct property),
 					__alignof__(struct property));
 		if (!dryrun) {
@@ -188,16 +264,22 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		if (pa < ps)
 			pa = p1;
 		sz = (pa - ps) + 1;
-		pp = unflatten_dt_alloc(&mem, sizeof(struct property) + sz,
+		/* Without a unit address the name in the blob can be used */
+		pp = unflatten_dt_alloc(&mem, sizeof(struct property) +
+					(*pa ? sz : 0),
 					__alignof__(struct property));
 		if (!dryrun) {
 			pp->name = "name";
 			pp->length = sz;
-			pp->value = pp + 1;
 			*prev_pp = pp;
 			prev_pp = &pp->next;
-			memcpy(pp->value, ps, sz - 1);
-			((char *)pp->value)[sz - 1] = 0;
+			if (*pa) {
+				pp->value = pp + 1;
+				memcpy(pp->value, ps, sz - 1);
+				((char *)pp->value)[sz - 1] = 0;
+			} else {
+				pp->value = (char *)ps;
+			}
 			debug("fixed up name for %s -> %s\n", pathp,
 			      (char *)pp->value);
 		}
@@ -218,7 +300,7 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		depth = 0;
 	while (*poffset > 0 && depth > old_depth) {
 		mem = unflatten_dt_node(blob, mem, poffset, np, NULL,
-					fpsize, dryrun);
+					fpsize, phandlesp, dryrun);
 		if (!mem)
 			return NULL;
 	}
@@ -256,7 +338,8 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
  * unflattens a device-tree, creating the
  * tree of struct device_node. It also fills the "name" and "type"
  * pointers of the nodes so the normal device-tree walking functions
- * can be used.
+ * can be used. Everything is allocated in one block, see struct of_live_tree,
+ * with a hash table to look up phandles.
  * @blob: The blob to expand
  * @mynodes: The device_node tree created by the call
  * @return 0 if OK, -ve on error
@@ -264,7 +347,9 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 static int unflatten_device_tree(const void *blob,
 				 struct device_node **mynodes)
 {
-	unsigned long size;
+	struct of_live_tree *tree;
+	unsigned long size, table, total;
+	unsigned int phandles, slots;
 	int start;
 	void *mem;
 
@@ -287,17 +372,30 @@ static int unflatten_device_tree(const void *blob,
 
 	/* First pass, scan for size */
 	start = 0;
+	phandles = 0;
 	size = (unsigned long)unflatten_dt_node(blob, NULL, &start, NULL, NULL,
-						0, true);
+						0, &phandles, true);
 	if (!size)
 		return -EFAULT;
 	size = ALIGN(size, 4);
 
-	debug("  size is %lx, allocating...\n", size);
+	/* Keep the phandle hash table at most half full */
+	for (slots = 2; slots < phandles * 2; slots <<= 1)
+		;
+	table = ALIGN(OF_LIVE_HDR_SIZE + size + 4, sizeof(void *));
+	total = table + slots * sizeof(struct device_node *);
+
+	debug("  size is %lx, %u phandles, allocating %lx...\n", size,
+	      phandles, total);
 
 	/* Allocate memory for the expanded device tree */
-	mem = malloc(size + 4);
-	memset(mem, '\0', size);
+	tree = malloc(total);
+	if (!tree) {
+		debug("Out of memory for %lx bytes\n", total);
+		return -ENOMEM;
+	}
+	memset(tree, '\0', total);
+	mem = (void *)tree + OF_LIVE_HDR_SIZE;
 
 	*(__be32 *)(mem + size) = cpu_to_be32(0xdeadbeef);
 
@@ -305,13 +403,21 @@ static int unflatten_device_tree(const void *blob,
 
 	/* Second pass, do actual unflattening */
 	start = 0;
-	unflatten_dt_node(blob, mem, &start, NULL, mynodes, 0, false);
+	unflatten_dt_node(blob, mem, &start, NULL, &tree->root, 0, NULL,
+			  false);
 	if (be32_to_cpup(mem + size) != 0xdeadbeef) {
 		debug("End of tree marker overwritten: %08x\n",
 		      be32_to_cpup(mem + size));
+		free(tree);
 		return -ENOSPC;
 	}
 
+	tree->magic = OF_LIVE_MAGIC;
+	tree->phandle_mask = slots - 1;
+	tree->phandles = (void *)tree + table;
+	of_live_hash_phandles(tree);
+	*mynodes = tree->root;
+
 	debug(" <- unflatten_device_tree()\n");
 
 	return 0;
@@ -336,3 +442,34 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp)
 
 	return ret;
 }
+
+struct device_node *of_live_find_node_by_phandle(const struct device_node *root,
+						 u32 handle)
+{
+	struct of_live_tree *tree = of_live_tree_of(root);
+	struct device_node *np;
+	unsigned int i;
+
+	if (!tree)
+		return ERR_PTR(-ENOSYS);
+
+	for (i = of_live_hash(tree, handle); (np = tree->phandles[i]);
+	     i = (i + 1) & tree->phandle_mask) {
+		if (np->phandle == handle)
+			return np;
+	}
+
+	return NULL;
+}
+
+int of_live_free(struct device_node *root)
+{
+	struct of_live_tree *tree = of_live_tree_of(root);
+
+	if (!tree)
+		return -EINVAL;
+	tree->magic = 0;
+	free(tree);
+
+	return 0;
+}
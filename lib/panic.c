@@ -10,6 +10,7 @@
  */
 
 #include <common.h>
+#include <console.h>
 #if !defined(CONFIG_PANIC_HANG)
 #include <command.h>
 #endif
@@ -31,6 +32,7 @@ static void panic_finish(void)
 
 void panic_str(const char *str)
 {
+	console_async_stop();
 	puts(str);
 	panic_finish();
 }
@@ -38,6 +40,8 @@ void panic_str(const char *str)
 void panic(const char *fmt, ...)
 {
 	va_list args;
+
+	console_async_stop();
 	va_start(args, fmt);
 	vprintf(fmt, args);
 	va_end(args);
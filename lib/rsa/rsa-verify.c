@@ -62,74 +62,22 @@ static int rsa_verify_padding(const uint8_t *msg, const int pad_len,
 
 #if !defined(USE_HOSTCC)
 #if CONFIG_IS_ENABLED(FIT_HW_CRYPTO)
-static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src,
-				   int total_len, int convert_len)
-{
-	int total_wd, convert_wd, i;
-
-	if (total_len < convert_len)
-		convert_len = total_len;
-
-	total_wd = total_len / sizeof(uint32_t);
-	convert_wd = convert_len / sizeof(uint32_t);
-	for (i = 0; i < convert_wd; i++)
-		dst[i] = fdt32_to_cpu(src[total_wd - 1 - i]);
-}
-
 static int rsa_mod_exp_hw(struct key_prop *prop, const uint8_t *sig,
 			  const uint32_t sig_len, const uint32_t key_len,
 			  uint8_t *output)
 {
-	struct udevice *dev;
-	uint8_t sig_reverse[sig_len];
-	uint8_t buf[sig_len];
-	rsa_key rsa_key;
-	int i, ret;
-
-	if (key_len != RSA2048_BYTES)
-		return -EINVAL;
-
-	rsa_key.algo = CRYPTO_RSA2048;
-	rsa_key.n = malloc(key_len);
-	rsa_key.e = malloc(key_len);
-	rsa_key.c = malloc(key_len);
-	if (!rsa_key.n || !rsa_key.e || !rsa_key.c)
-		return -ENOMEM;
-
-	rsa_convert_big_endian(rsa_key.n, (uint32_t *)prop->modulus,
-			       key_len, key_len);
-	rsa_convert_big_endian(rsa_key.e, (uint32_t *)prop->public_exponent_BN,
-			       key_len, key_len);
 #ifdef CONFIG_ROCKCHIP_CRYPTO_V1
-	rsa_convert_big_endian(rsa_key.c, (uint32_t *)prop->factor_c,
-			       key_len, key_len);
+	const void *factor = prop->factor_c;
 #else
-	rsa_convert_big_endian(rsa_key.c, (uint32_t *)prop->factor_np,
-			       key_len, key_len);
+	const void *factor = prop->factor_np;
 #endif
-	for (i = 0; i < sig_len; i++)
-		sig_reverse[sig_len-1-i] = sig[i];
-
-	dev = crypto_get_device(rsa_key.algo);
-	if (!dev) {
-		printf("No crypto device for expected RSA\n");
-		return -ENODEV;
-	}
-
-	ret = crypto_rsa_verify(dev, &rsa_key, (u8 *)sig_reverse, buf);
-	if (ret)
-		goto out;
-
-	for (i = 0; i < sig_len; i++)
-		sig_reverse[sig_len-1-i] = buf[i];
 
-	memcpy(output, sig_reverse, sig_len);
-out:
-	free(rsa_key.n);
-	free(rsa_key.e);
-	free(rsa_key.c);
+	if (sig_len != key_len || !prop->public_exponent_BN)
+		return -EINVAL;
 
-	return ret;
+	return crypto_rsa_verify_be(key_len * 8, prop->modulus,
+				    prop->public_exponent_BN, factor,
+				    sig, output);
 }
 #endif
 #endif
@@ -391,19 +339,23 @@ static int rsa_verify_key(struct image_sign_info *info,
 	uint8_t buf[sig_len];
 
 #if !defined(USE_HOSTCC)
-#if CONFIG_IS_ENABLED(FIT_HW_CRYPTO)
-	ret = rsa_mod_exp_hw(prop, sig, sig_len, key_len, buf);
-#else
 	struct udevice *mod_exp_dev;
 
-	ret = uclass_get_device(UCLASS_MOD_EXP, 0, &mod_exp_dev);
+	ret = -ENODEV;
+#if CONFIG_IS_ENABLED(FIT_HW_CRYPTO)
+	ret = rsa_mod_exp_hw(prop, sig, sig_len, key_len, buf);
+	if (ret)
+		debug("RSA: hardware verify failed %d, try software\n", ret);
+#endif
 	if (ret) {
-		printf("RSA: Can't find Modular Exp implementation\n");
-		return -EINVAL;
-	}
+		ret = uclass_get_device(UCLASS_MOD_EXP, 0, &mod_exp_dev);
+		if (ret) {
+			printf("RSA: Can't find Modular Exp implementation\n");
+			return -EINVAL;
+		}
 
-	ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
-#endif
+		ret = rsa_mod_exp(mod_exp_dev, sig, sig_len, prop, buf);
+	}
 #else
 	ret = rsa_mod_exp_sw(sig, sig_len, prop, buf);
 #endif
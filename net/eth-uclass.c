@@ -21,9 +21,11 @@ DECLARE_GLOBAL_DATA_PTR;
  * struct eth_device_priv - private structure for each Ethernet device
  *
  * @state: The state of the Ethernet MAC driver (defined by enum eth_state_t)
+ * @stats: Traffic counters since probe or the last eth_reset_stats()
  */
 struct eth_device_priv {
 	enum eth_state_t state;
+	struct eth_stats stats;
 };
 
 /**
@@ -331,6 +333,7 @@ int eth_is_active(struct udevice *dev)
 int eth_send(void *packet, int length)
 {
 	struct udevice *current;
+	struct eth_device_priv *priv;
 	int ret;
 
 	current = eth_get_dev();
@@ -340,10 +343,15 @@ int eth_send(void *packet, int length)
 	if (!device_active(current))
 		return -EINVAL;
 
+	priv = dev_get_uclass_priv(current);
 	ret = eth_get_ops(current)->send(current, packet, length);
 	if (ret < 0) {
+		priv->stats.tx_errors++;
 		/* We cannot completely return the error at present */
 		debug("%s: send() returned error %d\n", __func__, ret);
+	} else {
+		priv->stats.tx_packets++;
+		priv->stats.tx_bytes += length;
 	}
 	return ret;
 }
@@ -351,6 +359,7 @@ int eth_send(void *packet, int length)
 int eth_rx(void)
 {
 	struct udevice *current;
+	struct eth_device_priv *priv;
 	uchar *packet;
 	int flags;
 	int ret;
@@ -363,27 +372,81 @@ int eth_rx(void)
 	if (!device_active(current))
 		return -EINVAL;
 
-	/* Process up to 32 packets at one time */
+	priv = dev_get_uclass_priv(current);
+
+	/*
+	 * Drain every frame the device has ready, so a burst does not sit
+	 * in the receive ring while the caller does other work between
+	 * polls. The budget only keeps a flood from starving the caller.
+	 */
 	flags = ETH_RECV_CHECK_DEVICE;
-	for (i = 0; i < 32; i++) {
+	for (i = 0; i < CONFIG_ETH_RX_BUDGET; i++) {
 		ret = eth_get_ops(current)->recv(current, flags, &packet);
 		flags = 0;
-		if (ret > 0)
+		if (ret > 0) {
+			priv->stats.rx_packets++;
+			priv->stats.rx_bytes += ret;
 			net_process_received_packet(packet, ret);
+		}
 		if (ret >= 0 && eth_get_ops(current)->free_pkt)
 			eth_get_ops(current)->free_pkt(current, packet, ret);
 		if (ret <= 0)
 			break;
 	}
+	if (i > priv->stats.rx_batch_max)
+		priv->stats.rx_batch_max = i;
 	if (ret == -EAGAIN)
 		ret = 0;
 	if (ret < 0) {
+		priv->stats.rx_errors++;
 		/* We cannot completely return the error at present */
 		debug("%s: recv() returned error %d\n", __func__, ret);
 	}
 	return ret;
 }
 
+/* Fold the counters only the driver knows about into the uclass ones */
+static int eth_update_stats(struct udevice *dev)
+{
+	struct eth_device_priv *priv = dev_get_uclass_priv(dev);
+
+	if (!device_active(dev))
+		return -EINVAL;
+
+	if (!eth_get_ops(dev)->get_stats)
+		return 0;
+
+	return eth_get_ops(dev)->get_stats(dev, &priv->stats);
+}
+
+int eth_get_stats(struct udevice *dev, struct eth_stats *stats)
+{
+	struct eth_device_priv *priv = dev_get_uclass_priv(dev);
+	int ret;
+
+	ret = eth_update_stats(dev);
+	if (ret)
+		return ret;
+
+	*stats = priv->stats;
+
+	return 0;
+}
+
+int eth_reset_stats(struct udevice *dev)
+{
+	struct eth_device_priv *priv = dev_get_uclass_priv(dev);
+	int ret;
+
+	ret = eth_update_stats(dev);
+	if (ret)
+		return ret;
+
+	memset(&priv->stats, 0, sizeof(priv->stats));
+
+	return 0;
+}
+
 int eth_initialize(void)
 {
 	int num_devices = 0;
@@ -489,6 +552,8 @@ static int eth_post_probe(struct udevice *dev)
 			ops->write_hwaddr += gd->reloc_off;
 		if (ops->read_rom_hwaddr)
 			ops->read_rom_hwaddr += gd->reloc_off;
+		if (ops->get_stats)
+			ops->get_stats += gd->reloc_off;
 
 		reloc_done++;
 	}
@@ -31,6 +31,7 @@
 #include <net.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <linux/log2.h>
 #include "nfs.h"
 #include "bootp.h"
 
@@ -41,15 +42,41 @@
 #else
 # define NFS_TIMEOUT CONFIG_NFS_TIMEOUT
 #endif
+#ifndef CONFIG_NFS_READ_WINDOW
+# define NFS_READ_WINDOW 1
+#else
+# define NFS_READ_WINDOW CONFIG_NFS_READ_WINDOW
+#endif
+
+/* Bytes of file data represented by one "loading" hash mark */
+#define NFS_BYTES_PER_HASH	((NFS_READ_SIZE / 2) * 10)
+/* nfs_read_end value while the size of the file is not known yet */
+#define NFS_SIZE_UNKNOWN	(~0U)
 
 #define NFS_RPC_ERR	1
 #define NFS_RPC_DROP	124
 
 static int fs_mounted;
 static unsigned long rpc_id;
-static int nfs_offset = -1;
-static int nfs_len;
 static ulong nfs_timeout = NFS_TIMEOUT;
+static ulong time_start;	/* Record time we started reading the file */
+
+/* One outstanding READ RPC of the transfer window */
+struct nfs_read_slot {
+	unsigned long xid;	/* RPC id of the request, 0 if slot is free */
+	unsigned int offset;	/* file offset requested */
+	unsigned int len;	/* number of bytes requested */
+	ulong sent;		/* get_timer() value of the last transmission */
+	int retries;		/* retransmissions of this request so far */
+};
+
+static struct nfs_read_slot nfs_read_slots[NFS_READ_WINDOW];
+static int nfs_read_window;	/* slots currently allowed in flight */
+static unsigned int nfs_read_size = NFS_READ_SIZE;
+static unsigned int nfs_read_next;	/* first offset not requested yet */
+static unsigned int nfs_read_end;	/* file size, or NFS_SIZE_UNKNOWN */
+static unsigned int nfs_read_done;	/* bytes stored so far */
+static int nfs_read_hashes;
 
 static char dirfh[NFS_FHSIZE];	/* NFSv2 / NFSv3 file handle of directory */
 static char filefh[NFS3_FHSIZE]; /* NFSv2 / NFSv3 file handle */
@@ -69,6 +96,7 @@ static int nfs_state;
 #define STATE_LOOKUP_REQ		5
 #define STATE_READ_REQ			6
 #define STATE_READLINK_REQ		7
+#define STATE_FSINFO_REQ		8
 
 static char *nfs_filename;
 static char *nfs_path;
@@ -168,17 +196,16 @@ static uint32_t *rpc_add_credentials(uint32_t *p)
 }
 
 /**************************************************************************
-RPC_LOOKUP - Lookup RPC Port numbers
+RPC_SEND - Send an RPC call carrying the given transaction id
 **************************************************************************/
-static void rpc_req(int rpc_prog, int rpc_proc, uint32_t *data, int datalen)
+static void rpc_send(unsigned long id, int rpc_prog, int rpc_proc,
+		     uint32_t *data, int datalen)
 {
 	struct rpc_t rpc_pkt;
-	unsigned long id;
 	uint32_t *p;
 	int pktlen;
 	int sport;
 
-	id = ++rpc_id;
 	rpc_pkt.u.call.id = htonl(id);
 	rpc_pkt.u.call.type = htonl(MSG_CALL);
 	rpc_pkt.u.call.rpcvers = htonl(2);	/* use RPC version 2 */
@@ -217,6 +244,14 @@ static void rpc_req(int rpc_prog, int rpc_proc, uint32_t *data, int datalen)
 			    nfs_our_port, pktlen);
 }
 
+/**************************************************************************
+RPC_REQ - Send an RPC call with a new transaction id
+**************************************************************************/
+static void rpc_req(int rpc_prog, int rpc_proc, uint32_t *data, int datalen)
+{
+	rpc_send(++rpc_id, rpc_prog, rpc_proc, data, datalen);
+}
+
 /**************************************************************************
 RPC_LOOKUP - Lookup RPC Port numbers
 **************************************************************************/
@@ -353,10 +388,33 @@ static void nfs_lookup_req(char *fname)
 	}
 }
 
+/**************************************************************************
+NFS_FSINFO - Ask an NFSv3 Server for its preferred Transfer Sizes
+**************************************************************************/
+static void nfs_fsinfo_req(void)
+{
+	uint32_t data[1024];
+	uint32_t *p;
+	int len;
+
+	p = &(data[0]);
+	p = rpc_add_credentials(p);
+
+	*p++ = htonl(filefh3_length);
+	memcpy(p, filefh, filefh3_length);
+	p += (filefh3_length / 4);
+
+	len = (uint32_t *)p - (uint32_t *)&(data[0]);
+
+	rpc_req(PROG_NFS, NFS3PROC_FSINFO, data, len);
+}
+
 /**************************************************************************
 NFS_READ - Read File on NFS Server
+A slot keeps its transaction id across retransmissions, so that a late
+reply to the first transmission is still accepted.
 **************************************************************************/
-static void nfs_read_req(int offset, int readlen)
+static void nfs_read_req(struct nfs_read_slot *slot)
 {
 	uint32_t data[1024];
 	uint32_t *p;
@@ -368,22 +426,85 @@ static void nfs_read_req(int offset, int readlen)
 	if (supported_nfs_versions & NFSV2_FLAG) {
 		memcpy(p, filefh, NFS_FHSIZE);
 		p += (NFS_FHSIZE / 4);
-		*p++ = htonl(offset);
-		*p++ = htonl(readlen);
+		*p++ = htonl(slot->offset);
+		*p++ = htonl(slot->len);
 		*p++ = 0;
 	} else { /* NFSV3_FLAG */
 		*p++ = htonl(filefh3_length);
 		memcpy(p, filefh, filefh3_length);
 		p += (filefh3_length / 4);
 		*p++ = htonl(0); /* offset is 64-bit long, so fill with 0 */
-		*p++ = htonl(offset);
-		*p++ = htonl(readlen);
+		*p++ = htonl(slot->offset);
+		*p++ = htonl(slot->len);
 		*p++ = 0;
 	}
 
 	len = (uint32_t *)p - (uint32_t *)&(data[0]);
 
-	rpc_req(PROG_NFS, NFS_READ, data, len);
+	if (!slot->xid)
+		slot->xid = ++rpc_id;
+	slot->sent = get_timer(0);
+	rpc_send(slot->xid, PROG_NFS, NFS_READ, data, len);
+}
+
+/*
+ * Top up the READ window: retransmit requests whose reply is overdue and
+ * issue new ones for the part of the file not requested yet.  Returns the
+ * number of requests in flight, or -ETIMEDOUT if one of them ran out of
+ * retries.
+ */
+static int nfs_read_fill(void)
+{
+	struct nfs_read_slot *slot;
+	int busy = 0;
+	int i;
+
+	for (i = 0; i < nfs_read_window; i++) {
+		slot = &nfs_read_slots[i];
+
+		if (slot->xid && slot->offset >= nfs_read_end) {
+			/* Issued past end of file, the answer is not needed */
+			slot->xid = 0;
+		}
+
+		if (slot->xid) {
+			if (get_timer(slot->sent) >= nfs_timeout) {
+				if (++slot->retries > NFS_RETRY_COUNT)
+					return -ETIMEDOUT;
+				nfs_read_req(slot);
+			}
+			busy++;
+			continue;
+		}
+
+		if (nfs_read_next >= nfs_read_end)
+			continue;
+
+		slot->offset = nfs_read_next;
+		slot->len = min(nfs_read_size, nfs_read_end - nfs_read_next);
+		slot->retries = 0;
+		nfs_read_next += slot->len;
+		nfs_read_req(slot);
+		busy++;
+	}
+
+	return busy;
+}
+
+static void nfs_read_start(void)
+{
+	memset(nfs_read_slots, 0, sizeof(nfs_read_slots));
+	/* Only one request until we know the handle is a regular file */
+	nfs_read_window = 1;
+	nfs_read_next = 0;
+	nfs_read_end = NFS_SIZE_UNKNOWN;
+	nfs_read_done = 0;
+	nfs_read_hashes = 0;
+	time_start = get_timer(0);
+
+	debug("NFS read size %u, window %d\n", nfs_read_size, NFS_READ_WINDOW);
+	nfs_state = STATE_READ_REQ;
+	nfs_read_fill();
 }
 
 /**************************************************************************
@@ -416,11 +537,14 @@ static void nfs_send(void)
 		nfs_lookup_req(nfs_filename);
 		break;
 	case STATE_READ_REQ:
-		nfs_read_req(nfs_offset, nfs_len);
+		nfs_read_fill();
 		break;
 	case STATE_READLINK_REQ:
 		nfs_readlink_req();
 		break;
+	case STATE_FSINFO_REQ:
+		nfs_fsinfo_req();
+		break;
 	}
 }
 
@@ -652,21 +776,89 @@ static int nfs_readlink_reply(uchar *pkt, unsigned len)
 	return 0;
 }
 
-static int nfs_read_reply(uchar *pkt, unsigned len)
+static int nfs_fsinfo_reply(uchar *pkt, unsigned len)
 {
 	struct rpc_t rpc_pkt;
-	int rlen;
-	uchar *data_ptr;
+	int nfsv3_data_offset;
+	unsigned int rtmax;
 
 	debug("%s\n", __func__);
 
-	memcpy(&rpc_pkt.u.data[0], pkt, sizeof(rpc_pkt.u.reply));
+	memcpy(&rpc_pkt.u.data[0], pkt, len);
 
 	if (ntohl(rpc_pkt.u.reply.id) > rpc_id)
 		return -NFS_RPC_ERR;
 	else if (ntohl(rpc_pkt.u.reply.id) < rpc_id)
 		return -NFS_RPC_DROP;
 
+	if (rpc_pkt.u.reply.rstatus  ||
+	    rpc_pkt.u.reply.verifier ||
+	    rpc_pkt.u.reply.astatus  ||
+	    rpc_pkt.u.reply.data[0])
+		return -1;
+
+	nfsv3_data_offset = nfs3_get_attributes_offset(rpc_pkt.u.reply.data);
+
+	/* rtmax is followed by rtpref, rtmult, wtmax, ... */
+	rtmax = ntohl(rpc_pkt.u.reply.data[1 + nfsv3_data_offset]);
+	rtmax = min_t(unsigned int, rtmax, NFS3_READ_SIZE_MAX);
+	if (rtmax > NFS_READ_SIZE)
+		nfs_read_size = rounddown_pow_of_two(rtmax);
+
+	return 0;
+}
+
+static void nfs_show_progress(unsigned int bytes)
+{
+	nfs_read_done += bytes;
+
+	while (nfs_read_hashes * NFS_BYTES_PER_HASH < nfs_read_done) {
+		if (nfs_read_hashes && !(nfs_read_hashes % HASHES_PER_LINE))
+			puts("\n\t ");
+		putc('#');
+		nfs_read_hashes++;
+	}
+}
+
+static struct nfs_read_slot *nfs_read_find_slot(unsigned long xid)
+{
+	int i;
+
+	for (i = 0; i < nfs_read_window; i++) {
+		if (nfs_read_slots[i].xid && nfs_read_slots[i].xid == xid)
+			return &nfs_read_slots[i];
+	}
+
+	return NULL;
+}
+
+/*
+ * Match a READ reply to its slot and store the data at the file offset
+ * of that request.  Replies that do not belong to an outstanding request
+ * (duplicates of retransmitted ones, answers to requests issued past the
+ * end of file) are dropped.
+ */
+static int nfs_read_reply(uchar *pkt, unsigned len,
+			  struct nfs_read_slot **slotp, int *eof)
+{
+	struct rpc_t rpc_pkt;
+	struct nfs_read_slot *slot;
+	unsigned int size = NFS_SIZE_UNKNOWN;
+	uint32_t *data;
+	uchar *data_ptr;
+	int rlen;
+
+	debug("%s\n", __func__);
+
+	/* Only the RPC and NFS headers are needed, data is used in place */
+	memcpy(&rpc_pkt.u.data[0], pkt,
+	       min_t(unsigned, len, sizeof(rpc_pkt.u.reply)));
+
+	slot = nfs_read_find_slot(ntohl(rpc_pkt.u.reply.id));
+	if (!slot)
+		return -NFS_RPC_DROP;
+	*slotp = slot;
+
 	if (rpc_pkt.u.reply.rstatus  ||
 	    rpc_pkt.u.reply.verifier ||
 	    rpc_pkt.u.reply.astatus  ||
@@ -678,40 +870,90 @@ static int nfs_read_reply(uchar *pkt, unsigned len)
 		return -ntohl(rpc_pkt.u.reply.data[0]);
 	}
 
-	if ((nfs_offset != 0) && !((nfs_offset) %
-			(NFS_READ_SIZE / 2 * 10 * HASHES_PER_LINE)))
-		puts("\n\t ");
-	if (!(nfs_offset % ((NFS_READ_SIZE / 2) * 10)))
-		putc('#');
+	data = rpc_pkt.u.reply.data;
+	*eof = 0;
 
 	if (supported_nfs_versions & NFSV2_FLAG) {
-		rlen = ntohl(rpc_pkt.u.reply.data[18]);
-		data_ptr = (uchar *)&(rpc_pkt.u.reply.data[19]);
+		/* fattr: type, mode, nlink, uid, gid, size, ... */
+		size = ntohl(data[6]);
+		rlen = ntohl(data[18]);
+		data_ptr = (uchar *)&(data[19]);
 	} else {  /* NFSV3_FLAG */
-		int nfsv3_data_offset =
-			nfs3_get_attributes_offset(rpc_pkt.u.reply.data);
+		int nfsv3_data_offset = nfs3_get_attributes_offset(data);
+
+		/* fattr3 size is 64-bit, only use it when it fits */
+		if (ntohl(data[1]) && !data[7])
+			size = ntohl(data[8]);
 
 		/* count value */
-		rlen = ntohl(rpc_pkt.u.reply.data[1 + nfsv3_data_offset]);
-		/* Skip unused values :
-			EOF:		32 bits value,
+		rlen = ntohl(data[1 + nfsv3_data_offset]);
+		*eof = !!data[2 + nfsv3_data_offset];
+		/* Skip unused value :
 			data_size:	32 bits value,
 		*/
-		data_ptr = (uchar *)
-			&(rpc_pkt.u.reply.data[4 + nfsv3_data_offset]);
+		data_ptr = (uchar *)&(data[4 + nfsv3_data_offset]);
 	}
 
-	if (store_block(data_ptr, nfs_offset, rlen))
+	/* Point into the received packet rather than our header copy */
+	data_ptr = pkt + (data_ptr - &rpc_pkt.u.data[0]);
+	if (rlen < 0 || rlen > slot->len || data_ptr + rlen > pkt + len)
+		return -NFS_RPC_DROP;
+
+	if (size < nfs_read_end)
+		nfs_read_end = size;
+	if (!rlen || slot->offset + rlen >= nfs_read_end)
+		*eof = 1;
+	if (*eof && slot->offset + rlen < nfs_read_end)
+		nfs_read_end = slot->offset + rlen;
+
+	if (store_block(data_ptr, slot->offset, rlen))
 			return -9999;
 
+	nfs_show_progress(rlen);
+
 	return rlen;
 }
 
+/* Retire a slot after its reply was stored, re-asking for a short read */
+static void nfs_read_slot_done(struct nfs_read_slot *slot, int rlen, int eof)
+{
+	slot->xid = 0;
+	if (!eof && rlen < slot->len) {
+		slot->offset += rlen;
+		slot->len -= rlen;
+		slot->retries = 0;
+		nfs_read_req(slot);
+	}
+}
+
+/* The file has been read completely, report the throughput like tftp */
+static void nfs_read_complete(void)
+{
+	time_start = get_timer(time_start);
+	if (time_start > 0) {
+		puts("\n\t ");	/* Line up with "Loading: " */
+		print_size(net_boot_file_size /
+			time_start * 1000, "/s");
+	}
+	nfs_download_state = NETLOOP_SUCCESS;
+}
+
 /**************************************************************************
 Interfaces of U-BOOT
 **************************************************************************/
 static void nfs_timeout_handler(void)
 {
+	if (nfs_state == STATE_READ_REQ) {
+		/* Retries are accounted per outstanding request */
+		puts("T ");
+		net_set_timeout_handler(nfs_timeout, nfs_timeout_handler);
+		if (nfs_read_fill() < 0) {
+			puts("\nRetry count exceeded; starting again\n");
+			net_start_again();
+		}
+		return;
+	}
+
 	if (++nfs_timeout_count > NFS_RETRY_COUNT) {
 		puts("\nRetry count exceeded; starting again\n");
 		net_start_again();
@@ -727,8 +969,10 @@ static void nfs_timeout_handler(void)
 static void nfs_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 			unsigned src, unsigned len)
 {
+	struct nfs_read_slot *slot = NULL;
 	int rlen;
 	int reply;
+	int eof = 0;
 
 	debug("%s\n", __func__);
 
@@ -794,14 +1038,23 @@ static void nfs_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 			/* And retry with another supported version */
 			nfs_state = STATE_PRCLOOKUP_PROG_MOUNT_REQ;
 			nfs_send();
-		} else {
-			nfs_state = STATE_READ_REQ;
-			nfs_offset = 0;
-			nfs_len = NFS_READ_SIZE;
+		} else if (!(supported_nfs_versions & NFSV2_FLAG)) {
+			/* NFSv3: ask the server how much we may read at once */
+			nfs_state = STATE_FSINFO_REQ;
 			nfs_send();
+		} else {
+			nfs_read_start();
 		}
 		break;
 
+	case STATE_FSINFO_REQ:
+		reply = nfs_fsinfo_reply(pkt, len);
+		if (reply == -NFS_RPC_DROP)
+			break;
+		/* Failing FSINFO is not fatal, we keep the default size */
+		nfs_read_start();
+		break;
+
 	case STATE_READLINK_REQ:
 		reply = nfs_readlink_reply(pkt, len);
 		if (reply == -NFS_RPC_DROP) {
@@ -821,20 +1074,29 @@ static void nfs_handler(uchar *pkt, unsigned dest, struct in_addr sip,
 		break;
 
 	case STATE_READ_REQ:
-		rlen = nfs_read_reply(pkt, len);
+		rlen = nfs_read_reply(pkt, len, &slot, &eof);
+		if (rlen == -NFS_RPC_DROP)
+			break;
 		net_set_timeout_handler(nfs_timeout, nfs_timeout_handler);
-		if (rlen > 0) {
-			nfs_offset += rlen;
+		if (rlen >= 0) {
+			/* The handle is a regular file, open the window */
+			nfs_read_window = NFS_READ_WINDOW;
+			nfs_read_slot_done(slot, rlen, eof);
+			reply = nfs_read_fill();
+			if (reply > 0)
+				break;
+			if (!reply)
+				nfs_read_complete();
+			else
+				puts("\nRetry count exceeded\n");
+			nfs_state = STATE_UMOUNT_REQ;
 			nfs_send();
 		} else if ((rlen == -NFSERR_ISDIR) || (rlen == -NFSERR_INVAL)) {
 			/* symbolic link */
 			nfs_state = STATE_READLINK_REQ;
 			nfs_send();
 		} else {
-			if (!rlen)
-				nfs_download_state = NETLOOP_SUCCESS;
-			if (rlen < 0)
-				debug("NFS READ error (%d)\n", rlen);
+			debug("NFS READ error (%d)\n", rlen);
 			nfs_state = STATE_UMOUNT_REQ;
 			nfs_send();
 		}
@@ -912,6 +1174,7 @@ void nfs_start(void)
 	net_set_udp_handler(nfs_handler);
 
 	nfs_timeout_count = 0;
+	nfs_read_size = NFS_READ_SIZE;
 	nfs_state = STATE_PRCLOOKUP_PROG_MOUNT_REQ;
 
 	/*nfs_our_port = 4096 + (get_ticks() % 3072);*/
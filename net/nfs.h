@@ -26,6 +26,7 @@
 #define NFS_READ        6
 
 #define NFS3PROC_LOOKUP 3
+#define NFS3PROC_FSINFO 19
 
 #define NFS_FHSIZE      32
 #define NFS3_FHSIZE     64
@@ -44,6 +45,21 @@
  */
 #define NFS_READ_SIZE	1024	/* biggest power of two that fits Ether frame */
 
+/*
+ * Upper bound for the NFSv3 read size negotiated through FSINFO.  Replies
+ * bigger than NFS_READ_SIZE are IP fragmented, so they are only asked for
+ * when CONFIG_IP_DEFRAG can put them back together.
+ */
+#ifdef CONFIG_IP_DEFRAG
+#ifdef CONFIG_NET_MAXDEFRAG
+#define NFS3_READ_SIZE_MAX	(CONFIG_NET_MAXDEFRAG / 2)
+#else
+#define NFS3_READ_SIZE_MAX	8192
+#endif
+#else
+#define NFS3_READ_SIZE_MAX	NFS_READ_SIZE
+#endif
+
 /* Values for Accept State flag on RPC answers (See: rfc1831) */
 enum rpc_accept_stat {
 	NFS_RPC_SUCCESS = 0,	/* RPC executed successfully */
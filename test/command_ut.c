@@ -50,6 +50,16 @@ static int do_ut_cmd(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	assert(!strcmp("1", env_get("black")));
 	assert(env_get("adder") != NULL);
 	assert(!strcmp("2", env_get("adder")));
+
+	/* a script run again sees the variables as they are now */
+	run_command("setenv list", 0);
+	run_command("setenv loop 'for i in ${items}; do setenv list ${list}${i}; done'",
+		    0);
+	run_command("setenv items 1 2", 0);
+	run_command("run loop", 0);
+	run_command("setenv items 3", 0);
+	run_command("run loop", 0);
+	assert(!strcmp("123", env_get("list")));
 #endif
 
 	assert(run_command("", 0) == 0);
@@ -66,6 +66,33 @@ static int dm_test_eth_alias(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_eth_alias, DM_TESTF_SCAN_FDT);
 
+/* Test that a ping shows up in the traffic counters and reset clears them */
+static int dm_test_eth_stats(struct unit_test_state *uts)
+{
+	struct eth_stats stats;
+	struct udevice *dev;
+
+	net_ping_ip = string_to_ip("1.1.2.2");
+	env_set("ethact", "eth@10002000");
+	ut_assertok(net_loop(PING));
+
+	dev = eth_get_dev_by_name("eth@10002000");
+	ut_assertnonnull(dev);
+	ut_assertok(eth_get_stats(dev, &stats));
+	ut_assert(stats.tx_packets > 0);
+	ut_assert(stats.rx_packets > 0);
+	ut_assert(stats.rx_batch_max > 0);
+	ut_asserteq(0, stats.tx_errors);
+
+	ut_assertok(eth_reset_stats(dev));
+	ut_assertok(eth_get_stats(dev, &stats));
+	ut_asserteq(0, stats.tx_packets);
+	ut_asserteq(0, stats.rx_packets);
+
+	return 0;
+}
+DM_TEST(dm_test_eth_stats, DM_TESTF_SCAN_FDT);
+
 static int dm_test_eth_prime(struct unit_test_state *uts)
 {
 	net_ping_ip = string_to_ip("1.1.2.2");
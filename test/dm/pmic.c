@@ -67,3 +67,50 @@ static int dm_test_power_pmic_io(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_power_pmic_io, DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_DM_PMIC_CACHE
+/* Test the PMIC register cache and deferred writes */
+static int dm_test_power_pmic_cache(struct unit_test_state *uts)
+{
+	static const struct pmic_reg_range ranges[] = { { 0, 3 } };
+	const char *name = "sandbox_pmic";
+	struct pmic_stats stats;
+	uint8_t buffer[3] = { 0 };
+	struct udevice *dev;
+
+	ut_assertok(pmic_get(name, &dev));
+	ut_assertok(pmic_cache_init(dev, ranges, ARRAY_SIZE(ranges)));
+
+	/* Written through, then read back and rewritten from the cache */
+	ut_assertok(pmic_reg_write(dev, 0, 0x10));
+	ut_asserteq(0x10, pmic_reg_read(dev, 0));
+	ut_assertok(pmic_reg_write(dev, 0, 0x10));
+
+	/* Held back until the commit, then sent as a single burst */
+	ut_assertok(pmic_write(dev, 1, buffer, 3));
+	ut_assertok(pmic_cache_begin(dev));
+	ut_assertok(pmic_clrsetbits(dev, 1, 0xff, 0x21));
+	ut_assertok(pmic_reg_write(dev, 2, 0x22));
+	ut_assertok(pmic_reg_write(dev, 3, 0x33));
+	ut_assertok(pmic_reg_write(dev, 3, 0x34));
+	ut_asserteq(0x34, pmic_reg_read(dev, 3));
+	ut_assertok(dm_i2c_read(dev, 1, buffer, 3));
+	ut_asserteq(0, buffer[0]);
+	ut_asserteq(0, buffer[2]);
+	ut_assertok(pmic_cache_commit(dev));
+	ut_assertok(dm_i2c_read(dev, 1, buffer, 3));
+	ut_asserteq(0x21, buffer[0]);
+	ut_asserteq(0x22, buffer[1]);
+	ut_asserteq(0x34, buffer[2]);
+
+	ut_assertok(pmic_get_stats(dev, &stats));
+	ut_asserteq(0, stats.reads);
+	ut_asserteq(3, stats.writes);
+	ut_asserteq(3, stats.read_hits);
+	ut_asserteq(1, stats.write_skips);
+	ut_asserteq(3, stats.write_merges);
+
+	return 0;
+}
+DM_TEST(dm_test_power_pmic_cache, DM_TESTF_SCAN_FDT);
+#endif
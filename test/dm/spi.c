@@ -7,6 +7,8 @@
 #include <common.h>
 #include <dm.h>
 #include <fdtdec.h>
+#include <malloc.h>
+#include <os.h>
 #include <spi.h>
 #include <spi_flash.h>
 #include <asm/state.h>
@@ -125,3 +127,54 @@ static int dm_test_spi_xfer(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_spi_xfer, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/*
+ * Test a long read, not a multiple of any FIFO depth, through the generic
+ * SPI uclass on the sandbox SPI bus
+ */
+static int dm_test_spi_xfer_long(struct unit_test_state *uts)
+{
+	struct spi_slave *slave;
+	struct udevice *bus;
+	const int busnum = 0, cs = 0, mode = 0;
+	const int size = 0x10000 + 0x123;
+	const u8 cmd[4] = {0x03, 0, 0, 0};
+	u8 *src, *dst;
+	int fd, i;
+
+	src = malloc(size);
+	dst = malloc(size);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	for (i = 0; i < size; i++)
+		src[i] = i ^ (i >> 8);
+	memset(dst, '\0', size);
+
+	fd = os_open("spi.bin", OS_O_WRONLY | OS_O_CREAT);
+	ut_assert(fd >= 0);
+	ut_asserteq(size, os_write(fd, src, size));
+	os_close(fd);
+
+	ut_assertok(spi_get_bus_and_cs(busnum, cs, 1000000, mode, NULL, 0,
+				       &bus, &slave));
+	ut_assertok(spi_claim_bus(slave));
+	ut_assertok(spi_xfer(slave, sizeof(cmd) * 8, cmd, NULL,
+			     SPI_XFER_BEGIN));
+	ut_assertok(spi_xfer(slave, size * 8, NULL, dst, SPI_XFER_END));
+	spi_release_bus(slave);
+	ut_assertok(memcmp(src, dst, size));
+
+	free(src);
+	free(dst);
+
+	/*
+	 * Since we are about to destroy all devices, we must tell sandbox
+	 * to forget the emulation device
+	 */
+#ifdef CONFIG_DM_SPI_FLASH
+	sandbox_sf_unbind_emul(state_get_current(), busnum, cs);
+#endif
+
+	return 0;
+}
+DM_TEST(dm_test_spi_xfer_long, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -10,6 +10,7 @@
 #include <fdtdec.h>
 #include <malloc.h>
 #include <asm/io.h>
+#include <linux/ctype.h>
 #include <dm/test.h>
 #include <dm/root.h>
 #include <dm/device-internal.h>
@@ -419,3 +420,77 @@ static int dm_test_first_next_ok_device(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_first_next_ok_device, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that the index of the control tree gives the same results as libfdt */
+static int dm_test_fdtdec_index(struct unit_test_state *uts)
+{
+	const void *blob = gd->fdt_blob;
+	const char *compat, *end, *name;
+	int node, aliases, prop, len, seq, index_seq, ret;
+	char base[32];
+	void *copy;
+	u32 phandle;
+
+	/* fdtdec_* on a copy of the tree use libfdt, not the index */
+	copy = malloc(fdt_totalsize(blob));
+	ut_assertnonnull(copy);
+	memcpy(copy, blob, fdt_totalsize(blob));
+
+	aliases = fdt_path_offset(blob, "/aliases");
+	ut_assert(aliases >= 0);
+
+	for (node = 0; node >= 0; node = fdt_next_node(blob, node, NULL)) {
+		ut_asserteq(fdt_parent_offset(blob, node),
+			    fdtdec_parent_offset(blob, node));
+
+		phandle = fdt_get_phandle(blob, node);
+		if (phandle)
+			ut_asserteq(fdt_node_offset_by_phandle(blob, phandle),
+				    fdtdec_node_offset_by_phandle(blob,
+								  phandle));
+
+		fdt_for_each_property_offset(prop, blob, aliases) {
+			fdt_getprop_by_offset(blob, prop, &name, NULL);
+			strlcpy(base, name, sizeof(base));
+			len = strlen(base);
+			while (len && isdigit(base[len - 1]))
+				base[--len] = '\0';
+
+			ret = fdtdec_get_alias_seq(copy, base, node, &seq);
+			ut_asserteq(ret, fdtdec_get_alias_seq(blob, base, node,
+							      &index_seq));
+			if (!ret)
+				ut_asserteq(seq, index_seq);
+		}
+
+		compat = fdt_getprop(blob, node, "compatible", &len);
+		if (!compat)
+			continue;
+		for (end = compat + len; compat < end;
+		     compat += strlen(compat) + 1)
+			ut_asserteq(fdt_node_offset_by_compatible(blob, -1,
+								  compat),
+				    fdtdec_node_offset_by_compatible(blob, -1,
+								     compat));
+	}
+
+	/* Every match of a compatible string, in order */
+	node = -1;
+	do {
+		ret = fdt_node_offset_by_compatible(blob, node,
+						    "denx,u-boot-fdt-test");
+		node = fdtdec_node_offset_by_compatible(blob, node,
+							"denx,u-boot-fdt-test");
+		ut_asserteq(ret, node);
+	} while (node >= 0);
+
+	/* Misses */
+	ut_asserteq(-FDT_ERR_NOTFOUND,
+		    fdtdec_node_offset_by_phandle(blob, 0xfffffff0));
+	ut_asserteq(-FDT_ERR_NOTFOUND,
+		    fdtdec_node_offset_by_compatible(blob, -1, "no,such"));
+	free(copy);
+
+	return 0;
+}
+DM_TEST(dm_test_fdtdec_index, 0);
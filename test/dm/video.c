@@ -300,7 +300,7 @@ static int dm_test_video_truetype(struct unit_test_state *uts)
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
 	for (s = test_string; *s; s++)
 		vidconsole_put_char(con, *s);
-	ut_asserteq(12619, compress_frame_buffer(dev));
+	ut_asserteq(10167, compress_frame_buffer(dev));
 
 	return 0;
 }
@@ -323,7 +323,7 @@ static int dm_test_video_truetype_scroll(struct unit_test_state *uts)
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
 	for (s = test_string; *s; s++)
 		vidconsole_put_char(con, *s);
-	ut_asserteq(33849, compress_frame_buffer(dev));
+	ut_asserteq(30525, compress_frame_buffer(dev));
 
 	return 0;
 }
@@ -346,7 +346,7 @@ static int dm_test_video_truetype_bs(struct unit_test_state *uts)
 	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
 	for (s = test_string; *s; s++)
 		vidconsole_put_char(con, *s);
-	ut_asserteq(34871, compress_frame_buffer(dev));
+	ut_asserteq(31673, compress_frame_buffer(dev));
 
 	return 0;
 }
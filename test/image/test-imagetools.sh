@@ -129,6 +129,12 @@ create_fit_image()
 	            compression = \"gzip\"; \
 	            load = <0x40000>; \
 	            entry = <0x8>; \
+	            hash@1 { \
+	                algo = \"sha1\"; \
+	            }; \
+	            hash@2 { \
+	                algo = \"crc32\"; \
+	            }; \
 	        }; \
 	        ramdisk@1 { \
 	            description = \"filesystem\"; \
@@ -139,6 +145,9 @@ create_fit_image()
 	            compression = \"none\"; \
 	            load = <0x80000>; \
 	            entry = <0x16>; \
+	            hash@1 { \
+	                algo = \"sha256\"; \
+	            }; \
 	        }; \
 	        fdt@1 { \
 	            description = \"device tree\"; \
@@ -146,6 +155,9 @@ create_fit_image()
 	            type = \"flat_dt\"; \
 	            arch = \"sandbox\"; \
 	            compression = \"none\"; \
+	            hash@1 { \
+	                algo = \"md5\"; \
+	            }; \
 	        }; \
 	    }; \
 	    configurations { \
@@ -163,6 +175,23 @@ create_fit_image()
 	echo "done."
 }
 
+# Check that hashing FIT images with several threads gives the same image
+check_fit_threads()
+{
+	echo -e "\nBuilding FIT image with hashing threads..."
+	export SOURCE_DATE_EPOCH=0
+	do_cmd ${MKIMAGE} -f ${IMAGE_FIT_ITS} ${IMAGE_FIT_ITB}.j1
+	do_cmd ${MKIMAGE} -j 4 -f ${IMAGE_FIT_ITS} ${IMAGE_FIT_ITB}.j4
+	unset SOURCE_DATE_EPOCH
+	if ! cmp ${IMAGE_FIT_ITB}.j1 ${IMAGE_FIT_ITB}.j4; then
+		echo "Failed."
+		cleanup
+		exit 1
+	fi
+	rm -f ${IMAGE_FIT_ITB}.j1 ${IMAGE_FIT_ITB}.j4
+	echo "done."
+}
+
 # Extract files from a FIT image
 extract_fit_image()
 {
@@ -207,6 +236,7 @@ main()
 
 	# Compress and extract FIT images, compare the result
 	create_fit_image
+	check_fit_threads
 	extract_fit_image
 	for file in ${DATAFILES}; do
 		assert_equal ${file} ${SRCDIR}/${file}
@@ -215,6 +215,187 @@ static int fdt_overlay_stacked(struct unit_test_state *uts)
 }
 OVERLAY_TEST(fdt_overlay_stacked, 0);
 
+#ifdef CONFIG_OF_LIBFDT_OVERLAY_INDEX
+/* The indexed overlay code must build exactly the same tree */
+static int fdt_overlay_index_same(struct unit_test_state *uts)
+{
+	struct fdt_overlay_index *idx;
+	void *base, *overlay, *stacked;
+
+	base = malloc(FDT_COPY_SIZE);
+	overlay = malloc(FDT_COPY_SIZE);
+	stacked = malloc(FDT_COPY_SIZE);
+	ut_assertnonnull(base);
+	ut_assertnonnull(overlay);
+	ut_assertnonnull(stacked);
+
+	ut_assertok(fdt_open_into(&__dtb_test_fdt_base_begin, base,
+				  FDT_COPY_SIZE));
+	ut_assertok(fdt_open_into(&__dtb_test_fdt_overlay_begin, overlay,
+				  FDT_COPY_SIZE));
+	ut_assertok(fdt_open_into(&__dtb_test_fdt_overlay_stacked_begin,
+				  stacked, FDT_COPY_SIZE));
+
+	ut_assertok(fdt_overlay_index_create(base, &idx));
+	ut_assertok(fdt_overlay_apply_index(base, overlay, idx));
+	ut_assertok(fdt_overlay_apply_index(base, stacked, idx));
+	fdt_overlay_index_free(idx);
+
+	ut_asserteq(fdt_totalsize(uts->priv), fdt_totalsize(base));
+	ut_assertok(memcmp(uts->priv, base, fdt_totalsize(base)));
+
+	free(stacked);
+	free(overlay);
+	free(base);
+
+	return CMD_RET_SUCCESS;
+}
+OVERLAY_TEST(fdt_overlay_index_same, 0);
+
+#define BENCH_NODES		1000
+#define BENCH_FRAGMENTS		300
+#define BENCH_BASE_SIZE		SZ_1M
+#define BENCH_OVERLAY_SIZE	SZ_256K
+
+/*
+ * A base tree with @BENCH_NODES labelled nodes under /soc, like a board
+ * tree compiled with symbols
+ */
+static int bench_make_base(void *buf)
+{
+	char name[32], path[32];
+	int i;
+
+	fdt_create(buf, BENCH_BASE_SIZE);
+	fdt_finish_reservemap(buf);
+	fdt_begin_node(buf, "");
+	fdt_begin_node(buf, "soc");
+	for (i = 0; i < BENCH_NODES; i++) {
+		snprintf(name, sizeof(name), "dev@%x", i);
+		fdt_begin_node(buf, name);
+		fdt_property_u32(buf, "reg", i);
+		fdt_property_string(buf, "status", "okay");
+		fdt_property_u32(buf, "phandle", i + 1);
+		fdt_end_node(buf);
+	}
+	fdt_end_node(buf);
+	fdt_begin_node(buf, "__symbols__");
+	for (i = 0; i < BENCH_NODES; i++) {
+		snprintf(name, sizeof(name), "dev%d", i);
+		snprintf(path, sizeof(path), "/soc/dev@%x", i);
+		fdt_property_string(buf, name, path);
+	}
+	fdt_end_node(buf);
+	fdt_end_node(buf);
+	fdt_finish(buf);
+
+	return fdt_open_into(buf, buf, BENCH_BASE_SIZE);
+}
+
+/*
+ * An overlay of @BENCH_FRAGMENTS fragments, each targeting a base node by
+ * label, referring to it once more and adding a labelled local node
+ */
+static int bench_make_overlay(void *buf)
+{
+	char name[32], fixup[64];
+	int i, len;
+
+	fdt_create(buf, BENCH_OVERLAY_SIZE);
+	fdt_finish_reservemap(buf);
+	fdt_begin_node(buf, "");
+	for (i = 0; i < BENCH_FRAGMENTS; i++) {
+		snprintf(name, sizeof(name), "fragment@%d", i);
+		fdt_begin_node(buf, name);
+		fdt_property_u32(buf, "target", 0xffffffff);
+		fdt_begin_node(buf, "__overlay__");
+		fdt_property_string(buf, "status", "disabled");
+		fdt_property_u32(buf, "remote", 0xffffffff);
+		fdt_property_u32(buf, "local", i + 1);
+		fdt_begin_node(buf, "child");
+		fdt_property_u32(buf, "phandle", i + 1);
+		fdt_end_node(buf);
+		fdt_end_node(buf);
+		fdt_end_node(buf);
+	}
+
+	fdt_begin_node(buf, "__fixups__");
+	for (i = 0; i < BENCH_FRAGMENTS; i++) {
+		snprintf(name, sizeof(name), "dev%d", i * 7 % BENCH_NODES);
+		len = snprintf(fixup, sizeof(fixup), "/fragment@%d:target:0", i);
+		len += snprintf(fixup + len + 1, sizeof(fixup) - len - 1,
+				"/fragment@%d/__overlay__:remote:0", i);
+		fdt_property(buf, name, fixup, len + 2);
+	}
+	fdt_end_node(buf);
+
+	fdt_begin_node(buf, "__local_fixups__");
+	for (i = 0; i < BENCH_FRAGMENTS; i++) {
+		snprintf(name, sizeof(name), "fragment@%d", i);
+		fdt_begin_node(buf, name);
+		fdt_begin_node(buf, "__overlay__");
+		fdt_property_u32(buf, "local", 0);
+		fdt_end_node(buf);
+		fdt_end_node(buf);
+	}
+	fdt_end_node(buf);
+
+	fdt_begin_node(buf, "__symbols__");
+	for (i = 0; i < BENCH_FRAGMENTS; i++) {
+		snprintf(name, sizeof(name), "ovl%d", i);
+		snprintf(fixup, sizeof(fixup), "/fragment@%d/__overlay__/child",
+			 i);
+		fdt_property_string(buf, name, fixup);
+	}
+	fdt_end_node(buf);
+	fdt_end_node(buf);
+	fdt_finish(buf);
+
+	return fdt_open_into(buf, buf, BENCH_OVERLAY_SIZE);
+}
+
+/* Compare fdt_overlay_apply() with the indexed version on a large tree */
+static int fdt_overlay_index_bench(struct unit_test_state *uts)
+{
+	struct fdt_overlay_index *idx;
+	void *base, *base_idx, *overlay;
+	ulong start, plain_us, index_us;
+
+	base = malloc(BENCH_BASE_SIZE);
+	base_idx = malloc(BENCH_BASE_SIZE);
+	overlay = malloc(BENCH_OVERLAY_SIZE);
+	ut_assertnonnull(base);
+	ut_assertnonnull(base_idx);
+	ut_assertnonnull(overlay);
+
+	ut_assertok(bench_make_base(base));
+	memcpy(base_idx, base, BENCH_BASE_SIZE);
+
+	ut_assertok(bench_make_overlay(overlay));
+	start = timer_get_us();
+	ut_assertok(fdt_overlay_apply(base, overlay));
+	plain_us = timer_get_us() - start;
+
+	ut_assertok(bench_make_overlay(overlay));
+	start = timer_get_us();
+	ut_assertok(fdt_overlay_index_create(base_idx, &idx));
+	ut_assertok(fdt_overlay_apply_index(base_idx, overlay, idx));
+	index_us = timer_get_us() - start;
+	fdt_overlay_index_free(idx);
+
+	printf("%d nodes, %d fragments: plain %lu us, indexed %lu us\n",
+	       BENCH_NODES, BENCH_FRAGMENTS, plain_us, index_us);
+	ut_assertok(memcmp(base, base_idx, fdt_totalsize(base)));
+
+	free(overlay);
+	free(base_idx);
+	free(base);
+
+	return CMD_RET_SUCCESS;
+}
+OVERLAY_TEST(fdt_overlay_index_bench, 0);
+#endif
+
 int do_ut_overlay(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	struct unit_test *tests = ll_entry_start(struct unit_test,
@@ -13,6 +13,38 @@
 #include <bootm.h>
 #include <image.h>
 #include <version.h>
+#include <pthread.h>
+
+/**
+ * struct fit_hash_job - hash of one hash node, computed ahead of time
+ *
+ * Hashing only reads the FIT while storing the value changes it, so all
+ * hashes are computed first (possibly in parallel) and written afterwards
+ * in node order. This keeps the output identical whatever the number of
+ * threads.
+ *
+ * @data:	image data to hash
+ * @size:	size of data in bytes
+ * @algo:	hash algorithm name, NULL if the node has none
+ * @value:	computed hash value
+ * @value_len:	length of computed hash value
+ * @ret:	result of calculate_hash()
+ */
+struct fit_hash_job {
+	const void *data;
+	size_t size;
+	const char *algo;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int value_len;
+	int ret;
+};
+
+struct fit_hash_pool {
+	struct fit_hash_job *jobs;
+	int count;
+	int next;
+	pthread_mutex_t lock;
+};
 
 /**
  * fit_set_hash_value - set hash value in requested has node
@@ -28,7 +60,7 @@
  *     0, on success
  *     -1, on failure
  */
-static int fit_set_hash_value(void *fit, int noffset, uint8_t *value,
+static int fit_set_hash_value(void *fit, int noffset, const uint8_t *value,
 				int value_len)
 {
 	int ret;
@@ -47,22 +79,19 @@ static int fit_set_hash_value(void *fit, int noffset, uint8_t *value,
 /**
  * fit_image_process_hash - Process a single subnode of the images/ node
  *
- * Check each subnode and process accordingly. For hash nodes we generate
- * a hash of the supplised data and store it in the node.
+ * Check each subnode and process accordingly. For hash nodes we store the
+ * hash computed by fit_compute_hashes() in the node.
  *
  * @fit:	pointer to the FIT format image header
  * @image_name:	name of image being processes (used to display errors)
  * @noffset:	subnode offset
- * @data:	data to process
- * @size:	size of data in bytes
+ * @job:	precomputed hash of the image data
  * @return 0 if ok, -1 on error
  */
 static int fit_image_process_hash(void *fit, const char *image_name,
-		int noffset, const void *data, size_t size)
+		int noffset, const struct fit_hash_job *job)
 {
-	uint8_t value[FIT_MAX_HASH_LEN];
 	const char *node_name;
-	int value_len;
 	char *algo;
 	int ret;
 
@@ -74,13 +103,13 @@ static int fit_image_process_hash(void *fit, const char *image_name,
 		return -ENOENT;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	if (job->ret) {
 		printf("Unsupported hash algorithm (%s) for '%s' hash node in '%s' image node\n",
 		       algo, node_name, image_name);
 		return -EPROTONOSUPPORT;
 	}
 
-	ret = fit_set_hash_value(fit, noffset, value, value_len);
+	ret = fit_set_hash_value(fit, noffset, job->value, job->value_len);
 	if (ret) {
 		printf("Can't set hash value for '%s' hash node in '%s' image node\n",
 		       node_name, image_name);
@@ -296,11 +325,13 @@ static int fit_image_process_sig(const char *keydir, void *keydest,
  * @comment:	Comment to add to signature nodes
  * @require_keys: Mark all keys as 'required'
  * @engine_id:	Engine to use for signing
+ * @jobp:	Precomputed hashes, advanced past those used for this image
  * @return: 0 on success, <0 on failure
  */
 int fit_image_add_verification_data(const char *keydir, void *keydest,
 		void *fit, int image_noffset, const char *comment,
-		int require_keys, const char *engine_id)
+		int require_keys, const char *engine_id,
+		struct fit_hash_job **jobp)
 {
 	const char *image_name;
 	const void *data;
@@ -331,7 +362,7 @@ int fit_image_add_verification_data(const char *keydir, void *keydest,
 		if (!strncmp(node_name, FIT_HASH_NODENAME,
 			     strlen(FIT_HASH_NODENAME))) {
 			ret = fit_image_process_hash(fit, image_name, noffset,
-						data, size);
+						     (*jobp)++);
 		} else if (IMAGE_ENABLE_SIGN && keydir &&
 			   !strncmp(node_name, FIT_SIG_NODENAME,
 				strlen(FIT_SIG_NODENAME))) {
@@ -676,11 +707,141 @@ static int fit_config_add_verification_data(const char *keydir, void *keydest,
 	return 0;
 }
 
+/*
+ * Walk the hash nodes of all images in the order
+ * fit_image_add_verification_data() visits them and fill in what is needed
+ * to hash them. Returns the number of hash nodes, jobs may be NULL to only
+ * count them.
+ */
+static int fit_collect_hash_jobs(void *fit, int images_noffset,
+				 struct fit_hash_job *jobs)
+{
+	int image_noffset, noffset;
+	const void *data;
+	size_t size;
+	int count = 0;
+
+	for (image_noffset = fdt_first_subnode(fit, images_noffset);
+	     image_noffset >= 0;
+	     image_noffset = fdt_next_subnode(fit, image_noffset)) {
+		/* Reported when the image is processed */
+		if (fit_image_get_data(fit, image_noffset, &data, &size))
+			break;
+
+		for (noffset = fdt_first_subnode(fit, image_noffset);
+		     noffset >= 0;
+		     noffset = fdt_next_subnode(fit, noffset)) {
+			const char *node_name = fit_get_name(fit, noffset,
+							     NULL);
+			char *algo;
+
+			if (strncmp(node_name, FIT_HASH_NODENAME,
+				    strlen(FIT_HASH_NODENAME)))
+				continue;
+
+			if (jobs) {
+				struct fit_hash_job *job = &jobs[count];
+
+				job->data = data;
+				job->size = size;
+				if (!fit_image_hash_get_algo(fit, noffset,
+							     &algo))
+					job->algo = algo;
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static void fit_hash_job_run(struct fit_hash_job *job)
+{
+	if (!job->algo) {
+		job->ret = -ENOENT;
+		return;
+	}
+
+	job->ret = calculate_hash(job->data, job->size, job->algo,
+				  job->value, &job->value_len);
+}
+
+static void *fit_hash_worker(void *arg)
+{
+	struct fit_hash_pool *pool = arg;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&pool->lock);
+		i = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+		if (i >= pool->count)
+			break;
+		fit_hash_job_run(&pool->jobs[i]);
+	}
+
+	return NULL;
+}
+
+/**
+ * fit_compute_hashes() - hash the data of all image hash nodes
+ *
+ * @fit:	Pointer to the FIT format image header
+ * @images_noffset: Offset of the images parent node
+ * @threads:	Number of worker threads to hash with
+ * @jobsp:	Returns the allocated hash jobs, in node order
+ * @return 0 on success, <0 on failure
+ */
+static int fit_compute_hashes(void *fit, int images_noffset, int threads,
+			      struct fit_hash_job **jobsp)
+{
+	struct fit_hash_pool pool;
+	pthread_t *tids;
+	int started;
+	int i;
+
+	pool.count = fit_collect_hash_jobs(fit, images_noffset, NULL);
+	pool.jobs = calloc(pool.count + 1, sizeof(*pool.jobs));
+	if (!pool.jobs)
+		return -ENOMEM;
+	fit_collect_hash_jobs(fit, images_noffset, pool.jobs);
+	*jobsp = pool.jobs;
+
+	if (threads > pool.count)
+		threads = pool.count;
+	if (threads <= 1) {
+		for (i = 0; i < pool.count; i++)
+			fit_hash_job_run(&pool.jobs[i]);
+		return 0;
+	}
+
+	tids = calloc(threads, sizeof(*tids));
+	if (!tids)
+		return -ENOMEM;
+
+	pool.next = 0;
+	pthread_mutex_init(&pool.lock, NULL);
+	for (started = 0; started < threads; started++) {
+		if (pthread_create(&tids[started], NULL, fit_hash_worker,
+				   &pool))
+			break;
+	}
+	/* Whatever could not be handed to a thread is done here */
+	fit_hash_worker(&pool);
+	for (i = 0; i < started; i++)
+		pthread_join(tids[i], NULL);
+	pthread_mutex_destroy(&pool.lock);
+	free(tids);
+
+	return 0;
+}
+
 int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 			      const char *comment, int require_keys,
-			      const char *engine_id)
+			      const char *engine_id, int threads)
 {
 	int images_noffset, confs_noffset;
+	struct fit_hash_job *jobs, *job;
 	int noffset;
 	int ret;
 
@@ -692,7 +853,14 @@ int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 		return images_noffset;
 	}
 
+	ret = fit_compute_hashes(fit, images_noffset, threads, &jobs);
+	if (ret) {
+		printf("Can't allocate hash jobs\n");
+		return ret;
+	}
+
 	/* Process its subnodes, print out component images details */
+	job = jobs;
 	for (noffset = fdt_first_subnode(fit, images_noffset);
 	     noffset >= 0;
 	     noffset = fdt_next_subnode(fit, noffset)) {
@@ -701,10 +869,14 @@ int fit_add_verification_data(const char *keydir, void *keydest, void *fit,
 		 * i.e. component image node.
 		 */
 		ret = fit_image_add_verification_data(keydir, keydest,
-				fit, noffset, comment, require_keys, engine_id);
-		if (ret)
+				fit, noffset, comment, require_keys, engine_id,
+				&job);
+		if (ret) {
+			free(jobs);
 			return ret;
+		}
 	}
+	free(jobs);
 
 	/* If there are no keys, we can't sign configurations */
 	if (!IMAGE_ENABLE_SIGN || !keydir)
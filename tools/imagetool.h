@@ -78,6 +78,7 @@ struct image_tool_params {
 	bool quiet;		/* Don't output text in normal operation */
 	unsigned int external_offset;	/* Add padding to external data */
 	const char *engine_id;	/* Engine to use for signing */
+	int jobs;		/* Number of threads to hash FIT images with */
 	char *extraparams;	/* Extra parameters for img creation (-X) */
 };
 
@@ -22,6 +22,7 @@ static struct image_tool_params params = {
 	.type = IH_TYPE_KERNEL,
 	.comp = IH_COMP_GZIP,
 	.dtc = MKIMAGE_DEFAULT_DTC_OPTIONS,
+	.jobs = 1,
 	.imagename = "",
 	.imagename2 = "",
 };
@@ -96,6 +97,7 @@ static void usage(const char *msg)
 		"          -D => set all options for device tree compiler\n"
 		"          -f => input filename for FIT source\n"
 		"          -i => input filename for ramdisk file\n"
+		"          -j => number of threads hashing FIT images (0: one per CPU)\n"
 		"          -v => set FIT image version in decimal\n");
 
 #ifdef CONFIG_FIT_SIGNATURE
@@ -146,7 +148,7 @@ static void process_args(int argc, char **argv)
 	int opt;
 
 	while ((opt = getopt(argc, argv,
-			     "a:A:b:c:C:d:D:e:Ef:Fk:i:K:ln:N:p:O:rR:qsT:v:VxX:")) != -1) {
+			     "a:A:b:c:C:d:D:e:Ef:Fj:k:i:K:ln:N:p:O:rR:qsT:v:VxX:")) != -1) {
 		switch (opt) {
 		case 'a':
 			params.addr = strtoull(optarg, &ptr, 16);
@@ -215,6 +217,16 @@ static void process_args(int argc, char **argv)
 		case 'i':
 			params.fit_ramdisk = optarg;
 			break;
+		case 'j':
+			params.jobs = strtoul(optarg, &ptr, 10);
+			if (*ptr) {
+				fprintf(stderr, "%s: invalid job count %s\n",
+					params.cmdname, optarg);
+				exit(EXIT_FAILURE);
+			}
+			if (!params.jobs)
+				params.jobs = sysconf(_SC_NPROCESSORS_ONLN);
+			break;
 		case 'k':
 			params.keydir = optarg;
 			break;
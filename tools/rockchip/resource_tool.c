@@ -4,13 +4,17 @@
  */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <memory.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 
 /**
  * \brief	   SHA-1 context structure
@@ -599,8 +603,23 @@ typedef struct {
 	uint8_t tbl_offset;     /* blocks, offset of index table. */
 	uint8_t tbl_entry_size; /* blocks, size of index table's entry. */
 	uint32_t tbl_entry_num; /* numbers of index table's entry. */
+	/* optional, ignored by readers which don't know about it. */
+	char index_magic[4];    /* tag, "RIDX" if name index is present. */
+	uint32_t index_offset;  /* blocks, offset of name index. */
+	uint32_t index_num;     /* numbers of name index's entry. */
 } resource_ptn_header;
 
+/*
+ * The name index is an array of (hash, entry) pairs sorted by hash and then
+ * by path, so that a reader can binary search a path instead of walking the
+ * whole index table. It is placed after the last content.
+ */
+#define NAME_INDEX_MAGIC "RIDX"
+typedef struct {
+	uint32_t hash;  /* name_hash() of the entry's path. */
+	uint32_t entry; /* number of the entry in index table. */
+} name_index_entry;
+
 #define INDEX_TBL_ENTR_TAG "ENTR"
 #define MAX_INDEX_ENTRY_PATH_LEN	220
 #define MAX_HASH_LEN			32
@@ -652,6 +671,9 @@ typedef struct {
 #define OPT_CHARGE_ANIM_LEVEL_PFX "prefix="
 
 static char image_path[MAX_INDEX_ENTRY_PATH_LEN] = "\0";
+/* the whole image mapped while packing/unpacking. */
+static uint8_t *image_map = NULL;
+static size_t image_map_size = 0;
 
 static int fix_blocks(size_t size)
 {
@@ -696,6 +718,8 @@ static void fix_header(resource_ptn_header *header)
 	header->resource_ptn_version = switch_short(header->resource_ptn_version);
 	header->index_tbl_version = switch_short(header->index_tbl_version);
 	header->tbl_entry_num = switch_int(header->tbl_entry_num);
+	header->index_offset = switch_int(header->index_offset);
+	header->index_num = switch_int(header->index_num);
 }
 
 static void fix_entry(index_tbl_entry *entry)
@@ -705,6 +729,80 @@ static void fix_entry(index_tbl_entry *entry)
 	entry->content_size = switch_int(entry->content_size);
 }
 
+static void fix_name_index(name_index_entry *index)
+{
+	/* switch for be. */
+	index->hash = switch_int(index->hash);
+	index->entry = switch_int(index->entry);
+}
+
+/* FNV-1a, sync with arch/arm/mach-rockchip/resource_img.c */
+static uint32_t name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+static bool has_name_index(const resource_ptn_header *header)
+{
+	return !memcmp(header->index_magic, NAME_INDEX_MAGIC,
+		       sizeof(header->index_magic)) &&
+	       header->index_num == header->tbl_entry_num;
+}
+
+static bool map_image(bool write, size_t size)
+{
+	int fd = open(image_path, write ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY,
+		      0644);
+	struct stat st;
+	bool ret = false;
+
+	if (fd < 0) {
+		LOGE("Failed to open:%s", image_path);
+		return false;
+	}
+	if (write) {
+		if (ftruncate(fd, size)) {
+			LOGE("Failed to resize %s to %zu!", image_path, size);
+			goto end;
+		}
+	} else {
+		if (fstat(fd, &st) || st.st_size < BLOCK_SIZE) {
+			LOGE("Failed to get size:%s", image_path);
+			goto end;
+		}
+		size = st.st_size;
+	}
+
+	image_map = mmap(NULL, size, write ? PROT_READ | PROT_WRITE : PROT_READ,
+			 MAP_SHARED, fd, 0);
+	if (image_map == MAP_FAILED) {
+		LOGE("Failed to mmap:%s", image_path);
+		image_map = NULL;
+		goto end;
+	}
+	image_map_size = size;
+	ret = true;
+end:
+	close(fd);
+	return ret;
+}
+
+static void unmap_image(void)
+{
+	if (!image_map)
+		return;
+	munmap(image_map, image_map_size);
+	image_map = NULL;
+	image_map_size = 0;
+}
+
 static int inline get_ptn_offset(void)
 {
 	return 0;
@@ -759,6 +857,15 @@ static bool write_data(int offset_block, void *data, size_t len)
 	bool ret = false;
 	if (!data)
 		goto end;
+	if (image_map) {
+		/* the mapping is zero filled, so no need to pad the tail. */
+		if ((size_t)offset_block * BLOCK_SIZE + len > image_map_size) {
+			LOGE("Write beyond the end of %s!", image_path);
+			goto end;
+		}
+		memcpy(image_map + (size_t)offset_block * BLOCK_SIZE, data, len);
+		return true;
+	}
 	int blocks = len / BLOCK_SIZE;
 	if (blocks && !StorageWriteLba(offset_block, data, blocks)) {
 		goto end;
@@ -847,6 +954,73 @@ static bool load_content_data(resource_content *content, int offset_block,
 	return true;
 }
 
+static bool read_entry(const resource_ptn_header *header, int i,
+                       index_tbl_entry *entry)
+{
+	char buf[BLOCK_SIZE];
+
+	/* TODO: support tbl_entry_size */
+	if (!StorageReadLba(get_ptn_offset() + header->header_size +
+	                    i * header->tbl_entry_size, buf, 1)) {
+		LOGE("Failed to read index entry:%d!", i);
+		return false;
+	}
+	memcpy(entry, buf, sizeof(*entry));
+
+	if (memcmp(entry->tag, INDEX_TBL_ENTR_TAG, sizeof(entry->tag))) {
+		LOGE("Something wrong with index entry:%d!", i);
+		return false;
+	}
+	return true;
+}
+
+static bool read_name_index(const resource_ptn_header *header, int i,
+                            name_index_entry *index)
+{
+	const int per_block = BLOCK_SIZE / sizeof(*index);
+	name_index_entry buf[BLOCK_SIZE / sizeof(*index)];
+
+	if (!StorageReadLba(get_ptn_offset() + header->index_offset +
+	                    i / per_block, buf, 1)) {
+		LOGE("Failed to read name index:%d!", i);
+		return false;
+	}
+	*index = buf[i % per_block];
+	fix_name_index(index);
+	return true;
+}
+
+/* binary search the name index, returns entry number or -1. */
+static int find_entry_by_index(const resource_ptn_header *header,
+                               const char *file_path, index_tbl_entry *entry)
+{
+	uint32_t hash = name_hash(file_path);
+	name_index_entry index;
+	int lo = 0, hi = header->index_num, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (!read_name_index(header, mid, &index))
+			return -1;
+		if (index.hash < hash)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (; lo < header->index_num; lo++) {
+		if (!read_name_index(header, lo, &index) || index.hash != hash)
+			break;
+		if (index.entry >= header->tbl_entry_num)
+			break;
+		if (!read_entry(header, index.entry, entry))
+			break;
+		if (!strncmp(entry->path, file_path, sizeof(entry->path)))
+			return index.entry;
+	}
+	return -1;
+}
+
 static bool get_entry(const char *file_path, index_tbl_entry *entry)
 {
 	bool ret = false;
@@ -875,23 +1049,17 @@ static bool get_entry(const char *file_path, index_tbl_entry *entry)
 	}
 
 	int i;
-	for (i = 0; i < header.tbl_entry_num; i++) {
-		/* TODO: support tbl_entry_size */
-		if (!StorageReadLba(
-		            get_ptn_offset() + header.header_size + i * header.tbl_entry_size,
-		            buf, 1)) {
-			LOGE("Failed to read index entry:%d!", i);
-			goto end;
-		}
-		memcpy(entry, buf, sizeof(*entry));
-
-		if (memcmp(entry->tag, INDEX_TBL_ENTR_TAG, sizeof(entry->tag))) {
-			LOGE("Something wrong with index entry:%d!", i);
-			goto end;
+	if (has_name_index(&header)) {
+		i = find_entry_by_index(&header, file_path, entry);
+		if (i < 0)
+			i = header.tbl_entry_num;
+	} else {
+		for (i = 0; i < header.tbl_entry_num; i++) {
+			if (!read_entry(&header, i, entry))
+				goto end;
+			if (!strncmp(entry->path, file_path, sizeof(entry->path)))
+				break;
 		}
-
-		if (!strncmp(entry->path, file_path, sizeof(entry->path)))
-			break;
 	}
 	if (i == header.tbl_entry_num) {
 		LOGE("Cannot find %s!", file_path);
@@ -1261,20 +1429,23 @@ static bool mkdirs(char *path)
 	return ret;
 }
 
-static bool dump_file(FILE *file, const char *unpack_dir,
-                      index_tbl_entry entry)
+static bool dump_file(const char *unpack_dir, index_tbl_entry entry)
 {
 	LOGD("try to dump entry:%s", entry.path);
 	bool ret = false;
 	FILE *out_file = NULL;
-	long int pos = 0;
 	char path[MAX_INDEX_ENTRY_PATH_LEN * 2 + 1];
 	if (just_print) {
 		ret = true;
 		goto done;
 	}
 
-	pos = ftell(file);
+	size_t offset = (size_t)entry.content_offset * BLOCK_SIZE;
+	if (offset > image_map_size ||
+	    entry.content_size > image_map_size - offset) {
+		LOGE("Failed to read content:%s", entry.path);
+		goto end;
+	}
 	snprintf(path, sizeof(path), "%s/%s", unpack_dir, entry.path);
 	mkdirs(path);
 	out_file = fopen(path, "wb");
@@ -1282,40 +1453,21 @@ static bool dump_file(FILE *file, const char *unpack_dir,
 		LOGE("Failed to create:%s", path);
 		goto end;
 	}
-	long int offset = entry.content_offset * BLOCK_SIZE;
-	fseek(file, offset, SEEK_SET);
-	if (offset != ftell(file)) {
-		LOGE("Failed to read content:%s", entry.path);
+	if (entry.content_size &&
+	    !fwrite(image_map + offset, entry.content_size, 1, out_file)) {
+		LOGE("Failed to write:%s", entry.path);
 		goto end;
 	}
-	char buf[BLOCK_SIZE];
-	int n;
-	int len = entry.content_size;
-	while (len > 0) {
-		n = len > BLOCK_SIZE ? BLOCK_SIZE : len;
-		if (!fread(buf, n, 1, file)) {
-			LOGE("Failed to read content:%s", entry.path);
-			goto end;
-		}
-		if (!fwrite(buf, n, 1, out_file)) {
-			LOGE("Failed to write:%s", entry.path);
-			goto end;
-		}
-		len -= n;
-	}
 done:
 	ret = true;
 end:
 	if (out_file)
 		fclose(out_file);
-	if (pos)
-		fseek(file, pos, SEEK_SET);
 	return ret;
 }
 
 static int unpack_image(const char *dir)
 {
-	FILE *image_file = NULL;
 	bool ret = false;
 	char unpack_dir[MAX_INDEX_ENTRY_PATH_LEN];
 	if (just_print)
@@ -1328,17 +1480,9 @@ static int unpack_image(const char *dir)
 	}
 
 	mkdir(unpack_dir, 0755);
-	image_file = fopen(image_path, "rb");
-	char buf[BLOCK_SIZE];
-	if (!image_file) {
-		LOGE("Failed to open:%s", image_path);
+	if (!map_image(false, 0))
 		goto end;
-	}
-	if (!fread(buf, BLOCK_SIZE, 1, image_file)) {
-		LOGE("Failed to read header!");
-		goto end;
-	}
-	memcpy(&header, buf, sizeof(header));
+	memcpy(&header, image_map, sizeof(header));
 
 	if (memcmp(header.magic, RESOURCE_PTN_HDR_MAGIC, sizeof(header.magic))) {
 		LOGE("Not a resource image(%s)!", image_path);
@@ -1353,6 +1497,9 @@ static int unpack_image(const char *dir)
 	printf("header size:%d\n", header.header_size);
 	printf("index tbl:\n\toffset:%d\tentry size:%d\tentry num:%d\n",
 	       header.tbl_offset, header.tbl_entry_size, header.tbl_entry_num);
+	if (has_name_index(&header))
+		printf("name index:\n\toffset:%d\tentry num:%d\n",
+		       header.index_offset, header.index_num);
 
 	/* TODO: support header_size & tbl_entry_size */
 	if (header.resource_ptn_version != RESOURCE_PTN_VERSION ||
@@ -1365,14 +1512,16 @@ static int unpack_image(const char *dir)
 
 	printf("Dump Index table:\n");
 	index_tbl_entry entry;
+	size_t offset;
 	int i;
 	for (i = 0; i < header.tbl_entry_num; i++) {
 		/* TODO: support tbl_entry_size */
-		if (!fread(buf, BLOCK_SIZE, 1, image_file)) {
+		offset = (size_t)(header.header_size + i) * BLOCK_SIZE;
+		if (offset + BLOCK_SIZE > image_map_size) {
 			LOGE("Failed to read index entry:%d!", i);
 			goto end;
 		}
-		memcpy(&entry, buf, sizeof(entry));
+		memcpy(&entry, image_map + offset, sizeof(entry));
 
 		if (memcmp(entry.tag, INDEX_TBL_ENTR_TAG, sizeof(entry.tag))) {
 			LOGE("Something wrong with index entry:%d!", i);
@@ -1383,15 +1532,14 @@ static int unpack_image(const char *dir)
 
 		printf("entry(%d):\n\tpath:%s\n\toffset:%d\tsize:%d\n", i, entry.path,
 		       entry.content_offset, entry.content_size);
-		if (!dump_file(image_file, unpack_dir, entry)) {
+		if (!dump_file(unpack_dir, entry)) {
 			goto end;
 		}
 	}
 	printf("Unack %s to %s successed!\n", image_path, unpack_dir);
 	ret = true;
 end:
-	if (image_file)
-		fclose(image_file);
+	unmap_image();
 	return ret ? 0 : -1;
 }
 
@@ -1414,29 +1562,30 @@ static int write_file(int offset_block, const char *src_path,
 		      char hash[], int hash_size)
 {
 	LOGD("try to write file(%s) to offset:%d...", src_path, offset_block);
-	char *buf = NULL;
+	void *buf = NULL;
 	int ret = -1;
 	size_t file_size;
-	FILE *src_file = fopen(src_path, "rb");
-	if (!src_file) {
+	int fd = open(src_path, O_RDONLY);
+	if (fd < 0) {
 		LOGE("Failed to open:%s", src_path);
 		goto end;
 	}
 
 	file_size = get_file_size(src_path);
-	if (file_size < 0) {
+	if (file_size == (size_t)-1) {
 		goto end;
 	}
 
-	buf = calloc(file_size, 1);
-	if (!buf)
-		goto end;
-
-	if (!fread(buf, file_size, 1, src_file))
-		goto end;
-
-	if (!write_data(offset_block, buf, file_size))
-		goto end;
+	if (file_size) {
+		buf = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (buf == MAP_FAILED) {
+			LOGE("Failed to mmap:%s", src_path);
+			buf = NULL;
+			goto end;
+		}
+		if (!write_data(offset_block, buf, file_size))
+			goto end;
+	}
 
 	if (hash_size == 20)
 		sha1_csum((const unsigned char *)buf, file_size,
@@ -1449,15 +1598,15 @@ static int write_file(int offset_block, const char *src_path,
 
 	ret = file_size;
 end:
-	if (src_file)
-		fclose(src_file);
 	if (buf)
-		free(buf);
+		munmap(buf, file_size);
+	if (fd >= 0)
+		close(fd);
 
 	return ret;
 }
 
-static bool write_header(const int file_num)
+static bool write_header(const int file_num, const int index_offset)
 {
 	LOGD("try to write header...");
 	memcpy(header.magic, RESOURCE_PTN_HDR_MAGIC, sizeof(header.magic));
@@ -1467,6 +1616,9 @@ static bool write_header(const int file_num)
 	header.tbl_offset = header.header_size;
 	header.tbl_entry_size = INDEX_TBL_ENTR_SIZE;
 	header.tbl_entry_num = file_num;
+	memcpy(header.index_magic, NAME_INDEX_MAGIC, sizeof(header.index_magic));
+	header.index_offset = index_offset;
+	header.index_num = file_num;
 
 	/* switch for le. */
 	resource_ptn_header hdr = header;
@@ -1485,6 +1637,7 @@ static bool write_index_tbl(const int file_num, const char **files)
 	char hash[20];	/* sha1 */
 	int i;
 
+	memset(&entry, 0, sizeof(entry));
 	memcpy(entry.tag, INDEX_TBL_ENTR_TAG, sizeof(entry.tag));
 	for (i = 0; i < file_num; i++) {
 		size_t file_size = get_file_size(files[i]);
@@ -1544,15 +1697,55 @@ end:
 	return ret;
 }
 
-static int pack_image(int file_num, const char **files)
+static const char *mapped_entry_path(uint32_t i)
 {
+	index_tbl_entry *entry = (index_tbl_entry *)(image_map +
+	        (header.header_size + i * header.tbl_entry_size) * BLOCK_SIZE);
+
+	return entry->path;
+}
+
+static int name_index_cmp(const void *a, const void *b)
+{
+	const name_index_entry *x = a, *y = b;
+	int ret;
+
+	if (x->hash != y->hash)
+		return x->hash < y->hash ? -1 : 1;
+	ret = strncmp(mapped_entry_path(x->entry), mapped_entry_path(y->entry),
+	              MAX_INDEX_ENTRY_PATH_LEN);
+	if (ret)
+		return ret;
+	return x->entry < y->entry ? -1 : 1;
+}
+
+static bool write_name_index(const int file_num)
+{
+	LOGD("try to write name index...");
+	name_index_entry *index = calloc(file_num, sizeof(*index));
 	bool ret = false;
-	FILE *image_file = fopen(image_path, "wb");
-	if (!image_file) {
-		LOGE("Failed to create:%s", image_path);
+	int i;
+
+	if (!index)
 		goto end;
+	for (i = 0; i < file_num; i++) {
+		index[i].hash = name_hash(mapped_entry_path(i));
+		index[i].entry = i;
 	}
-	fclose(image_file);
+	qsort(index, file_num, sizeof(*index), name_index_cmp);
+
+	/* switch for le. */
+	for (i = 0; i < file_num; i++)
+		fix_name_index(&index[i]);
+	ret = write_data(header.index_offset, index, file_num * sizeof(*index));
+end:
+	free(index);
+	return ret;
+}
+
+static int pack_image(int file_num, const char **files)
+{
+	bool ret = false;
 
 	/* prepare files */
 	int i = 0;
@@ -1574,7 +1767,21 @@ static int pack_image(int file_num, const char **files)
 		}
 	}
 
-	if (!write_header(file_num)) {
+	/* header, index table, contents and then name index. */
+	int index_offset = RESOURCE_PTN_HDR_SIZE + INDEX_TBL_ENTR_SIZE * file_num;
+	for (i = 0; i < file_num; i++) {
+		size_t file_size = get_file_size(files[i]);
+		if (file_size == (size_t)-1)
+			goto end;
+		index_offset += fix_blocks(file_size);
+	}
+	int index_blocks = fix_blocks(file_num * sizeof(name_index_entry));
+	if (!map_image(true, (size_t)(index_offset + index_blocks) * BLOCK_SIZE)) {
+		LOGE("Failed to create:%s", image_path);
+		goto end;
+	}
+
+	if (!write_header(file_num, index_offset)) {
 		LOGE("Failed to write header!");
 		goto end;
 	}
@@ -1582,9 +1789,14 @@ static int pack_image(int file_num, const char **files)
 		LOGE("Failed to write index table!");
 		goto end;
 	}
+	if (!write_name_index(file_num)) {
+		LOGE("Failed to write name index!");
+		goto end;
+	}
 	printf("Pack to %s successed!\n", image_path);
 	ret = true;
 end:
+	unmap_image();
 	return ret ? 0 : -1;
 }
 